@@ -12,8 +12,8 @@ extern RenderGraph::ResourceHandle g_LightingOutputRDGTextureHandle;
 
 class AdaptLuminanceRenderer : public IRenderer
 {
-    nvrhi::BufferHandle m_LuminanceReadbackBuffers[2];
-    nvrhi::StagingTextureHandle m_ExposureReadbackTextures[2];
+    nvrhi::BufferHandle m_LuminanceReadbackBuffers[GraphicConstants::kMaxFramesInFlight];
+    nvrhi::StagingTextureHandle m_ExposureReadbackTextures[GraphicConstants::kMaxFramesInFlight];
     RenderGraph::ResourceHandle m_LuminanceHistogramRDGBufferHandle;
 
     float m_MinimumLuminance = 0.004f;
@@ -30,7 +30,7 @@ public:
         nvrhi::CommandListHandle commandList = g_Graphic.AllocateCommandList();
         SCOPED_COMMAND_LIST_AUTO_QUEUE(commandList, "AdaptLuminanceRenderer Init");
 
-        for (uint32_t i = 0; i < 2; ++i)
+        for (uint32_t i = 0; i < GraphicConstants::kMaxFramesInFlight; ++i)
         {
             nvrhi::BufferDesc desc;
             desc.byteSize = sizeof(float);
@@ -41,7 +41,7 @@ public:
             m_LuminanceReadbackBuffers[i] = device->createBuffer(desc);
         }
 
-        for (uint32_t i = 0; i < 2; ++i)
+        for (uint32_t i = 0; i < GraphicConstants::kMaxFramesInFlight; ++i)
         {
             nvrhi::TextureDesc desc;
             desc.format = nvrhi::Format::R32_FLOAT;
@@ -111,7 +111,7 @@ public:
         desc.initialState = nvrhi::ResourceStates::ShaderResource;
         renderGraph.CreateTransientResource(m_LuminanceHistogramRDGBufferHandle, desc);
 
-        renderGraph.AddReadDependency(g_LightingOutputRDGTextureHandle);
+        renderGraph.AddReadDependency(g_LightingOutputRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
 
         return true;
     }
@@ -122,15 +122,15 @@ public:
 
         // read back previous frame's scene luminance
         {
-            const float* readbackBytes = (float*)device->mapBuffer(m_LuminanceReadbackBuffers[g_Graphic.m_FrameCounter % 2], nvrhi::CpuAccessMode::Read);
+            const float* readbackBytes = (float*)device->mapBuffer(m_LuminanceReadbackBuffers[g_Graphic.GetFrameSlot()], nvrhi::CpuAccessMode::Read);
             check(readbackBytes);
             g_Scene->m_LastFrameLuminance = *readbackBytes;
-            device->unmapBuffer(m_LuminanceReadbackBuffers[g_Graphic.m_FrameCounter % 2]);
+            device->unmapBuffer(m_LuminanceReadbackBuffers[g_Graphic.GetFrameSlot()]);
         }
 
         // read back previous frame's exposure value
         {
-            nvrhi::StagingTextureHandle thisFrameExposureReadbackTexture = m_ExposureReadbackTextures[g_Graphic.m_FrameCounter % 2]; 
+            nvrhi::StagingTextureHandle thisFrameExposureReadbackTexture = m_ExposureReadbackTextures[g_Graphic.GetFrameSlot()]; 
 
             size_t outRowPitch;
             const float* exposureReadback = (const float*)g_Graphic.m_NVRHIDevice->mapStagingTexture(thisFrameExposureReadbackTexture, nvrhi::TextureSlice{}, nvrhi::CpuAccessMode::Read, &outRowPitch);
@@ -142,8 +142,8 @@ public:
         ON_EXIT_SCOPE_LAMBDA([&]
             {
                 // copy to staging buffer/texture to be read back by CPU next frame, regardless whether manual exposure mode is enabled or not
-                commandList->copyBuffer(m_LuminanceReadbackBuffers[g_Graphic.m_FrameCounter % 2], 0, g_Scene->m_LuminanceBuffer, 0, sizeof(float));
-                commandList->copyTexture(m_ExposureReadbackTextures[g_Graphic.m_FrameCounter % 2], nvrhi::TextureSlice{}, g_Scene->m_ExposureTexture, nvrhi::TextureSlice{});
+                commandList->copyBuffer(m_LuminanceReadbackBuffers[g_Graphic.GetFrameSlot()], 0, g_Scene->m_LuminanceBuffer, 0, sizeof(float));
+                commandList->copyTexture(m_ExposureReadbackTextures[g_Graphic.GetFrameSlot()], nvrhi::TextureSlice{}, g_Scene->m_ExposureTexture, nvrhi::TextureSlice{});
             });
 
         if (g_Scene->m_ManualExposureOverride > 0.0f)
@@ -176,7 +176,7 @@ public:
 
             Graphic::ComputePassParams computePassParams;
             computePassParams.m_CommandList = commandList;
-            computePassParams.m_ShaderName = "adaptluminance_CS_GenerateLuminanceHistogram";
+            computePassParams.m_ShaderID = "adaptluminance_CS_GenerateLuminanceHistogram";
             computePassParams.m_BindingSetDesc = bindingSetDesc;
             computePassParams.m_DispatchGroupSize = ComputeShaderUtils::GetGroupCount(passParameters.m_SrcColorDims, Vector2U{ 16, 16 });
             computePassParams.m_PushConstantsData = &passParameters;
@@ -204,7 +204,7 @@ public:
 
             Graphic::ComputePassParams computePassParams;
             computePassParams.m_CommandList = commandList;
-            computePassParams.m_ShaderName = "adaptluminance_CS_AdaptExposure";
+            computePassParams.m_ShaderID = "adaptluminance_CS_AdaptExposure";
             computePassParams.m_BindingSetDesc = bindingSetDesc;
             computePassParams.m_DispatchGroupSize = Vector3U{ 1,1,1 };
             computePassParams.m_PushConstantsData = &passParameters;
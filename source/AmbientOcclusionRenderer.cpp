@@ -120,8 +120,8 @@ public:
             renderGraph.CreateTransientResource(m_DebugOutputRDGTextureHandle, desc);
         }
 
-		renderGraph.AddReadDependency(g_GBufferARDGTextureHandle);
-        renderGraph.AddReadDependency(g_DepthBufferCopyRDGTextureHandle);
+		renderGraph.AddReadDependency(g_GBufferARDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
+        renderGraph.AddReadDependency(g_DepthBufferCopyRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
 
 		return true;
 	}
@@ -135,7 +135,7 @@ public:
         const uint32_t frameCounter = g_Graphic.m_FrameCounter % 256;
         XeGTAO::GTAOUpdateConstants(GTAOconsts, g_Graphic.m_RenderResolution.x, g_Graphic.m_RenderResolution.y, m_XeGTAOSettings, (const float*)&g_Scene->m_View.m_ViewToClip.m, bRowMajor, frameCounter);
 
-        nvrhi::BufferHandle passConstantBuffer = g_Graphic.CreateConstantBuffer(commandList, GTAOconsts);
+        nvrhi::BufferHandle passConstantBuffer = g_Graphic.WriteConstantBuffer(commandList, GTAOconsts);
 
         nvrhi::TextureHandle workingDepthBuffer = renderGraph.GetTexture(m_WorkingDepthBufferRDGTextureHandle);
         nvrhi::TextureHandle workingSSAOTexture = renderGraph.GetTexture(m_WorkingSSAORDGTextureHandle);
@@ -166,7 +166,7 @@ public:
 
             Graphic::ComputePassParams computePassParams;
             computePassParams.m_CommandList = commandList;
-            computePassParams.m_ShaderName = "ambientocclusion_CS_XeGTAO_PrefilterDepths";
+            computePassParams.m_ShaderID = "ambientocclusion_CS_XeGTAO_PrefilterDepths";
             computePassParams.m_BindingSetDesc = bindingSetDesc;
             computePassParams.m_DispatchGroupSize = ComputeShaderUtils::GetGroupCount(Vector2U{ workingDepthBuffer->getDesc().width, workingDepthBuffer->getDesc().height }, Vector2U{ 16, 16 });
 
@@ -197,7 +197,16 @@ public:
 
             Graphic::ComputePassParams computePassParams;
             computePassParams.m_CommandList = commandList;
-            computePassParams.m_ShaderName = StringFormat("ambientocclusion_CS_XeGTAO_MainPass DEBUG_OUTPUT_MODE=%d", m_DebugOutputMode);
+            static constexpr ShaderID kMainPassShaderIDs[] =
+            {
+                "ambientocclusion_CS_XeGTAO_MainPass DEBUG_OUTPUT_MODE=0",
+                "ambientocclusion_CS_XeGTAO_MainPass DEBUG_OUTPUT_MODE=1",
+                "ambientocclusion_CS_XeGTAO_MainPass DEBUG_OUTPUT_MODE=2",
+                "ambientocclusion_CS_XeGTAO_MainPass DEBUG_OUTPUT_MODE=3",
+            };
+            check((uint32_t)m_DebugOutputMode < std::size(kMainPassShaderIDs));
+
+            computePassParams.m_ShaderID = kMainPassShaderIDs[m_DebugOutputMode];
             computePassParams.m_BindingSetDesc = bindingSetDesc;
             computePassParams.m_DispatchGroupSize = ComputeShaderUtils::GetGroupCount(Vector2U{ workingSSAOTexture->getDesc().width, workingSSAOTexture->getDesc().height }, Vector2U{ XE_GTAO_NUMTHREADS_X, XE_GTAO_NUMTHREADS_Y });
             computePassParams.m_PushConstantsData = &mainPassConsts;
@@ -235,7 +244,7 @@ public:
 
             Graphic::ComputePassParams computePassParams;
             computePassParams.m_CommandList = commandList;
-            computePassParams.m_ShaderName = "ambientocclusion_CS_XeGTAO_Denoise";
+            computePassParams.m_ShaderID = "ambientocclusion_CS_XeGTAO_Denoise";
             computePassParams.m_BindingSetDesc = bindingSetDesc;
             computePassParams.m_DispatchGroupSize = ComputeShaderUtils::GetGroupCount(Vector2U{ srcTexture->getDesc().width, srcTexture->getDesc().height }, Vector2U{ XE_GTAO_NUMTHREADS_X * 2, XE_GTAO_NUMTHREADS_Y });
             computePassParams.m_PushConstantsData = &denoiseConsts;
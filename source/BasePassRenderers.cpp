@@ -58,7 +58,7 @@ public:
 
         g_Scene->m_InstanceConstsBuffer = g_Graphic.m_NVRHIDevice->createBuffer(desc);
 
-        commandList->writeBuffer(g_Scene->m_InstanceConstsBuffer, instanceConstsBytes.data(), instanceConstsBytes.size() * sizeof(BasePassInstanceConstants));
+        g_Graphic.WriteStructuredBuffer(commandList, g_Scene->m_InstanceConstsBuffer, std::span<const BasePassInstanceConstants>{ instanceConstsBytes });
     }
 
     void CreateNodeTransformsBuffer(nvrhi::CommandListHandle commandList)
@@ -82,7 +82,7 @@ public:
             g_Scene->m_NodeLocalTransformsBuffer = g_Graphic.m_NVRHIDevice->createBuffer(desc);
         }
 
-        commandList->writeBuffer(g_Scene->m_NodeLocalTransformsBuffer, g_Scene->m_NodeLocalTransforms.data(), g_Scene->m_NodeLocalTransforms.size() * sizeof(NodeLocalTransform));
+        g_Graphic.WriteStructuredBuffer(commandList, g_Scene->m_NodeLocalTransformsBuffer, std::span<const Scene::NodeLocalTransformBytes>{ g_Scene->m_NodeLocalTransforms });
 
         {
             nvrhi::BufferDesc desc;
@@ -100,7 +100,7 @@ public:
             primitiveIDToNodeIDBytes.push_back(primitive.m_NodeID);
         }
 
-        commandList->writeBuffer(g_Scene->m_PrimitiveIDToNodeIDBuffer, primitiveIDToNodeIDBytes.data(), primitiveIDToNodeIDBytes.size() * sizeof(uint32_t));
+        g_Graphic.WriteStructuredBuffer(commandList, g_Scene->m_PrimitiveIDToNodeIDBuffer, std::span<const uint32_t>{ primitiveIDToNodeIDBytes });
     }
 
     void PostSceneLoad() override
@@ -126,7 +126,7 @@ public:
     {
         {
             PROFILE_GPU_SCOPED(commandList, "Upload Node Transforms");
-            commandList->writeBuffer(g_Scene->m_NodeLocalTransformsBuffer, g_Scene->m_NodeLocalTransforms.data(), g_Scene->m_NodeLocalTransforms.size() * sizeof(NodeLocalTransform));
+            g_Graphic.WriteStructuredBuffer(commandList, g_Scene->m_NodeLocalTransformsBuffer, std::span<const Scene::NodeLocalTransformBytes>{ g_Scene->m_NodeLocalTransforms });
         }
 
         const uint32_t numPrimitives = g_Scene->m_Primitives.size();
@@ -146,7 +146,7 @@ public:
 
         Graphic::ComputePassParams computePassParams;
         computePassParams.m_CommandList = commandList;
-        computePassParams.m_ShaderName = "updateinstanceconsts_CS_UpdateInstanceConstsAndBuildTLAS";
+        computePassParams.m_ShaderID = "updateinstanceconsts_CS_UpdateInstanceConstsAndBuildTLAS";
         computePassParams.m_BindingSetDesc = bindingSetDesc;
         computePassParams.m_DispatchGroupSize = ComputeShaderUtils::GetGroupCount(passConstants.m_NumInstances, kNumThreadsPerWave);
         computePassParams.m_PushConstantsData = &passConstants;
@@ -175,12 +175,18 @@ class BasePassRenderer : public IRenderer
     RenderGraph::ResourceHandle m_MeshletAmplificationDataBufferRDGBufferHandle;
     RenderGraph::ResourceHandle m_MeshletDispatchArgumentsBufferRDGBufferHandle;
 
-    nvrhi::PipelineStatisticsQueryHandle m_PipelineStatisticsQuery[2];
+    static const uint32_t kMaxNumBasePassSteps = 4;
+
+    // 1 per command list the base pass is recorded in, summed on readback
+    nvrhi::PipelineStatisticsQueryHandle m_PipelineStatisticsQueries[GraphicConstants::kMaxFramesInFlight][kMaxNumBasePassSteps];
+    uint32_t m_NumPipelineStatisticsQueries[GraphicConstants::kMaxFramesInFlight] = {};
     nvrhi::PipelineStatistics m_LastPipelineStatistics;
 
     bool m_DoFrustumCulling = true;
     bool m_bDoOcclusionCulling = true;
     bool m_bDoMeshletConeCulling = true;
+    bool m_bMultithreadedRecording = true;
+    bool m_bRecordStepsInChildCommandLists = false;
     uint32_t m_CullingFlags = 0;
 
     Vector2U m_HZBDimensions = Vector2U{ 1,1 };
@@ -201,9 +207,12 @@ public:
 
 	void Initialize() override
 	{
-        for (uint32_t i = 0; i < 2; ++i)
+        for (uint32_t i = 0; i < GraphicConstants::kMaxFramesInFlight; ++i)
         {
-            m_PipelineStatisticsQuery[i] = g_Graphic.m_NVRHIDevice->createPipelineStatisticsQuery();
+            for (uint32_t j = 0; j < kMaxNumBasePassSteps; ++j)
+            {
+                m_PipelineStatisticsQueries[i][j] = g_Graphic.m_NVRHIDevice->createPipelineStatisticsQuery();
+            }
         }
 	}
 
@@ -211,6 +220,7 @@ public:
 
     void UpdateImgui() override
     {
+        ImGui::Checkbox("Multi-threaded Recording", &m_bMultithreadedRecording);
         ImGui::Text("Primitives Invocations: %llu", m_LastPipelineStatistics.CInvocations);
         ImGui::Text("Primitives Primitives: %llu", m_LastPipelineStatistics.CPrimitives);
         ImGui::Text("PS Invocations: %llu", m_LastPipelineStatistics.PSInvocations);
@@ -232,6 +242,12 @@ public:
         m_bDoOcclusionCulling = g_Scene->m_bEnableOcclusionCulling;
         m_bDoMeshletConeCulling = g_Scene->m_bEnableMeshletConeCulling;
 
+        m_bRecordStepsInChildCommandLists = m_bMultithreadedRecording;
+        if (m_bRecordStepsInChildCommandLists)
+        {
+            renderGraph.SetNumChildCommandLists(GetNumBasePassSteps());
+        }
+
         {
             nvrhi::BufferDesc desc;
             desc.byteSize = sizeof(MeshletAmplificationData) * GraphicConstants::kMaxThreadGroupsPerDimension;
@@ -346,7 +362,7 @@ public:
         passParameters.m_ForcedMeshLOD =  forcedMeshLOD;
         passParameters.m_MeshLODTarget = (2.0f / g_Scene->m_View.m_ViewToClip.m[1][1]) * (1.0f / (float)g_Graphic.m_RenderResolution.y);
 
-        nvrhi::BufferHandle passConstantBuffer = g_Graphic.CreateConstantBuffer(commandList, passParameters);
+        nvrhi::BufferHandle passConstantBuffer = g_Graphic.WriteConstantBuffer(commandList, passParameters);
 
         nvrhi::BindingSetDesc bindingSetDesc;
         bindingSetDesc.bindings = {
@@ -362,13 +378,13 @@ public:
             nvrhi::BindingSetItem::Sampler(0, g_CommonResources.LinearClampMinReductionSampler)
         };
 
-        const std::string shaderName = StringFormat("gpuculling_CS_GPUCulling LATE_CULL=%d", bLateCull);
+        const ShaderID shaderID = bLateCull ? ShaderID{ "gpuculling_CS_GPUCulling LATE_CULL=1" } : ShaderID{ "gpuculling_CS_GPUCulling LATE_CULL=0" };
 
         if (!bLateCull)
         {
             Graphic::ComputePassParams computePassParams;
             computePassParams.m_CommandList = commandList;
-            computePassParams.m_ShaderName = shaderName;
+            computePassParams.m_ShaderID = shaderID;
             computePassParams.m_BindingSetDesc = bindingSetDesc;
             computePassParams.m_DispatchGroupSize = ComputeShaderUtils::GetGroupCount(nbInstances, kNumThreadsPerWave);
 
@@ -381,7 +397,7 @@ public:
                     nvrhi::BindingSetItem::StructuredBuffer_UAV(0, lateCullDispatchIndirectArgsBuffer)
                 };
 
-                computePassParams.m_ShaderName = "gpuculling_CS_BuildLateCullIndirectArgs";
+                computePassParams.m_ShaderID = "gpuculling_CS_BuildLateCullIndirectArgs";
                 computePassParams.m_BindingSetDesc = bindingSetDesc;
                 computePassParams.m_DispatchGroupSize = Vector3U{ 1, 1, 1 };
 
@@ -394,7 +410,7 @@ public:
             {
                 Graphic::ComputePassParams computePassParams;
                 computePassParams.m_CommandList = commandList;
-                computePassParams.m_ShaderName = shaderName;
+                computePassParams.m_ShaderID = shaderID;
                 computePassParams.m_BindingSetDesc = bindingSetDesc;
                 computePassParams.m_IndirectArgsBuffer = lateCullDispatchIndirectArgsBuffer;
 
@@ -457,7 +473,7 @@ public:
         basePassConstants.m_bVisualizeMinMipTilesOnAlbedoOutput = g_Scene->m_bVisualizeMinMipTilesOnAlbedoOutput ? 1 : 0;
         basePassConstants.m_bWriteSamplerFeedback = g_Scene->m_bWriteSamplerFeedback ? 1 : 0;
 
-        nvrhi::BufferHandle passConstantBuffer = g_Graphic.CreateConstantBuffer(commandList, basePassConstants);
+        nvrhi::BufferHandle passConstantBuffer = g_Graphic.WriteConstantBuffer(commandList, basePassConstants);
 
         // bind and set root signature
         nvrhi::BindingSetDesc bindingSetDesc;
@@ -484,7 +500,7 @@ public:
         g_Graphic.CreateBindingSetAndLayout(bindingSetDesc, bindingSet, bindingLayout);
 
         nvrhi::MeshletPipelineDesc PSODesc;
-        PSODesc.AS = g_Graphic.GetShader(StringFormat("basepass_AS_Main LATE_CULL=%d", bIsLateCull));
+        PSODesc.AS = g_Graphic.GetShader(bIsLateCull ? ShaderID{ "basepass_AS_Main LATE_CULL=1" } : ShaderID{ "basepass_AS_Main LATE_CULL=0" });
         PSODesc.MS = g_Graphic.GetShader("basepass_MS_Main");
         PSODesc.PS = bAlphaMaskPrimitives ? params.m_PSAlphaMask : params.m_PS;
         PSODesc.renderState = finalRenderState;
@@ -528,7 +544,7 @@ public:
 
         Graphic::ComputePassParams computePassParams;
         computePassParams.m_CommandList = commandList;
-        computePassParams.m_ShaderName = "minmaxdownsample_CS_Main";
+        computePassParams.m_ShaderID = "minmaxdownsample_CS_Main";
         computePassParams.m_BindingSetDesc = bindingSetDesc;
         computePassParams.m_DispatchGroupSize = ComputeShaderUtils::GetGroupCount(m_HZBDimensions, 8);
         computePassParams.m_PushConstantsData = &passParameters;
@@ -541,12 +557,32 @@ public:
         m_SPDHelper.Execute(commandList, renderGraph, depthStencilBuffer, g_Scene->m_HZB, reductionType);
     }
 
-    void RenderBasePass(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph, const RenderBasePassParams& params)
+    // The base pass is a sequence of GPU culling + rendering steps, one per instance set. With occlusion culling: early opaque, late opaque, early alpha mask & late alpha mask
+    // The HZB is built from the depth buffer before each late cull. Steps only depend on each other on the GPU, so they can be recorded in parallel child command lists
+    uint32_t GetNumBasePassSteps() const { return m_bDoOcclusionCulling ? 4 : 2; }
+    bool IsRecordingStepsInChildCommandLists() const { return m_bRecordStepsInChildCommandLists; }
+
+    void BeginBasePass()
     {
         nvrhi::DeviceHandle device = g_Graphic.m_NVRHIDevice;
 
-        m_LastPipelineStatistics = device->getPipelineStatistics(m_PipelineStatisticsQuery[g_Graphic.m_FrameCounter % 2]);
-        AUTO_SCOPE([&]{ commandList->beginPipelineStatisticsQuery(m_PipelineStatisticsQuery[g_Graphic.m_FrameCounter % 2]); }, [&]{ commandList->endPipelineStatisticsQuery(m_PipelineStatisticsQuery[g_Graphic.m_FrameCounter % 2]); });
+        const uint32_t frameSlot = g_Graphic.GetFrameSlot();
+
+        m_LastPipelineStatistics = nvrhi::PipelineStatistics{};
+        for (uint32_t i = 0; i < m_NumPipelineStatisticsQueries[frameSlot]; ++i)
+        {
+            const nvrhi::PipelineStatistics stats = device->getPipelineStatistics(m_PipelineStatisticsQueries[frameSlot][i]);
+
+            // only the displayed ones
+            m_LastPipelineStatistics.CInvocations += stats.CInvocations;
+            m_LastPipelineStatistics.CPrimitives += stats.CPrimitives;
+            m_LastPipelineStatistics.PSInvocations += stats.PSInvocations;
+            m_LastPipelineStatistics.CSInvocations += stats.CSInvocations;
+            m_LastPipelineStatistics.ASInvocations += stats.ASInvocations;
+            m_LastPipelineStatistics.MSInvocations += stats.MSInvocations;
+            m_LastPipelineStatistics.MSPrimitives += stats.MSPrimitives;
+        }
+        m_NumPipelineStatisticsQueries[frameSlot] = m_bRecordStepsInChildCommandLists ? GetNumBasePassSteps() : 1;
 
         m_CullingFlags = m_DoFrustumCulling ? kCullingFlagFrustumCullingEnable : 0;
         m_CullingFlags |= m_bDoOcclusionCulling ? kCullingFlagOcclusionCullingEnable : 0;
@@ -561,29 +597,68 @@ public:
         frustumY.Normalize();
 
         m_CullingFrustum = Vector4{ frustumX.x, frustumX.z, frustumY.y, frustumY.z };
+    }
 
-        GPUCulling(commandList, renderGraph, params, false /* bLateCull */, false /* bAlphaMaskPrimitives */);
-        RenderInstances(commandList, renderGraph, params, false /* bLateCull */, false /* bAlphaMaskPrimitives */);
+    // NOTE: only reads state set by 'BeginBasePass', as steps may be recorded concurrently
+    void RenderBasePassStep(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph, const RenderBasePassParams& params, uint32_t stepIdx)
+    {
+        check(stepIdx < GetNumBasePassSteps());
 
-        if (m_bDoOcclusionCulling)
+        const bool bLateCull = m_bDoOcclusionCulling && ((stepIdx % 2) == 1);
+        const bool bAlphaMaskPrimitives = stepIdx >= (GetNumBasePassSteps() / 2);
+
+        if (bLateCull && !bAlphaMaskPrimitives)
         {
             GenerateHZB(commandList, renderGraph, params);
+        }
 
-            GPUCulling(commandList, renderGraph, params, true /* bLateCull */, false /* bAlphaMaskPrimitives */);
-            RenderInstances(commandList, renderGraph, params, true /* bLateCull */, false /* bAlphaMaskPrimitives */);
-
-            GPUCulling(commandList, renderGraph, params, false /* bLateCull */, true /* bAlphaMaskPrimitives */);
-            RenderInstances(commandList, renderGraph, params, false /* bLateCull */, true /* bAlphaMaskPrimitives */);
-            GPUCulling(commandList, renderGraph, params, true /* bLateCull */, true /* bAlphaMaskPrimitives */);
-            RenderInstances(commandList, renderGraph, params, true /* bLateCull */, true /* bAlphaMaskPrimitives */);
+        GPUCulling(commandList, renderGraph, params, bLateCull, bAlphaMaskPrimitives);
+        RenderInstances(commandList, renderGraph, params, bLateCull, bAlphaMaskPrimitives);
 
+        if (bLateCull && bAlphaMaskPrimitives)
+        {
             GenerateHZB(commandList, renderGraph, params);
         }
-        else
+    }
+
+    // all steps in the pass' own command list, unless they are recorded in child command lists
+    void RenderBasePass(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph, const RenderBasePassParams& params)
+    {
+        BeginBasePass();
+
+        if (m_bRecordStepsInChildCommandLists)
         {
-            // cull & render for alpha mask primitives, but no occlusion culling
-            GPUCulling(commandList, renderGraph, params, false /* bLateCull */, true /* bAlphaMaskPrimitives */);
-            RenderInstances(commandList, renderGraph, params, false /* bLateCull */, true /* bAlphaMaskPrimitives */);
+            return;
+        }
+
+        nvrhi::PipelineStatisticsQueryHandle pipelineStatisticsQuery = m_PipelineStatisticsQueries[g_Graphic.GetFrameSlot()][0];
+        AUTO_SCOPE([&]{ commandList->beginPipelineStatisticsQuery(pipelineStatisticsQuery); }, [&]{ commandList->endPipelineStatisticsQuery(pipelineStatisticsQuery); });
+
+        for (uint32_t i = 0; i < GetNumBasePassSteps(); ++i)
+        {
+            RenderBasePassStep(commandList, renderGraph, params, i);
+        }
+    }
+
+    void RenderBasePassChild(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph, const RenderBasePassParams& params, uint32_t childIdx)
+    {
+        check(m_bRecordStepsInChildCommandLists);
+
+        nvrhi::PipelineStatisticsQueryHandle pipelineStatisticsQuery = m_PipelineStatisticsQueries[g_Graphic.GetFrameSlot()][childIdx];
+        AUTO_SCOPE([&]{ commandList->beginPipelineStatisticsQuery(pipelineStatisticsQuery); }, [&]{ commandList->endPipelineStatisticsQuery(pipelineStatisticsQuery); });
+
+        // the HZB is not owned by the render graph & each command list tracks it from scratch. Hand it over from child to child as a SRV
+        if (m_bDoOcclusionCulling)
+        {
+            commandList->beginTrackingTextureState(g_Scene->m_HZB, nvrhi::AllSubresources, nvrhi::ResourceStates::ShaderResource);
+        }
+
+        RenderBasePassStep(commandList, renderGraph, params, childIdx);
+
+        if (m_bDoOcclusionCulling)
+        {
+            commandList->setTextureState(g_Scene->m_HZB, nvrhi::AllSubresources, nvrhi::ResourceStates::ShaderResource);
+            commandList->commitBarriers();
         }
     }
 };
@@ -669,6 +744,33 @@ public:
         {
             return;
         }
+
+        m_BasePassParams = GetBasePassParams(renderGraph);
+
+        RenderBasePass(commandList, renderGraph, m_BasePassParams);
+
+        if (!IsRecordingStepsInChildCommandLists())
+        {
+            CopyDepthBuffer(commandList, renderGraph);
+        }
+    }
+
+    void RenderChild(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph, uint32_t childIdx) override
+    {
+        RenderBasePassChild(commandList, renderGraph, m_BasePassParams, childIdx);
+
+        if (childIdx == GetNumBasePassSteps() - 1)
+        {
+            CopyDepthBuffer(commandList, renderGraph);
+        }
+    }
+
+private:
+    // written by 'Render', read by the children
+    RenderBasePassParams m_BasePassParams;
+
+    RenderBasePassParams GetBasePassParams(const RenderGraph& renderGraph) const
+    {
         nvrhi::TextureHandle GBufferATexture = renderGraph.GetTexture(g_GBufferARDGTextureHandle);
         nvrhi::TextureHandle GBufferMotionTexture = renderGraph.GetTexture(g_GBufferMotionRDGTextureHandle);
         nvrhi::TextureHandle depthStencilBuffer = renderGraph.GetTexture(g_DepthStencilBufferRDGTextureHandle);
@@ -692,32 +794,35 @@ public:
         params.m_RenderState = nvrhi::RenderState{ blendState, depthStencilState, g_CommonResources.CullBackFace };
         params.m_FrameBufferDesc = frameBufferDesc;
 
-        RenderBasePass(commandList, renderGraph, params);
+        return params;
+    }
 
-        // at this point, we have the final depth buffer. create a copy for SRV purposes
-        {
-            PROFILE_GPU_SCOPED(commandList, "Copy depth buffer");
+    // at this point, we have the final depth buffer. create a copy for SRV purposes
+    void CopyDepthBuffer(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph)
+    {
+        nvrhi::TextureHandle depthStencilBuffer = renderGraph.GetTexture(g_DepthStencilBufferRDGTextureHandle);
 
-            nvrhi::BindingSetDesc bindingSetDesc;
-            bindingSetDesc.bindings =
-            {
-                nvrhi::BindingSetItem::Texture_SRV(0, depthStencilBuffer),
-                nvrhi::BindingSetItem::Sampler(0, g_CommonResources.LinearClampSampler)
-            };
+        PROFILE_GPU_SCOPED(commandList, "Copy depth buffer");
+
+        nvrhi::BindingSetDesc bindingSetDesc;
+        bindingSetDesc.bindings =
+        {
+            nvrhi::BindingSetItem::Texture_SRV(0, depthStencilBuffer),
+            nvrhi::BindingSetItem::Sampler(0, g_CommonResources.LinearClampSampler)
+        };
 
-            nvrhi::TextureHandle depthBufferCopy = renderGraph.GetTexture(g_DepthBufferCopyRDGTextureHandle);
+        nvrhi::TextureHandle depthBufferCopy = renderGraph.GetTexture(g_DepthBufferCopyRDGTextureHandle);
 
-            nvrhi::FramebufferDesc frameBufferDescDepthBufferCopy;
-            frameBufferDescDepthBufferCopy.addColorAttachment(depthBufferCopy);
+        nvrhi::FramebufferDesc frameBufferDescDepthBufferCopy;
+        frameBufferDescDepthBufferCopy.addColorAttachment(depthBufferCopy);
 
-            Graphic::FullScreenPassParams fullScreenPassParams;
-            fullScreenPassParams.m_CommandList = commandList;
-            fullScreenPassParams.m_FrameBufferDesc = frameBufferDescDepthBufferCopy;
-            fullScreenPassParams.m_BindingSetDesc = bindingSetDesc;
-            fullScreenPassParams.m_ShaderName = "fullscreen_PS_Passthrough";
+        Graphic::FullScreenPassParams fullScreenPassParams;
+        fullScreenPassParams.m_CommandList = commandList;
+        fullScreenPassParams.m_FrameBufferDesc = frameBufferDescDepthBufferCopy;
+        fullScreenPassParams.m_BindingSetDesc = bindingSetDesc;
+        fullScreenPassParams.m_ShaderID = "fullscreen_PS_Passthrough";
 
-            g_Graphic.AddFullScreenPass(fullScreenPassParams);
-        }
+        g_Graphic.AddFullScreenPass(fullScreenPassParams);
     }
 };
 
@@ -49,7 +49,7 @@ public:
 
 		renderGraph.CreateTransientResource(g_BloomRDGTextureHandle, desc);
 
-		renderGraph.AddReadDependency(g_LightingOutputRDGTextureHandle);
+		renderGraph.AddReadDependency(g_LightingOutputRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
 
 		return true;
 	}
@@ -96,7 +96,7 @@ public:
 			fullScreenPassParams.m_CommandList = commandList;
 			fullScreenPassParams.m_FrameBufferDesc = frameBufferDesc;
 			fullScreenPassParams.m_BindingSetDesc = bindingSetDesc;
-			fullScreenPassParams.m_ShaderName = "bloom_PS_Downsample";
+			fullScreenPassParams.m_ShaderID = "bloom_PS_Downsample";
             fullScreenPassParams.m_ViewPort = &viewPort;
 			fullScreenPassParams.m_PushConstantsData = &bloomConsts;
 			fullScreenPassParams.m_PushConstantsBytes = sizeof(bloomConsts);
@@ -131,7 +131,7 @@ public:
 			fullScreenPassParams.m_CommandList = commandList;
 			fullScreenPassParams.m_FrameBufferDesc = frameBufferDesc;
 			fullScreenPassParams.m_BindingSetDesc = bindingSetDesc;
-			fullScreenPassParams.m_ShaderName = "bloom_PS_Upsample";
+			fullScreenPassParams.m_ShaderID = "bloom_PS_Upsample";
 			fullScreenPassParams.m_ViewPort = &viewPort;
 			fullScreenPassParams.m_PushConstantsData = &bloomConsts;
 			fullScreenPassParams.m_PushConstantsBytes = sizeof(bloomConsts);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "extern/taskflow/taskflow/taskflow.hpp"
+
+// Recording tasks of a render graph pass, split into child command lists. Command lists of a pass are indexed in submission order:
+//   0                : the pass' own command list. Pass begin barriers, timer & whatever 'IRenderer::Render' records
+//   [1, numChildren] : 'IRenderer::RenderChild', recorded in parallel once the pass' own command list is done
+//   numChildren + 1  : pass end barriers & timer, once all children are done
+// Every command list is recorded into its own slot, so the submission order only depends on indices & never on which worker finished first
+// Device agnostic, so that the wiring is exercised w/o a GPU by 'RunChildCommandListsSelfTest'
+namespace ChildCommandLists
+{
+    constexpr uint32_t GetNumCommandLists(uint32_t numChildren) { return numChildren > 0 ? numChildren + 2 : 1; }
+    constexpr bool IsChild(uint32_t commandListIdx, uint32_t numChildren) { return commandListIdx >= 1 && commandListIdx <= numChildren; }
+    constexpr bool IsTail(uint32_t commandListIdx, uint32_t numChildren) { return numChildren > 0 && commandListIdx == numChildren + 1; }
+
+    struct Tasks
+    {
+        tf::Task m_Record; // records command list 0
+        tf::Task m_Queue;  // queues all command lists of the pass, in order. Chained pass to pass by the render graph
+    };
+
+    // 'recordFunc(commandListIdx)' records one command list, 'queueFunc()' queues all of them
+    template <typename RecordFuncT, typename QueueFuncT>
+    Tasks Emplace(tf::Taskflow& taskFlow, uint32_t numChildren, RecordFuncT recordFunc, QueueFuncT queueFunc)
+    {
+        Tasks tasks;
+        tasks.m_Record = taskFlow.emplace([recordFunc] { recordFunc(0); });
+        tasks.m_Queue = taskFlow.emplace(std::move(queueFunc));
+
+        if (numChildren == 0)
+        {
+            tasks.m_Queue.succeed(tasks.m_Record);
+            return tasks;
+        }
+
+        tf::Task tailTask = taskFlow.emplace([recordFunc, numChildren] { recordFunc(numChildren + 1); });
+
+        for (uint32_t i = 1; i <= numChildren; ++i)
+        {
+            tf::Task childTask = taskFlow.emplace([recordFunc, i] { recordFunc(i); });
+            childTask.succeed(tasks.m_Record);
+            tailTask.succeed(childTask);
+        }
+
+        tasks.m_Queue.succeed(tailTask);
+
+        return tasks;
+    }
+}
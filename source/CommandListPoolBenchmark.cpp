@@ -0,0 +1,151 @@
+#include <barrier>
+
+#include "EngineCore.h"
+#include "FencedPool.h"
+#include "FrameRing.h"
+#include "HeadlessRuns.h"
+#include "Utilities.h"
+
+// stand-in for a command list from a stubbed device
+using StubCommandList = std::shared_ptr<uint64_t>;
+
+CommandLineOption<int> g_CommandListPoolBenchmarkThreads{ "commandlistpoolbenchmarkthreads", 32 };
+
+static void RunCommandListPoolBenchmark(uint32_t numThreads)
+{
+    PROFILE_FUNCTION();
+
+    const uint32_t kNumFrames = 64;
+    const uint32_t kNumAllocationsPerThreadPerFrame = 16;
+    const uint32_t kMaxFramesInFlight = 2;
+
+    // the old path: 1 global locked free list, lists returned through the frame ring's deferred releases
+    auto RunLockedFreeList = [&]
+        {
+            ScriptedFrameFence fence;
+            fence.m_LatencyFrames = 1; // the "GPU" finishes a frame 1 frame after it was signaled
+            FrameRing frameRing;
+            frameRing.Initialize(&fence, kMaxFramesInFlight);
+
+            std::mutex freeListLock;
+            std::deque<StubCommandList> freeList;
+            std::atomic<uint32_t> numCreated = 0;
+
+            auto Allocate = [&]
+                {
+                    StubCommandList ret;
+                    {
+                        AUTO_LOCK(freeListLock);
+                        if (freeList.empty())
+                        {
+                            ret = std::make_shared<uint64_t>(0);
+                            ++numCreated;
+                        }
+                        else
+                        {
+                            ret = freeList.front();
+                            freeList.pop_front();
+                        }
+                    }
+
+                    frameRing.DeferRelease([&, ret] { AUTO_LOCK(freeListLock); freeList.push_back(ret); });
+                    return ret;
+                };
+
+            std::barrier frameBarrier{ numThreads + 1 };
+            std::vector<std::thread> threads;
+            for (uint32_t i = 0; i < numThreads; ++i)
+            {
+                threads.emplace_back([&]
+                    {
+                        for (uint32_t frame = 0; frame < kNumFrames; ++frame)
+                        {
+                            frameBarrier.arrive_and_wait();
+                            for (uint32_t j = 0; j < kNumAllocationsPerThreadPerFrame; ++j)
+                            {
+                                ++*Allocate();
+                            }
+                            frameBarrier.arrive_and_wait();
+                        }
+                    });
+            }
+
+            Timer timer;
+            for (uint32_t frame = 0; frame < kNumFrames; ++frame)
+            {
+                frameRing.BeginFrame();
+                frameBarrier.arrive_and_wait();
+                frameBarrier.arrive_and_wait();
+                frameRing.EndFrame();
+            }
+            const float elapsedMs = timer.GetElapsedMilliseconds();
+
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+            frameRing.Shutdown();
+
+            SDL_Log("Command List Pool Benchmark [locked free list]: %u threads, %.2f ms, %.1f ns per allocation, %u lists created",
+                numThreads, elapsedMs, (elapsedMs * 1e6) / (kNumFrames * numThreads * kNumAllocationsPerThreadPerFrame), numCreated.load());
+        };
+
+    // per-thread fenced pools, as in 'Graphic::AllocateCommandList'
+    auto RunPerThreadPools = [&]
+        {
+            ScriptedFrameFence fence;
+            fence.m_LatencyFrames = 1; // the "GPU" finishes a frame 1 frame after it was signaled
+            FrameRing frameRing;
+            frameRing.Initialize(&fence, kMaxFramesInFlight);
+
+            std::atomic<uint32_t> numCreated = 0;
+
+            std::barrier frameBarrier{ numThreads + 1 };
+            std::vector<std::thread> threads;
+            for (uint32_t i = 0; i < numThreads; ++i)
+            {
+                threads.emplace_back([&]
+                    {
+                        FencedPool<StubCommandList> pool;
+
+                        for (uint32_t frame = 0; frame < kNumFrames; ++frame)
+                        {
+                            frameBarrier.arrive_and_wait();
+                            for (uint32_t j = 0; j < kNumAllocationsPerThreadPerFrame; ++j)
+                            {
+                                ++*pool.Allocate(frameRing.GetFrameIdx(), frameRing.GetNumRetiredFrames(), [] { return std::make_shared<uint64_t>(0); });
+                            }
+                            frameBarrier.arrive_and_wait();
+                        }
+
+                        numCreated += pool.GetNumCreated();
+                    });
+            }
+
+            Timer timer;
+            for (uint32_t frame = 0; frame < kNumFrames; ++frame)
+            {
+                frameRing.BeginFrame();
+                frameBarrier.arrive_and_wait();
+                frameBarrier.arrive_and_wait();
+                frameRing.EndFrame();
+            }
+            const float elapsedMs = timer.GetElapsedMilliseconds();
+
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+            frameRing.Shutdown();
+
+            // steady state: every thread needs (kMaxFramesInFlight + 1) frames worth of lists
+            test_verify(numCreated <= numThreads * kNumAllocationsPerThreadPerFrame * (kMaxFramesInFlight + 1));
+
+            SDL_Log("Command List Pool Benchmark [per-thread fenced pools]: %u threads, %.2f ms, %.1f ns per allocation, %u lists created",
+                numThreads, elapsedMs, (elapsedMs * 1e6) / (kNumFrames * numThreads * kNumAllocationsPerThreadPerFrame), numCreated.load());
+        };
+
+    RunLockedFreeList();
+    RunPerThreadPools();
+}
+REGISTER_HEADLESS_RUN("commandlistpoolbenchmark", HeadlessRunType::Benchmark, [] { RunCommandListPoolBenchmark(g_CommandListPoolBenchmarkThreads.Get()); });
@@ -33,24 +33,24 @@ public:
 
 		renderGraph.CreateTransientResource(g_LightingOutputRDGTextureHandle, desc);
 
-		renderGraph.AddReadDependency(g_GBufferARDGTextureHandle);
-        renderGraph.AddReadDependency(g_GBufferMotionRDGTextureHandle);
-		renderGraph.AddReadDependency(g_DepthStencilBufferRDGTextureHandle);
-		renderGraph.AddReadDependency(g_DepthBufferCopyRDGTextureHandle);
+		renderGraph.AddReadDependency(g_GBufferARDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
+        renderGraph.AddReadDependency(g_GBufferMotionRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
+		renderGraph.AddReadDependency(g_DepthStencilBufferRDGTextureHandle, nvrhi::ResourceStates::DepthRead);
+		renderGraph.AddReadDependency(g_DepthBufferCopyRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
 
 		if (g_Scene->m_bEnableAO)
 		{
-			renderGraph.AddReadDependency(g_SSAORDGTextureHandle);
+			renderGraph.AddReadDependency(g_SSAORDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
 		}
 
 		if (g_Scene->IsShadowsEnabled())
 		{
-			renderGraph.AddReadDependency(g_ShadowMaskRDGTextureHandle);
+			renderGraph.AddReadDependency(g_ShadowMaskRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
 		}
 
 		if (g_Scene->IsDDGIEnabled())
 		{
-			renderGraph.AddReadDependency(g_RTDDRTDDGIVolumeDescsBuffer);
+			renderGraph.AddReadDependency(g_RTDDRTDDGIVolumeDescsBuffer, nvrhi::ResourceStates::ShaderResource);
 		}
 
 		return true;
@@ -70,7 +70,7 @@ public:
 		passConstants.m_LightingOutputResolution = g_Graphic.m_RenderResolution;
 		passConstants.m_DebugMode = g_Scene->m_DebugViewMode;
         passConstants.m_bRTDDGIEnabled = g_Scene->IsDDGIEnabled();
-		nvrhi::BufferHandle passConstantBuffer = g_Graphic.CreateConstantBuffer(commandList, passConstants);
+		nvrhi::BufferHandle passConstantBuffer = g_Graphic.WriteConstantBuffer(commandList, passConstants);
 
 		nvrhi::TextureHandle GBufferATexture = renderGraph.GetTexture(g_GBufferARDGTextureHandle);
         nvrhi::TextureHandle GBufferMotionTexture = renderGraph.GetTexture(g_GBufferMotionRDGTextureHandle);
@@ -107,13 +107,13 @@ public:
 		depthStencilState.frontFaceStencil.stencilFunc = nvrhi::ComparisonFunc::Equal;
 
 		const bool bHasDebugView = g_Scene->m_DebugViewMode != 0;
-		const char* shaderName = bHasDebugView ? "deferredlighting_PS_Main_Debug" : "deferredlighting_PS_Main";
+		const ShaderID shaderID = bHasDebugView ? ShaderID{ "deferredlighting_PS_Main_Debug" } : ShaderID{ "deferredlighting_PS_Main" };
 
 		Graphic::FullScreenPassParams fullScreenPassParams;
 		fullScreenPassParams.m_CommandList = commandList;
 		fullScreenPassParams.m_FrameBufferDesc = frameBufferDesc;
 		fullScreenPassParams.m_BindingSetDesc = bindingSetDesc;
-		fullScreenPassParams.m_ShaderName = shaderName;
+		fullScreenPassParams.m_ShaderID = shaderID;
 		fullScreenPassParams.m_DepthStencilState = &depthStencilState;
 
 		g_Graphic.AddFullScreenPass(fullScreenPassParams);
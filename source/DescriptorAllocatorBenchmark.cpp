@@ -0,0 +1,125 @@
+#include "DescriptorIndexAllocator.h"
+#include "Engine.h"
+#include "GraphicConstants.h"
+#include "HeadlessRuns.h"
+#include "Utilities.h"
+
+CommandLineOption<int> g_DescriptorAllocatorBenchmarkDescriptors{ "descriptorallocatorbenchmarkdescriptors", 100000 };
+
+// Texture streaming style churn on a full bindless table: every frame, a batch of random descriptors is released, then as many are created
+static void RunDescriptorAllocatorBenchmark(uint32_t numDescriptors)
+{
+    PROFILE_FUNCTION();
+
+    const uint32_t kNumFrames = 256;
+    const uint32_t kNumChurnPerFrame = 256;
+    const uint32_t kFramesInFlight = GraphicConstants::kMaxFramesInFlight;
+
+    // same sequence of released slots for both allocators
+    std::mt19937 rng{ 42 };
+    std::vector<uint32_t> releasePicks(kNumFrames * kNumChurnPerFrame);
+    for (uint32_t& pick : releasePicks)
+    {
+        pick = rng();
+    }
+
+    std::vector<uint32_t> liveIndices;
+    auto ReleaseBatch = [&](uint64_t frame, auto&& releaseFunc)
+        {
+            for (uint32_t i = 0; i < kNumChurnPerFrame; ++i)
+            {
+                const uint32_t pick = releasePicks[frame * kNumChurnPerFrame + i] % liveIndices.size();
+                releaseFunc(liveIndices[pick]);
+
+                liveIndices[pick] = liveIndices.back();
+                liveIndices.pop_back();
+            }
+        };
+
+    // the old path: linear scan for a free slot from the lowest released one, slots reused immediately
+    {
+        std::mutex lock;
+        std::vector<bool> allocatedDescriptors(numDescriptors + kNumChurnPerFrame);
+        uint32_t searchStart = 0;
+
+        auto Allocate = [&]
+            {
+                AUTO_LOCK(lock);
+
+                uint32_t index = searchStart;
+                while (allocatedDescriptors[index])
+                {
+                    ++index;
+                }
+                test_verify(index < allocatedDescriptors.size());
+
+                allocatedDescriptors[index] = true;
+                searchStart = index + 1;
+                return index;
+            };
+
+        auto Release = [&](uint32_t index)
+            {
+                AUTO_LOCK(lock);
+
+                allocatedDescriptors[index] = false;
+                searchStart = std::min(searchStart, index);
+            };
+
+        liveIndices.clear();
+        for (uint32_t i = 0; i < numDescriptors; ++i)
+        {
+            liveIndices.push_back(Allocate());
+        }
+
+        Timer timer;
+        for (uint32_t frame = 0; frame < kNumFrames; ++frame)
+        {
+            ReleaseBatch(frame, [&](uint32_t index) { Release(index); });
+
+            for (uint32_t i = 0; i < kNumChurnPerFrame; ++i)
+            {
+                liveIndices.push_back(Allocate());
+            }
+        }
+        const float elapsedMs = timer.GetElapsedMilliseconds();
+
+        SDL_Log("Descriptor Allocator Benchmark [linear scan]: %u descriptors, %.2f ms, %.1f ns per release + create",
+            numDescriptors, elapsedMs, (elapsedMs * 1e6) / (kNumFrames * kNumChurnPerFrame));
+    }
+
+    // free list, slots reused once the releasing frame retires, as in 'DescriptorTableManager'
+    {
+        std::mutex lock;
+        DescriptorIndexAllocator allocator;
+        allocator.Initialize(numDescriptors);
+
+        liveIndices.clear();
+        for (uint32_t i = 0; i < numDescriptors; ++i)
+        {
+            liveIndices.push_back(allocator.Allocate());
+        }
+
+        Timer timer;
+        for (uint64_t frame = 0; frame < kNumFrames; ++frame)
+        {
+            {
+                AUTO_LOCK(lock);
+                allocator.RetireFrames((frame >= kFramesInFlight) ? (frame - kFramesInFlight + 1) : 0);
+            }
+
+            ReleaseBatch(frame, [&](uint32_t index) { AUTO_LOCK(lock); allocator.Free(index, frame); });
+
+            for (uint32_t i = 0; i < kNumChurnPerFrame; ++i)
+            {
+                AUTO_LOCK(lock);
+                liveIndices.push_back(allocator.Allocate());
+            }
+        }
+        const float elapsedMs = timer.GetElapsedMilliseconds();
+
+        SDL_Log("Descriptor Allocator Benchmark [free list]: %u descriptors, %.2f ms, %.1f ns per release + create, capacity %u after %u growths",
+            numDescriptors, elapsedMs, (elapsedMs * 1e6) / (kNumFrames * kNumChurnPerFrame), allocator.GetCapacity(), allocator.GetNumGrowths());
+    }
+}
+REGISTER_HEADLESS_RUN("descriptorallocatorbenchmark", HeadlessRunType::Benchmark, [] { RunDescriptorAllocatorBenchmark(g_DescriptorAllocatorBenchmarkDescriptors.Get()); });
@@ -0,0 +1,215 @@
+#include "DescriptorIndexAllocator.h"
+
+#include "Engine.h"
+#include "GraphicConstants.h"
+#include "HeadlessRuns.h"
+
+void DescriptorIndexAllocator::Initialize(uint32_t capacity, uint32_t maxCapacity)
+{
+    check(capacity > 0 && capacity <= maxCapacity);
+
+    m_Capacity = 0;
+    m_MaxCapacity = maxCapacity;
+    m_NumAllocated = 0;
+    m_NumGrowths = 0;
+    m_FreeIndices.clear();
+    m_AllocatedBits.clear();
+    m_PendingFrees.clear();
+
+    Grow(capacity);
+    m_NumGrowths = 0;
+}
+
+uint32_t DescriptorIndexAllocator::Allocate()
+{
+    if (m_FreeIndices.empty())
+    {
+        if (m_Capacity == m_MaxCapacity)
+        {
+            return kInvalidIndex;
+        }
+
+        Grow((uint32_t)std::min<uint64_t>((uint64_t)m_Capacity * 2, m_MaxCapacity));
+    }
+
+    const uint32_t index = m_FreeIndices.back();
+    m_FreeIndices.pop_back();
+
+    check(!IsAllocated(index));
+    m_AllocatedBits[index / 64] |= (1ull << (index % 64));
+    ++m_NumAllocated;
+
+    return index;
+}
+
+void DescriptorIndexAllocator::Free(uint32_t index, uint64_t frameIdx)
+{
+    check(IsAllocated(index));
+    check(m_PendingFrees.empty() || m_PendingFrees.back().m_FrameIdx <= frameIdx);
+
+    m_PendingFrees.push_back(PendingFree{ index, frameIdx });
+}
+
+bool DescriptorIndexAllocator::IsAllocated(uint32_t index) const
+{
+    check(index < m_Capacity);
+    return (m_AllocatedBits[index / 64] & (1ull << (index % 64))) != 0;
+}
+
+void DescriptorIndexAllocator::Grow(uint32_t newCapacity)
+{
+    check(newCapacity > m_Capacity);
+
+    // new indices go below the existing free ones, so that low indices keep being handed out first
+    std::vector<uint32_t> newFreeIndices;
+    newFreeIndices.reserve(newCapacity);
+    for (uint32_t i = newCapacity; i > m_Capacity; --i)
+    {
+        newFreeIndices.push_back(i - 1);
+    }
+    newFreeIndices.insert(newFreeIndices.end(), m_FreeIndices.begin(), m_FreeIndices.end());
+
+    m_FreeIndices = std::move(newFreeIndices);
+    m_AllocatedBits.resize((newCapacity + 63) / 64);
+    m_Capacity = newCapacity;
+    ++m_NumGrowths;
+}
+
+void DescriptorIndexAllocator::Recycle(uint32_t index)
+{
+    check(IsAllocated(index));
+    m_AllocatedBits[index / 64] &= ~(1ull << (index % 64));
+    --m_NumAllocated;
+
+    m_FreeIndices.push_back(index);
+}
+
+static void RunDescriptorIndexAllocatorSelfTest()
+{
+    PROFILE_FUNCTION();
+
+    // basics: lowest indices first, LIFO reuse once the freeing frame retires
+    {
+        DescriptorIndexAllocator allocator;
+        allocator.Initialize(4);
+
+        test_verify(allocator.Allocate() == 0);
+        test_verify(allocator.Allocate() == 1);
+        test_verify(allocator.Allocate() == 2);
+
+        allocator.Free(1, 5);
+        test_verify(allocator.IsAllocated(1));
+        test_verify(allocator.Allocate() == 3); // 1 is still in use by frame 5 on the GPU
+
+        allocator.RetireFrames(5);
+        test_verify(allocator.GetNumPendingFrees() == 1);
+
+        uint32_t numRecycled = 0;
+        allocator.RetireFrames(6, [&](uint32_t index) { test_verify(index == 1); ++numRecycled; });
+        test_verify(numRecycled == 1);
+        test_verify(!allocator.IsAllocated(1));
+        test_verify(allocator.Allocate() == 1);
+        test_verify(allocator.GetNumAllocated() == 4);
+        test_verify(allocator.GetNumGrowths() == 0);
+    }
+
+    // growth: capacity doubles, existing indices are kept
+    {
+        DescriptorIndexAllocator allocator;
+        allocator.Initialize(2);
+
+        test_verify(allocator.Allocate() == 0);
+        test_verify(allocator.Allocate() == 1);
+        test_verify(allocator.Allocate() == 2);
+        test_verify(allocator.GetCapacity() == 4);
+        test_verify(allocator.Allocate() == 3);
+        test_verify(allocator.Allocate() == 4);
+        test_verify(allocator.GetCapacity() == 8);
+        test_verify(allocator.GetNumGrowths() == 2);
+        test_verify(allocator.IsAllocated(0) && allocator.IsAllocated(4) && !allocator.IsAllocated(5));
+    }
+
+    // max capacity: the last growth is clamped to it, then allocations fail until a slot is recycled
+    {
+        DescriptorIndexAllocator allocator;
+        allocator.Initialize(2, 5);
+
+        for (uint32_t i = 0; i < 5; ++i)
+        {
+            test_verify(allocator.Allocate() == i);
+        }
+        test_verify(allocator.GetCapacity() == 5);
+        test_verify(allocator.Allocate() == DescriptorIndexAllocator::kInvalidIndex);
+        test_verify(allocator.GetNumAllocated() == 5);
+
+        allocator.Free(3, 0);
+        test_verify(allocator.Allocate() == DescriptorIndexAllocator::kInvalidIndex); // still in flight
+
+        allocator.RetireFrames(1);
+        test_verify(allocator.Allocate() == 3);
+        test_verify(allocator.GetCapacity() == 5);
+    }
+
+    // stress: random allocs & frees over many frames with a few frames in flight. No index is ever handed out twice while in use or in flight
+    {
+        const uint32_t kNumFrames = 2000;
+        const uint32_t kFramesInFlight = GraphicConstants::kMaxFramesInFlight;
+
+        DescriptorIndexAllocator allocator;
+        allocator.Initialize(64);
+
+        std::mt19937 rng{ 1234 };
+        std::vector<uint32_t> liveIndices;
+        std::vector<uint64_t> releasedInFrame(1, UINT64_MAX); // per index, UINT64_MAX = not pending
+        uint32_t peakNumAllocated = 0;
+
+        for (uint64_t frameIdx = 0; frameIdx < kNumFrames; ++frameIdx)
+        {
+            const uint64_t numRetiredFrames = (frameIdx >= kFramesInFlight) ? (frameIdx - kFramesInFlight + 1) : 0;
+            allocator.RetireFrames(numRetiredFrames, [&](uint32_t index)
+                {
+                    test_verify(releasedInFrame[index] < numRetiredFrames);
+                    releasedInFrame[index] = UINT64_MAX;
+                });
+
+            // bursts of streaming in, then out
+            const bool bGrowPhase = ((frameIdx / 200) % 2) == 0;
+            const uint32_t numAllocs = std::uniform_int_distribution<uint32_t>{ 0, bGrowPhase ? 24u : 8u }(rng);
+            const uint32_t numFrees = std::uniform_int_distribution<uint32_t>{ 0, bGrowPhase ? 8u : 24u }(rng);
+
+            for (uint32_t i = 0; i < numAllocs; ++i)
+            {
+                const uint32_t index = allocator.Allocate();
+                if (index >= releasedInFrame.size())
+                {
+                    releasedInFrame.resize(allocator.GetCapacity(), UINT64_MAX);
+                }
+                test_verify(releasedInFrame[index] == UINT64_MAX);
+                test_verify(std::find(liveIndices.begin(), liveIndices.end(), index) == liveIndices.end());
+                liveIndices.push_back(index);
+            }
+
+            for (uint32_t i = 0; i < numFrees && !liveIndices.empty(); ++i)
+            {
+                const uint32_t pick = std::uniform_int_distribution<uint32_t>{ 0, (uint32_t)liveIndices.size() - 1 }(rng);
+                const uint32_t index = liveIndices[pick];
+                liveIndices[pick] = liveIndices.back();
+                liveIndices.pop_back();
+
+                allocator.Free(index, frameIdx);
+                releasedInFrame[index] = frameIdx;
+            }
+
+            peakNumAllocated = std::max(peakNumAllocated, allocator.GetNumAllocated());
+            test_verify(allocator.GetNumAllocated() == liveIndices.size() + allocator.GetNumPendingFrees());
+        }
+
+        // only grows when every slot is live or in flight, so the capacity stays within 2x of the peak
+        test_verify(allocator.GetCapacity() <= std::max(64u, 2 * peakNumAllocated));
+
+        allocator.RetireFrames(UINT64_MAX);
+        test_verify(allocator.GetNumPendingFrees() == 0);
+        test_verify(allocator.GetNumAllocated() == liveIndices.size());
+    }
+}
+REGISTER_HEADLESS_RUN("descriptorindexallocatorselftest", HeadlessRunType::SelfTest, RunDescriptorIndexAllocatorSelfTest);
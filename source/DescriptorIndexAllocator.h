@@ -0,0 +1,62 @@
+#pragma once
+
+// Index allocator for bindless descriptor table slots
+// Free slots are kept on a LIFO free list, so allocating & freeing are O(1). When the free list runs dry, the capacity doubles, up to a max capacity
+// Freed slots are only recycled once the frame they were freed in retires, as the GPU may still read them until then
+// CPU only, no device calls. Not thread safe
+class DescriptorIndexAllocator
+{
+public:
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+    void Initialize(uint32_t capacity, uint32_t maxCapacity = UINT32_MAX);
+
+    // grows the capacity if there is no free slot. Check 'GetCapacity' afterwards to resize what the indices point into
+    // 'kInvalidIndex' if every slot up to the max capacity is live or in flight
+    [[nodiscard]] uint32_t Allocate();
+
+    // 'index' stays allocated until 'frameIdx' retires
+    void Free(uint32_t index, uint64_t frameIdx);
+
+    // recycles the slots freed in all frames before 'numRetiredFrames'. 'onRecycledFunc' is called for each of them
+    template <typename OnRecycledFunc>
+    void RetireFrames(uint64_t numRetiredFrames, OnRecycledFunc&& onRecycledFunc)
+    {
+        while (!m_PendingFrees.empty() && (m_PendingFrees.front().m_FrameIdx < numRetiredFrames))
+        {
+            const uint32_t index = m_PendingFrees.front().m_Index;
+            m_PendingFrees.pop_front();
+
+            onRecycledFunc(index);
+            Recycle(index);
+        }
+    }
+
+    void RetireFrames(uint64_t numRetiredFrames) { RetireFrames(numRetiredFrames, [](uint32_t) {}); }
+
+    bool IsAllocated(uint32_t index) const;
+    uint32_t GetCapacity() const { return m_Capacity; }
+    uint32_t GetMaxCapacity() const { return m_MaxCapacity; }
+    uint32_t GetNumAllocated() const { return m_NumAllocated; }
+    uint32_t GetNumPendingFrees() const { return (uint32_t)m_PendingFrees.size(); }
+    uint32_t GetNumGrowths() const { return m_NumGrowths; }
+
+private:
+    struct PendingFree
+    {
+        uint32_t m_Index;
+        uint64_t m_FrameIdx;
+    };
+
+    void Grow(uint32_t newCapacity);
+    void Recycle(uint32_t index);
+
+    uint32_t m_Capacity = 0;
+    uint32_t m_MaxCapacity = 0;
+    uint32_t m_NumAllocated = 0; // including pending frees
+    uint32_t m_NumGrowths = 0;
+
+    std::vector<uint32_t> m_FreeIndices; // lowest index at the back
+    std::vector<uint64_t> m_AllocatedBits; // to catch double frees
+    std::deque<PendingFree> m_PendingFrees; // in frame order
+};
@@ -28,12 +28,14 @@ DescriptorTableManager::DescriptorTableManager(nvrhi::IBindingLayout* layout)
 {
     m_DescriptorTable = g_Graphic.m_NVRHIDevice->createDescriptorTable(layout);
 
-    m_MaxCapacity = layout->getBindlessDesc()->maxCapacity;
-
-    g_Graphic.m_NVRHIDevice->resizeDescriptorTable(m_DescriptorTable, m_MaxCapacity);
-    m_AllocatedDescriptors.resize(m_MaxCapacity);
-    m_Descriptors.resize(m_MaxCapacity);
-    memset(m_Descriptors.data(), 0, sizeof(nvrhi::BindingSetItem) * m_MaxCapacity);
+    // the whole range is reserved up front & never resized: resizing moves the table within the heap, which would invalidate every index in heap baked into GPU data
+    m_ReservedCapacity = layout->getBindlessDesc()->maxCapacity;
+    g_Graphic.m_NVRHIDevice->resizeDescriptorTable(m_DescriptorTable, m_ReservedCapacity, false /*keepContents*/);
+
+    const uint32_t initialCapacity = std::min(GraphicConstants::kSrvUavCbvBindlessInitialCapacity, m_ReservedCapacity);
+    m_IndexAllocator.Initialize(initialCapacity, m_ReservedCapacity);
+    m_Descriptors.resize(initialCapacity);
+    memset(m_Descriptors.data(), 0, sizeof(nvrhi::BindingSetItem) * initialCapacity);
 }
 
 uint32_t DescriptorTableManager::CreateDescriptorHandle(nvrhi::BindingSetItem item)
@@ -42,33 +44,38 @@ uint32_t DescriptorTableManager::CreateDescriptorHandle(nvrhi::BindingSetItem it
 
     nvrhi::DeviceHandle device = g_Graphic.m_NVRHIDevice;
 
-    uint32_t index = 0;
+    AUTO_LOCK(m_Lock);
 
-    {
-        AUTO_LOCK(m_Lock);
-        const auto& found = m_DescriptorIndexMap.find(item);
-        if (found != m_DescriptorIndexMap.end())
-            return found->second;
+    const auto& found = m_DescriptorIndexMap.find(item);
+    if (found != m_DescriptorIndexMap.end())
+        return found->second;
 
-        bool foundFreeSlot = false;
+    const uint32_t index = m_IndexAllocator.Allocate();
 
-        for (index = m_SearchStart; index < m_MaxCapacity; index++)
-        {
-            if (!m_AllocatedDescriptors[index])
-            {
-                foundFreeSlot = true;
-                break;
-            }
-        }
-        check(foundFreeSlot);
+    // fatal in every build: an index past the reserved range would write descriptors outside of the table
+    // NOTE: the table can't grow past its reservation, as resizing it moves it in the heap & invalidates every index in heap baked into GPU data
+    if (index == DescriptorIndexAllocator::kInvalidIndex)
+    {
+        SDL_Log("Descriptor table full: %u descriptors reserved. Increase 'kSrvUavCbvBindlessLayoutCapacity'", m_ReservedCapacity);
+        check(0);
+        std::abort();
+    }
 
-        item.slot = index;
-        m_SearchStart = index + 1;
-        m_AllocatedDescriptors[index] = true;
-        m_Descriptors[index] = item;
-        m_DescriptorIndexMap[item] = index;
+    const uint32_t oldCapacity = (uint32_t)m_Descriptors.size();
+    const uint32_t newCapacity = m_IndexAllocator.GetCapacity();
+    if (newCapacity != oldCapacity)
+    {
+        // only the bookkeeping grows, the descriptors already have their slots in the reserved range
+        m_Descriptors.resize(newCapacity);
+        memset(m_Descriptors.data() + oldCapacity, 0, sizeof(nvrhi::BindingSetItem) * (newCapacity - oldCapacity));
+
+        SDL_Log("Descriptor table grown from %u to %u descriptors", oldCapacity, newCapacity);
     }
 
+    item.slot = index;
+    m_Descriptors[index] = item;
+    m_DescriptorIndexMap[item] = index;
+
     device->writeDescriptorTable(m_DescriptorTable, item);
 
     if (item.resourceHandle)
@@ -81,22 +88,42 @@ void DescriptorTableManager::ReleaseDescriptor(uint32_t indexInTable)
 {
     AUTO_LOCK(m_Lock);
 
-    nvrhi::BindingSetItem& descriptor = m_Descriptors[indexInTable];
-
-    if (descriptor.resourceHandle)
-        descriptor.resourceHandle->Release();
-
     // Erase the existing descriptor from the index map to prevent its "reuse" later
     const auto indexMapEntry = m_DescriptorIndexMap.find(m_Descriptors[indexInTable]);
     if (indexMapEntry != m_DescriptorIndexMap.end())
         m_DescriptorIndexMap.erase(indexMapEntry);
 
-    descriptor = nvrhi::BindingSetItem::None(indexInTable);
+    // shaders of frames in flight may still read the descriptor
+    m_IndexAllocator.Free(indexInTable, g_Graphic.m_FrameRing.GetFrameIdx());
+}
 
-    g_Graphic.m_NVRHIDevice->writeDescriptorTable(m_DescriptorTable, descriptor);
+void DescriptorTableManager::RetireFrames(uint64_t numRetiredFrames)
+{
+    AUTO_LOCK(m_Lock);
+
+    m_IndexAllocator.RetireFrames(numRetiredFrames, [this](uint32_t indexInTable)
+        {
+            nvrhi::BindingSetItem& descriptor = m_Descriptors[indexInTable];
+
+            if (descriptor.resourceHandle)
+                descriptor.resourceHandle->Release();
+
+            descriptor = nvrhi::BindingSetItem::None(indexInTable);
+
+            g_Graphic.m_NVRHIDevice->writeDescriptorTable(m_DescriptorTable, descriptor);
+        });
+}
 
-    m_AllocatedDescriptors[indexInTable] = false;
-    m_SearchStart = std::min(m_SearchStart, indexInTable);
+uint32_t DescriptorTableManager::GetCapacity()
+{
+    AUTO_LOCK(m_Lock);
+    return m_IndexAllocator.GetCapacity();
+}
+
+uint32_t DescriptorTableManager::GetNumAllocated()
+{
+    AUTO_LOCK(m_Lock);
+    return m_IndexAllocator.GetNumAllocated();
 }
 
 DescriptorTableManager::~DescriptorTableManager()
@@ -24,6 +24,9 @@
 
 #include "extern/nvrhi/include/nvrhi/nvrhi.h"
 
+#include "DescriptorIndexAllocator.h"
+#include "Hash.h"
+
 class DescriptorTableManager
 {
 protected:
@@ -32,14 +35,19 @@ protected:
     {
         std::size_t operator()(const nvrhi::BindingSetItem& item) const
         {
-            size_t hash = 0;
-            nvrhi::hash_combine(hash, item.resourceHandle);
-            nvrhi::hash_combine(hash, item.type);
-            nvrhi::hash_combine(hash, item.format);
-            nvrhi::hash_combine(hash, item.dimension);
-            nvrhi::hash_combine(hash, item.rawData[0]);
-            nvrhi::hash_combine(hash, item.rawData[1]);
-            return hash;
+            // bitfields copied out, the hasher needs addressable values
+            const nvrhi::ResourceType type = item.type;
+            const nvrhi::Format format = item.format;
+            const nvrhi::TextureDimension dimension = item.dimension;
+
+            Hasher hasher;
+            hasher.Update(item.resourceHandle);
+            hasher.Update(type);
+            hasher.Update(format);
+            hasher.Update(dimension);
+            hasher.Update(item.rawData[0]);
+            hasher.Update(item.rawData[1]);
+            return (std::size_t)hasher.Finalize();
         }
     };
 
@@ -57,13 +65,14 @@ protected:
     };
 
     nvrhi::DescriptorTableHandle m_DescriptorTable;
+    uint32_t m_ReservedCapacity = 0;
 
     std::vector<nvrhi::BindingSetItem> m_Descriptors;
     std::unordered_map<nvrhi::BindingSetItem, uint32_t, BindingSetItemHasher, BindingSetItemsEqual> m_DescriptorIndexMap;
-    std::vector<bool> m_AllocatedDescriptors;
-    uint32_t m_SearchStart = 0;
+    DescriptorIndexAllocator m_IndexAllocator;
+
+    // NOTE: descriptors are written under the lock too, so that they never race with the table being resized
     std::mutex m_Lock;
-    uint32_t m_MaxCapacity;
 
 public:
     DescriptorTableManager(nvrhi::IBindingLayout* layout);
@@ -71,11 +80,19 @@ public:
 
     nvrhi::IDescriptorTable* GetDescriptorTable() const { return m_DescriptorTable; }
 
+    // the allocator's capacity doubles when it is full, within the heap range reserved for the table. Aborts once every reserved slot is live or in flight
     uint32_t CreateDescriptorHandle(nvrhi::BindingSetItem item);
 
     // For ResourceDescriptorHeap Index instead of a table relative index
-    // This value is volatile if the descriptor table resizes and needs to be refetched
+    // Stable for the lifetime of the table: its heap range is reserved once & never moves
     uint32_t GetIndexInHeap(uint32_t indexInTable) const { return m_DescriptorTable->getFirstDescriptorIndexInHeap() + indexInTable; }
 
+    // the slot is cleared & reused once the GPU is done with the frame currently being recorded
     void ReleaseDescriptor(uint32_t indexInTable);
+
+    // clears & recycles the slots released in all frames before 'numRetiredFrames'
+    void RetireFrames(uint64_t numRetiredFrames);
+
+    uint32_t GetCapacity();
+    uint32_t GetNumAllocated();
 };
@@ -3,7 +3,6 @@
 #include <dxgidebug.h>
 #include <psapi.h>
 
-#include "extern/cxxopts/include/cxxopts.hpp"
 #include "extern/imgui/imgui.h"
 #include "extern/imgui/backends/imgui_impl_sdl3.h"
 
@@ -11,6 +10,7 @@
 #include "SDL3/SDL_keyboard.h"
 
 #include "Graphic.h"
+#include "HeadlessRuns.h"
 #include "Scene.h"
 #include "Utilities.h"
 
@@ -18,6 +18,8 @@ CommandLineOption<std::vector<int>> g_DisplayResolution{ "displayresolution", {
 CommandLineOption<bool> g_ProfileStartup{ "profilestartup", false };
 CommandLineOption<int> g_MaxWorkerThreads{ "maxworkerthreads", 12 };
 
+extern CommandLineOption<std::string> g_HeadlessRuns;
+
 static bool gs_TriggerDumpProfilingCapture = false;
 static std::string gs_DumpProfilingCaptureFileName;
 
@@ -40,12 +42,6 @@ void TriggerDumpProfilingCapture(std::string_view fileName)
     gs_DumpProfilingCaptureFileName = fileName;
 }
 
-static std::string gs_ExecutableDirectory;
-const char* GetExecutableDirectory()
-{
-    return gs_ExecutableDirectory.c_str();
-}
-
 static Vector2U GetBestWindowSize()
 {
     if (g_DisplayResolution.Get()[0] != 0 && g_DisplayResolution.Get()[1] != 0)
@@ -85,13 +81,22 @@ void Engine::Initialize(int argc, char** argv)
     SCOPED_TIMER_FUNCTION();
     PROFILE_FUNCTION();
 
-    gs_ExecutableDirectory = std::filesystem::path{ argv[0] }.parent_path().string();
+    InitializeExecutableDirectory(argv[0]);
 
     SDL_Log("Root Directory: %s", GetRootDirectory());
     SDL_Log("Executable Directory: %s", GetExecutableDirectory());
     SDL_Log("Application Directory: %s", GetApplicationDirectory());
 
-    ParseCommandlineArguments(argc, argv);
+    ParseCommandLineOptions(argc, argv);
+
+    // self-tests, benchmarks & tools on stubbed devices. No window, device or scene. See 'HeadlessRuns.h'
+    if (!g_HeadlessRuns.Get().empty())
+    {
+        m_bHeadlessRunsPassed = HeadlessRuns::Run(g_HeadlessRuns.Get());
+
+        m_bHeadless = true;
+        return;
+    }
 
     SDL_CALL(SDL_Init(SDL_INIT_VIDEO));
 
@@ -144,48 +149,6 @@ void Engine::Initialize(int argc, char** argv)
     }
 }
 
-void Engine::ParseCommandlineArguments(int argc, char** argv)
-{
-    cxxopts::Options options{ argv[0], "Argument Parser" };
-
-    options.allow_unrecognised_options();
-
-    auto RegisterCmdLineOptsMap = [&](const auto& optsMap)
-    {
-        for (const auto& [opts, val] : optsMap)
-        {
-            options.add_options() (opts.c_str(), "", cxxopts::value(*val));
-        }
-    };
-
-    // TODO: add more types as needed
-    RegisterCmdLineOptsMap(CommandLineOption<bool>::ms_CachedArgs);
-    RegisterCmdLineOptsMap(CommandLineOption<int>::ms_CachedArgs);
-    RegisterCmdLineOptsMap(CommandLineOption<float>::ms_CachedArgs);
-    RegisterCmdLineOptsMap(CommandLineOption<std::vector<int>>::ms_CachedArgs);
-    RegisterCmdLineOptsMap(CommandLineOption<std::string>::ms_CachedArgs);
-
-    const cxxopts::ParseResult parseResult = options.parse(argc, argv);
-
-    std::string printArgsStr = "Command Line Arguments: ";
-    for (const cxxopts::KeyValue& arg : parseResult.arguments())
-    {
-        printArgsStr += StringFormat("{%s : %s} ", arg.key().c_str(), arg.value().c_str());
-    }
-    SDL_Log(printArgsStr.c_str());
-
-    if (!parseResult.unmatched().empty())
-    {
-        printArgsStr = "Unmatched Command Line Arguments: { ";
-        for (std::string_view s : parseResult.unmatched())
-        {
-            printArgsStr += StringFormat("%s ", s.data());
-        }
-        printArgsStr += "}";
-        SDL_Log(printArgsStr.c_str());
-    }
-}
-
 void Engine::Shutdown()
 {
 	// recurssive consume all commands until empty
@@ -430,8 +393,12 @@ int SDL_main(int argc, char** argv)
 {
     Engine e;
     e.Initialize(argc, argv);
-    e.MainLoop();
-    e.Shutdown();
 
-    return 0;
+    if (!e.m_bHeadless)
+    {
+        e.MainLoop();
+        e.Shutdown();
+    }
+
+    return e.m_bHeadlessRunsPassed ? 0 : 1;
 }
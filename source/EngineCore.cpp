@@ -0,0 +1,58 @@
+#include "EngineCore.h"
+
+#include "extern/cxxopts/include/cxxopts.hpp"
+
+#include "Utilities.h"
+
+static std::string gs_ExecutableDirectory;
+const char* GetExecutableDirectory()
+{
+    return gs_ExecutableDirectory.c_str();
+}
+
+void InitializeExecutableDirectory(const char* argv0)
+{
+    gs_ExecutableDirectory = std::filesystem::path{ argv0 }.parent_path().string();
+}
+
+void ParseCommandLineOptions(int argc, char** argv)
+{
+    cxxopts::Options options{ argv[0], "Argument Parser" };
+
+    options.allow_unrecognised_options();
+
+    auto RegisterCmdLineOptsMap = [&](const auto& optsMap)
+    {
+        for (const auto& [opts, val] : optsMap)
+        {
+            options.add_options() (opts.c_str(), "", cxxopts::value(*val));
+        }
+    };
+
+    // TODO: add more types as needed
+    RegisterCmdLineOptsMap(CommandLineOption<bool>::ms_CachedArgs);
+    RegisterCmdLineOptsMap(CommandLineOption<int>::ms_CachedArgs);
+    RegisterCmdLineOptsMap(CommandLineOption<float>::ms_CachedArgs);
+    RegisterCmdLineOptsMap(CommandLineOption<std::vector<int>>::ms_CachedArgs);
+    RegisterCmdLineOptsMap(CommandLineOption<std::string>::ms_CachedArgs);
+
+    const cxxopts::ParseResult parseResult = options.parse(argc, argv);
+
+    std::string printArgsStr = "Command Line Arguments: ";
+    for (const cxxopts::KeyValue& arg : parseResult.arguments())
+    {
+        printArgsStr += StringFormat("{%s : %s} ", arg.key().c_str(), arg.value().c_str());
+    }
+    SDL_Log(printArgsStr.c_str());
+
+    if (!parseResult.unmatched().empty())
+    {
+        printArgsStr = "Unmatched Command Line Arguments: { ";
+        for (std::string_view s : parseResult.unmatched())
+        {
+            printArgsStr += StringFormat("%s ", s.data());
+        }
+        printArgsStr += "}";
+        SDL_Log(printArgsStr.c_str());
+    }
+}
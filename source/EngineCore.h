@@ -0,0 +1,70 @@
+#pragma once
+
+#include "extern/microprofile/microprofile.h"
+#include "extern/taskflow/taskflow/taskflow.hpp"
+
+// Parts of the engine that dont need a window, device or OS: profiling & lock macros, threading helpers & command line options
+// Shared by the app & the standalone tools. See 'source/tools/ToolMain.cpp'
+
+#define PROFILE_LOCK(NAME) MICROPROFILE_SCOPEI("Locks", NAME, 0xFF0000)
+#define AUTO_LOCK(lck) AUTO_SCOPE( [&]{ PROFILE_LOCK(TOSTRING(lck)); lck.lock(); } , [&]{ lck.unlock(); } )
+
+#define SDL_CALL(x) if (!(x)) { SDL_Log("SDL Error: %s", SDL_GetError()); check(false); }
+
+// forward declare 'StringFormat' here so that logging macros can compile without including Utilities.h
+const char* StringFormat(const char* format, ...);
+
+// note: DON'T input formatted strings from 'StringFormat'!!! It will cock up the profiling dump if the internal ring buffer of strings gets overwritten
+#define PROFILE_SCOPED(NAME) MICROPROFILE_SCOPE_CSTR(NAME)
+
+#define PROFILE_FUNCTION() PROFILE_SCOPED(__FUNCTION__)
+
+class MultithreadDetector
+{
+public:
+    void Enter(std::thread::id newID)
+    {
+        if (m_CurrentID != std::thread::id{} && newID != m_CurrentID)
+            check(false); // Multi-thread detected!
+        m_CurrentID = newID;
+    }
+
+    void Exit() { m_CurrentID = std::thread::id{}; }
+
+private:
+    std::atomic<std::thread::id> m_CurrentID = {};
+};
+
+#define SCOPED_MULTITHREAD_DETECTOR(MTDetector) AUTO_SCOPE( [&]{ MTDetector.Enter(std::this_thread::get_id()); }, [&]{ MTDetector.Exit(); } );
+
+#define STATIC_MULTITHREAD_DETECTOR() \
+    static MultithreadDetector __s_MTDetector__; \
+    SCOPED_MULTITHREAD_DETECTOR(__s_MTDetector__);
+
+// Parses the values of every 'CommandLineOption', i.e.: "-maxworkerthreads=8"
+void ParseCommandLineOptions(int argc, char** argv);
+
+// Directory of the running executable, see 'GetExecutableDirectory'
+void InitializeExecutableDirectory(const char* argv0);
+
+template <typename T>
+class CommandLineOption
+{
+public:
+    CommandLineOption(const char* opts, T defaultValue)
+        : value(defaultValue)
+    {
+        auto[insertIt, bInserted] = ms_CachedArgs.insert({opts, &value});
+
+        check(bInserted); // cmd line arg already exists
+    }
+
+    const T& Get() const { return value; }
+
+private:
+    T value;
+
+    inline static std::unordered_map<std::string, T*> ms_CachedArgs;
+
+    friend void ParseCommandLineOptions(int argc, char** argv);
+};
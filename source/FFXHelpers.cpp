@@ -103,9 +103,16 @@ namespace FFXHelpers
 				return kResults[(uint32_t)reductionType];
 			};
 
+		static constexpr ShaderID kSPDShaderIDs[] =
+		{
+			"ffx_spd_downsample_pass_CS FFX_SPD_OPTION_DOWNSAMPLE_FILTER=0",
+			"ffx_spd_downsample_pass_CS FFX_SPD_OPTION_DOWNSAMPLE_FILTER=1",
+			"ffx_spd_downsample_pass_CS FFX_SPD_OPTION_DOWNSAMPLE_FILTER=2",
+		};
+
 		Graphic::ComputePassParams computePassParams;
 		computePassParams.m_CommandList = commandList;
-		computePassParams.m_ShaderName = StringFormat("ffx_spd_downsample_pass_CS FFX_SPD_OPTION_DOWNSAMPLE_FILTER=%d", GetSPDReductionTypeIdx(reductionType));
+		computePassParams.m_ShaderID = kSPDShaderIDs[GetSPDReductionTypeIdx(reductionType)];
         computePassParams.m_BindingSetDesc = bindingSetDesc;
         computePassParams.m_DispatchGroupSize = Vector3U{ dispatchThreadGroupCountXY[0], dispatchThreadGroupCountXY[1], 1 };
 		computePassParams.m_PushConstantsData = &passParameters;
@@ -0,0 +1,258 @@
+#include "FeedbackTrace.h"
+
+#include "EngineCore.h"
+#include "HeadlessRuns.h"
+#include "IntegerMath.h"
+#include "Utilities.h"
+
+struct FeedbackChunkHeader
+{
+    uint32_t m_TiledTextureID;
+    uint32_t m_NumBytes;
+};
+
+uint32_t FeedbackTrace::TextureDesc::GetNumFeedbackRegions() const
+{
+    return DivideAndRoundUp(m_Width, m_FeedbackRegionWidth) * DivideAndRoundUp(m_Height, m_FeedbackRegionHeight);
+}
+
+bool FeedbackTrace::Load(std::string_view filePath)
+{
+    PROFILE_FUNCTION();
+
+    *this = FeedbackTrace{};
+
+    if (!std::filesystem::exists(filePath))
+    {
+        return false;
+    }
+
+    ScopedFile f{ filePath, "rb" };
+
+    Header header;
+    if (fread(&header, sizeof(header), 1, f) != 1 || header.m_Magic != kMagic || header.m_Version != kCurrentVersion)
+    {
+        return false;
+    }
+
+    ChunkType chunkType;
+    while (fread(&chunkType, sizeof(chunkType), 1, f) == 1)
+    {
+        if (chunkType == ChunkType::Texture)
+        {
+            TextureDesc& textureDesc = m_Textures.emplace_back();
+            if (fread(&textureDesc, sizeof(textureDesc), 1, f) != 1 ||
+                textureDesc.m_NumStandardMips > GraphicConstants::kMaxTextureMips || textureDesc.m_FeedbackRegionWidth == 0 || textureDesc.m_FeedbackRegionHeight == 0)
+            {
+                *this = FeedbackTrace{};
+                return false;
+            }
+        }
+        else if (chunkType == ChunkType::Frame)
+        {
+            uint32_t numFeedbacks;
+            if (fread(&numFeedbacks, sizeof(numFeedbacks), 1, f) != 1)
+            {
+                *this = FeedbackTrace{};
+                return false;
+            }
+
+            Frame& frame = m_Frames.emplace_back();
+            frame.m_Feedbacks.resize(numFeedbacks);
+            for (Feedback& feedback : frame.m_Feedbacks)
+            {
+                FeedbackChunkHeader feedbackHeader;
+                if (fread(&feedbackHeader, sizeof(feedbackHeader), 1, f) != 1)
+                {
+                    *this = FeedbackTrace{};
+                    return false;
+                }
+
+                feedback.m_TiledTextureID = feedbackHeader.m_TiledTextureID;
+                feedback.m_MinMipData.resize(feedbackHeader.m_NumBytes);
+                if (fread(feedback.m_MinMipData.data(), 1, feedbackHeader.m_NumBytes, f) != feedbackHeader.m_NumBytes)
+                {
+                    *this = FeedbackTrace{};
+                    return false;
+                }
+            }
+        }
+        else
+        {
+            *this = FeedbackTrace{};
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool FeedbackTraceRecorder::Open(std::string_view filePath)
+{
+    Close();
+
+    m_File = fopen(filePath.data(), "wb");
+    if (!m_File)
+    {
+        return false;
+    }
+
+    const FeedbackTrace::Header header;
+    verify(fwrite(&header, sizeof(header), 1, m_File) == 1);
+
+    return true;
+}
+
+void FeedbackTraceRecorder::Close()
+{
+    if (!m_File)
+    {
+        return;
+    }
+
+    fclose(m_File);
+    m_File = nullptr;
+
+    m_FrameData.clear();
+    m_NumFrameFeedbacks = 0;
+}
+
+void FeedbackTraceRecorder::RecordTexture(const FeedbackTrace::TextureDesc& textureDesc)
+{
+    check(m_File);
+
+    const FeedbackTrace::ChunkType chunkType = FeedbackTrace::ChunkType::Texture;
+    verify(fwrite(&chunkType, sizeof(chunkType), 1, m_File) == 1);
+    verify(fwrite(&textureDesc, sizeof(textureDesc), 1, m_File) == 1);
+}
+
+void FeedbackTraceRecorder::RecordFeedback(uint32_t tiledTextureID, std::span<const uint8_t> minMipData)
+{
+    check(m_File);
+
+    const FeedbackChunkHeader feedbackHeader{ tiledTextureID, (uint32_t)minMipData.size() };
+
+    const size_t offset = m_FrameData.size();
+    m_FrameData.resize(offset + sizeof(feedbackHeader) + minMipData.size());
+    memcpy(m_FrameData.data() + offset, &feedbackHeader, sizeof(feedbackHeader));
+    memcpy(m_FrameData.data() + offset + sizeof(feedbackHeader), minMipData.data(), minMipData.size());
+
+    ++m_NumFrameFeedbacks;
+}
+
+void FeedbackTraceRecorder::EndFrame()
+{
+    check(m_File);
+
+    const FeedbackTrace::ChunkType chunkType = FeedbackTrace::ChunkType::Frame;
+    verify(fwrite(&chunkType, sizeof(chunkType), 1, m_File) == 1);
+    verify(fwrite(&m_NumFrameFeedbacks, sizeof(m_NumFrameFeedbacks), 1, m_File) == 1);
+    if (!m_FrameData.empty())
+    {
+        verify(fwrite(m_FrameData.data(), 1, m_FrameData.size(), m_File) == m_FrameData.size());
+    }
+
+    m_FrameData.clear();
+    m_NumFrameFeedbacks = 0;
+    ++m_NumFramesRecorded;
+}
+
+static void RunFeedbackTraceSelfTest()
+{
+    PROFILE_FUNCTION();
+
+    const std::string filePath = (std::filesystem::temp_directory_path() / "FeedbackTraceSelfTest.bin").string();
+
+    std::mt19937 rng{ 42 };
+
+    std::vector<FeedbackTrace::TextureDesc> textureDescs(3);
+    for (uint32_t i = 0; i < textureDescs.size(); ++i)
+    {
+        FeedbackTrace::TextureDesc& textureDesc = textureDescs[i];
+        textureDesc.m_TiledTextureID = i;
+        textureDesc.m_Width = 512u << i;
+        textureDesc.m_Height = 256u << i;
+        textureDesc.m_TileWidth = 256;
+        textureDesc.m_TileHeight = 256;
+        textureDesc.m_NumStandardMips = 1 + i;
+        textureDesc.m_NumPackedMips = 8;
+        textureDesc.m_NumPackedTiles = 1;
+        textureDesc.m_FeedbackRegionWidth = 256;
+        textureDesc.m_FeedbackRegionHeight = 128;
+        textureDesc.m_bReadsWholeMips = i % 2;
+        for (uint32_t mip = 0; mip < textureDesc.m_NumStandardMips; ++mip)
+        {
+            textureDesc.m_Mips[mip] = { (512u << i >> mip) / 256, std::max((256u << i >> mip) / 256, 1u), (uint32_t)rng(), GraphicConstants::kTiledResourceSizeInBytes };
+        }
+    }
+
+    // frames w/ a varying number of feedbacks, including none
+    const uint32_t kNumFrames = 10;
+    std::vector<FeedbackTrace::Frame> frames(kNumFrames);
+
+    {
+        FeedbackTraceRecorder recorder;
+        test_verify(recorder.Open(filePath));
+
+        // textures can be added after the first frames, as when streaming in new ones
+        recorder.RecordTexture(textureDescs[0]);
+        recorder.RecordTexture(textureDescs[1]);
+
+        for (uint32_t frameIdx = 0; frameIdx < kNumFrames; ++frameIdx)
+        {
+            if (frameIdx == kNumFrames / 2)
+            {
+                recorder.RecordTexture(textureDescs[2]);
+            }
+
+            const uint32_t numTextures = (frameIdx < kNumFrames / 2) ? 2 : 3;
+            for (uint32_t i = 0; i < frameIdx % 4; ++i)
+            {
+                const FeedbackTrace::TextureDesc& textureDesc = textureDescs[rng() % numTextures];
+
+                FeedbackTrace::Feedback& feedback = frames[frameIdx].m_Feedbacks.emplace_back();
+                feedback.m_TiledTextureID = textureDesc.m_TiledTextureID;
+                feedback.m_MinMipData.resize(textureDesc.GetNumFeedbackRegions());
+                for (uint8_t& minMip : feedback.m_MinMipData)
+                {
+                    minMip = (uint8_t)rng();
+                }
+
+                recorder.RecordFeedback(feedback.m_TiledTextureID, feedback.m_MinMipData);
+            }
+
+            recorder.EndFrame();
+        }
+        test_verify(recorder.GetNumFramesRecorded() == kNumFrames);
+    }
+
+    FeedbackTrace trace;
+    test_verify(trace.Load(filePath));
+
+    test_verify(trace.m_Textures.size() == textureDescs.size());
+    for (uint32_t i = 0; i < textureDescs.size(); ++i)
+    {
+        test_verify(memcmp(&trace.m_Textures[i], &textureDescs[i], sizeof(FeedbackTrace::TextureDesc)) == 0);
+    }
+
+    test_verify(trace.m_Frames.size() == kNumFrames);
+    for (uint32_t frameIdx = 0; frameIdx < kNumFrames; ++frameIdx)
+    {
+        const FeedbackTrace::Frame& frame = trace.m_Frames[frameIdx];
+        test_verify(frame.m_Feedbacks.size() == frames[frameIdx].m_Feedbacks.size());
+        for (uint32_t i = 0; i < frame.m_Feedbacks.size(); ++i)
+        {
+            test_verify(frame.m_Feedbacks[i].m_TiledTextureID == frames[frameIdx].m_Feedbacks[i].m_TiledTextureID);
+            test_verify(frame.m_Feedbacks[i].m_MinMipData == frames[frameIdx].m_Feedbacks[i].m_MinMipData);
+        }
+    }
+
+    // a truncated trace is rejected
+    const uint64_t fileSize = std::filesystem::file_size(filePath);
+    std::filesystem::resize_file(filePath, fileSize - 1);
+    test_verify(!trace.Load(filePath));
+    test_verify(trace.m_Frames.empty());
+
+    std::filesystem::remove(filePath);
+}
+REGISTER_HEADLESS_RUN("feedbacktraceselftest", HeadlessRunType::SelfTest, RunFeedbackTraceSelfTest);
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "GraphicConstants.h"
+
+// Per frame sampler feedback that 'TextureFeedbackManager' feeds to the tiled texture manager, recorded w/ "-recordfeedbacktrace=<path>" & replayed offline by 'RunStreamingSimulator'
+// The file is a 'Header', then a sequence of chunks: 1 per streamed texture as it's added, & 1 per frame w/ the MinMip feedback of every texture updated that frame, followers included
+// Device agnostic, see 'RunFeedbackTraceSelfTest'
+class FeedbackTrace
+{
+public:
+    static const uint32_t kMagic = 'F' | ('B' << 8) | ('T' << 16) | ('R' << 24);
+    static const uint32_t kCurrentVersion = 1; // increment this if the file format changes
+
+    struct Header
+    {
+        uint32_t m_Magic = kMagic;
+        uint32_t m_Version = kCurrentVersion;
+    };
+
+    enum class ChunkType : uint32_t
+    {
+        Texture,
+        Frame,
+    };
+
+    struct Mip
+    {
+        uint32_t m_WidthInTiles = 0;
+        uint32_t m_HeightInTiles = 0;
+        uint32_t m_ReadNumBytes = 0;   // of a tile, or of the whole mip if 'm_bReadsWholeMips'. Edge tiles are counted as full ones
+        uint32_t m_UploadNumBytes = 0; // of a tile
+    };
+
+    // what the tiled texture manager & the streaming of a texture need. Stored as is
+    struct TextureDesc
+    {
+        uint32_t m_TiledTextureID = UINT_MAX; // at record time
+        uint32_t m_Width = 0;
+        uint32_t m_Height = 0;
+        uint32_t m_TileWidth = 0;  // in texels
+        uint32_t m_TileHeight = 0;
+        uint32_t m_NumStandardMips = 0;
+        uint32_t m_NumPackedMips = 0;
+        uint32_t m_NumPackedTiles = 0;
+        uint32_t m_FeedbackRegionWidth = 0; // in texels
+        uint32_t m_FeedbackRegionHeight = 0;
+        uint32_t m_bReadsWholeMips = 0; // no tiled texture file: standard mips are read whole from the DDS
+        Mip m_Mips[GraphicConstants::kMaxTextureMips]; // standard mips
+
+        uint32_t GetNumFeedbackRegions() const;
+    };
+
+    struct Feedback
+    {
+        uint32_t m_TiledTextureID;
+        std::vector<uint8_t> m_MinMipData;
+    };
+
+    struct Frame
+    {
+        std::vector<Feedback> m_Feedbacks;
+    };
+
+    // False if the file is missing, from another version or truncated
+    bool Load(std::string_view filePath);
+
+    std::vector<TextureDesc> m_Textures;
+    std::vector<Frame> m_Frames;
+};
+
+// Writes a 'FeedbackTrace' as the renderer runs. Textures & feedback are written as they're recorded, frames as they end
+class FeedbackTraceRecorder
+{
+public:
+    ~FeedbackTraceRecorder() { Close(); }
+
+    bool Open(std::string_view filePath);
+    void Close();
+    bool IsOpen() const { return m_File != nullptr; }
+
+    void RecordTexture(const FeedbackTrace::TextureDesc& textureDesc);
+    void RecordFeedback(uint32_t tiledTextureID, std::span<const uint8_t> minMipData);
+    void EndFrame();
+
+    uint32_t GetNumFramesRecorded() const { return m_NumFramesRecorded; }
+
+private:
+    FILE* m_File = nullptr;
+    std::vector<std::byte> m_FrameData; // feedbacks of the current frame, written at 'EndFrame'
+    uint32_t m_NumFrameFeedbacks = 0;
+    uint32_t m_NumFramesRecorded = 0;
+};
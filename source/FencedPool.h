@@ -0,0 +1,46 @@
+#pragma once
+
+// Pool of objects that are handed over to the GPU for a frame, i.e. command lists
+// An object is only recycled once the frame it was allocated in has retired (see 'FrameRing')
+// NOTE: owned & accessed by a single thread, so there are no locks. Use 1 pool per thread
+template <typename T>
+class FencedPool
+{
+public:
+    // 'numRetiredFrames': all frames before this index are done on the GPU
+    template <typename CreateFunc>
+    [[nodiscard]] T Allocate(uint64_t frameIdx, uint64_t numRetiredFrames, CreateFunc&& createFunc)
+    {
+        T ret;
+
+        // in-flight objects are ordered by frame. Only the oldest one needs to be checked
+        if (!m_InFlight.empty() && (m_InFlight.front().m_FrameIdx < numRetiredFrames))
+        {
+            ret = std::move(m_InFlight.front().m_Object);
+            m_InFlight.pop_front();
+        }
+        else
+        {
+            ret = createFunc();
+            ++m_NumCreated;
+        }
+
+        m_InFlight.push_back(Entry{ frameIdx, ret });
+
+        return ret;
+    }
+
+    void Clear() { m_InFlight.clear(); }
+
+    uint32_t GetNumCreated() const { return m_NumCreated; }
+
+private:
+    struct Entry
+    {
+        uint64_t m_FrameIdx;
+        T m_Object;
+    };
+    std::deque<Entry> m_InFlight;
+
+    uint32_t m_NumCreated = 0;
+};
@@ -0,0 +1,253 @@
+#include "FrameRing.h"
+
+#include <thread>
+
+#include "EngineCore.h"
+#include "HeadlessRuns.h"
+#include "Utilities.h"
+
+void FrameRing::Initialize(IFrameFence* fence, uint32_t maxFramesInFlight)
+{
+    check(fence);
+    check(maxFramesInFlight >= 1 && maxFramesInFlight <= GraphicConstants::kMaxFramesInFlight);
+
+    m_Fence = fence;
+    m_MaxFramesInFlight = maxFramesInFlight;
+}
+
+void FrameRing::Shutdown()
+{
+    // wait for everything in flight & flush all deferred releases, including the ones of the frame being recorded
+    for (uint32_t i = 0; i < m_MaxFramesInFlight; ++i)
+    {
+        RetireFrame(i);
+    }
+
+    std::vector<std::function<void()>> releaseFuncs;
+    {
+        AUTO_LOCK(m_DeferredReleasesLock);
+        for (Slot& slot : m_Slots)
+        {
+            releaseFuncs.insert(releaseFuncs.end(), std::make_move_iterator(slot.m_DeferredReleases.begin()), std::make_move_iterator(slot.m_DeferredReleases.end()));
+            slot.m_DeferredReleases.clear();
+        }
+    }
+
+    for (std::function<void()>& releaseFunc : releaseFuncs)
+    {
+        releaseFunc();
+    }
+}
+
+void FrameRing::BeginFrame()
+{
+    PROFILE_FUNCTION();
+
+    const uint32_t slotIdx = GetFrameSlot();
+
+    Timer waitTimer;
+    RetireFrame(slotIdx);
+    m_LastWaitTimeMs = waitTimer.GetElapsedMilliseconds();
+
+    std::vector<std::function<void()>> releaseFuncs;
+    {
+        AUTO_LOCK(m_DeferredReleasesLock);
+        releaseFuncs.swap(m_Slots[slotIdx].m_DeferredReleases);
+    }
+
+    // NOTE: outside of the lock, as release funcs may defer more releases
+    for (std::function<void()>& releaseFunc : releaseFuncs)
+    {
+        releaseFunc();
+    }
+}
+
+void FrameRing::EndFrame()
+{
+    PROFILE_FUNCTION();
+
+    Slot& slot = m_Slots[GetFrameSlot()];
+    check(slot.m_FrameIdx == UINT64_MAX);
+
+    m_Fence->Signal(m_FrameIdx);
+    slot.m_FrameIdx = m_FrameIdx;
+
+    ++m_FrameIdx;
+}
+
+void FrameRing::DeferRelease(std::function<void()>&& releaseFunc)
+{
+    AUTO_LOCK(m_DeferredReleasesLock);
+    m_Slots[GetFrameSlot()].m_DeferredReleases.push_back(std::move(releaseFunc));
+}
+
+void FrameRing::RetireFrame(uint32_t slotIdx)
+{
+    Slot& slot = m_Slots[slotIdx];
+
+    if (slot.m_FrameIdx == UINT64_MAX)
+    {
+        return;
+    }
+
+    if (!m_Fence->IsComplete(slot.m_FrameIdx))
+    {
+        PROFILE_SCOPED("Wait for GPU Frame");
+        m_Fence->Wait(slot.m_FrameIdx);
+    }
+
+    slot.m_FrameIdx = UINT64_MAX;
+    m_NumRetiredFrames.fetch_add(1, std::memory_order_release);
+}
+
+void ScriptedFrameFence::Signal(uint64_t frameIdx)
+{
+    AUTO_LOCK(m_Lock);
+    check(frameIdx == m_NumSignaledFrames); // frames are signaled in order
+
+    ++m_NumSignaledFrames;
+    if (m_LatencyFrames != UINT32_MAX && frameIdx >= m_LatencyFrames)
+    {
+        CompleteFrameInternal(frameIdx - m_LatencyFrames);
+    }
+}
+
+bool ScriptedFrameFence::IsComplete(uint64_t frameIdx)
+{
+    AUTO_LOCK(m_Lock);
+    return frameIdx < m_NumCompletedFrames;
+}
+
+void ScriptedFrameFence::Wait(uint64_t frameIdx)
+{
+    std::unique_lock lock{ m_Lock };
+    check(frameIdx < m_NumSignaledFrames); // would never complete
+
+    m_WaitedFrames.push_back(frameIdx);
+
+    // the "GPU" catches up while the CPU blocks
+    if (m_LatencyFrames != UINT32_MAX)
+    {
+        CompleteFrameInternal(frameIdx);
+        return;
+    }
+
+    m_WaitingFrameIdx = frameIdx;
+    m_ConditionVariable.notify_all();
+    m_ConditionVariable.wait(lock, [&] { return frameIdx < m_NumCompletedFrames; });
+    m_WaitingFrameIdx = UINT64_MAX;
+}
+
+void ScriptedFrameFence::CompleteFrame(uint64_t frameIdx)
+{
+    AUTO_LOCK(m_Lock);
+    check(frameIdx < m_NumSignaledFrames);
+    CompleteFrameInternal(frameIdx);
+}
+
+void ScriptedFrameFence::WaitForWaiter(uint64_t frameIdx)
+{
+    std::unique_lock lock{ m_Lock };
+    m_ConditionVariable.wait(lock, [&] { return m_WaitingFrameIdx == frameIdx; });
+}
+
+std::vector<uint64_t> ScriptedFrameFence::GetWaitedFrames()
+{
+    AUTO_LOCK(m_Lock);
+    return m_WaitedFrames;
+}
+
+void ScriptedFrameFence::CompleteFrameInternal(uint64_t frameIdx)
+{
+    m_NumCompletedFrames = std::max(m_NumCompletedFrames, frameIdx + 1);
+    m_ConditionVariable.notify_all();
+}
+
+static void RunFrameRingSelfTest()
+{
+    PROFILE_FUNCTION();
+
+    const uint32_t kMaxFramesInFlight = 2;
+
+    ScriptedFrameFence fence;
+    FrameRing frameRing;
+    frameRing.Initialize(&fence, kMaxFramesInFlight);
+
+    // frame idx of every deferred release, in order of execution
+    std::vector<uint64_t> releasedFrames;
+    std::mutex releasedFramesLock;
+
+    auto GetReleasedFrames = [&]
+        {
+            AUTO_LOCK(releasedFramesLock);
+            return releasedFrames;
+        };
+
+    auto RecordFrame = [&]
+        {
+            const uint64_t frameIdx = frameRing.GetFrameIdx();
+            frameRing.DeferRelease([&, frameIdx] { AUTO_LOCK(releasedFramesLock); releasedFrames.push_back(frameIdx); });
+            frameRing.EndFrame();
+        };
+
+    // frames 0 & 1: free slots, nothing to wait for or release
+    for (uint32_t i = 0; i < kMaxFramesInFlight; ++i)
+    {
+        frameRing.BeginFrame();
+        RecordFrame();
+    }
+    test_verify(fence.GetWaitedFrames().empty());
+    test_verify(GetReleasedFrames().empty());
+
+    // frame 0 completes on the GPU, but its releases only run once its slot is re-used by frame 2
+    fence.CompleteFrame(0);
+    test_verify(GetReleasedFrames().empty());
+    test_verify(frameRing.GetNumRetiredFrames() == 0);
+
+    frameRing.BeginFrame();
+    test_verify(fence.GetWaitedFrames().empty()); // already complete, no wait
+    test_verify(GetReleasedFrames() == std::vector<uint64_t>{ 0 });
+    test_verify(frameRing.GetNumRetiredFrames() == 1);
+    RecordFrame();
+
+    // frame 3 re-uses the slot of frame 1, which is still in flight: 'BeginFrame' must block on it & not release anything until it completes
+    {
+        std::atomic<bool> bBeginFrameReturned = false;
+        std::thread beginFrameThread{ [&] { frameRing.BeginFrame(); bBeginFrameReturned = true; } };
+
+        fence.WaitForWaiter(1);
+        test_verify(!bBeginFrameReturned);
+        test_verify(GetReleasedFrames() == std::vector<uint64_t>{ 0 });
+
+        fence.CompleteFrame(1);
+        beginFrameThread.join();
+
+        test_verify(fence.GetWaitedFrames() == std::vector<uint64_t>{ 1 });
+        test_verify(GetReleasedFrames() == (std::vector<uint64_t>{ 0, 1 }));
+        test_verify(frameRing.GetNumRetiredFrames() == 2);
+    }
+    RecordFrame();
+
+    // completing frame 3 completes frame 2 as well: frames retire in order
+    fence.CompleteFrame(3);
+    for (uint32_t i = 0; i < kMaxFramesInFlight; ++i)
+    {
+        frameRing.BeginFrame();
+        RecordFrame();
+    }
+    test_verify(fence.GetWaitedFrames().size() == 1);
+    test_verify(GetReleasedFrames() == (std::vector<uint64_t>{ 0, 1, 2, 3 }));
+
+    // shutdown flushes the releases of the frames in flight & of the frame being recorded
+    fence.CompleteFrame(5);
+    frameRing.BeginFrame();
+    test_verify(GetReleasedFrames() == (std::vector<uint64_t>{ 0, 1, 2, 3, 4 }));
+    frameRing.DeferRelease([&] { AUTO_LOCK(releasedFramesLock); releasedFrames.push_back(UINT64_MAX); });
+    frameRing.Shutdown();
+
+    std::vector<uint64_t> shutdownReleasedFrames = GetReleasedFrames();
+    std::sort(shutdownReleasedFrames.begin() + 5, shutdownReleasedFrames.end());
+    test_verify(shutdownReleasedFrames == (std::vector<uint64_t>{ 0, 1, 2, 3, 4, 5, UINT64_MAX }));
+    test_verify(fence.GetWaitedFrames().size() == 1);
+}
+REGISTER_HEADLESS_RUN("frameringselftest", HeadlessRunType::SelfTest, RunFrameRingSelfTest);
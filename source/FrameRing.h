@@ -0,0 +1,89 @@
+#pragma once
+
+#include "GraphicConstants.h"
+
+// Signaled by the GPU once all work submitted for a frame is done
+// Abstracted so that frame pacing & retirement can be driven by a fake fence that completes on a schedule
+class IFrameFence
+{
+public:
+    virtual ~IFrameFence() = default;
+
+    // called after the last submission of 'frameIdx'
+    virtual void Signal(uint64_t frameIdx) = 0;
+    virtual bool IsComplete(uint64_t frameIdx) = 0;
+    virtual void Wait(uint64_t frameIdx) = 0;
+};
+
+// Fake fence for headless runs: the "GPU" completes frames in order, when the script says so
+// 'Wait' really blocks until the frame is completed from another thread, unless completion is automatic. Thread safe
+class ScriptedFrameFence : public IFrameFence
+{
+public:
+    void Signal(uint64_t frameIdx) override;
+    bool IsComplete(uint64_t frameIdx) override;
+    void Wait(uint64_t frameIdx) override;
+
+    // completes all signaled frames up to & including 'frameIdx'
+    void CompleteFrame(uint64_t frameIdx);
+
+    // blocks until a thread waits on 'frameIdx'
+    void WaitForWaiter(uint64_t frameIdx);
+
+    std::vector<uint64_t> GetWaitedFrames();
+
+    // automatic completion: frame N completes when frame 'N + m_LatencyFrames' is signaled, or when waited on. UINT32_MAX = only by 'CompleteFrame'
+    uint32_t m_LatencyFrames = UINT32_MAX;
+
+private:
+    void CompleteFrameInternal(uint64_t frameIdx);
+
+    std::mutex m_Lock;
+    std::condition_variable m_ConditionVariable;
+    uint64_t m_NumSignaledFrames = 0;
+    uint64_t m_NumCompletedFrames = 0;
+    uint64_t m_WaitingFrameIdx = UINT64_MAX;
+    std::vector<uint64_t> m_WaitedFrames;
+};
+
+// Ring of frames in flight. Frame N uses slot 'N % maxFramesInFlight' for its per-frame resources
+// 'BeginFrame' blocks until the frame that previously used the slot has retired, then runs the releases deferred by that frame
+// CPU only, no device calls
+class FrameRing
+{
+public:
+    void Initialize(IFrameFence* fence, uint32_t maxFramesInFlight);
+    void Shutdown();
+
+    void BeginFrame();
+    void EndFrame();
+
+    // runs once the frame currently being recorded has retired on the GPU. Thread safe
+    void DeferRelease(std::function<void()>&& releaseFunc);
+
+    uint32_t GetMaxFramesInFlight() const { return m_MaxFramesInFlight; }
+    uint32_t GetFrameSlot() const { return m_FrameIdx % m_MaxFramesInFlight; }
+    uint64_t GetFrameIdx() const { return m_FrameIdx; }
+
+    // frames are retired in order: all frames before this index are done on the GPU. Thread safe
+    uint64_t GetNumRetiredFrames() const { return m_NumRetiredFrames.load(std::memory_order_acquire); }
+    float GetLastWaitTimeMs() const { return m_LastWaitTimeMs; }
+
+private:
+    void RetireFrame(uint32_t slotIdx);
+
+    struct Slot
+    {
+        uint64_t m_FrameIdx = UINT64_MAX; // UINT64_MAX = not submitted
+        std::vector<std::function<void()>> m_DeferredReleases;
+    };
+
+    IFrameFence* m_Fence = nullptr;
+    uint32_t m_MaxFramesInFlight = 1;
+    uint64_t m_FrameIdx = 0;
+    std::atomic<uint64_t> m_NumRetiredFrames = 0;
+    float m_LastWaitTimeMs = 0.0f;
+
+    std::mutex m_DeferredReleasesLock;
+    std::array<Slot, GraphicConstants::kMaxFramesInFlight> m_Slots;
+};
@@ -130,7 +130,7 @@ public:
             m_ProbeDistance = CreateProbeTexture(rtxgi::EDDGIVolumeTextureType::Distance);
             m_ProbeData = CreateProbeTexture(rtxgi::EDDGIVolumeTextureType::Data);
 
-            for (uint32_t i = 0; i < 2; ++i)
+            for (uint32_t i = 0; i < GraphicConstants::kMaxFramesInFlight; ++i)
             {
                 nvrhi::TextureDesc desc;
                 desc.format = kProbeTextureFormatsNVRHI[(int)rtxgi::EDDGIVolumeTextureType::VariabilityAverage];
@@ -203,7 +203,7 @@ public:
     RenderGraph::ResourceHandle m_ProbeVariabilityRDGTextureHandle;        // Probe variability texture array
     RenderGraph::ResourceHandle m_ProbeVariabilityAverageRDGTextureHandle; // Average of Probe variability for whole volume
 
-    nvrhi::StagingTextureHandle m_ProbeVariabilityReadbackStagingTextures[2]; // CPU-readable resource containing final Probe variability average
+    nvrhi::StagingTextureHandle m_ProbeVariabilityReadbackStagingTextures[GraphicConstants::kMaxFramesInFlight]; // CPU-readable resource containing final Probe variability average
 
     uint32_t m_NumVolumeVariabilitySamples = 0;
     float m_DebugProbeRadius = 0.1f;
@@ -437,7 +437,7 @@ public:
 
         Graphic::ComputePassParams computePassParams;
         computePassParams.m_CommandList = commandList;
-        computePassParams.m_ShaderName = "giprobetrace_CS_ProbeTrace";
+        computePassParams.m_ShaderID = "giprobetrace_CS_ProbeTrace";
         computePassParams.m_BindingSetDesc = bindingSetDesc;
         computePassParams.m_ExtraBindingSets = { g_Graphic.GetSrvUavCbvDescriptorTable() };
         computePassParams.m_ExtraBindingLayouts = { g_Graphic.m_SrvUavCbvBindlessLayout };
@@ -500,35 +500,35 @@ public:
 
         Graphic::ComputePassParams computePassParams;
         computePassParams.m_CommandList = commandList;
-        computePassParams.m_ShaderName = "ProbeBlendingCS_DDGIProbeBlendingCS RTXGI_DDGI_BLEND_RADIANCE=1";
+        computePassParams.m_ShaderID = "ProbeBlendingCS_DDGIProbeBlendingCS RTXGI_DDGI_BLEND_RADIANCE=1";
         computePassParams.m_BindingSetDesc = bindingSetDesc;
         computePassParams.m_DispatchGroupSize = Vector3U{ probeCountX, probeCountY, probeCountZ };
         computePassParams.m_PushConstantsData = &rootConsts;
         computePassParams.m_PushConstantsBytes = sizeof(rootConsts);
         g_Graphic.AddComputePass(computePassParams);
 
-        computePassParams.m_ShaderName = "ProbeBlendingCS_DDGIProbeBlendingCS RTXGI_DDGI_BLEND_RADIANCE=0";
+        computePassParams.m_ShaderID = "ProbeBlendingCS_DDGIProbeBlendingCS RTXGI_DDGI_BLEND_RADIANCE=0";
         g_Graphic.AddComputePass(computePassParams);
 
         const Vector3U relocationAndClassificationGroupSize = ComputeShaderUtils::GetGroupCount(m_RTDDGIVolume.GetNumProbes(), 32);
 
         if (m_RTDDGIVolume.GetProbeRelocationEnabled())
         {
-            computePassParams.m_ShaderName = "ProbeRelocationCS_DDGIProbeRelocationCS";
+            computePassParams.m_ShaderID = "ProbeRelocationCS_DDGIProbeRelocationCS";
             computePassParams.m_DispatchGroupSize = relocationAndClassificationGroupSize;
             g_Graphic.AddComputePass(computePassParams);
         }
 
         if (m_RTDDGIVolume.GetProbeClassificationEnabled())
         {
-            computePassParams.m_ShaderName = "ProbeClassificationCS_DDGIProbeClassificationCS";
+            computePassParams.m_ShaderID = "ProbeClassificationCS_DDGIProbeClassificationCS";
             computePassParams.m_DispatchGroupSize = relocationAndClassificationGroupSize;
             g_Graphic.AddComputePass(computePassParams);
         }
 
         if (m_RTDDGIVolume.GetProbeVariabilityEnabled())
         {
-            nvrhi::StagingTextureHandle thisFrameVariabilityTexture = m_RTDDGIVolume.m_ProbeVariabilityReadbackStagingTextures[g_Graphic.m_FrameCounter % 2];
+            nvrhi::StagingTextureHandle thisFrameVariabilityTexture = m_RTDDGIVolume.m_ProbeVariabilityReadbackStagingTextures[g_Graphic.GetFrameSlot()];
 
             size_t outRowPitch;
             const float* variabilityReadback = (const float*)g_Graphic.m_NVRHIDevice->mapStagingTexture(thisFrameVariabilityTexture, nvrhi::TextureSlice{}, nvrhi::CpuAccessMode::Read, &outRowPitch);
@@ -559,7 +559,7 @@ public:
                 rootConsts.reductionInputSizeY = inputTexelsY;
                 rootConsts.reductionInputSizeZ = inputTexelsZ;
 
-                computePassParams.m_ShaderName = bIsFirstPass ? "ReductionCS_DDGIReductionCS REDUCTION=1" : "ReductionCS_DDGIExtraReductionCS";
+                computePassParams.m_ShaderID = bIsFirstPass ? ShaderID{ "ReductionCS_DDGIReductionCS REDUCTION=1" } : ShaderID{ "ReductionCS_DDGIExtraReductionCS" };
                 computePassParams.m_DispatchGroupSize = Vector3U{ outputTexelsX, outputTexelsY, outputTexelsZ };
                 g_Graphic.AddComputePass(computePassParams);
 
@@ -617,7 +617,7 @@ public:
             return false;
         }
 
-        renderGraph.AddReadDependency(g_DepthStencilBufferRDGTextureHandle);
+        renderGraph.AddWriteDependency(g_DepthStencilBufferRDGTextureHandle); // probes are depth tested & written
 
         {
             nvrhi::BufferDesc desc;
@@ -652,7 +652,7 @@ public:
             renderGraph.CreateTransientResource(m_InstanceIDToProbeIndexRDGBufferHandle, desc);
         }
 
-        renderGraph.AddReadDependency(g_RTDDRTDDGIVolumeDescsBuffer);
+        renderGraph.AddReadDependency(g_RTDDRTDDGIVolumeDescsBuffer, nvrhi::ResourceStates::ShaderResource);
 
         return true;
     }
@@ -708,7 +708,7 @@ public:
             passParameters.m_ProbeRadius = gs_GIRenderer.m_RTDDGIVolume.m_DebugProbeRadius;
             passParameters.m_bHideInactiveProbes = gs_GIRenderer.m_RTDDGIVolume.GetProbeVisType() == rtxgi::EDDGIVolumeProbeVisType::Hide_Inactive;
 
-            nvrhi::BufferHandle passParametersBuffer = g_Graphic.CreateConstantBuffer(commandList, passParameters);
+            nvrhi::BufferHandle passParametersBuffer = g_Graphic.WriteConstantBuffer(commandList, passParameters);
 
             nvrhi::BindingSetDesc bindingSetDesc;
             bindingSetDesc.bindings =
@@ -725,7 +725,7 @@ public:
 
             Graphic::ComputePassParams computePassParams;
             computePassParams.m_CommandList = commandList;
-            computePassParams.m_ShaderName = "giprobevisualization_CS_VisualizeGIProbesCulling";
+            computePassParams.m_ShaderID = "giprobevisualization_CS_VisualizeGIProbesCulling";
             computePassParams.m_BindingSetDesc = bindingSetDesc;
             computePassParams.m_DispatchGroupSize = ComputeShaderUtils::GetGroupCount(numProbes, kNumThreadsPerWave);
 
@@ -1,11 +1,10 @@
 #include "Graphic.h"
 
-#include "extern/cxxopts/include/cxxopts.hpp"
-#include "extern/shadermake/ShaderMake/ShaderBlob.h"
-
 #include "CommonResources.h"
 #include "Engine.h"
+#include "RenderGraph.h"
 #include "Scene.h"
+#include "ShaderLoading.h"
 #include "TextureFeedbackManager.h"
 #include "Utilities.h"
 
@@ -23,6 +22,104 @@ CommandLineOption<bool> g_AttachRenderDoc{ "attachrenderdoc", false };
 CommandLineOption<bool> g_ExecuteAndWaitPerCommandList{ "executeandwaitpercommandlist", false };
 CommandLineOption<bool> g_ExecutePerCommandList{ "executepercommandlist", false };
 CommandLineOption<bool> g_DisableTextureStreaming{ "disabletextureStreaming", false };
+CommandLineOption<int> g_MaxFramesInFlight{ "maxframesinflight", 2 };
+CommandLineOption<int> g_UploadRingSizeMB{ "uploadringsizemb", 32 };
+
+// 1 event query per frame slot, signaled after the last submission of the frame
+class NVRHIFrameFence : public IFrameFence
+{
+public:
+    void Signal(uint64_t frameIdx) override
+    {
+        nvrhi::EventQueryHandle& query = m_EventQueries[frameIdx % GraphicConstants::kMaxFramesInFlight];
+        if (!query)
+        {
+            query = g_Graphic.m_NVRHIDevice->createEventQuery();
+        }
+
+        g_Graphic.m_NVRHIDevice->resetEventQuery(query);
+        g_Graphic.m_NVRHIDevice->setEventQuery(query, nvrhi::CommandQueue::Graphics);
+    }
+
+    bool IsComplete(uint64_t frameIdx) override { return g_Graphic.m_NVRHIDevice->pollEventQuery(m_EventQueries[frameIdx % GraphicConstants::kMaxFramesInFlight]); }
+    void Wait(uint64_t frameIdx) override { g_Graphic.m_NVRHIDevice->waitEventQuery(m_EventQueries[frameIdx % GraphicConstants::kMaxFramesInFlight]); }
+
+private:
+    nvrhi::EventQueryHandle m_EventQueries[GraphicConstants::kMaxFramesInFlight];
+};
+
+// Transient resources & pass recording of the render graph on the nvrhi device
+class RenderGraphDeviceBackend : public RenderGraphBackend
+{
+public:
+    uint32_t GetFrameCounter() const override { return g_Graphic.m_FrameCounter; }
+    nvrhi::HeapHandle CreateHeap(const nvrhi::HeapDesc& heapDesc) override { return g_Graphic.m_NVRHIDevice->createHeap(heapDesc); }
+
+    nvrhi::ResourceHandle CreateTexture(const nvrhi::TextureDesc& textureDesc, uint64_t& outMemReq) override
+    {
+        nvrhi::TextureHandle texture = g_Graphic.m_NVRHIDevice->createTexture(textureDesc);
+        outMemReq = g_Graphic.m_NVRHIDevice->getTextureMemoryRequirements(texture).size;
+        return texture;
+    }
+
+    nvrhi::ResourceHandle CreateBuffer(const nvrhi::BufferDesc& bufferDesc, uint64_t& outMemReq) override
+    {
+        nvrhi::BufferHandle buffer = g_Graphic.m_NVRHIDevice->createBuffer(bufferDesc);
+        outMemReq = g_Graphic.m_NVRHIDevice->getBufferMemoryRequirements(buffer).size;
+        return buffer;
+    }
+
+    bool BindTextureMemory(nvrhi::IResource* texture, nvrhi::IHeap* heap, uint64_t heapOffset) override { return g_Graphic.m_NVRHIDevice->bindTextureMemory((nvrhi::ITexture*)texture, heap, heapOffset); }
+    bool BindBufferMemory(nvrhi::IResource* buffer, nvrhi::IHeap* heap, uint64_t heapOffset) override { return g_Graphic.m_NVRHIDevice->bindBufferMemory((nvrhi::IBuffer*)buffer, heap, heapOffset); }
+    void OnTransientResourceFreed(nvrhi::IResource* resource) override { g_Graphic.InvalidateCachedBindingSets(resource); }
+
+    nvrhi::CommandListHandle AllocateCommandList() override { return g_Graphic.AllocateCommandList(); }
+
+    // same as 'SCOPED_COMMAND_LIST', split in begin & end
+    void BeginCommandList(nvrhi::ICommandList* commandList, const char* name) override
+    {
+        g_Graphic.BeginCommandList(commandList, name);
+
+        commandList->beginMarker(name);
+        MicroProfileEnterGpu(MicroProfileGetToken("GPU", name, (uint32_t)std::hash<std::string_view>{}(name), MicroProfileTokenTypeGpu, 0), Graphic::GetGPULogForCurrentThread());
+    }
+
+    void EndCommandList(nvrhi::ICommandList* commandList) override
+    {
+        MicroProfileLeaveGpu(Graphic::GetGPULogForCurrentThread());
+        commandList->endMarker();
+
+        g_Graphic.EndCommandList(commandList, false /*bQueueCmdlist*/, false /*bImmediateExecute*/);
+    }
+
+    void QueueCommandList(nvrhi::ICommandList* commandList) override { g_Graphic.QueueCommandList(commandList); }
+
+    void BeginRendererTimer(IRenderer& renderer, nvrhi::ICommandList* commandList) override
+    {
+        nvrhi::TimerQueryHandle& rendererTimerQuery = renderer.m_FrameTimerQuery[g_Graphic.GetFrameSlot()];
+        if (!rendererTimerQuery)
+        {
+            rendererTimerQuery = g_Graphic.m_NVRHIDevice->createTimerQuery();
+        }
+
+        // the query of this frame slot was resolved by the time the slot is re-used
+        renderer.m_GPUFrameTime = Timer::SecondsToMilliSeconds(g_Graphic.m_NVRHIDevice->getTimerQueryTime(rendererTimerQuery));
+
+        g_Graphic.m_NVRHIDevice->resetTimerQuery(rendererTimerQuery);
+        commandList->beginTimerQuery(rendererTimerQuery);
+    }
+
+    void EndRendererTimer(IRenderer& renderer, nvrhi::ICommandList* commandList) override
+    {
+        commandList->endTimerQuery(renderer.m_FrameTimerQuery[g_Graphic.GetFrameSlot()]);
+    }
+};
+
+RenderGraphBackend& Graphic::GetRenderGraphBackend()
+{
+    static RenderGraphDeviceBackend s_RenderGraphBackend;
+    return s_RenderGraphBackend;
+}
 
 void Graphic::InitRenderDocAPI()
 {
@@ -94,160 +191,119 @@ void Graphic::InitDevice()
         }
     }
 
-    for (uint32_t i = 0; i < 2; ++i)
+    for (uint32_t i = 0; i < GraphicConstants::kMaxFramesInFlight; ++i)
     {
         m_FrameTimerQuery[i] = m_NVRHIDevice->createTimerQuery();
     }
+
+    const uint32_t maxFramesInFlight = std::clamp<uint32_t>(g_MaxFramesInFlight.Get(), 1, GraphicConstants::kMaxFramesInFlight);
+    SDL_Log("Max Frames In Flight: %u", maxFramesInFlight);
+
+    m_FrameFence = std::make_unique<NVRHIFrameFence>();
+    m_FrameRing.Initialize(m_FrameFence.get(), maxFramesInFlight);
+
+    const uint64_t uploadRingSize = MB_TO_BYTES(std::max(1, g_UploadRingSizeMB.Get()));
+    SDL_Log("Upload Ring Size: %.1f MB", BYTES_TO_MB(uploadRingSize));
+
+    m_UploadRing.Initialize(uploadRingSize);
+    m_UploadRingBuffer = m_NVRHIDevice->createBuffer(CreateUploadBufferDesc(uploadRingSize, "Upload Ring"));
+
+    // mapped once & never unmapped. Upload heap memory stays valid while the GPU reads from it
+    m_UploadRingCPUAddress = (std::byte*)m_NVRHIDevice->mapBuffer(m_UploadRingBuffer, nvrhi::CpuAccessMode::Write);
+    check(m_UploadRingCPUAddress);
 }
 
 void Graphic::InitShaders()
 {
     PROFILE_FUNCTION();
 
-    m_AllShaders.clear();
-
     std::filesystem::path inputPath = std::filesystem::path{ GetExecutableDirectory() }.parent_path() / "shaderstocompile.txt";
     std::string fileFullText;
     ReadTextFromFile(inputPath.string(), fileFullText);
 
-    std::stringstream stringStream{ fileFullText };
-    std::string shaderEntryLine;
-    while (std::getline(stringStream, shaderEntryLine))
-    {
-        if (shaderEntryLine.empty())
-        {
-            continue;
-        }
+    const std::string binDirectory = (std::filesystem::path{ GetExecutableDirectory() } / "shaders").string();
+    const std::vector<ShaderListEntry> entries = ParseShaderList(fileFullText, binDirectory);
+    const std::vector<ShaderBinary> binaries = LoadShaderBinaries(entries, *g_Engine.m_Executor);
 
-        PROFILE_SCOPED("Process Shader Line");
-
-        // Tokenize for argparse to read
-        std::vector<const char*> configLineTokens;
-        TokenizeLine((char*)shaderEntryLine.c_str(), configLineTokens);
-
-        // use cxxopts lib to conveniently retrieve shader type & entry point, so we can reconstruct bin file name
-        cxxopts::Options options{ "Shader Line Parser", "" };
-        options.allow_unrecognised_options();
-        options.add_options()
-            ("T", "profile", cxxopts::value<std::string>())
-            ("E", "entryPoint", cxxopts::value<std::string>());
-
-        const cxxopts::ParseResult parseResult = options.parse(configLineTokens.size(), configLineTokens.data());
-
-        const std::string profile = parseResult["T"].as<std::string>();
-        const std::string entryPoint = parseResult["E"].as<std::string>();
-
-        // kinda manual... but it's robust enough
-        nvrhi::ShaderType shaderType = nvrhi::ShaderType::None;
-        std::string profileStr = profile;
-        StringUtils::ToLower(profileStr);
-        if (profileStr == "vs")
-            shaderType = nvrhi::ShaderType::Vertex;
-        else if (profileStr == "ps")
-            shaderType = nvrhi::ShaderType::Pixel;
-        else if (profileStr == "cs")
-            shaderType = nvrhi::ShaderType::Compute;
-        else if (profileStr == "ms")
-            shaderType = nvrhi::ShaderType::Mesh;
-        else if (profileStr == "as")
-            shaderType = nvrhi::ShaderType::Amplification;
-
-        // NOTE: for raytracing, only support inline ray query, so dont have to parse weird shader file extensions
-
-        check(shaderType != nvrhi::ShaderType::None);
-
-        // reconstruct bin file name
-        // NOTE: after tokenization the line string is the 1st token of the line, which is the file name
-        std::string binFullPath = (std::filesystem::path{ GetExecutableDirectory() } / "shaders" / "").string();
-
-        // if the entry point is 'main', it won't be appended to the bin file name. Thanks ShaderMake. That's retarded.
-        if (entryPoint == "main")
-        {
-            binFullPath += std::filesystem::path{ shaderEntryLine }.stem().string() + ".bin";
-        }
-        else
-        {
-            binFullPath += std::filesystem::path{ shaderEntryLine }.stem().string() + "_" + entryPoint + ".bin";
-        }
-
-        const std::string binFileName = std::filesystem::path{ binFullPath }.stem().string();
+    // only shaders whose binary changed since the last load are (re-)created
+    const ShaderDiff diff = DiffShaderBinaries(binaries, m_ShaderBinaryHashes);
 
-        std::vector<std::byte> shaderBlob;
-        {
-            PROFILE_SCOPED("Read Shader bin");
-            ReadDataFromFile(binFullPath, shaderBlob);
-        }
-        check(!shaderBlob.empty());
-
-        std::vector<std::string> permutationDefines;
-        ShaderMake::EnumeratePermutationsInBlob(shaderBlob.data(), shaderBlob.size(), permutationDefines);
-
-        auto InitShaderHandle = [&, entryPoint, shaderType](const void* pBinary, uint32_t binarySize, std::string_view shaderDebugName)
+    std::vector<nvrhi::ShaderHandle> newShaders;
+    newShaders.resize(diff.m_NewOrChanged.size());
+    {
+        tf::Taskflow tf;
+        tf.for_each_index(0u, (uint32_t)diff.m_NewOrChanged.size(), 1u, [&](uint32_t i)
             {
                 PROFILE_SCOPED("Init Shader Handle");
 
+                const ShaderBinary& binary = binaries[diff.m_NewOrChanged[i]];
+
                 nvrhi::ShaderDesc shaderDesc;
-                shaderDesc.shaderType = shaderType;
-                shaderDesc.debugName = shaderDebugName;
-                shaderDesc.entryName = entryPoint;
+                shaderDesc.shaderType = binary.m_ShaderType;
+                shaderDesc.debugName = binary.m_DebugName;
+                shaderDesc.entryName = binary.m_EntryPoint;
 
-                size_t shaderHash = std::hash<std::string_view>{}(shaderDebugName);
-                nvrhi::ShaderHandle newShader = m_NVRHIDevice->createShader(shaderDesc, pBinary, binarySize);
-                check(newShader);
+                newShaders[i] = m_NVRHIDevice->createShader(shaderDesc, binary.m_Binary.data(), binary.m_Binary.size());
+                check(newShaders[i]);
+            });
+        g_Engine.m_Executor->corun(tf);
+    }
 
-                m_AllShaders[shaderHash] = newShader;
+    // keep the old versions alive until the PSOs that use them are evicted
+    std::vector<nvrhi::ShaderHandle> staleShaders;
 
-                SDL_Log("Shader name: %s, Type: %s, Entry: %s", shaderDebugName.data(), nvrhi::utils::ShaderStageToString(shaderType), entryPoint.c_str());
-            };
+    for (ShaderID shaderID : diff.m_Removed)
+    {
+        staleShaders.push_back(m_AllShaders.at(shaderID));
+        m_ShaderBinaryHashesByShader.erase(staleShaders.back().Get());
+        m_AllShaders.erase(shaderID);
+        m_ShaderBinaryHashes.erase(shaderID);
+    }
 
-        // no permutations
-        if (permutationDefines.empty())
-        {
-            InitShaderHandle(shaderBlob.data(), (uint32_t)shaderBlob.size(), binFileName);
-        }
+    for (uint32_t i = 0; i < diff.m_NewOrChanged.size(); ++i)
+    {
+        const ShaderBinary& binary = binaries[diff.m_NewOrChanged[i]];
 
-        // permutations. enumerate through all and init
-        else
+        nvrhi::ShaderHandle& shader = m_AllShaders[binary.m_ShaderID];
+        if (shader)
         {
-            const uint32_t kNbMaxConstants = 8;
+            staleShaders.push_back(shader);
+            m_ShaderBinaryHashesByShader.erase(shader.Get());
+        }
+        shader = newShaders[i];
+        m_ShaderBinaryHashes[binary.m_ShaderID] = binary.m_BinaryHash;
+        m_ShaderBinaryHashesByShader[shader.Get()] = binary.m_BinaryHash;
 
-            // 'enumeratePermutationsInBlob' will return an array of strings of all combinations of permutation defines
-            // assume each instance of '=' character represents a Shader #define
-            const int64_t nbConstants = std::count(permutationDefines[0].begin(), permutationDefines[0].end(), '=');
-            check(nbConstants <= kNbMaxConstants);
+        SDL_Log("Shader name: %s, Type: %s, Entry: %s", binary.m_DebugName.c_str(), nvrhi::utils::ShaderStageToString(binary.m_ShaderType), binary.m_EntryPoint.c_str());
+    }
 
-            for (std::string permutationDefine : permutationDefines) // NOTE: deliberately not by const ref
-            {
-                // for debug name purposes
-                const std::string definesStringCopy = permutationDefine;
+    if (!staleShaders.empty())
+    {
+        EvictPSOs(staleShaders);
+    }
 
-                ShaderMake::ShaderConstant shaderConstants[kNbMaxConstants]{};
+    SDL_Log("Shaders: %u created, %u unchanged, %u removed", (uint32_t)diff.m_NewOrChanged.size(), diff.m_NumUnchanged, (uint32_t)diff.m_Removed.size());
+}
 
-                std::vector<const char*> constantAndValueStrings;
-                TokenizeLine((char*)permutationDefine.c_str(), constantAndValueStrings);
+void Graphic::EvictPSOs(std::span<const nvrhi::ShaderHandle> staleShaders)
+{
+    PROFILE_FUNCTION();
 
-                uint32_t i = 0;
-                for (const char* constantAndValueString : constantAndValueStrings)
-                {
-                    ShaderMake::ShaderConstant& shaderConstant = shaderConstants[i++];
+    std::unordered_set<nvrhi::IShader*> staleShaderSet;
+    for (nvrhi::IShader* shader : staleShaders)
+    {
+        staleShaderSet.insert(shader);
+    }
 
-                    shaderConstant.name = strtok((char*)constantAndValueString, "=");
-                    shaderConstant.value = strtok(nullptr, "=");
-                }
+    auto IsStale = [&staleShaderSet](nvrhi::IShader* shader) { return shader && staleShaderSet.contains(shader); };
 
-                const void* pBinary = nullptr;
-                size_t binarySize = 0;
-                if (!ShaderMake::FindPermutationInBlob(shaderBlob.data(), shaderBlob.size(), shaderConstants, (uint32_t)nbConstants, &pBinary, &binarySize))
-                {
-                    SDL_Log("%s", ShaderMake::FormatShaderNotFoundMessage(shaderBlob.data(), shaderBlob.size(), shaderConstants, (uint32_t)nbConstants).c_str());
-                    check(false);
-                }
+    // NOTE: command lists in flight hold their own references to the PSOs they use
+    const uint32_t numEvictedPSOs =
+        m_CachedGraphicPSOs.EraseIf([&](const nvrhi::GraphicsPipelineHandle& pso) { return IsStale(pso->getDesc().VS) || IsStale(pso->getDesc().PS); }) +
+        m_CachedMeshletPSOs.EraseIf([&](const nvrhi::MeshletPipelineHandle& pso) { return IsStale(pso->getDesc().AS) || IsStale(pso->getDesc().MS) || IsStale(pso->getDesc().PS); }) +
+        m_CachedComputePSOs.EraseIf([&](const nvrhi::ComputePipelineHandle& pso) { return IsStale(pso->getDesc().CS); });
 
-                const std::string shaderDebugName = StringFormat("%s %s", binFileName.c_str(), definesStringCopy.c_str());
-                InitShaderHandle(pBinary, (uint32_t)binarySize, shaderDebugName);
-            }
-        }
-    }
+    SDL_Log("Evicted %u PSOs using %u stale shaders", numEvictedPSOs, (uint32_t)staleShaderSet.size());
 }
 
 void Graphic::InitDescriptorTables()
@@ -267,11 +323,9 @@ nvrhi::TextureHandle Graphic::GetCurrentBackBuffer()
     return m_SwapChainTextureHandles[m_GraphicRHI->GetCurrentBackBufferIndex()];
 }
 
-nvrhi::ShaderHandle Graphic::GetShader(std::string_view shaderBinName)
+nvrhi::ShaderHandle Graphic::GetShader(ShaderID shaderID)
 {
-    const size_t hash = std::hash<std::string_view>{}(shaderBinName);
-
-    auto it = m_AllShaders.find(hash);
+    auto it = m_AllShaders.find(shaderID);
     check(it != m_AllShaders.end()); // double-check Shader Bin Name
 
     return it->second;
@@ -279,28 +333,47 @@ nvrhi::ShaderHandle Graphic::GetShader(std::string_view shaderBinName)
 
 static size_t HashBindingLayoutDesc(const nvrhi::BindingLayoutDesc& layoutDesc)
 {
-    size_t layoutHash = 0;
-    for (const nvrhi::BindingLayoutItem& layoutItem : layoutDesc.bindings)
-    {
-        // just hash each layout item as a whole. it only contains PODs
-        HashCombine(layoutHash, HashRawMem(layoutItem));
-    }
-
-    return layoutHash;
+    // just hash the layout items as a whole. they only contain PODs
+    Hasher hasher;
+    hasher.Update(layoutDesc.bindings.data(), layoutDesc.bindings.size() * sizeof(nvrhi::BindingLayoutItem));
+    hasher.Update(layoutDesc.visibility);
+    hasher.Update(layoutDesc.registerSpace);
+    return (size_t)hasher.Finalize();
 }
 
 static size_t HashBindingLayoutDesc(const nvrhi::BindlessLayoutDesc& layoutDesc)
 {
-    size_t layoutHash = 0;
-    for (const nvrhi::BindingLayoutItem& layoutItem : layoutDesc.registerSpaces)
+    // just hash the layout items as a whole. they only contain PODs
+    Hasher hasher;
+    hasher.Update(layoutDesc.registerSpaces.data(), layoutDesc.registerSpaces.size() * sizeof(nvrhi::BindingLayoutItem));
+    hasher.Update(layoutDesc.visibility);
+    hasher.Update(layoutDesc.firstSlot);
+    hasher.Update(layoutDesc.maxCapacity);
+    hasher.Update(layoutDesc.layoutType);
+    return (size_t)hasher.Finalize();
+}
+
+static size_t HashBindingSetDesc(const nvrhi::BindingSetDesc& bindingSetDesc, uint32_t registerSpace)
+{
+    Hasher hasher;
+    for (const nvrhi::BindingSetItem& item : bindingSetDesc.bindings)
     {
-        // just hash each layout item as a whole. it only contains PODs
-        HashCombine(layoutHash, HashRawMem(layoutItem));
+        // bitfields copied out, the hasher needs addressable values
+        const nvrhi::ResourceType type = item.type;
+        const nvrhi::TextureDimension dimension = item.dimension;
+        const nvrhi::Format format = item.format;
+
+        hasher.Update(item.resourceHandle);
+        hasher.Update(item.slot);
+        hasher.Update(type);
+        hasher.Update(dimension);
+        hasher.Update(format);
+        hasher.Update(item.rawData[0]);
+        hasher.Update(item.rawData[1]);
     }
-
-    HashCombine(layoutHash, layoutDesc.layoutType);
-
-    return layoutHash;
+    hasher.Update(bindingSetDesc.trackLiveness);
+    hasher.Update(registerSpace);
+    return (size_t)hasher.Finalize();
 }
 
 nvrhi::BindingLayoutHandle Graphic::GetOrCreateBindingLayout(const nvrhi::BindingLayoutDesc& layoutDesc)
@@ -337,139 +410,345 @@ nvrhi::BindingLayoutHandle Graphic::GetOrCreateBindingLayout(const nvrhi::Bindle
     return bindingLayout;
 }
 
-static void HashBindingLayout(size_t& psoHash, std::span<const nvrhi::BindingLayoutHandle> bindingLayouts)
+// records are: type, shaders (debug name + binary hash), then the type's states. See 'CreatePSOFromRecord'
+void Graphic::WritePSORecordShader(PSOCacheWriter& writer, nvrhi::IShader* shader) const
+{
+    if (!shader)
+    {
+        writer.WriteString("");
+        writer.Write((uint64_t)0);
+        return;
+    }
+
+    auto it = m_ShaderBinaryHashesByShader.find(shader);
+    check(it != m_ShaderBinaryHashesByShader.end());
+
+    writer.WriteString(shader->getDesc().debugName);
+    writer.Write((uint64_t)it->second);
+}
+
+// in-memory PSO keys reference shaders, binding & input layouts by pointer: all of them are unique per binary/desc & outlive the PSOs cached with them (see 'EvictPSOs')
+// so a lookup is a few field writes & 1 hash. The string record is only built on a miss, for the PSO cache file
+static void WritePSOKeyObject(PSOCacheWriter& writer, const void* object)
+{
+    writer.Write((uint64_t)(uintptr_t)object);
+}
+
+static void WritePSOKeyBindingLayouts(PSOCacheWriter& writer, std::span<const nvrhi::BindingLayoutHandle> bindingLayouts)
+{
+    writer.Write((uint32_t)bindingLayouts.size());
+    for (nvrhi::BindingLayoutHandle bindingLayout : bindingLayouts)
+    {
+        WritePSOKeyObject(writer, bindingLayout.Get());
+    }
+}
+
+static void WritePSORecordBindingLayouts(PSOCacheWriter& writer, std::span<const nvrhi::BindingLayoutHandle> bindingLayouts)
 {
+    writer.Write((uint32_t)bindingLayouts.size());
     for (nvrhi::BindingLayoutHandle bindingLayout : bindingLayouts)
     {
         if (const nvrhi::BindlessLayoutDesc* layoutDesc = bindingLayout->getBindlessDesc())
         {
-            HashCombine(psoHash, HashBindingLayoutDesc(*layoutDesc));
+            writer.Write(true);
+            writer.Write(*layoutDesc);
         }
-
-        if (const nvrhi::BindingLayoutDesc* layoutDesc = bindingLayout->getDesc())
+        else
         {
-            HashCombine(psoHash, HashBindingLayoutDesc(*layoutDesc));
+            writer.Write(false);
+            writer.Write(*bindingLayout->getDesc());
         }
     }
 }
 
-static std::size_t HashCommonGraphicStates(
-    nvrhi::PrimitiveType primType,
-    nvrhi::ShaderHandle PS,
-    const nvrhi::RenderState& renderState,
-    const nvrhi::BindingLayoutVector& bindingLayouts,
-    nvrhi::FramebufferHandle frameBuffer
-)
+static void WritePSORecordCommonGraphicStates(PSOCacheWriter& writer, nvrhi::PrimitiveType primType, const nvrhi::RenderState& renderState, const nvrhi::FramebufferInfo& framebufferInfo)
 {
-    check(PS->getDesc().shaderType == nvrhi::ShaderType::Pixel);
+    writer.Write(primType);
+    writer.Write(renderState.blendState);
+    writer.Write(renderState.depthStencilState);
+    writer.Write(renderState.rasterState);
+    writer.Write(framebufferInfo);
+}
 
-    size_t psoHash = 0;
+nvrhi::GraphicsPipelineHandle Graphic::GetOrCreatePSO(const nvrhi::GraphicsPipelineDesc& psoDesc, nvrhi::FramebufferHandle frameBuffer)
+{
+    return GetOrCreatePSO(psoDesc, frameBuffer->getFramebufferInfo());
+}
 
-    HashCombine(psoHash, primType);
-    if (PS)
-    {
-        HashCombine(psoHash, PS->getDesc().debugName);
-    }
+nvrhi::GraphicsPipelineHandle Graphic::GetOrCreatePSO(const nvrhi::GraphicsPipelineDesc& psoDesc, const nvrhi::FramebufferInfo& framebufferInfo)
+{
+    thread_local std::vector<std::byte> tl_Key;
+    tl_Key.clear();
 
-    // for some reason, in Release builds, there's a PSO hash leak when hashing the entire RenderState struct, so we only hash the individual members
-    // did not investigate why
-    HashCombine(psoHash, std::hash<nvrhi::BlendState>()(renderState.blendState));
-    HashCombine(psoHash, HashRawMem(renderState.depthStencilState));
-    HashCombine(psoHash, HashRawMem(renderState.rasterState));
+    PSOCacheWriter keyWriter{ tl_Key };
+    keyWriter.Write(PSOType::Graphics);
+    WritePSOKeyObject(keyWriter, psoDesc.VS.Get());
+    WritePSOKeyObject(keyWriter, psoDesc.PS.Get());
+    WritePSORecordCommonGraphicStates(keyWriter, psoDesc.primType, psoDesc.renderState, framebufferInfo);
+    WritePSOKeyBindingLayouts(keyWriter, psoDesc.bindingLayouts);
+    WritePSOKeyObject(keyWriter, psoDesc.inputLayout.Get());
 
-    HashBindingLayout(psoHash, bindingLayouts);
+    const size_t psoKey = PSOCacheFile::ComputeKey(tl_Key);
 
-    const nvrhi::FramebufferDesc& frameBufferDesc = frameBuffer->getDesc();
-    for (const nvrhi::FramebufferAttachment& RT : frameBufferDesc.colorAttachments)
-    {
-        const nvrhi::TextureDesc& RTDesc = RT.texture->getDesc();
-        HashCombine(psoHash, RTDesc.format);
-    }
+    return m_CachedGraphicPSOs.FindOrCreate(psoKey, [&]
+        {
+            PROFILE_SCOPED("createGraphicsPipeline");
+            //SDL_Log("New Graphic PSO: [%zx]", psoKey);
 
-    if (frameBufferDesc.depthAttachment.valid())
-    {
-        const nvrhi::TextureDesc& DepthBufferDesc = frameBufferDesc.depthAttachment.texture->getDesc();
-        HashCombine(psoHash, DepthBufferDesc.format);
-    }
+            // input layouts are standalone objects that can't be re-created from a record, so such PSOs are not saved to disk
+            if (!psoDesc.inputLayout)
+            {
+                thread_local std::vector<std::byte> tl_Record;
+                tl_Record.clear();
+
+                PSOCacheWriter writer{ tl_Record };
+                writer.Write(PSOType::Graphics);
+                writer.Write((uint8_t)2);
+                WritePSORecordShader(writer, psoDesc.VS);
+                WritePSORecordShader(writer, psoDesc.PS);
+                WritePSORecordCommonGraphicStates(writer, psoDesc.primType, psoDesc.renderState, framebufferInfo);
+                WritePSORecordBindingLayouts(writer, psoDesc.bindingLayouts);
+                writer.Write((uint32_t)0); // no input layout
+
+                m_PSOCacheFile.Add(PSOCacheFile::ComputeKey(tl_Record), tl_Record);
+            }
+            return m_NVRHIDevice->createGraphicsPipeline(psoDesc, framebufferInfo);
+        });
+}
 
-    return psoHash;
+nvrhi::MeshletPipelineHandle Graphic::GetOrCreatePSO(const nvrhi::MeshletPipelineDesc& psoDesc, nvrhi::FramebufferHandle frameBuffer)
+{
+    return GetOrCreatePSO(psoDesc, frameBuffer->getFramebufferInfo());
 }
 
-nvrhi::GraphicsPipelineHandle Graphic::GetOrCreatePSO(const nvrhi::GraphicsPipelineDesc& psoDesc, nvrhi::FramebufferHandle frameBuffer)
+nvrhi::MeshletPipelineHandle Graphic::GetOrCreatePSO(const nvrhi::MeshletPipelineDesc& psoDesc, const nvrhi::FramebufferInfo& framebufferInfo)
 {
-    size_t psoHash = HashCommonGraphicStates(psoDesc.primType, psoDesc.PS, psoDesc.renderState, psoDesc.bindingLayouts, frameBuffer);
-    
-    if (nvrhi::InputLayoutHandle inputLayout = psoDesc.inputLayout)
+    thread_local std::vector<std::byte> tl_Key;
+    tl_Key.clear();
+
+    PSOCacheWriter keyWriter{ tl_Key };
+    keyWriter.Write(PSOType::Meshlet);
+    WritePSOKeyObject(keyWriter, psoDesc.AS.Get());
+    WritePSOKeyObject(keyWriter, psoDesc.MS.Get());
+    WritePSOKeyObject(keyWriter, psoDesc.PS.Get());
+    WritePSORecordCommonGraphicStates(keyWriter, psoDesc.primType, psoDesc.renderState, framebufferInfo);
+    WritePSOKeyBindingLayouts(keyWriter, psoDesc.bindingLayouts);
+
+    const size_t psoKey = PSOCacheFile::ComputeKey(tl_Key);
+
+    return m_CachedMeshletPSOs.FindOrCreate(psoKey, [&]
+        {
+            PROFILE_SCOPED("createMeshletPipeline");
+            //SDL_Log("New Meshlet PSO: [%zx]", psoKey);
+
+            thread_local std::vector<std::byte> tl_Record;
+            tl_Record.clear();
+
+            PSOCacheWriter writer{ tl_Record };
+            writer.Write(PSOType::Meshlet);
+            writer.Write((uint8_t)3);
+            WritePSORecordShader(writer, psoDesc.AS);
+            WritePSORecordShader(writer, psoDesc.MS);
+            WritePSORecordShader(writer, psoDesc.PS);
+            WritePSORecordCommonGraphicStates(writer, psoDesc.primType, psoDesc.renderState, framebufferInfo);
+            WritePSORecordBindingLayouts(writer, psoDesc.bindingLayouts);
+
+            m_PSOCacheFile.Add(PSOCacheFile::ComputeKey(tl_Record), tl_Record);
+            return m_NVRHIDevice->createMeshletPipeline(psoDesc, framebufferInfo);
+        });
+}
+
+nvrhi::ComputePipelineHandle Graphic::GetOrCreatePSO(const nvrhi::ComputePipelineDesc& psoDesc)
+{
+    thread_local std::vector<std::byte> tl_Key;
+    tl_Key.clear();
+
+    PSOCacheWriter keyWriter{ tl_Key };
+    keyWriter.Write(PSOType::Compute);
+    WritePSOKeyObject(keyWriter, psoDesc.CS.Get());
+    WritePSOKeyBindingLayouts(keyWriter, psoDesc.bindingLayouts);
+
+    const size_t psoKey = PSOCacheFile::ComputeKey(tl_Key);
+
+    return m_CachedComputePSOs.FindOrCreate(psoKey, [&]
+        {
+            PROFILE_SCOPED("createComputePipeline");
+            //SDL_Log("New Compute PSO: [%zx]", psoKey);
+
+            thread_local std::vector<std::byte> tl_Record;
+            tl_Record.clear();
+
+            PSOCacheWriter writer{ tl_Record };
+            writer.Write(PSOType::Compute);
+            writer.Write((uint8_t)1);
+            WritePSORecordShader(writer, psoDesc.CS);
+            WritePSORecordBindingLayouts(writer, psoDesc.bindingLayouts);
+
+            m_PSOCacheFile.Add(PSOCacheFile::ComputeKey(tl_Record), tl_Record);
+            return m_NVRHIDevice->createComputePipeline(psoDesc);
+        });
+}
+
+bool Graphic::IsPSORecordValid(std::span<const std::byte> record) const
+{
+    PSOCacheReader reader{ record };
+    reader.Read<PSOType>();
+
+    const uint8_t numShaders = reader.Read<uint8_t>();
+    for (uint8_t i = 0; i < numShaders; ++i)
     {
-        for (uint32_t i = 0; i < inputLayout->getNumAttributes(); ++i)
+        const std::string shaderName = reader.ReadString();
+        const uint64_t binaryHash = reader.Read<uint64_t>();
+
+        if (shaderName.empty())
         {
-            const nvrhi::VertexAttributeDesc* desc = inputLayout->getAttributeDesc(i);
+            continue;
+        }
 
-            // simply hash only each vertex format for now. others are not so important to be unique enough
-            HashCombine(psoHash, desc->format);
+        // shader removed or recompiled
+        auto it = m_ShaderBinaryHashes.find(ShaderID{ shaderName });
+        if ((it == m_ShaderBinaryHashes.end()) || (it->second != binaryHash))
+        {
+            return false;
         }
     }
 
-    HashCombine(psoHash, psoDesc.VS->getDesc().debugName);
+    return !reader.HasError();
+}
+
+void Graphic::CreatePSOFromRecord(std::span<const std::byte> record)
+{
+    PROFILE_FUNCTION();
+
+    PSOCacheReader reader{ record };
 
-    static std::mutex s_CachedGraphicPSOsLock;
-    AUTO_LOCK(s_CachedGraphicPSOsLock);
+    const PSOType psoType = reader.Read<PSOType>();
+    const uint8_t numShaders = reader.Read<uint8_t>();
 
-    nvrhi::GraphicsPipelineHandle& graphicsPipeline = m_CachedGraphicPSOs[psoHash];
-    if (!graphicsPipeline)
+    nvrhi::ShaderHandle shaders[3];
+    for (uint8_t i = 0; i < numShaders && i < std::size(shaders); ++i)
     {
-        PROFILE_SCOPED("createGraphicsPipeline");
-        //SDL_Log("New Graphic PSO: [%zx]", psoHash);
-        graphicsPipeline = m_NVRHIDevice->createGraphicsPipeline(psoDesc, frameBuffer->getFramebufferInfo());
+        const std::string shaderName = reader.ReadString();
+        reader.Read<uint64_t>();
+
+        if (!shaderName.empty())
+        {
+            shaders[i] = GetShader(ShaderID{ shaderName });
+        }
     }
-    return graphicsPipeline;
-}
 
-nvrhi::MeshletPipelineHandle Graphic::GetOrCreatePSO(const nvrhi::MeshletPipelineDesc& psoDesc, nvrhi::FramebufferHandle frameBuffer)
-{
-    size_t psoHash = HashCommonGraphicStates(psoDesc.primType, psoDesc.PS, psoDesc.renderState, psoDesc.bindingLayouts, frameBuffer);
+    nvrhi::PrimitiveType primType{};
+    nvrhi::RenderState renderState;
+    nvrhi::FramebufferInfo framebufferInfo;
+    if (psoType != PSOType::Compute)
+    {
+        primType = reader.Read<nvrhi::PrimitiveType>();
+        reader.Read(renderState.blendState);
+        reader.Read(renderState.depthStencilState);
+        reader.Read(renderState.rasterState);
+        reader.Read(framebufferInfo);
+    }
 
-	if (psoDesc.AS)
-	{
-		HashCombine(psoHash, psoDesc.AS->getDesc().debugName);
-	}
+    nvrhi::BindingLayoutVector bindingLayouts;
+    const uint32_t numBindingLayouts = reader.Read<uint32_t>();
+    for (uint32_t i = 0; i < numBindingLayouts && i < nvrhi::c_MaxBindingLayouts && !reader.HasError(); ++i)
+    {
+        if (reader.Read<bool>())
+        {
+            nvrhi::BindlessLayoutDesc layoutDesc;
+            reader.Read(layoutDesc);
+            bindingLayouts.push_back(GetOrCreateBindingLayout(layoutDesc));
+        }
+        else
+        {
+            nvrhi::BindingLayoutDesc layoutDesc;
+            reader.Read(layoutDesc);
+            bindingLayouts.push_back(GetOrCreateBindingLayout(layoutDesc));
+        }
+    }
 
-	HashCombine(psoHash, psoDesc.MS->getDesc().debugName);
+    if (psoType == PSOType::Graphics)
+    {
+        // only PSOs without input layouts are saved
+        verify(reader.Read<uint32_t>() == 0);
+    }
 
-    static std::mutex s_CachedMeshletPSOsLock;
-    AUTO_LOCK(s_CachedMeshletPSOsLock);
+    if (reader.HasError() || !reader.IsAtEnd())
+    {
+        SDL_Log("Corrupted PSO cache record");
+        return;
+    }
 
-    nvrhi::MeshletPipelineHandle& pipeline = m_CachedMeshletPSOs[psoHash];
-    if (!pipeline)
+    switch (psoType)
+    {
+    case PSOType::Graphics:
+    {
+        nvrhi::GraphicsPipelineDesc psoDesc;
+        psoDesc.VS = shaders[0];
+        psoDesc.PS = shaders[1];
+        psoDesc.primType = primType;
+        psoDesc.renderState = renderState;
+        psoDesc.bindingLayouts = bindingLayouts;
+        (void)GetOrCreatePSO(psoDesc, framebufferInfo);
+        break;
+    }
+    case PSOType::Meshlet:
     {
-        PROFILE_SCOPED("createMeshletPipeline");
-        //SDL_Log("New Meshlet PSO: [%zx]", psoHash);
-        pipeline = m_NVRHIDevice->createMeshletPipeline(psoDesc, frameBuffer->getFramebufferInfo());
+        nvrhi::MeshletPipelineDesc psoDesc;
+        psoDesc.AS = shaders[0];
+        psoDesc.MS = shaders[1];
+        psoDesc.PS = shaders[2];
+        psoDesc.primType = primType;
+        psoDesc.renderState = renderState;
+        psoDesc.bindingLayouts = bindingLayouts;
+        (void)GetOrCreatePSO(psoDesc, framebufferInfo);
+        break;
+    }
+    case PSOType::Compute:
+    {
+        nvrhi::ComputePipelineDesc psoDesc;
+        psoDesc.CS = shaders[0];
+        psoDesc.bindingLayouts = bindingLayouts;
+        (void)GetOrCreatePSO(psoDesc);
+        break;
+    }
     }
-    return pipeline;
 }
 
-nvrhi::ComputePipelineHandle Graphic::GetOrCreatePSO(const nvrhi::ComputePipelineDesc& psoDesc)
+void Graphic::PrewarmPSOs()
 {
-    size_t psoHash = 0;
+    PROFILE_FUNCTION();
 
-    // hash CS. just hash its debug name... assume all Shaders have unique debug names
-    HashCombine(psoHash, psoDesc.CS->getDesc().debugName);
+    const std::string psoCacheFilePath = (std::filesystem::path{ GetExecutableDirectory() } / kPSOCacheFileName).string();
+    if (!m_PSOCacheFile.Load(psoCacheFilePath))
+    {
+        SDL_Log("No valid PSO cache at: %s", psoCacheFilePath.c_str());
+        return;
+    }
 
-    // hash binding layout
-    HashBindingLayout(psoHash, psoDesc.bindingLayouts);
+    const uint32_t numInvalidRecords = m_PSOCacheFile.RemoveInvalid([this](std::span<const std::byte> record) { return IsPSORecordValid(record); });
 
-    static std::mutex s_CachedComputePSOsLock;
-    AUTO_LOCK(s_CachedComputePSOsLock);
+    // NOTE: copy of the records, as PSOs created during the pre-warm add their records to the file
+    m_PSOPrewarmRecords = m_PSOCacheFile.GetRecords();
+    SDL_Log("Pre-warming %u PSOs, %u invalidated by shader changes", (uint32_t)m_PSOPrewarmRecords.size(), numInvalidRecords);
 
-    nvrhi::ComputePipelineHandle& computePipeline = m_CachedComputePSOs[psoHash];
-    if (!computePipeline)
+    m_PSOPrewarmTaskflow.clear();
+    for (const std::vector<std::byte>& record : m_PSOPrewarmRecords)
+    {
+        m_PSOPrewarmTaskflow.emplace([this, &record] { CreatePSOFromRecord(record); });
+    }
+
+    // in the background. Passes that need a PSO before it's pre-warmed simply create it themselves
+    m_PSOPrewarmFuture = g_Engine.m_Executor->run(m_PSOPrewarmTaskflow);
+}
+
+void Graphic::WaitForPSOPrewarm()
+{
+    if (m_PSOPrewarmFuture.valid())
     {
-        PROFILE_SCOPED("createComputePipeline");
-        //SDL_Log("New Compute PSO: [%zx]", psoHash);
-        computePipeline = m_NVRHIDevice->createComputePipeline(psoDesc);
+        PROFILE_FUNCTION();
+        m_PSOPrewarmFuture.wait();
     }
-    return computePipeline;
 }
 
 nvrhi::IDescriptorTable* Graphic::GetSrvUavCbvDescriptorTable()
@@ -513,52 +792,171 @@ void Graphic::CreateBindingSetAndLayout(const nvrhi::BindingSetDesc& bindingSetD
     outLayoutHandle = GetOrCreateBindingLayout(layoutDesc);
     check(outLayoutHandle);
 
-    outBindingSetHandle = m_NVRHIDevice->createBindingSet(bindingSetDesc, outLayoutHandle);
+    // sets that don't keep their resources alive can't be keyed by resource pointers: a pointer may be re-used by a new resource
+    if (!bindingSetDesc.trackLiveness)
+    {
+        outBindingSetHandle = m_NVRHIDevice->createBindingSet(bindingSetDesc, outLayoutHandle);
+        check(outBindingSetHandle);
+        return;
+    }
+
+    // the layout is derived from the set items & the register space, so no need to hash it separately
+    const size_t bindingSetHash = HashBindingSetDesc(bindingSetDesc, registerSpace);
+
+    AUTO_LOCK(m_CachedBindingSetsLock);
+
+    // NOTE: a hash collision simply replaces the older set
+    CachedBindingSet& cachedBindingSet = m_CachedBindingSets[bindingSetHash];
+    if (!cachedBindingSet.m_BindingSet || (cachedBindingSet.m_Desc != bindingSetDesc) || (cachedBindingSet.m_RegisterSpace != registerSpace))
+    {
+        PROFILE_SCOPED("createBindingSet");
+
+        cachedBindingSet.m_Desc = bindingSetDesc;
+        cachedBindingSet.m_RegisterSpace = registerSpace;
+        cachedBindingSet.m_BindingSet = m_NVRHIDevice->createBindingSet(bindingSetDesc, outLayoutHandle);
+        ++m_NumBindingSetCacheMisses;
+    }
+    else
+    {
+        ++m_NumBindingSetCacheHits;
+    }
+    cachedBindingSet.m_LastUsedFrame = m_FrameCounter;
+
+    outBindingSetHandle = cachedBindingSet.m_BindingSet;
     check(outBindingSetHandle);
 }
 
-nvrhi::CommandListHandle Graphic::AllocateCommandList(nvrhi::CommandQueue queueType)
+void Graphic::InvalidateCachedBindingSets(nvrhi::IResource* resource)
 {
-    PROFILE_FUNCTION();
+    AUTO_LOCK(m_CachedBindingSetsLock);
+    m_BindingSetResourcesToInvalidate.push_back(resource);
+}
 
-    const uint32_t queueIdx = (uint32_t)queueType;
+uint32_t Graphic::CreateVolatileConstantBuffer(uint32_t byteSize, const char* debugName)
+{
+    AUTO_LOCK(m_VolatileConstantBuffersLock);
 
-    nvrhi::CommandListHandle ret;
+    if (m_NumVolatileConstantBuffers == kMaxVolatileConstantBuffers)
+    {
+        SDL_Log("Out of volatile constant buffers! Increase 'kMaxVolatileConstantBuffers'");
+        check(0);
+        std::abort();
+    }
+
+    const uint32_t bufferIdx = m_NumVolatileConstantBuffers++;
+    m_VolatileConstantBuffers[bufferIdx] = m_NVRHIDevice->createBuffer(nvrhi::utils::CreateVolatileConstantBufferDesc(byteSize, debugName, 1));
+
+    return bufferIdx;
+}
+
+static nvrhi::BufferDesc CreateUploadBufferDesc(uint64_t byteSize, const char* debugName)
+{
+    nvrhi::BufferDesc desc;
+    desc.byteSize = byteSize;
+    desc.debugName = debugName;
+    desc.cpuAccess = nvrhi::CpuAccessMode::Write;
+    desc.isConstantBuffer = true;
+    desc.isVertexBuffer = true;
+    desc.isIndexBuffer = true;
+    desc.canHaveRawViews = true;
+    desc.initialState = nvrhi::ResourceStates::ConstantBuffer | nvrhi::ResourceStates::ShaderResource | nvrhi::ResourceStates::VertexBuffer | nvrhi::ResourceStates::IndexBuffer | nvrhi::ResourceStates::CopySource;
+    desc.keepInitialState = true;
+
+    return desc;
+}
 
+UploadAllocation Graphic::AllocateUpload(uint64_t size, uint64_t alignment)
+{
+    check(size > 0);
+
+    struct UploadPage
     {
-        AUTO_LOCK(m_FreeCommandListsLock);
+        uint64_t m_FrameIdx = UINT64_MAX;
+        uint64_t m_Offset = 0;
+        uint64_t m_End = 0;
+    };
 
-        if (m_FreeCommandLists[queueIdx].empty())
-        {
-            nvrhi::CommandListParameters params;
-            params.enableImmediateExecution = false; // always enable parallel executions
-            params.queueType = queueType;
+    // NOTE: a page only serves the frame it was grabbed in, as the ring recycles memory per frame. The rest of an older page is wasted
+    thread_local UploadPage tl_UploadPage;
+
+    const uint64_t frameIdx = m_FrameRing.GetFrameIdx();
+    uint64_t offset = RingAllocator::kInvalidOffset;
 
-            ret = m_NVRHIDevice->createCommandList(params);
+    const uint64_t alignedPageOffset = AlignUp(tl_UploadPage.m_Offset, alignment);
+    if ((tl_UploadPage.m_FrameIdx == frameIdx) && (alignedPageOffset + size <= tl_UploadPage.m_End))
+    {
+        offset = alignedPageOffset;
+        tl_UploadPage.m_Offset = alignedPageOffset + size;
+    }
+    else
+    {
+        AUTO_LOCK(m_UploadRingLock);
 
-            m_AllCommandLists[queueIdx].push_back(ret);
+        // big allocations go straight to the ring, so that they don't waste the rest of a page
+        if ((size > kUploadPageSize / 4) || (alignment > kConstantBufferAlignment))
+        {
+            offset = m_UploadRing.Allocate(size, alignment);
         }
         else
         {
-            // Reuse the "oldest" from the free list
-            ret = m_FreeCommandLists[queueIdx].front();
-            m_FreeCommandLists[queueIdx].pop_front();
+            const uint64_t pageOffset = m_UploadRing.Allocate(kUploadPageSize, kConstantBufferAlignment);
+            if (pageOffset != RingAllocator::kInvalidOffset)
+            {
+                offset = AlignUp(pageOffset, alignment);
+                tl_UploadPage = UploadPage{ frameIdx, offset + size, pageOffset + kUploadPageSize };
+            }
         }
     }
 
-    // auto free next frame
-    g_Engine.AddCommand([ret, this] { FreeCommandList(ret); });
+    if (offset == RingAllocator::kInvalidOffset)
+    {
+        // ring is full: fall back to a dedicated buffer that lives until the frame retires
+        if (m_NumUploadRingOverflows++ == 0)
+        {
+            SDL_Log("Upload Ring is full! Falling back to dedicated upload buffers. Increase '-uploadringsizemb'");
+        }
+
+        UploadAllocation allocation;
+        allocation.m_Buffer = m_NVRHIDevice->createBuffer(CreateUploadBufferDesc(size, "Upload Ring Overflow"));
+        allocation.m_Size = size;
+        allocation.m_CPUAddress = m_NVRHIDevice->mapBuffer(allocation.m_Buffer, nvrhi::CpuAccessMode::Write);
+        DeferRelease(allocation.m_Buffer);
+
+        return allocation;
+    }
 
-    return ret;
+    return UploadAllocation{ m_UploadRingBuffer, offset, size, m_UploadRingCPUAddress + offset };
 }
 
-void Graphic::FreeCommandList(nvrhi::CommandListHandle cmdList)
+nvrhi::CommandListHandle Graphic::AllocateCommandList(nvrhi::CommandQueue queueType)
 {
-    STATIC_MULTITHREAD_DETECTOR();
+    PROFILE_FUNCTION();
 
-    // TODO: use fences to guard these command lists from being used again before the GPU is done with them if needed
+    // NOTE: no locks. The pool is only touched by this thread & the retired frame count is atomic
+    FencedPool<nvrhi::CommandListHandle>& pool = GetCommandListPoolForCurrentThread()[(uint32_t)queueType];
 
-    m_FreeCommandLists[(uint32_t)cmdList->getDesc().queueType].push_back(cmdList);
+    return pool.Allocate(m_FrameRing.GetFrameIdx(), m_FrameRing.GetNumRetiredFrames(), [this, queueType]
+        {
+            nvrhi::CommandListParameters params;
+            params.enableImmediateExecution = false; // always enable parallel executions
+            params.queueType = queueType;
+
+            return m_NVRHIDevice->createCommandList(params);
+        });
+}
+
+Graphic::CommandListPool& Graphic::GetCommandListPoolForCurrentThread()
+{
+    thread_local CommandListPool* tl_CommandListPool = nullptr;
+
+    // 1st allocation on this thread
+    if (!tl_CommandListPool)
+    {
+        AUTO_LOCK(m_CommandListPoolsLock);
+        tl_CommandListPool = m_CommandListPools.emplace_back(std::make_unique<CommandListPool>()).get();
+    }
+
+    return *tl_CommandListPool;
 }
 
 MicroProfileThreadLogGpu*& Graphic::GetGPULogForCurrentThread()
@@ -644,6 +1042,8 @@ void Graphic::Initialize()
 
     // execute all cmd lists that was created & populated during init phase
     ExecuteAllCommandLists();
+
+    PrewarmPSOs();
 }
 
 void Graphic::PostSceneLoad()
@@ -666,6 +1066,19 @@ void Graphic::Shutdown()
     // wait for latest swap chain present to be done
     verify(m_NVRHIDevice->waitForIdle());
 
+    m_FrameRing.Shutdown();
+
+    WaitForPSOPrewarm();
+    m_PSOCacheFile.Save((std::filesystem::path{ GetExecutableDirectory() } / kPSOCacheFileName).string());
+    SDL_Log("PSO cache saved: %u PSOs", m_PSOCacheFile.GetNumRecords());
+
+    SDL_Log("Upload Ring: peak usage %.1f MB of %.1f MB, %u overflows",
+        BYTES_TO_MB(m_UploadRing.GetPeakUsedSize()), BYTES_TO_MB(m_UploadRing.GetCapacity()), m_NumUploadRingOverflows.load());
+
+    m_NVRHIDevice->unmapBuffer(m_UploadRingBuffer);
+    m_UploadRingBuffer.Reset();
+    m_UploadRingCPUAddress = nullptr;
+
     m_Scene->Shutdown();
     m_Scene.reset();
 
@@ -673,10 +1086,17 @@ void Graphic::Shutdown()
     m_TextureFeedbackManager.reset();
 
     m_AllShaders.clear();
-    m_CachedGraphicPSOs.clear();
-    m_CachedMeshletPSOs.clear();
-    m_CachedComputePSOs.clear();
+    m_ShaderBinaryHashes.clear();
+    m_ShaderBinaryHashesByShader.clear();
+    m_CachedGraphicPSOs.Clear();
+    m_CachedMeshletPSOs.Clear();
+    m_CachedComputePSOs.Clear();
     m_CachedBindingLayouts.clear();
+    m_CachedBindingSets.clear();
+    for (nvrhi::BufferHandle& buffer : m_VolatileConstantBuffers)
+    {
+        buffer = nullptr;
+    }
 
     // manually call destructor for all Renderers as they may hold resource handles
     for (IRenderer* renderer : IRenderer::ms_AllRenderers)
@@ -686,10 +1106,13 @@ void Graphic::Shutdown()
 
     m_CommonResources.reset();
 
-    for (uint32_t i = 0; i < (uint32_t)nvrhi::CommandQueue::Count; i++)
+    // NOTE: dont free the pools themselves, threads still point to them
+    for (std::unique_ptr<CommandListPool>& commandListPool : m_CommandListPools)
     {
-        m_AllCommandLists[i].clear();
-		m_FreeCommandLists[i].clear();
+        for (FencedPool<nvrhi::CommandListHandle>& pool : *commandListPool)
+        {
+            pool.Clear();
+        }
     }
 
     // Make sure that all frames have finished rendering & garbage collect
@@ -709,18 +1132,18 @@ void Graphic::Update()
 
         SDL_Log("Reloading all Shaders...");
 
-        verify(m_NVRHIDevice->waitForIdle());
-        m_NVRHIDevice->runGarbageCollection();
-
-        m_CachedGraphicPSOs.clear();
-        m_CachedMeshletPSOs.clear();
-        m_CachedComputePSOs.clear();
+        // NOTE: no need to wait for the GPU. Only changed shaders are replaced & only the PSOs using them are evicted. Frames in flight hold references to what they use
+        // pre-warm tasks read the shader map though
+        WaitForPSOPrewarm();
 
         // run as a task due to the usage of "corun" in the InitShaders function
         tf::Taskflow tf;
         tf.emplace([this] { InitShaders(); });
         g_Engine.m_Executor->corun(tf);
 
+        // records of recompiled shaders are stale
+        m_PSOCacheFile.RemoveInvalid([this](std::span<const std::byte> record) { return IsPSORecordValid(record); });
+
         m_bTriggerReloadShaders = false;
     }
     
@@ -737,6 +1160,41 @@ void Graphic::Update()
 
     ++m_FrameCounter;
 
+    // wait for the GPU frame that used this frame slot. Everything written/read back by the CPU per frame slot is safe to touch after this
+    m_FrameRing.BeginFrame();
+
+    // recycle the upload memory of every frame the GPU is done with
+    {
+        AUTO_LOCK(m_UploadRingLock);
+        m_UploadRing.RetireFrames(m_FrameRing.GetNumRetiredFrames());
+    }
+
+    // recycle the bindless descriptors released by every frame the GPU is done with
+    m_SrvUavCbvDescriptorTableManager->RetireFrames(m_FrameRing.GetNumRetiredFrames());
+    MICROPROFILE_COUNTER_SET("Graphic/BindlessDescriptors/Allocated", m_SrvUavCbvDescriptorTableManager->GetNumAllocated());
+    MICROPROFILE_COUNTER_SET("Graphic/BindlessDescriptors/Capacity", m_SrvUavCbvDescriptorTableManager->GetCapacity());
+
+    // drop binding sets that reference invalidated resources or were not requested recently
+    // NOTE: command lists in flight hold their own references to the sets they bind
+    {
+        PROFILE_SCOPED("Evict Binding Sets");
+        AUTO_LOCK(m_CachedBindingSetsLock);
+
+        std::sort(m_BindingSetResourcesToInvalidate.begin(), m_BindingSetResourcesToInvalidate.end());
+        auto IsInvalidated = [this](const nvrhi::BindingSetItem& item) { return std::binary_search(m_BindingSetResourcesToInvalidate.begin(), m_BindingSetResourcesToInvalidate.end(), item.resourceHandle); };
+
+        std::erase_if(m_CachedBindingSets, [&](const auto& it)
+            {
+                return (m_FrameCounter - it.second.m_LastUsedFrame > kMaxUnusedBindingSetFrames) ||
+                    (!m_BindingSetResourcesToInvalidate.empty() && std::ranges::any_of(it.second.m_Desc.bindings, IsInvalidated));
+            });
+        m_BindingSetResourcesToInvalidate.clear();
+
+        MICROPROFILE_COUNTER_SET("Graphic/BindingSetCache/Hits", m_NumBindingSetCacheHits.exchange(0));
+        MICROPROFILE_COUNTER_SET("Graphic/BindingSetCache/Misses", m_NumBindingSetCacheMisses.exchange(0));
+        MICROPROFILE_COUNTER_SET("Graphic/BindingSetCache/Entries", m_CachedBindingSets.size());
+    }
+
     // execute all cmd lists that may have been potentially added as engine commands
     ExecuteAllCommandLists();
 
@@ -744,15 +1202,15 @@ void Graphic::Update()
 
     {
         PROFILE_SCOPED("getTimerQueryTime");
-        g_Engine.m_GPUTimeMs = Timer::SecondsToMilliSeconds(m_NVRHIDevice->getTimerQueryTime(m_FrameTimerQuery[m_FrameCounter % 2]));
+        g_Engine.m_GPUTimeMs = Timer::SecondsToMilliSeconds(m_NVRHIDevice->getTimerQueryTime(m_FrameTimerQuery[GetFrameSlot()]));
     }
 
     {
         nvrhi::CommandListHandle commandList = AllocateCommandList();
         SCOPED_COMMAND_LIST_AUTO_QUEUE(commandList, "Begin Frame Timer Query");
 
-        g_Graphic.m_NVRHIDevice->resetTimerQuery(m_FrameTimerQuery[m_FrameCounter % 2]);
-        commandList->beginTimerQuery(m_FrameTimerQuery[m_FrameCounter % 2]);
+        g_Graphic.m_NVRHIDevice->resetTimerQuery(m_FrameTimerQuery[GetFrameSlot()]);
+        commandList->beginTimerQuery(m_FrameTimerQuery[GetFrameSlot()]);
     }
 
     tf::Taskflow tf;
@@ -771,7 +1229,7 @@ void Graphic::Update()
     {
         nvrhi::CommandListHandle commandList = AllocateCommandList();
         SCOPED_COMMAND_LIST_AUTO_QUEUE(commandList, "End Frame Timer Query");
-        commandList->endTimerQuery(m_FrameTimerQuery[m_FrameCounter % 2]);
+        commandList->endTimerQuery(m_FrameTimerQuery[GetFrameSlot()]);
     }
 
     m_GraphicUpdateTimerMs = updateTimer.GetElapsedMilliseconds();
@@ -781,6 +1239,13 @@ void Graphic::Update()
 
     // finally, present swap chain
     m_GraphicRHI->SwapChainPresent();
+
+    {
+        AUTO_LOCK(m_UploadRingLock);
+        m_UploadRing.FinishFrame(m_FrameRing.GetFrameIdx());
+    }
+
+    m_FrameRing.EndFrame();
 }
 
 void Graphic::ExecuteAllCommandLists()
@@ -801,11 +1266,6 @@ void Graphic::ExecuteAllCommandLists()
             cmdList->m_GPULog = ULLONG_MAX;
         }
 
-        {
-            PROFILE_SCOPED("Wait for previous GPU Frame");
-            verify(m_NVRHIDevice->waitForIdle());
-        }
-
         if (g_ExecutePerCommandList.Get() || g_ExecuteAndWaitPerCommandList.Get())
         {
             for (nvrhi::CommandListHandle cmdList : m_PendingCommandLists)
@@ -840,7 +1300,10 @@ void Graphic::AddFullScreenPass(const FullScreenPassParams& fullScreenPassParams
     const size_t pushConstantsBytes = fullScreenPassParams.m_PushConstantsBytes;
 
     PROFILE_FUNCTION();
-    PROFILE_GPU_SCOPED(commandList, fullScreenPassParams.m_ShaderName.data());
+
+    // profiled under the shader's name, w/o hashing it again
+    nvrhi::ShaderHandle pixelShader = GetShader(fullScreenPassParams.m_ShaderID);
+    PROFILE_GPU_SCOPED_HASHED(commandList, pixelShader->getDesc().debugName.c_str(), fullScreenPassParams.m_ShaderID.m_Hash);
 
     nvrhi::BlendState blendState;
     blendState.targets[0] = blendStateIn ? *blendStateIn : g_CommonResources.BlendOpaque;
@@ -854,7 +1317,7 @@ void Graphic::AddFullScreenPass(const FullScreenPassParams& fullScreenPassParams
     // PSO
     nvrhi::MeshletPipelineDesc PSODesc;
     PSODesc.MS = GetShader("fullscreen_MS_FullScreenTriangle");
-    PSODesc.PS = GetShader(fullScreenPassParams.m_ShaderName);
+    PSODesc.PS = pixelShader;
     PSODesc.renderState = nvrhi::RenderState{ blendState, depthStencilState, g_CommonResources.CullNone };
     PSODesc.bindingLayouts.push_back(bindingLayout);
     
@@ -893,17 +1356,19 @@ void Graphic::AddFullScreenPass(const FullScreenPassParams& fullScreenPassParams
 void Graphic::AddComputePass(const ComputePassParams& computePassParams)
 {
     check(computePassParams.m_CommandList);
-    check(!computePassParams.m_ShaderName.empty());
+    check(computePassParams.m_ShaderID.IsValid());
 
     PROFILE_FUNCTION();
-    PROFILE_GPU_SCOPED(computePassParams.m_CommandList, computePassParams.m_ShaderName.data());
+
+    nvrhi::ShaderHandle computeShader = GetShader(computePassParams.m_ShaderID);
+    PROFILE_GPU_SCOPED_HASHED(computePassParams.m_CommandList, computeShader->getDesc().debugName.c_str(), computePassParams.m_ShaderID.m_Hash);
 
     nvrhi::BindingSetHandle bindingSet;
     nvrhi::BindingLayoutHandle bindingLayout;
     g_Graphic.CreateBindingSetAndLayout(computePassParams.m_BindingSetDesc, bindingSet, bindingLayout);
 
     nvrhi::ComputePipelineDesc pipelineDesc;
-    pipelineDesc.CS = GetShader(computePassParams.m_ShaderName);
+    pipelineDesc.CS = computeShader;
     pipelineDesc.bindingLayouts.push_back(bindingLayout);
 
     for (nvrhi::BindingLayoutHandle extraBindingLayout : computePassParams.m_ExtraBindingLayouts)
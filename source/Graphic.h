@@ -7,13 +7,20 @@
 
 #include "DescriptorTableManager.h"
 #include "Engine.h"
+#include "FencedPool.h"
+#include "FrameRing.h"
 #include "GraphicConstants.h"
 #include "MathUtilities.h"
+#include "PSOCache.h"
+#include "Renderer.h"
+#include "RingAllocator.h"
+#include "ShaderID.h"
 #include "Utilities.h"
 #include "Visual.h"
 
 class CommonResources;
 class RenderGraph;
+class RenderGraphBackend;
 class Scene;
 class TextureFeedbackManager;
 struct MaterialData;
@@ -36,11 +43,24 @@ public:
     virtual void SetRHIObjectDebugName(nvrhi::ResourceHandle resource, std::string_view debugName) = 0;
 };
 
+// Sub-range of a CPU-writable upload buffer. Valid until the frame it was allocated in has retired on the GPU
+struct UploadAllocation
+{
+    nvrhi::BufferHandle m_Buffer;
+    uint64_t m_Offset = 0;
+    uint64_t m_Size = 0;
+    void* m_CPUAddress = nullptr;
+
+    nvrhi::BufferRange GetRange() const { return nvrhi::BufferRange{ m_Offset, m_Size }; }
+};
+
 class Graphic
 {
 public:
     SingletonFunctionsSimple(Graphic);
 
+    using CommandListPool = std::array<FencedPool<nvrhi::CommandListHandle>, (uint32_t)nvrhi::CommandQueue::Count>;
+
     void Initialize();
     void PostSceneLoad();
     void Shutdown();
@@ -51,39 +71,82 @@ public:
     void InitDescriptorTables();
     
     [[nodiscard]] nvrhi::TextureHandle GetCurrentBackBuffer();
-    [[nodiscard]] nvrhi::ShaderHandle GetShader(std::string_view shaderBinName);
+    [[nodiscard]] nvrhi::ShaderHandle GetShader(ShaderID shaderID);
     [[nodiscard]] nvrhi::BindingLayoutHandle GetOrCreateBindingLayout(const nvrhi::BindingLayoutDesc& layoutDesc);
     [[nodiscard]] nvrhi::BindingLayoutHandle GetOrCreateBindingLayout(const nvrhi::BindlessLayoutDesc& layoutDesc);
     [[nodiscard]] nvrhi::GraphicsPipelineHandle GetOrCreatePSO(const nvrhi::GraphicsPipelineDesc& psoDesc, nvrhi::FramebufferHandle frameBuffer);
     [[nodiscard]] nvrhi::MeshletPipelineHandle GetOrCreatePSO(const nvrhi::MeshletPipelineDesc& psoDesc, nvrhi::FramebufferHandle frameBuffer);
     [[nodiscard]] nvrhi::ComputePipelineHandle GetOrCreatePSO(const nvrhi::ComputePipelineDesc& psoDesc);
+    [[nodiscard]] nvrhi::GraphicsPipelineHandle GetOrCreatePSO(const nvrhi::GraphicsPipelineDesc& psoDesc, const nvrhi::FramebufferInfo& framebufferInfo);
+    [[nodiscard]] nvrhi::MeshletPipelineHandle GetOrCreatePSO(const nvrhi::MeshletPipelineDesc& psoDesc, const nvrhi::FramebufferInfo& framebufferInfo);
 
     nvrhi::IDescriptorTable* GetSrvUavCbvDescriptorTable();
     uint32_t GetIndexInHeap(uint32_t indexInTable) const;
 
+    // binding sets are cached by the contents of their desc. Thread safe
+    // NOTE: per-frame constants must be bound with 'WriteConstantBuffer', so that the desc of a pass is the same every frame
     void CreateBindingSetAndLayout(const nvrhi::BindingSetDesc& bindingSetDesc, nvrhi::BindingSetHandle& outBindingSetHandle, nvrhi::BindingLayoutHandle& outLayoutHandle, uint32_t registerSpace = 0);
 
+    // cached binding sets keep the resources they reference alive & are keyed by their pointers, so a set can never be handed out for a different resource at the same address
+    // call when a resource that may be referenced by a binding set is released, so that the sets referencing it are dropped at the start of the next frame & don't keep it alive. Thread safe
+    void InvalidateCachedBindingSets(nvrhi::IResource* resource);
+
+    // linear sub-allocation from the per-frame upload ring. Thread safe, lock-free unless the calling thread's current page is exhausted
+    [[nodiscard]] UploadAllocation AllocateUpload(uint64_t size, uint64_t alignment);
+
+    // per-frame constants, written into the 1 persistent volatile buffer of 'T', created on first use. Bind with 'nvrhi::BindingSetItem::ConstantBuffer(slot, buffer)' before writing it again on the same command list
+    // the data lives in the upload memory of the command list & is bound as a root CBV, so binding sets that reference the buffer don't change across frames & stay cached
+    // NOTE: not in the upload ring: a ring range is baked into the descriptor of the set, which would then change every frame
     template <typename T>
-    [[nodiscard]] nvrhi::BufferHandle CreateConstantBuffer(nvrhi::CommandListHandle commandList, const T& srcData)
+    [[nodiscard]] nvrhi::BufferHandle WriteConstantBuffer(nvrhi::ICommandList* commandList, const T& srcData)
     {
-        nvrhi::BufferHandle buffer = m_NVRHIDevice->createBuffer(nvrhi::utils::CreateVolatileConstantBufferDesc(sizeof(T), std::type_index{ typeid(T) }.name(), 1));
+        // once per 'T': no lock nor lookup on later calls
+        static const uint32_t s_VolatileConstantBufferIdx = CreateVolatileConstantBuffer(sizeof(T), typeid(T).name());
+
+        nvrhi::IBuffer* buffer = m_VolatileConstantBuffers[s_VolatileConstantBufferIdx];
         commandList->writeBuffer(buffer, &srcData, sizeof(T));
         return buffer;
     }
 
+    // raw/structured data. Bind with a 'BufferRange' or use as a copy source
+    template <typename T>
+    [[nodiscard]] UploadAllocation CreateStructuredUpload(std::span<const T> srcData)
+    {
+        check(!srcData.empty());
+
+        const UploadAllocation allocation = AllocateUpload(srcData.size_bytes(), std::max<uint64_t>(alignof(T), kRawBufferAlignment));
+        memcpy(allocation.m_CPUAddress, srcData.data(), srcData.size_bytes());
+        return allocation;
+    }
+
+    // 'ICommandList::writeBuffer' through the upload ring: 1 copy on the GPU timeline from the ring range to 'destBuffer'
+    template <typename T>
+    void WriteStructuredBuffer(nvrhi::ICommandList* commandList, nvrhi::IBuffer* destBuffer, std::span<const T> srcData)
+    {
+        const UploadAllocation allocation = CreateStructuredUpload(srcData);
+        commandList->copyBuffer(destBuffer, 0, allocation.m_Buffer, allocation.m_Offset, allocation.m_Size);
+    }
+
     [[nodiscard]] nvrhi::CommandListHandle AllocateCommandList(nvrhi::CommandQueue queueType = nvrhi::CommandQueue::Graphics);
-    void FreeCommandList(nvrhi::CommandListHandle cmdList);
     void BeginCommandList(nvrhi::CommandListHandle cmdList, std::string_view name);
     void EndCommandList(nvrhi::CommandListHandle cmdList, bool bQueueCmdlist, bool bImmediateExecute);
     void ExecuteAllCommandLists();
     void QueueCommandList(nvrhi::CommandListHandle commandList) { AUTO_LOCK(m_PendingCommandListsLock); m_PendingCommandLists.push_back(commandList); }
 
+    // index of the per-frame version of resources that are written/read back by the CPU. See 'FrameRing'
+    uint32_t GetFrameSlot() const { return m_FrameRing.GetFrameSlot(); }
+
+    // keeps the resource alive until the GPU is done with the frame currently being recorded. Cached binding sets that reference it are dropped
+    void DeferRelease(nvrhi::ResourceHandle resource) { InvalidateCachedBindingSets(resource); m_FrameRing.DeferRelease([resource] {}); }
+
     static MicroProfileThreadLogGpu*& GetGPULogForCurrentThread();
+    RenderGraphBackend& GetRenderGraphBackend();
+    CommandListPool& GetCommandListPoolForCurrentThread();
 
     struct AddPassParamsCommon
     {
         nvrhi::CommandListHandle m_CommandList;
-        std::string m_ShaderName;
+        ShaderID m_ShaderID;
         nvrhi::BindingSetDesc m_BindingSetDesc;
         std::vector<nvrhi::BindingSetHandle> m_ExtraBindingSets;
         std::vector<nvrhi::BindingLayoutHandle> m_ExtraBindingLayouts;
@@ -141,58 +204,83 @@ public:
 
     uint32_t m_FrameCounter = 0;
     float m_GraphicUpdateTimerMs = 0.0f;
+    FrameRing m_FrameRing;
+    std::unique_ptr<IFrameFence> m_FrameFence;
     bool m_bTriggerReloadShaders = false;
 
-    std::vector<nvrhi::CommandListHandle> m_AllCommandLists[(uint32_t)nvrhi::CommandQueue::Count];
-    std::deque<nvrhi::CommandListHandle> m_FreeCommandLists[(uint32_t)nvrhi::CommandQueue::Count];
-    std::mutex m_FreeCommandListsLock;
+    static constexpr uint64_t kConstantBufferAlignment = 256; // D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT
+    static constexpr uint64_t kRawBufferAlignment = 16;
+    static constexpr uint64_t kUploadPageSize = KB_TO_BYTES(64);
+
+    // 1 persistently mapped buffer for per-frame structured, vertex & index data. Constants go through 'WriteConstantBuffer'. Threads grab pages from the ring & sub-allocate from them without locks
+    RingAllocator m_UploadRing;
+    std::mutex m_UploadRingLock;
+    nvrhi::BufferHandle m_UploadRingBuffer;
+    std::byte* m_UploadRingCPUAddress = nullptr;
+    std::atomic<uint32_t> m_NumUploadRingOverflows = 0;
+
+    // 1 per thread that has allocated a command list. Lists are recycled once the frame they were allocated in has retired
+    std::vector<std::unique_ptr<CommandListPool>> m_CommandListPools;
+    std::mutex m_CommandListPoolsLock;
 
 private:
-    std::unordered_map<size_t, nvrhi::ShaderHandle> m_AllShaders;
-    std::unordered_map<size_t, nvrhi::GraphicsPipelineHandle> m_CachedGraphicPSOs;
-    std::unordered_map<size_t, nvrhi::MeshletPipelineHandle> m_CachedMeshletPSOs;
-    std::unordered_map<size_t, nvrhi::ComputePipelineHandle> m_CachedComputePSOs;
+    // PSOs used in previous launches are re-created in the background at startup, from a file saved on shutdown
+    static constexpr const char* kPSOCacheFileName = "PSOCache.bin";
+
+    void PrewarmPSOs();
+    void WaitForPSOPrewarm();
+    bool IsPSORecordValid(std::span<const std::byte> record) const;
+    void CreatePSOFromRecord(std::span<const std::byte> record);
+    void WritePSORecordShader(PSOCacheWriter& writer, nvrhi::IShader* shader) const;
+    void EvictPSOs(std::span<const nvrhi::ShaderHandle> staleShaders);
+
+    std::unordered_map<ShaderID, nvrhi::ShaderHandle> m_AllShaders;
+    std::unordered_map<ShaderID, size_t> m_ShaderBinaryHashes; // same keys as 'm_AllShaders'
+    std::unordered_map<nvrhi::IShader*, size_t> m_ShaderBinaryHashesByShader; // same values, filled at shader load so PSO records never hash shader names
+    StripedCache<nvrhi::GraphicsPipelineHandle> m_CachedGraphicPSOs;
+    StripedCache<nvrhi::MeshletPipelineHandle> m_CachedMeshletPSOs;
+    StripedCache<nvrhi::ComputePipelineHandle> m_CachedComputePSOs;
+
+    PSOCacheFile m_PSOCacheFile;
+    std::vector<std::vector<std::byte>> m_PSOPrewarmRecords;
+    tf::Taskflow m_PSOPrewarmTaskflow;
+    tf::Future<void> m_PSOPrewarmFuture;
     std::unordered_map<size_t, nvrhi::BindingLayoutHandle> m_CachedBindingLayouts;
     
     std::mutex m_PendingCommandListsLock;
     std::vector<nvrhi::CommandListHandle> m_PendingCommandLists;
 
-    nvrhi::TimerQueryHandle m_FrameTimerQuery[2];
-};
-#define g_Graphic Graphic::GetInstance()
-
-class IRenderer
-{
-public:
-    IRenderer(const char* rendererName)
-        : m_Name(rendererName)
-    {
-        ms_AllRenderers.push_back(this);
-    }
+    nvrhi::TimerQueryHandle m_FrameTimerQuery[GraphicConstants::kMaxFramesInFlight];
 
-    virtual ~IRenderer() = default;
-    virtual void Initialize() {};
-    virtual void PostSceneLoad() {};
-    virtual bool HasImguiControls() const { return false; }
-    virtual void UpdateImgui() {};
+    // returns the index of the new buffer in 'm_VolatileConstantBuffers'. Thread safe
+    uint32_t CreateVolatileConstantBuffer(uint32_t byteSize, const char* debugName);
 
-    // return false if the renderer is not going to be used
-    virtual bool Setup(RenderGraph& renderGraph) { return true; }
+    // fixed size, so that 'WriteConstantBuffer' reads it w/o a lock while other threads create buffers for new types
+    static constexpr uint32_t kMaxVolatileConstantBuffers = 64;
+    std::mutex m_VolatileConstantBuffersLock;
+    uint32_t m_NumVolatileConstantBuffers = 0;
+    nvrhi::BufferHandle m_VolatileConstantBuffers[kMaxVolatileConstantBuffers];
 
-    virtual void Render(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph) = 0;
+    struct CachedBindingSet
+    {
+        // full key, compared on every hit: the map is keyed by its hash only
+        nvrhi::BindingSetDesc m_Desc;
+        uint32_t m_RegisterSpace = 0;
 
-    const std::string m_Name;
+        nvrhi::BindingSetHandle m_BindingSet;
+        uint32_t m_LastUsedFrame = 0;
+    };
 
-    float m_CPUFrameTime = 0.0f;
-    float m_GPUFrameTime = 0.0f;
-    nvrhi::TimerQueryHandle m_FrameTimerQuery[2];
+    // sets that are not requested for this many frames are dropped, so that the resources they reference don't stay alive forever
+    static constexpr uint32_t kMaxUnusedBindingSetFrames = 8;
 
-    inline static std::vector<IRenderer*> ms_AllRenderers;
+    std::mutex m_CachedBindingSetsLock;
+    std::unordered_map<size_t, CachedBindingSet> m_CachedBindingSets;
+    std::vector<nvrhi::IResource*> m_BindingSetResourcesToInvalidate;
+    std::atomic<uint32_t> m_NumBindingSetCacheHits = 0;
+    std::atomic<uint32_t> m_NumBindingSetCacheMisses = 0;
 };
-
-#define DEFINE_RENDERER(name) \
-    static name gs_##name; \
-    IRenderer* g_##name = &gs_##name;
+#define g_Graphic Graphic::GetInstance()
 
 struct ScopedCommandList
 {
@@ -230,11 +318,14 @@ constexpr uint32_t ComputeNbMips(uint32_t width, uint32_t height)
     return std::bit_width(resolution);
 }
 
-#define PROFILE_GPU_SCOPED(cmdList, NAME) \
+// 'NAME_HASH': precomputed hash of 'NAME', to skip hashing the string for every scope
+#define PROFILE_GPU_SCOPED_HASHED(cmdList, NAME, NAME_HASH) \
     nvrhi::utils::ScopedMarker GENERATE_UNIQUE_VARIABLE(nvrhi_utils_ScopedMarker){ cmdList, NAME }; \
-    MicroProfileToken MICROPROFILE_TOKEN_PASTE(__Microprofile_GPU_Token__, __LINE__) = MicroProfileGetToken("GPU", NAME, (uint32_t)std::hash<std::string_view>{}(NAME), MicroProfileTokenTypeGpu, 0); \
+    MicroProfileToken MICROPROFILE_TOKEN_PASTE(__Microprofile_GPU_Token__, __LINE__) = MicroProfileGetToken("GPU", NAME, (uint32_t)(NAME_HASH), MicroProfileTokenTypeGpu, 0); \
     MicroProfileScopeGpuHandler GENERATE_UNIQUE_VARIABLE(MicroProfileScopeGpuHandler){ MICROPROFILE_TOKEN_PASTE(__Microprofile_GPU_Token__, __LINE__), Graphic::GetGPULogForCurrentThread() };
 
+#define PROFILE_GPU_SCOPED(cmdList, NAME) PROFILE_GPU_SCOPED_HASHED(cmdList, NAME, std::hash<std::string_view>{}(NAME))
+
 #define SCOPED_COMMAND_LIST(commandList, NAME) \
     ScopedCommandList GENERATE_UNIQUE_VARIABLE(scopedCommandList){ commandList, NAME, false /*bAutoQueue*/, false /*bImmediateExecute*/ }; \
     PROFILE_GPU_SCOPED(commandList, NAME)
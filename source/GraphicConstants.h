@@ -9,6 +9,7 @@ namespace GraphicConstants
     static constexpr uint32_t kTiledResourceSizeInBytes = KB_TO_BYTES(64);
     static constexpr uint32_t kMaxThreadGroupsPerDimension = 65535;
     static constexpr uint32_t kMaxNumMeshLODs = 8;
+    static constexpr uint32_t kMaxFramesInFlight = 3;
 
     static constexpr uint32_t kStencilBit_Opaque = 0x0;
     static constexpr uint32_t kStencilBit_Sky = 0x1;
@@ -33,5 +34,8 @@ namespace GraphicConstants
 
     using IndexBufferFormat_t = uint32_t;
 
-    static constexpr uint32_t kSrvUavCbvBindlessLayoutCapacity = 1024; // NOTE: increase if needed
+    // the bindless table's heap range is reserved once at its max capacity, so indices in heap baked into GPU data never go stale
+    // only the CPU side bookkeeping starts small & grows when full
+    static constexpr uint32_t kSrvUavCbvBindlessLayoutCapacity = 1 << 16;
+    static constexpr uint32_t kSrvUavCbvBindlessInitialCapacity = 1024;
 }
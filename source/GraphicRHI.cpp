@@ -187,6 +187,7 @@ public:
         deviceDesc.pComputeCommandQueue = m_ComputeQueue.Get();
         deviceDesc.pCopyCommandQueue = m_CopyQueue.Get();
         deviceDesc.enableHeapDirectlyIndexed = true;
+        deviceDesc.shaderResourceViewHeapSize += GraphicConstants::kSrvUavCbvBindlessLayoutCapacity; // the bindless table's reserved range, on top of the default size for binding sets
 
         nvrhi::DeviceHandle device = nvrhi::d3d12::createDevice(deviceDesc);
 
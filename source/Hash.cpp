@@ -0,0 +1,346 @@
+#include "Hash.h"
+
+#include "EngineCore.h"
+#include "HeadlessRuns.h"
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define HASH_USE_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define HASH_USE_SSE2 0
+#endif
+
+static constexpr uint32_t kStripeSize = 64;
+
+alignas(16) static constexpr uint64_t kSecret[8] =
+{
+    0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull,
+    0x1d8e4e27c47d124full, 0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full, 0x165667b19e3779f9ull,
+};
+
+static uint64_t Read64(const uint8_t* p) { uint64_t v; memcpy(&v, p, sizeof(v)); return v; }
+static uint64_t Read32(const uint8_t* p) { uint32_t v; memcpy(&v, p, sizeof(v)); return v; }
+
+// 64x64->128 bit multiply, folded to 64 bits
+static uint64_t Mix(uint64_t a, uint64_t b)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    uint64_t hi;
+    const uint64_t lo = _umul128(a, b, &hi);
+    return lo ^ hi;
+#elif defined(__SIZEOF_INT128__)
+    const unsigned __int128 product = (unsigned __int128)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+#else
+    // portable 32-bit limbs
+    const uint64_t aLo = (uint32_t)a, aHi = a >> 32, bLo = (uint32_t)b, bHi = b >> 32;
+    const uint64_t lolo = aLo * bLo, lohi = aLo * bHi, hilo = aHi * bLo, hihi = aHi * bHi;
+    const uint64_t cross = (lolo >> 32) + (uint32_t)lohi + hilo;
+    const uint64_t hi = hihi + (lohi >> 32) + (cross >> 32);
+    const uint64_t lo = (cross << 32) | (uint32_t)lolo;
+    return lo ^ hi;
+#endif
+}
+
+// each lane gets the 32x32->64 bit product of its keyed input plus the raw input of its neighbour lane
+static void AccumulateStripeScalar(uint64_t* accumulators, const uint8_t* stripe)
+{
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        const uint64_t data = Read64(stripe + i * 8);
+        const uint64_t keyed = data ^ kSecret[i];
+        accumulators[i ^ 1] += data;
+        accumulators[i] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+    }
+}
+
+#if HASH_USE_SSE2
+static void AccumulateStripeSSE2(uint64_t* accumulators, const uint8_t* stripe)
+{
+    __m128i* acc = (__m128i*)accumulators;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        const __m128i data = _mm_loadu_si128((const __m128i*)(stripe + i * 16));
+        const __m128i keyed = _mm_xor_si128(data, _mm_load_si128((const __m128i*)kSecret + i));
+        const __m128i product = _mm_mul_epu32(keyed, _mm_srli_epi64(keyed, 32));
+        const __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        acc[i] = _mm_add_epi64(acc[i], _mm_add_epi64(product, swapped));
+    }
+}
+#endif
+
+static void AccumulateStripe(uint64_t* accumulators, const uint8_t* stripe)
+{
+#if HASH_USE_SSE2
+    AccumulateStripeSSE2(accumulators, stripe);
+#else
+    AccumulateStripeScalar(accumulators, stripe);
+#endif
+}
+
+static void InitAccumulators(uint64_t* accumulators, uint64_t seed)
+{
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        accumulators[i] = kSecret[i] + seed;
+    }
+}
+
+// 'tail': the last 1-64 bytes, or nothing for empty inputs
+static uint64_t Finish(const uint64_t* accumulators, const uint8_t* tail, size_t tailSize, uint64_t totalSize, uint64_t seed)
+{
+    check(tailSize <= kStripeSize);
+
+    uint64_t hash = seed ^ Mix(totalSize ^ kSecret[0], kSecret[1]);
+
+    if (totalSize > kStripeSize)
+    {
+        for (uint32_t i = 0; i < 8; i += 2)
+        {
+            hash ^= Mix(accumulators[i] ^ kSecret[i], accumulators[i + 1] ^ kSecret[i + 1]);
+        }
+    }
+
+    size_t offset = 0;
+    for (; offset + 16 <= tailSize; offset += 16)
+    {
+        hash = Mix(Read64(tail + offset) ^ kSecret[2], Read64(tail + offset + 8) ^ hash);
+    }
+
+    const size_t remainingSize = tailSize - offset;
+    if (remainingSize > 0)
+    {
+        const uint8_t* p = tail + offset;
+
+        uint64_t a, b;
+        if (remainingSize >= 8)
+        {
+            a = Read64(p);
+            b = Read64(p + remainingSize - 8);
+        }
+        else if (remainingSize >= 4)
+        {
+            a = Read32(p);
+            b = Read32(p + remainingSize - 4);
+        }
+        else
+        {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[remainingSize / 2] << 8) | p[remainingSize - 1];
+            b = 0;
+        }
+
+        hash = Mix(a ^ kSecret[3], b ^ hash ^ remainingSize);
+    }
+
+    return Mix(hash ^ kSecret[4], totalSize ^ kSecret[5]);
+}
+
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*)data;
+
+    alignas(16) uint64_t accumulators[8];
+    InitAccumulators(accumulators, seed);
+
+    // the last stripe, even if full, is left for 'Finish'
+    size_t offset = 0;
+    for (; size - offset > kStripeSize; offset += kStripeSize)
+    {
+        AccumulateStripe(accumulators, p + offset);
+    }
+
+    return Finish(accumulators, p + offset, size - offset, size, seed);
+}
+
+Hasher::Hasher(uint64_t seed)
+    : m_Seed(seed)
+{
+    InitAccumulators(m_Accumulators, seed);
+}
+
+void Hasher::Update(const void* data, size_t size)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    m_TotalSize += size;
+
+    while (size > 0)
+    {
+        // a full buffer is only consumed once more data comes in, as the last stripe belongs to 'Finish'
+        if (m_BufferSize == kStripeSize)
+        {
+            AccumulateStripe(m_Accumulators, m_Buffer);
+            m_BufferSize = 0;
+        }
+
+        // stripe aligned, straight from the input
+        if (m_BufferSize == 0)
+        {
+            while (size > kStripeSize)
+            {
+                AccumulateStripe(m_Accumulators, p);
+                p += kStripeSize;
+                size -= kStripeSize;
+            }
+        }
+
+        const size_t copySize = std::min<size_t>(kStripeSize - m_BufferSize, size);
+        memcpy(m_Buffer + m_BufferSize, p, copySize);
+        m_BufferSize += (uint32_t)copySize;
+        p += copySize;
+        size -= copySize;
+    }
+}
+
+uint64_t Hasher::Finalize() const
+{
+    return Finish(m_Accumulators, m_Buffer, m_BufferSize, m_TotalSize, m_Seed);
+}
+
+static void RunHashSelfTest()
+{
+    PROFILE_FUNCTION();
+
+    std::mt19937_64 rng{ 1234 };
+
+    std::vector<uint8_t> bytes(4096);
+    for (uint8_t& byte : bytes)
+    {
+        byte = (uint8_t)rng();
+    }
+
+#if HASH_USE_SSE2
+    // SIMD & scalar stripes must agree, or hashes would depend on the build
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        alignas(16) uint64_t scalarAccumulators[8];
+        alignas(16) uint64_t sse2Accumulators[8];
+        InitAccumulators(scalarAccumulators, i);
+        InitAccumulators(sse2Accumulators, i);
+
+        AccumulateStripeScalar(scalarAccumulators, bytes.data() + i * kStripeSize);
+        AccumulateStripeSSE2(sse2Accumulators, bytes.data() + i * kStripeSize);
+        test_verify(memcmp(scalarAccumulators, sse2Accumulators, sizeof(scalarAccumulators)) == 0);
+    }
+#endif
+
+    // streaming in random chunks == 1 shot, around all stripe & tail boundaries
+    for (uint32_t size = 0; size <= 600; ++size)
+    {
+        Hasher hasher{ size };
+        size_t offset = 0;
+        while (offset < size)
+        {
+            const size_t chunkSize = std::min<size_t>(size - offset, std::uniform_int_distribution<size_t>{ 0, 100 }(rng));
+            hasher.Update(bytes.data() + offset, chunkSize);
+            offset += chunkSize;
+        }
+        test_verify(hasher.Finalize() == HashBytes(bytes.data(), size, size));
+    }
+
+    // seed & length are part of the hash
+    test_verify(HashBytes(nullptr, 0, 0) != HashBytes(nullptr, 0, 1));
+    {
+        const uint8_t zeros[128]{};
+        std::unordered_set<uint64_t> zeroHashes;
+        for (uint32_t size = 0; size <= std::size(zeros); ++size)
+        {
+            test_verify(zeroHashes.insert(HashBytes(zeros, size)).second);
+        }
+    }
+
+    // collisions: sparse & dense inputs shaped like cache keys
+    {
+        std::unordered_set<uint64_t> hashes;
+        uint32_t numHashes = 0;
+        auto AddHash = [&](const void* data, size_t size)
+            {
+                test_verify(hashes.insert(HashBytes(data, size)).second);
+                ++numHashes;
+            };
+
+        // counters in otherwise identical structs, e.g. descs that only differ by size
+        for (uint32_t i = 0; i < 100000; ++i)
+        {
+            uint32_t desc[24]{};
+            desc[0] = i & 0xFFF;
+            desc[7] = i >> 12;
+            AddHash(desc, sizeof(desc));
+        }
+
+        // all single bit flips of a 256 bytes record
+        for (uint32_t bit = 0; bit < 256 * 8; ++bit)
+        {
+            std::vector<uint8_t> record{ bytes.begin(), bytes.begin() + 256 };
+            record[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+            AddHash(record.data(), record.size());
+        }
+
+        // random sizes & contents
+        for (uint32_t i = 0; i < 50000; ++i)
+        {
+            const size_t offset = rng() % 2048;
+            const size_t size = 1 + rng() % 2048;
+            uint8_t record[2048 + 8];
+            memcpy(record, bytes.data() + offset, size);
+            memcpy(record + size - std::min<size_t>(size, 8), &i, std::min<size_t>(size, sizeof(i)));
+            AddHash(record, size);
+        }
+
+        test_verify(hashes.size() == numHashes);
+    }
+
+    // avalanche: flipping any input bit flips each output bit with a probability of ~50%
+    for (const size_t size : { 4, 12, 16, 32, 64, 65, 200, 1000 })
+    {
+        const uint32_t kNumTrials = 400;
+        const uint32_t numInputBits = std::min<uint32_t>((uint32_t)size * 8, 256);
+
+        std::vector<uint8_t> input(size);
+        double maxBias = 0.0;
+        double totalFlips = 0.0;
+
+        for (uint32_t inputBitIdx = 0; inputBitIdx < numInputBits; ++inputBitIdx)
+        {
+            // spread the tested bits over the whole input
+            const uint32_t inputBit = (uint32_t)(((uint64_t)inputBitIdx * size * 8) / numInputBits);
+
+            uint32_t flipCounts[64]{};
+            for (uint32_t trial = 0; trial < kNumTrials; ++trial)
+            {
+                for (uint8_t& byte : input)
+                {
+                    byte = (uint8_t)rng();
+                }
+
+                const uint64_t hash = HashBytes(input.data(), size);
+                input[inputBit / 8] ^= (uint8_t)(1u << (inputBit % 8));
+                const uint64_t flippedHash = HashBytes(input.data(), size);
+
+                const uint64_t diff = hash ^ flippedHash;
+                for (uint32_t outputBit = 0; outputBit < 64; ++outputBit)
+                {
+                    flipCounts[outputBit] += (diff >> outputBit) & 1;
+                }
+            }
+
+            for (uint32_t outputBit = 0; outputBit < 64; ++outputBit)
+            {
+                const double flipProbability = (double)flipCounts[outputBit] / kNumTrials;
+                maxBias = std::max(maxBias, std::abs(flipProbability - 0.5));
+                totalFlips += flipProbability;
+            }
+        }
+
+        const double meanFlipProbability = totalFlips / (numInputBits * 64);
+        SDL_Log("Hash avalanche: %u bytes, mean flip probability %.4f, max bias %.4f", (uint32_t)size, meanFlipProbability, maxBias);
+
+        // ~6 standard deviations for 400 trials
+        test_verify(maxBias < 0.15);
+        test_verify(std::abs(meanFlipProbability - 0.5) < 0.01);
+    }
+}
+REGISTER_HEADLESS_RUN("hashselftest", HeadlessRunType::SelfTest, RunHashSelfTest);
@@ -0,0 +1,33 @@
+#pragma once
+
+// 64-bit hash of raw memory for cache keys, in the xxh3/wyhash class
+// Inputs over 64 bytes are consumed in 64-byte stripes by 8 independent accumulators (SSE2 if available, with an identical scalar fallback)
+// The last 1-64 bytes & the accumulators are folded with 64x64->128 bit multiplies
+// Not a stable on-disk format across versions of this file: anything persisted with it must be re-hashed on load
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0);
+
+// Streaming version of 'HashBytes': the result is the same as hashing all updates concatenated, regardless of how they are split
+class Hasher
+{
+public:
+    explicit Hasher(uint64_t seed = 0);
+
+    void Update(const void* data, size_t size);
+
+    // only for types w/o padding bytes, as those are not guaranteed to be initialized. Bitfields have to be copied to plain values first
+    template <typename T>
+    void Update(const T& value)
+    {
+        static_assert(std::has_unique_object_representations_v<T> || std::is_floating_point_v<T>);
+        Update(&value, sizeof(T));
+    }
+
+    uint64_t Finalize() const;
+
+private:
+    uint64_t m_Seed;
+    uint64_t m_TotalSize = 0;
+    alignas(16) uint64_t m_Accumulators[8];
+    uint8_t m_Buffer[64];
+    uint32_t m_BufferSize = 0;
+};
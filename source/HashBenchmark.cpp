@@ -0,0 +1,186 @@
+#include "Engine.h"
+#include "Hash.h"
+#include "HeadlessRuns.h"
+#include "PSOCache.h"
+#include "Utilities.h"
+
+// the byte by byte 'HashRange' that the caches used before 'HashBytes'
+static std::size_t LegacyHashRange(const std::byte* startByte, std::size_t nbBytes)
+{
+    std::size_t hash = 0;
+    for (std::size_t i = 0; i < nbBytes; ++i)
+    {
+        HashCombine(hash, *(startByte + i));
+    }
+    return hash;
+}
+
+CommandLineOption<int> g_HashBenchmarkIterations{ "hashbenchmarkiterations", 100000 };
+
+// Old vs new hashing of the keys of the engine's caches, on real descs
+static void RunHashBenchmark(uint32_t numIterations)
+{
+    PROFILE_FUNCTION();
+
+    // stand-in for the cache lookups, so that the hashes can't be optimized away
+    uint64_t checksum = 0;
+
+    auto Run = [&](const char* caseName, uint32_t numBytes, uint32_t numCaseIterations, auto&& legacyHashFunc, auto&& newHashFunc)
+        {
+            Timer legacyTimer;
+            for (uint32_t i = 0; i < numCaseIterations; ++i)
+            {
+                checksum += legacyHashFunc(i);
+            }
+            const float legacyElapsedMs = legacyTimer.GetElapsedMilliseconds();
+
+            Timer newTimer;
+            for (uint32_t i = 0; i < numCaseIterations; ++i)
+            {
+                checksum += newHashFunc(i);
+            }
+            const float newElapsedMs = newTimer.GetElapsedMilliseconds();
+
+            SDL_Log("Hash Benchmark [%s, %u bytes]: legacy %.1f ns, new %.1f ns per hash (%.1fx)",
+                caseName, numBytes, (legacyElapsedMs * 1e6) / numCaseIterations, (newElapsedMs * 1e6) / numCaseIterations, legacyElapsedMs / std::max(newElapsedMs, 1e-6f));
+        };
+
+    // PSO record, as written by 'Graphic::GetOrCreatePSO' for a meshlet pipeline
+    {
+        std::vector<std::byte> record;
+        PSOCacheWriter writer{ record };
+        writer.Write(PSOType::Meshlet);
+        writer.Write((uint8_t)3);
+        writer.WriteString("basepass_AS_Main LATE_CULL=0");
+        writer.Write((uint64_t)0x1234);
+        writer.WriteString("basepass_MS_Main");
+        writer.Write((uint64_t)0x5678);
+        writer.WriteString("basepass_PS_Main_GBuffer ALPHA_MASK_MODE=0");
+        writer.Write((uint64_t)0x9ABC);
+        writer.Write(nvrhi::PrimitiveType::TriangleList);
+        writer.Write(nvrhi::BlendState{});
+        writer.Write(nvrhi::DepthStencilState{});
+        writer.Write(nvrhi::RasterState{});
+
+        nvrhi::FramebufferInfo framebufferInfo;
+        framebufferInfo.colorFormats.push_back(nvrhi::Format::RGBA32_UINT);
+        framebufferInfo.colorFormats.push_back(nvrhi::Format::RG16_FLOAT);
+        framebufferInfo.depthFormat = nvrhi::Format::D24S8;
+        writer.Write(framebufferInfo);
+
+        nvrhi::BindingLayoutDesc layoutDesc;
+        layoutDesc.visibility = nvrhi::ShaderType::All;
+        layoutDesc.bindings.push_back(nvrhi::BindingLayoutItem::ConstantBuffer(0));
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            layoutDesc.bindings.push_back(nvrhi::BindingLayoutItem::StructuredBuffer_SRV(i));
+        }
+        layoutDesc.bindings.push_back(nvrhi::BindingLayoutItem::Texture_SRV(8));
+        layoutDesc.bindings.push_back(nvrhi::BindingLayoutItem::Sampler(0));
+        writer.Write(layoutDesc);
+
+        Run("PSO record", (uint32_t)record.size(), numIterations,
+            [&](uint32_t i) { record[0] = (std::byte)i; return (uint64_t)LegacyHashRange(record.data(), record.size()); },
+            [&](uint32_t i) { record[0] = (std::byte)i; return HashBytes(record.data(), record.size()); });
+    }
+
+    // render graph transient texture desc, field by field as in 'HashResourceDesc'
+    {
+        nvrhi::TextureDesc desc;
+        desc.width = 1920;
+        desc.height = 1080;
+        desc.format = nvrhi::Format::RGBA32_UINT;
+        desc.isRenderTarget = true;
+        desc.useClearValue = true;
+
+        Run("TextureDesc", (uint32_t)sizeof(nvrhi::TextureDesc), numIterations,
+            [&](uint32_t i)
+            {
+                desc.width = i;
+                std::size_t seed = 0;
+                HashCombine(seed, desc.width);
+                HashCombine(seed, desc.height);
+                HashCombine(seed, desc.depth);
+                HashCombine(seed, desc.arraySize);
+                HashCombine(seed, desc.mipLevels);
+                HashCombine(seed, desc.sampleCount);
+                HashCombine(seed, desc.sampleQuality);
+                HashCombine(seed, desc.format);
+                HashCombine(seed, desc.dimension);
+                HashCombine(seed, desc.isRenderTarget);
+                HashCombine(seed, desc.isUAV);
+                HashCombine(seed, desc.isTypeless);
+                HashCombine(seed, desc.isShadingRateSurface);
+                HashCombine(seed, LegacyHashRange((const std::byte*)&desc.clearValue, sizeof(desc.clearValue)));
+                HashCombine(seed, desc.useClearValue);
+                return (uint64_t)seed;
+            },
+            [&](uint32_t i)
+            {
+                desc.width = i;
+                Hasher hasher;
+                hasher.Update(desc.width);
+                hasher.Update(desc.height);
+                hasher.Update(desc.depth);
+                hasher.Update(desc.arraySize);
+                hasher.Update(desc.mipLevels);
+                hasher.Update(desc.sampleCount);
+                hasher.Update(desc.sampleQuality);
+                hasher.Update(desc.format);
+                hasher.Update(desc.dimension);
+                hasher.Update(desc.isRenderTarget);
+                hasher.Update(desc.isUAV);
+                hasher.Update(desc.isTypeless);
+                hasher.Update(desc.isShadingRateSurface);
+                hasher.Update(desc.clearValue.r);
+                hasher.Update(desc.clearValue.g);
+                hasher.Update(desc.clearValue.b);
+                hasher.Update(desc.clearValue.a);
+                hasher.Update(desc.useClearValue);
+                return hasher.Finalize();
+            });
+    }
+
+    // binding layout items, hashed item by item before & as a whole now
+    {
+        nvrhi::BindingLayoutDesc layoutDesc;
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            layoutDesc.bindings.push_back(nvrhi::BindingLayoutItem::Texture_SRV(i));
+        }
+
+        Run("BindingLayoutDesc", (uint32_t)(layoutDesc.bindings.size() * sizeof(nvrhi::BindingLayoutItem)), numIterations,
+            [&](uint32_t i)
+            {
+                layoutDesc.bindings[0].slot = i;
+                std::size_t layoutHash = 0;
+                for (const nvrhi::BindingLayoutItem& layoutItem : layoutDesc.bindings)
+                {
+                    HashCombine(layoutHash, LegacyHashRange((const std::byte*)&layoutItem, sizeof(layoutItem)));
+                }
+                return (uint64_t)layoutHash;
+            },
+            [&](uint32_t i)
+            {
+                layoutDesc.bindings[0].slot = i;
+                return HashBytes(layoutDesc.bindings.data(), layoutDesc.bindings.size() * sizeof(nvrhi::BindingLayoutItem));
+            });
+    }
+
+    // shader binary sized blob, as hashed by 'LoadShaderBinaries'
+    {
+        std::vector<std::byte> blob(KB_TO_BYTES(32));
+        for (uint32_t i = 0; i < blob.size(); ++i)
+        {
+            blob[i] = (std::byte)(i * 31);
+        }
+
+        // a few hundred times the bytes of the descs above, so as many times fewer iterations
+        Run("Shader binary", (uint32_t)blob.size(), std::max(1u, numIterations / 256),
+            [&](uint32_t i) { blob[0] = (std::byte)i; return (uint64_t)LegacyHashRange(blob.data(), blob.size()); },
+            [&](uint32_t i) { blob[0] = (std::byte)i; return HashBytes(blob.data(), blob.size()); });
+    }
+
+    SDL_Log("Hash Benchmark checksum: %llu", (unsigned long long)checksum);
+}
+REGISTER_HEADLESS_RUN("hashbenchmark", HeadlessRunType::Benchmark, [] { RunHashBenchmark(g_HashBenchmarkIterations.Get()); });
@@ -0,0 +1,104 @@
+#include "HeadlessRuns.h"
+
+#include <ranges>
+
+#include "EngineCore.h"
+#include "Utilities.h"
+
+// comma separated list of runs, see 'HeadlessRuns::Run'. Read by the app & the standalone tools
+CommandLineOption<std::string> g_HeadlessRuns{ "run", "" };
+
+std::vector<HeadlessRun>& HeadlessRuns::GetRuns()
+{
+    // function-local, so that it exists before the first static registration of any translation unit
+    static std::vector<HeadlessRun> s_Runs;
+    return s_Runs;
+}
+
+bool HeadlessRuns::Register(const char* name, HeadlessRunType type, void(*func)())
+{
+    std::vector<HeadlessRun>& runs = GetRuns();
+
+    check(std::ranges::find(runs, std::string_view{ name }, [](const HeadlessRun& run) { return std::string_view{ run.m_Name }; }) == runs.end()); // run already registered
+
+    runs.push_back(HeadlessRun{ name, type, func });
+    return true;
+}
+
+bool HeadlessRuns::Run(std::string_view names)
+{
+    std::vector<const HeadlessRun*> runsToExecute;
+    bool bAllFound = true;
+
+    for (const auto& nameRange : std::views::split(names, ','))
+    {
+        const std::string_view name{ nameRange.begin(), nameRange.end() };
+
+        if (name == "selftests")
+        {
+            for (const HeadlessRun& run : GetRuns())
+            {
+                if (run.m_Type == HeadlessRunType::SelfTest)
+                {
+                    runsToExecute.push_back(&run);
+                }
+            }
+            continue;
+        }
+
+        auto it = std::ranges::find(GetRuns(), name, [](const HeadlessRun& run) { return std::string_view{ run.m_Name }; });
+        if (it == GetRuns().end())
+        {
+            SDL_Log("Unknown headless run: '%.*s'", (int)name.size(), name.data());
+            bAllFound = false;
+            continue;
+        }
+
+        runsToExecute.push_back(&*it);
+    }
+
+    if (!bAllFound)
+    {
+        std::string availableRunsStr = "Available headless runs: selftests ";
+        for (const HeadlessRun& run : GetRuns())
+        {
+            availableRunsStr += StringFormat("%s ", run.m_Name);
+        }
+        SDL_Log(availableRunsStr.c_str());
+    }
+
+    bool bAllPassed = bAllFound;
+
+    for (const HeadlessRun* run : runsToExecute)
+    {
+        SDL_Log("Headless run [%s]: %s", EnumUtils::ToString(run->m_Type), run->m_Name);
+
+        const uint32_t numFailuresBefore = ms_NumFailures;
+
+        Timer timer;
+        run->m_Func();
+
+        const uint32_t numFailures = ms_NumFailures - numFailuresBefore;
+        if (numFailures > 0)
+        {
+            SDL_Log("Headless run [%s]: %s FAILED with %u failed checks in %.2f ms", EnumUtils::ToString(run->m_Type), run->m_Name, numFailures, timer.GetElapsedMilliseconds());
+            bAllPassed = false;
+            continue;
+        }
+
+        SDL_Log("Headless run [%s]: %s passed in %.2f ms", EnumUtils::ToString(run->m_Type), run->m_Name, timer.GetElapsedMilliseconds());
+    }
+
+    if (!bAllPassed)
+    {
+        SDL_Log("Headless runs FAILED");
+    }
+
+    return bAllPassed;
+}
+
+void HeadlessRuns::ReportFailure(const char* expr, const char* file, int line)
+{
+    SDL_Log("%s(%d): check failed: %s", file, line, expr);
+    ++ms_NumFailures;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Self-tests, benchmarks & tools that run without a window, device or scene
+// Each one registers itself next to its code & is run by name, i.e.: "-run=hashselftest,hashbenchmark". "-run=selftests" runs every self-test
+// Parameters of a run are regular 'CommandLineOption's, declared next to it
+enum class HeadlessRunType { SelfTest, Benchmark, Tool };
+
+struct HeadlessRun
+{
+    const char* m_Name;
+    HeadlessRunType m_Type;
+    void(*m_Func)();
+};
+
+class HeadlessRuns
+{
+public:
+    static bool Register(const char* name, HeadlessRunType type, void(*func)());
+
+    // comma separated list of run names. Returns false if any of them doesn't exist or failed a 'test_verify'
+    static bool Run(std::string_view names);
+
+    // see 'test_verify'. Thread safe, runs may test from executor tasks
+    static void ReportFailure(const char* expr, const char* file, int line);
+
+private:
+    static std::vector<HeadlessRun>& GetRuns();
+
+    inline static std::atomic<uint32_t> ms_NumFailures = 0;
+};
+
+#define REGISTER_HEADLESS_RUN(name, type, ...) static const bool GENERATE_UNIQUE_VARIABLE(gs_HeadlessRunRegistered) = HeadlessRuns::Register(name, type, __VA_ARGS__)
+
+// checks of the headless runs. Unlike 'verify' & 'check', active in every build: logs the expression & fails the run in progress
+#define test_verify(expr) do { if (!(expr)) { HeadlessRuns::ReportFailure(#expr, __FILE__, __LINE__); } } while(0)
@@ -14,13 +14,8 @@ class IMGUIRenderer : public IRenderer
 
     nvrhi::InputLayoutHandle m_InputLayout;
 
-    std::vector<ImDrawVert> m_Vertices;
-    std::vector<ImDrawIdx> m_Indices;
     std::vector<nvrhi::TextureHandle> m_Textures;
 
-    nvrhi::BufferHandle m_VertexBuffer;
-    nvrhi::BufferHandle m_IndexBuffer;
-
 public:
     IMGUIRenderer() : IRenderer{ "IMGUIRenderer" } {}
 
@@ -118,59 +113,25 @@ public:
         tex->SetStatus(tex->Status == ImTextureStatus_WantDestroy ? ImTextureStatus_Destroyed : ImTextureStatus_OK);
     }
 
-    void UploadVertexAndIndexBuffers(nvrhi::CommandListHandle commandList, ImDrawData* drawData)
+    // written straight into the upload ring & bound from there: no intermediate copies & no buffers to re-allocate as the UI grows
+    void UploadVertexAndIndexBuffers(ImDrawData* drawData, UploadAllocation& outVertices, UploadAllocation& outIndices)
     {
-        nvrhi::DeviceHandle device = g_Graphic.m_NVRHIDevice;
+        PROFILE_FUNCTION();
 
-        // VB
-        {
-            const uint32_t requiredSize = drawData->TotalVtxCount * sizeof(ImDrawVert);
-            const uint32_t reallocateSize = (drawData->TotalVtxCount + 5000) * sizeof(ImDrawVert);
-            if (!m_VertexBuffer || (m_VertexBuffer->getDesc().byteSize < requiredSize))
-            {
-                PROFILE_SCOPED("Create Vertex Buffer");
+        outVertices = g_Graphic.AllocateUpload(drawData->TotalVtxCount * sizeof(ImDrawVert), Graphic::kRawBufferAlignment);
+        outIndices = g_Graphic.AllocateUpload(drawData->TotalIdxCount * sizeof(ImDrawIdx), Graphic::kRawBufferAlignment);
 
-                nvrhi::BufferDesc desc;
-                desc.byteSize = reallocateSize;
-                desc.debugName = "ImGui vertex buffer";
-                desc.isVertexBuffer = true;
+        ImDrawVert* vertices = (ImDrawVert*)outVertices.m_CPUAddress;
+        ImDrawIdx* indices = (ImDrawIdx*)outIndices.m_CPUAddress;
 
-                m_VertexBuffer = device->createBuffer(desc);
-            }
-        }
-
-        // IB
+        for (const ImDrawList* drawList : drawData->CmdLists)
         {
-            const uint32_t requiredSize = drawData->TotalIdxCount * sizeof(ImDrawIdx);
-            const uint32_t reallocateSize = (drawData->TotalIdxCount + 5000) * sizeof(ImDrawIdx);
-
-            if (!m_IndexBuffer || (m_IndexBuffer->getDesc().byteSize < requiredSize))
-            {
-                PROFILE_SCOPED("Create Index Buffer");
-
-                nvrhi::BufferDesc desc;
-                desc.byteSize = reallocateSize;
-                desc.debugName = "ImGui index buffer";
-                desc.isIndexBuffer = true;
+            memcpy(vertices, drawList->VtxBuffer.Data, drawList->VtxBuffer.size_in_bytes());
+            memcpy(indices, drawList->IdxBuffer.Data, drawList->IdxBuffer.size_in_bytes());
 
-                m_IndexBuffer = device->createBuffer(desc);
-            }
-        }
-
-        // prep data into linear buffers for upload
-        m_Vertices.clear();
-        m_Indices.clear();
-
-        for (ImDrawList* drawList : drawData->CmdLists)
-        {
-            m_Vertices.insert(m_Vertices.end(), drawList->VtxBuffer.begin(), drawList->VtxBuffer.end());
-            m_Indices.insert(m_Indices.end(), drawList->IdxBuffer.begin(), drawList->IdxBuffer.end());
+            vertices += drawList->VtxBuffer.size();
+            indices += drawList->IdxBuffer.size();
         }
-
-        PROFILE_SCOPED("Write Buffers");
-
-        commandList->writeBuffer(m_VertexBuffer, m_Vertices.data(), m_Vertices.size() * sizeof(ImDrawVert));
-        commandList->writeBuffer(m_IndexBuffer, m_Indices.data(), m_Indices.size() * sizeof(ImDrawIdx));
     }
 
     void Render(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph) override
@@ -197,8 +158,14 @@ public:
             }
         }
 
-        // re-alloc & upload imgui vtx/idx data if needed
-        UploadVertexAndIndexBuffers(commandList, drawData);
+        if (drawData->TotalVtxCount == 0 || drawData->TotalIdxCount == 0)
+        {
+            return;
+        }
+
+        UploadAllocation vertices;
+        UploadAllocation indices;
+        UploadVertexAndIndexBuffers(drawData, vertices, indices);
 
         // Render Targets & Depth Buffer
         nvrhi::FramebufferDesc frameBufferDesc;
@@ -232,10 +199,10 @@ public:
 
         // vertex & index buffers
         static_assert(sizeof(ImDrawIdx) == sizeof(uint16_t));
-        drawState.vertexBuffers.push_back(nvrhi::VertexBufferBinding{ m_VertexBuffer, 0, 0 });
-        drawState.indexBuffer.buffer = m_IndexBuffer;
+        drawState.vertexBuffers.push_back(nvrhi::VertexBufferBinding{ vertices.m_Buffer, 0, vertices.m_Offset });
+        drawState.indexBuffer.buffer = indices.m_Buffer;
         drawState.indexBuffer.format = nvrhi::Format::R16_UINT;
-        drawState.indexBuffer.offset = 0;
+        drawState.indexBuffer.offset = (uint32_t)indices.m_Offset;
 
         check(nvrhi::getFormatInfo(drawState.indexBuffer.format).bytesPerBlock == sizeof(ImDrawIdx));
 
@@ -0,0 +1,35 @@
+#pragma once
+
+// Integer helpers w/o any dependency on DirectXMath, so that device agnostic code builds on every platform. Included by MathUtilities.h
+
+constexpr uint32_t GetNextPow2(uint32_t x)
+{
+    if (x == 0) return 1; // Special case: 0 returns 1 (2^0)
+
+    // Decrement x by 1, and then perform a series of bit shifts to propagate the highest bit.
+    --x;
+    x |= x >> 1;
+    x |= x >> 2;
+    x |= x >> 4;
+    x |= x >> 8;
+    x |= x >> 16;
+
+    // Now x has all bits set to 1 from the most significant bit down to the least significant bit of the original number.
+    return x + 1;
+}
+
+/** Divides two integers and rounds up */
+constexpr uint32_t DivideAndRoundUp(uint32_t Dividend, uint32_t Divisor)
+{
+    return (Dividend + Divisor - 1) / Divisor;
+}
+
+constexpr uint32_t AlignUp(uint32_t value, uint32_t alignment)
+{
+    return (value + (alignment - 1)) & ~(alignment - 1);
+}
+
+constexpr uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + (alignment - 1)) & ~(alignment - 1);
+}
@@ -9,19 +9,24 @@
 // C++ Lib
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <bitset>
 #include <codecvt>
+#include <condition_variable>
 #include <deque>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <numbers>
 #include <random>
 #include <regex>
 #include <set>
+#include <shared_mutex>
 #include <span>
 #include <string>
 #include <typeindex>
@@ -29,10 +34,12 @@
 #include <unordered_set>
 #include <vector>
 
-// Windows
-#include <windows.h>
-#include <windowsx.h>
-#include <wrl.h>
+// Windows. Not available to the standalone tools on other platforms, see 'source/tools/ToolMain.cpp'
+#if defined(_WIN32)
+    #include <windows.h>
+    #include <windowsx.h>
+    #include <wrl.h>
+#endif // _WIN32
 
 #include "SDL3/SDL.h"
 
@@ -47,7 +54,9 @@
     #define verify(expr) (expr)
 #endif
 
-using Microsoft::WRL::ComPtr;
+#if defined(_WIN32)
+    using Microsoft::WRL::ComPtr;
+#endif // _WIN32
 
 #define SingletonFunctionsCommon(ClassName)          \
     ClassName(const ClassName&)            = delete; \
@@ -0,0 +1,563 @@
+#include "PSOCache.h"
+
+#include <thread>
+
+#include "Engine.h"
+#include "HeadlessRuns.h"
+#include "Utilities.h"
+
+void PSOCacheWriter::WriteString(std::string_view str)
+{
+    Write((uint32_t)str.size());
+
+    const size_t offset = m_Bytes.size();
+    m_Bytes.resize(offset + str.size());
+    memcpy(m_Bytes.data() + offset, str.data(), str.size());
+}
+
+void PSOCacheWriter::Write(const nvrhi::BlendState& blendState)
+{
+    for (const nvrhi::BlendState::RenderTarget& target : blendState.targets)
+    {
+        Write(target.blendEnable);
+        Write(target.srcBlend);
+        Write(target.destBlend);
+        Write(target.blendOp);
+        Write(target.srcBlendAlpha);
+        Write(target.destBlendAlpha);
+        Write(target.blendOpAlpha);
+        Write(target.colorWriteMask);
+    }
+    Write(blendState.alphaToCoverageEnable);
+}
+
+void PSOCacheWriter::Write(const nvrhi::DepthStencilState& depthStencilState)
+{
+    Write(depthStencilState.depthTestEnable);
+    Write(depthStencilState.depthWriteEnable);
+    Write(depthStencilState.depthFunc);
+    Write(depthStencilState.stencilEnable);
+    Write(depthStencilState.stencilReadMask);
+    Write(depthStencilState.stencilWriteMask);
+    Write(depthStencilState.stencilRefValue);
+    Write(depthStencilState.dynamicStencilRef);
+
+    for (const nvrhi::DepthStencilState::StencilOpDesc* stencilOpDesc : { &depthStencilState.frontFaceStencil, &depthStencilState.backFaceStencil })
+    {
+        Write(stencilOpDesc->failOp);
+        Write(stencilOpDesc->depthFailOp);
+        Write(stencilOpDesc->passOp);
+        Write(stencilOpDesc->stencilFunc);
+    }
+}
+
+void PSOCacheWriter::Write(const nvrhi::RasterState& rasterState)
+{
+    Write(rasterState.fillMode);
+    Write(rasterState.cullMode);
+    Write(rasterState.frontCounterClockwise);
+    Write(rasterState.depthClipEnable);
+    Write(rasterState.scissorEnable);
+    Write(rasterState.multisampleEnable);
+    Write(rasterState.antialiasedLineEnable);
+    Write(rasterState.depthBias);
+    Write(rasterState.depthBiasClamp);
+    Write(rasterState.slopeScaledDepthBias);
+    Write(rasterState.forcedSampleCount);
+    Write(rasterState.programmableSamplePositionsEnable);
+    Write(rasterState.conservativeRasterEnable);
+    Write(rasterState.quadFillEnable);
+
+    for (uint32_t i = 0; i < std::size(rasterState.samplePositionsX); ++i)
+    {
+        Write(rasterState.samplePositionsX[i]);
+        Write(rasterState.samplePositionsY[i]);
+    }
+}
+
+void PSOCacheWriter::Write(const nvrhi::FramebufferInfo& framebufferInfo)
+{
+    Write((uint32_t)framebufferInfo.colorFormats.size());
+    for (nvrhi::Format format : framebufferInfo.colorFormats)
+    {
+        Write(format);
+    }
+    Write(framebufferInfo.depthFormat);
+    Write(framebufferInfo.sampleCount);
+    Write(framebufferInfo.sampleQuality);
+}
+
+void PSOCacheWriter::Write(const nvrhi::BindingLayoutDesc& layoutDesc)
+{
+    Write(layoutDesc.visibility);
+    Write(layoutDesc.registerSpace);
+
+    Write((uint32_t)layoutDesc.bindings.size());
+    for (const nvrhi::BindingLayoutItem& layoutItem : layoutDesc.bindings)
+    {
+        Write(layoutItem.slot);
+        Write(layoutItem.type);
+        Write((uint16_t)layoutItem.size);
+    }
+}
+
+void PSOCacheWriter::Write(const nvrhi::BindlessLayoutDesc& layoutDesc)
+{
+    Write(layoutDesc.visibility);
+    Write(layoutDesc.firstSlot);
+    Write(layoutDesc.maxCapacity);
+    Write(layoutDesc.layoutType);
+
+    Write((uint32_t)layoutDesc.registerSpaces.size());
+    for (const nvrhi::BindingLayoutItem& layoutItem : layoutDesc.registerSpaces)
+    {
+        Write(layoutItem.slot);
+        Write(layoutItem.type);
+        Write((uint16_t)layoutItem.size);
+    }
+}
+
+uint32_t PSOCacheReader::ReadCount(uint32_t maxCount)
+{
+    const uint32_t count = Read<uint32_t>();
+    if (count > maxCount)
+    {
+        m_bError = true;
+        return 0;
+    }
+    return count;
+}
+
+std::string PSOCacheReader::ReadString()
+{
+    const uint32_t size = Read<uint32_t>();
+    if (m_bError || (m_Offset + size > m_Bytes.size()))
+    {
+        m_bError = true;
+        return {};
+    }
+
+    std::string str{ (const char*)m_Bytes.data() + m_Offset, size };
+    m_Offset += size;
+    return str;
+}
+
+void PSOCacheReader::Read(nvrhi::BlendState& blendState)
+{
+    for (nvrhi::BlendState::RenderTarget& target : blendState.targets)
+    {
+        target.blendEnable = Read<bool>();
+        target.srcBlend = Read<nvrhi::BlendFactor>();
+        target.destBlend = Read<nvrhi::BlendFactor>();
+        target.blendOp = Read<nvrhi::BlendOp>();
+        target.srcBlendAlpha = Read<nvrhi::BlendFactor>();
+        target.destBlendAlpha = Read<nvrhi::BlendFactor>();
+        target.blendOpAlpha = Read<nvrhi::BlendOp>();
+        target.colorWriteMask = Read<nvrhi::ColorMask>();
+    }
+    blendState.alphaToCoverageEnable = Read<bool>();
+}
+
+void PSOCacheReader::Read(nvrhi::DepthStencilState& depthStencilState)
+{
+    depthStencilState.depthTestEnable = Read<bool>();
+    depthStencilState.depthWriteEnable = Read<bool>();
+    depthStencilState.depthFunc = Read<nvrhi::ComparisonFunc>();
+    depthStencilState.stencilEnable = Read<bool>();
+    depthStencilState.stencilReadMask = Read<uint8_t>();
+    depthStencilState.stencilWriteMask = Read<uint8_t>();
+    depthStencilState.stencilRefValue = Read<uint8_t>();
+    depthStencilState.dynamicStencilRef = Read<bool>();
+
+    for (nvrhi::DepthStencilState::StencilOpDesc* stencilOpDesc : { &depthStencilState.frontFaceStencil, &depthStencilState.backFaceStencil })
+    {
+        stencilOpDesc->failOp = Read<nvrhi::StencilOp>();
+        stencilOpDesc->depthFailOp = Read<nvrhi::StencilOp>();
+        stencilOpDesc->passOp = Read<nvrhi::StencilOp>();
+        stencilOpDesc->stencilFunc = Read<nvrhi::ComparisonFunc>();
+    }
+}
+
+void PSOCacheReader::Read(nvrhi::RasterState& rasterState)
+{
+    rasterState.fillMode = Read<nvrhi::RasterFillMode>();
+    rasterState.cullMode = Read<nvrhi::RasterCullMode>();
+    rasterState.frontCounterClockwise = Read<bool>();
+    rasterState.depthClipEnable = Read<bool>();
+    rasterState.scissorEnable = Read<bool>();
+    rasterState.multisampleEnable = Read<bool>();
+    rasterState.antialiasedLineEnable = Read<bool>();
+    rasterState.depthBias = Read<decltype(rasterState.depthBias)>();
+    rasterState.depthBiasClamp = Read<float>();
+    rasterState.slopeScaledDepthBias = Read<float>();
+    rasterState.forcedSampleCount = Read<uint8_t>();
+    rasterState.programmableSamplePositionsEnable = Read<bool>();
+    rasterState.conservativeRasterEnable = Read<bool>();
+    rasterState.quadFillEnable = Read<bool>();
+
+    for (uint32_t i = 0; i < std::size(rasterState.samplePositionsX); ++i)
+    {
+        rasterState.samplePositionsX[i] = Read<char>();
+        rasterState.samplePositionsY[i] = Read<char>();
+    }
+}
+
+void PSOCacheReader::Read(nvrhi::FramebufferInfo& framebufferInfo)
+{
+    framebufferInfo.colorFormats.clear();
+
+    const uint32_t numColorFormats = ReadCount(nvrhi::c_MaxRenderTargets);
+    for (uint32_t i = 0; i < numColorFormats; ++i)
+    {
+        framebufferInfo.colorFormats.push_back(Read<nvrhi::Format>());
+    }
+    framebufferInfo.depthFormat = Read<nvrhi::Format>();
+    framebufferInfo.sampleCount = Read<uint32_t>();
+    framebufferInfo.sampleQuality = Read<uint32_t>();
+}
+
+void PSOCacheReader::Read(nvrhi::BindingLayoutDesc& layoutDesc)
+{
+    layoutDesc.visibility = Read<nvrhi::ShaderType>();
+    layoutDesc.registerSpace = Read<uint32_t>();
+
+    layoutDesc.bindings.clear();
+
+    const uint32_t numBindings = ReadCount(nvrhi::c_MaxBindingsPerLayout);
+    for (uint32_t i = 0; i < numBindings; ++i)
+    {
+        nvrhi::BindingLayoutItem layoutItem{};
+        layoutItem.slot = Read<uint32_t>();
+        layoutItem.type = Read<nvrhi::ResourceType>();
+        layoutItem.size = Read<uint16_t>();
+        layoutDesc.bindings.push_back(layoutItem);
+    }
+}
+
+void PSOCacheReader::Read(nvrhi::BindlessLayoutDesc& layoutDesc)
+{
+    layoutDesc.visibility = Read<nvrhi::ShaderType>();
+    layoutDesc.firstSlot = Read<uint32_t>();
+    layoutDesc.maxCapacity = Read<uint32_t>();
+    layoutDesc.layoutType = Read<nvrhi::BindlessLayoutDesc::LayoutType>();
+
+    layoutDesc.registerSpaces.clear();
+
+    const uint32_t numRegisterSpaces = ReadCount(nvrhi::c_MaxBindingsPerLayout);
+    for (uint32_t i = 0; i < numRegisterSpaces; ++i)
+    {
+        nvrhi::BindingLayoutItem layoutItem{};
+        layoutItem.slot = Read<uint32_t>();
+        layoutItem.type = Read<nvrhi::ResourceType>();
+        layoutItem.size = Read<uint16_t>();
+        layoutDesc.registerSpaces.push_back(layoutItem);
+    }
+}
+
+size_t PSOCacheFile::ComputeKey(std::span<const std::byte> record)
+{
+    return HashRange((std::byte*)record.data(), record.size());
+}
+
+bool PSOCacheFile::Load(std::string_view filePath)
+{
+    PROFILE_FUNCTION();
+
+    std::vector<std::byte> fileData;
+    ReadDataFromFile(filePath, fileData);
+
+    PSOCacheReader reader{ fileData };
+
+    Header header;
+    header.m_Magic = reader.Read<uint32_t>();
+    header.m_Version = reader.Read<uint32_t>();
+    header.m_NumRecords = reader.Read<uint32_t>();
+
+    if (reader.HasError() || (header.m_Magic != kMagic) || (header.m_Version != kCurrentVersion))
+    {
+        return false;
+    }
+
+    std::unordered_map<size_t, std::vector<std::byte>> records;
+    for (uint32_t i = 0; i < header.m_NumRecords; ++i)
+    {
+        const std::string record = reader.ReadString();
+        if (reader.HasError())
+        {
+            return false;
+        }
+
+        const std::span<const std::byte> recordBytes{ (const std::byte*)record.data(), record.size() };
+        records.emplace(ComputeKey(recordBytes), std::vector<std::byte>{ recordBytes.begin(), recordBytes.end() });
+    }
+
+    if (!reader.IsAtEnd())
+    {
+        return false;
+    }
+
+    AUTO_LOCK(m_Lock);
+    m_Records = std::move(records);
+
+    return true;
+}
+
+void PSOCacheFile::Save(std::string_view filePath) const
+{
+    PROFILE_FUNCTION();
+
+    std::vector<std::byte> fileData;
+    PSOCacheWriter writer{ fileData };
+
+    {
+        AUTO_LOCK(m_Lock);
+
+        writer.Write(kMagic);
+        writer.Write(kCurrentVersion);
+        writer.Write((uint32_t)m_Records.size());
+
+        for (const auto& [key, record] : m_Records)
+        {
+            writer.WriteString(std::string_view{ (const char*)record.data(), record.size() });
+        }
+    }
+
+    ScopedFile file{ filePath, "wb" };
+    fwrite(fileData.data(), 1, fileData.size(), file);
+}
+
+bool PSOCacheFile::Add(size_t key, std::span<const std::byte> record)
+{
+    AUTO_LOCK(m_Lock);
+    return m_Records.try_emplace(key, record.begin(), record.end()).second;
+}
+
+uint32_t PSOCacheFile::RemoveInvalid(const std::function<bool(std::span<const std::byte>)>& isValidFunc)
+{
+    AUTO_LOCK(m_Lock);
+    return (uint32_t)std::erase_if(m_Records, [&isValidFunc](const auto& it) { return !isValidFunc(it.second); });
+}
+
+std::vector<std::vector<std::byte>> PSOCacheFile::GetRecords() const
+{
+    std::vector<std::vector<std::byte>> records;
+
+    AUTO_LOCK(m_Lock);
+    records.reserve(m_Records.size());
+    for (const auto& [key, record] : m_Records)
+    {
+        records.push_back(record);
+    }
+    return records;
+}
+
+uint32_t PSOCacheFile::GetNumRecords() const
+{
+    AUTO_LOCK(m_Lock);
+    return (uint32_t)m_Records.size();
+}
+
+static void RunPSOCacheSelfTest()
+{
+    PROFILE_FUNCTION();
+
+    // same layout as the records written by 'Graphic': type, shaders (name + binary hash), states
+    auto WriteRecord = [](std::vector<std::byte>& bytes, uint64_t shaderBinaryHash, const nvrhi::RasterState& rasterState)
+        {
+            PSOCacheWriter writer{ bytes };
+            writer.Write(PSOType::Graphics);
+            writer.Write((uint8_t)2);
+            writer.WriteString("fullscreen_VS_FullScreenTriangle");
+            writer.Write(shaderBinaryHash);
+            writer.WriteString("tonemap_PS_Main");
+            writer.Write(shaderBinaryHash);
+            writer.Write(nvrhi::PrimitiveType::TriangleList);
+            writer.Write(nvrhi::BlendState{});
+            writer.Write(nvrhi::DepthStencilState{});
+            writer.Write(rasterState);
+
+            nvrhi::FramebufferInfo framebufferInfo;
+            framebufferInfo.colorFormats.push_back(nvrhi::Format::RGBA8_UNORM);
+            writer.Write(framebufferInfo);
+
+            nvrhi::BindingLayoutDesc layoutDesc;
+            layoutDesc.visibility = nvrhi::ShaderType::All;
+            layoutDesc.bindings.push_back(nvrhi::BindingLayoutItem::Texture_SRV(0));
+            layoutDesc.bindings.push_back(nvrhi::BindingLayoutItem::Sampler(0));
+            writer.Write(layoutDesc);
+        };
+
+    // stable keys: garbage in struct padding must not change the key
+    std::vector<std::byte> record;
+    {
+        alignas(nvrhi::RasterState) std::byte zeroedStorage[sizeof(nvrhi::RasterState)];
+        alignas(nvrhi::RasterState) std::byte garbageStorage[sizeof(nvrhi::RasterState)];
+        memset(zeroedStorage, 0, sizeof(zeroedStorage));
+        memset(garbageStorage, 0xCD, sizeof(garbageStorage));
+
+        nvrhi::RasterState* zeroedRasterState = new (zeroedStorage) nvrhi::RasterState{};
+        nvrhi::RasterState* garbageRasterState = new (garbageStorage) nvrhi::RasterState{};
+        zeroedRasterState->setCullNone();
+        garbageRasterState->setCullNone();
+
+        std::vector<std::byte> garbageRecord;
+        WriteRecord(record, 0x1234, *zeroedRasterState);
+        WriteRecord(garbageRecord, 0x1234, *garbageRasterState);
+
+        test_verify(record == garbageRecord);
+        test_verify(PSOCacheFile::ComputeKey(record) == PSOCacheFile::ComputeKey(garbageRecord));
+
+        // a different state must give a different key
+        std::vector<std::byte> cullBackRecord;
+        WriteRecord(cullBackRecord, 0x1234, nvrhi::RasterState{}.setCullBack());
+        test_verify(PSOCacheFile::ComputeKey(record) != PSOCacheFile::ComputeKey(cullBackRecord));
+    }
+
+    // round trip: reading a record back & writing it again gives the exact same bytes
+    {
+        PSOCacheReader reader{ record };
+        test_verify(reader.Read<PSOType>() == PSOType::Graphics);
+        test_verify(reader.Read<uint8_t>() == 2);
+        test_verify(reader.ReadString() == "fullscreen_VS_FullScreenTriangle");
+        test_verify(reader.Read<uint64_t>() == 0x1234);
+        test_verify(reader.ReadString() == "tonemap_PS_Main");
+        test_verify(reader.Read<uint64_t>() == 0x1234);
+        const nvrhi::PrimitiveType primType = reader.Read<nvrhi::PrimitiveType>();
+
+        nvrhi::BlendState blendState;
+        nvrhi::DepthStencilState depthStencilState;
+        nvrhi::RasterState rasterState;
+        nvrhi::FramebufferInfo framebufferInfo;
+        nvrhi::BindingLayoutDesc layoutDesc;
+        reader.Read(blendState);
+        reader.Read(depthStencilState);
+        reader.Read(rasterState);
+        reader.Read(framebufferInfo);
+        reader.Read(layoutDesc);
+
+        test_verify(!reader.HasError());
+        test_verify(reader.IsAtEnd());
+
+        std::vector<std::byte> rewrittenRecord;
+        PSOCacheWriter writer{ rewrittenRecord };
+        writer.Write(PSOType::Graphics);
+        writer.Write((uint8_t)2);
+        writer.WriteString("fullscreen_VS_FullScreenTriangle");
+        writer.Write((uint64_t)0x1234);
+        writer.WriteString("tonemap_PS_Main");
+        writer.Write((uint64_t)0x1234);
+        writer.Write(primType);
+        writer.Write(blendState);
+        writer.Write(depthStencilState);
+        writer.Write(rasterState);
+        writer.Write(framebufferInfo);
+        writer.Write(layoutDesc);
+        test_verify(rewrittenRecord == record);
+
+        // truncated records flag an error instead of reading out of bounds
+        PSOCacheReader truncatedReader{ std::span{ record }.first(record.size() / 2) };
+        truncatedReader.Read<PSOType>();
+        truncatedReader.Read<uint8_t>();
+        truncatedReader.ReadString();
+        truncatedReader.Read<uint64_t>();
+        truncatedReader.ReadString();
+        truncatedReader.Read<uint64_t>();
+        truncatedReader.Read<nvrhi::PrimitiveType>();
+        truncatedReader.Read(blendState);
+        truncatedReader.Read(depthStencilState);
+        truncatedReader.Read(rasterState);
+        test_verify(truncatedReader.HasError());
+    }
+
+    // file round trip & invalidation
+    {
+        const std::string filePath = (std::filesystem::path{ GetExecutableDirectory() } / "PSOCacheSelfTest.bin").string();
+
+        std::vector<std::byte> otherShaderRecord;
+        WriteRecord(otherShaderRecord, 0x5678, nvrhi::RasterState{});
+
+        PSOCacheFile cacheFile;
+        test_verify(cacheFile.Add(PSOCacheFile::ComputeKey(record), record));
+        test_verify(!cacheFile.Add(PSOCacheFile::ComputeKey(record), record));
+        test_verify(cacheFile.Add(PSOCacheFile::ComputeKey(otherShaderRecord), otherShaderRecord));
+        cacheFile.Save(filePath);
+
+        PSOCacheFile loadedCacheFile;
+        test_verify(loadedCacheFile.Load(filePath));
+        test_verify(loadedCacheFile.GetNumRecords() == 2);
+        test_verify(!loadedCacheFile.Add(PSOCacheFile::ComputeKey(record), record));
+
+        // 'recompile' the shaders with hash 0x5678: only the record that uses them is dropped
+        const uint32_t numDropped = loadedCacheFile.RemoveInvalid([](std::span<const std::byte> recordBytes)
+            {
+                PSOCacheReader reader{ recordBytes };
+                reader.Read<PSOType>();
+                reader.Read<uint8_t>();
+                reader.ReadString();
+                return reader.Read<uint64_t>() == 0x1234;
+            });
+        test_verify(numDropped == 1);
+        test_verify(loadedCacheFile.GetNumRecords() == 1);
+
+        // version mismatch
+        {
+            std::vector<std::byte> fileData;
+            ReadDataFromFile(filePath, fileData);
+            const uint32_t oldVersion = PSOCacheFile::kCurrentVersion - 1;
+            memcpy(fileData.data() + sizeof(uint32_t), &oldVersion, sizeof(uint32_t));
+
+            ScopedFile file{ filePath, "wb" };
+            fwrite(fileData.data(), 1, fileData.size(), file);
+        }
+        test_verify(!PSOCacheFile{}.Load(filePath));
+
+        // missing file
+        std::filesystem::remove(filePath);
+        test_verify(!PSOCacheFile{}.Load(filePath));
+    }
+
+    // creation outside of the stripe lock: a slow creation doesn't block other keys of its stripe, & callers of the same key wait for it instead of creating it again
+    {
+        StripedCache<std::shared_ptr<uint32_t>> cache;
+        const size_t slowKey = 0;
+        const size_t otherKeyInSameStripe = 16;
+
+        std::promise<void> slowCreateStarted;
+        std::promise<void> slowCreateGate;
+        std::shared_future<void> slowCreateGateFuture = slowCreateGate.get_future().share();
+        std::atomic<uint32_t> numSlowCreates = 0;
+
+        auto SlowCreate = [&]
+            {
+                ++numSlowCreates;
+                slowCreateStarted.set_value();
+                slowCreateGateFuture.wait();
+                return std::make_shared<uint32_t>(1u);
+            };
+
+        std::shared_ptr<uint32_t> slowValues[2];
+        std::atomic<bool> bWaiterReturned = false;
+
+        std::thread creatorThread{ [&] { slowValues[0] = cache.FindOrCreate(slowKey, SlowCreate); } };
+        slowCreateStarted.get_future().wait();
+
+        std::thread waiterThread{ [&] { slowValues[1] = cache.FindOrCreate(slowKey, SlowCreate); bWaiterReturned = true; } };
+
+        // would dead-lock if the creation held the stripe's lock
+        test_verify(*cache.FindOrCreate(otherKeyInSameStripe, [] { return std::make_shared<uint32_t>(2u); }) == 2);
+        test_verify(!bWaiterReturned);
+
+        slowCreateGate.set_value();
+        creatorThread.join();
+        waiterThread.join();
+
+        test_verify(numSlowCreates == 1);
+        test_verify(slowValues[0] && (slowValues[0] == slowValues[1]));
+        test_verify(cache.FindOrCreate(slowKey, SlowCreate) == slowValues[0]);
+
+        // failed creations are retried
+        test_verify(!cache.FindOrCreate(32, [] { return std::shared_ptr<uint32_t>{}; }));
+        test_verify(*cache.FindOrCreate(32, [] { return std::make_shared<uint32_t>(3u); }) == 3);
+    }
+}
+REGISTER_HEADLESS_RUN("psocacheselftest", HeadlessRunType::SelfTest, RunPSOCacheSelfTest);
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "extern/nvrhi/include/nvrhi/nvrhi.h"
+
+enum class PSOType : uint8_t { Graphics, Meshlet, Compute };
+
+// Writes pipeline descs as a pointer-free byte record. The record is both the PSO cache key (hashed) & what is saved to disk to re-create the pipeline on the next launch
+// States are written field by field, so struct padding never leaks into the key
+class PSOCacheWriter
+{
+public:
+    explicit PSOCacheWriter(std::vector<std::byte>& bytes) : m_Bytes(bytes) {}
+
+    template <typename T>
+    void Write(T value)
+    {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+
+        const size_t offset = m_Bytes.size();
+        m_Bytes.resize(offset + sizeof(T));
+        memcpy(m_Bytes.data() + offset, &value, sizeof(T));
+    }
+
+    void WriteString(std::string_view str);
+    void Write(const nvrhi::BlendState& blendState);
+    void Write(const nvrhi::DepthStencilState& depthStencilState);
+    void Write(const nvrhi::RasterState& rasterState);
+    void Write(const nvrhi::FramebufferInfo& framebufferInfo);
+    void Write(const nvrhi::BindingLayoutDesc& layoutDesc);
+    void Write(const nvrhi::BindlessLayoutDesc& layoutDesc);
+
+private:
+    std::vector<std::byte>& m_Bytes;
+};
+
+// Mirror of 'PSOCacheWriter'. Reading past the end or an out of range count flags an error instead of asserting, as records come from disk
+class PSOCacheReader
+{
+public:
+    explicit PSOCacheReader(std::span<const std::byte> bytes) : m_Bytes(bytes) {}
+
+    template <typename T>
+    T Read()
+    {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+
+        T value{};
+        if (m_Offset + sizeof(T) > m_Bytes.size())
+        {
+            m_bError = true;
+            return value;
+        }
+
+        memcpy(&value, m_Bytes.data() + m_Offset, sizeof(T));
+        m_Offset += sizeof(T);
+        return value;
+    }
+
+    std::string ReadString();
+    void Read(nvrhi::BlendState& blendState);
+    void Read(nvrhi::DepthStencilState& depthStencilState);
+    void Read(nvrhi::RasterState& rasterState);
+    void Read(nvrhi::FramebufferInfo& framebufferInfo);
+    void Read(nvrhi::BindingLayoutDesc& layoutDesc);
+    void Read(nvrhi::BindlessLayoutDesc& layoutDesc);
+
+    bool HasError() const { return m_bError; }
+    bool IsAtEnd() const { return m_Offset == m_Bytes.size(); }
+
+private:
+    // flags an error if 'count' is above 'maxCount'
+    uint32_t ReadCount(uint32_t maxCount);
+
+    std::span<const std::byte> m_Bytes;
+    size_t m_Offset = 0;
+    bool m_bError = false;
+};
+
+// Set of PSO records saved on disk between launches. Thread safe
+class PSOCacheFile
+{
+public:
+    static constexpr uint32_t kMagic = 0x434F5350; // "PSOC"
+    static constexpr uint32_t kCurrentVersion = 2;
+
+    struct Header
+    {
+        uint32_t m_Magic = kMagic;
+        uint32_t m_Version = kCurrentVersion;
+        uint32_t m_NumRecords = 0;
+    };
+
+    static size_t ComputeKey(std::span<const std::byte> record);
+
+    // returns false if the file is missing, truncated or from another version. Keys are re-computed from the records, not trusted from disk
+    bool Load(std::string_view filePath);
+    void Save(std::string_view filePath) const;
+
+    // returns false if the record was already there
+    bool Add(size_t key, std::span<const std::byte> record);
+
+    // drops the records rejected by 'isValidFunc', i.e. the ones that use shaders that were removed or recompiled. Returns the # of dropped records
+    uint32_t RemoveInvalid(const std::function<bool(std::span<const std::byte>)>& isValidFunc);
+
+    std::vector<std::vector<std::byte>> GetRecords() const;
+    uint32_t GetNumRecords() const;
+
+private:
+    mutable std::mutex m_Lock;
+    std::unordered_map<size_t, std::vector<std::byte>> m_Records;
+};
+
+// Hash map split into independently locked stripes. Hits only take a shared lock on their stripe, so concurrent lookups don't block each other
+// Values are created outside of the lock: the 1st caller of a key inserts a pending entry & creates the value, later callers of that key wait for it
+// So a PSO being pre-warmed in the background is never created twice, & never blocks lookups of other keys of its stripe
+template <typename Value, uint32_t kNumStripes = 16>
+class StripedCache
+{
+public:
+    template <typename CreateFunc>
+    Value FindOrCreate(size_t key, CreateFunc&& createFunc)
+    {
+        Stripe& stripe = m_Stripes[key % kNumStripes];
+
+        std::shared_future<Value> pendingValue;
+        {
+            std::shared_lock lock{ stripe.m_Lock };
+
+            auto it = stripe.m_Map.find(key);
+            if (it != stripe.m_Map.end())
+            {
+                if (it->second.m_Value)
+                {
+                    return it->second.m_Value;
+                }
+                pendingValue = it->second.m_PendingValue;
+            }
+        }
+
+        std::promise<Value> valuePromise;
+        if (!pendingValue.valid())
+        {
+            std::unique_lock lock{ stripe.m_Lock };
+
+            Entry& entry = stripe.m_Map[key];
+            if (entry.m_Value)
+            {
+                return entry.m_Value;
+            }
+
+            if (entry.m_PendingValue.valid())
+            {
+                pendingValue = entry.m_PendingValue;
+            }
+            else
+            {
+                entry.m_PendingValue = valuePromise.get_future().share();
+            }
+        }
+
+        // another thread is creating it
+        if (pendingValue.valid())
+        {
+            return pendingValue.get();
+        }
+
+        Value value = createFunc();
+        {
+            std::unique_lock lock{ stripe.m_Lock };
+
+            // failed creations are not cached, the next caller retries. The entry may be gone if the cache was cleared in the meantime
+            auto it = stripe.m_Map.find(key);
+            if (it != stripe.m_Map.end())
+            {
+                if (value)
+                {
+                    it->second = Entry{ value };
+                }
+                else
+                {
+                    stripe.m_Map.erase(it);
+                }
+            }
+        }
+        valuePromise.set_value(value);
+
+        return value;
+    }
+
+    // returns the # of erased entries
+    template <typename Predicate>
+    uint32_t EraseIf(Predicate&& predicate)
+    {
+        uint32_t numErased = 0;
+        for (Stripe& stripe : m_Stripes)
+        {
+            std::unique_lock lock{ stripe.m_Lock };
+            numErased += (uint32_t)std::erase_if(stripe.m_Map, [&predicate](const auto& it) { return it.second.m_Value && predicate(it.second.m_Value); });
+        }
+        return numErased;
+    }
+
+    void Clear()
+    {
+        for (Stripe& stripe : m_Stripes)
+        {
+            std::unique_lock lock{ stripe.m_Lock };
+            stripe.m_Map.clear();
+        }
+    }
+
+private:
+    struct Entry
+    {
+        Value m_Value;
+        std::shared_future<Value> m_PendingValue; // only while 'm_Value' is being created
+    };
+
+    struct Stripe
+    {
+        std::shared_mutex m_Lock;
+        std::unordered_map<size_t, Entry> m_Map;
+    };
+
+    std::array<Stripe, kNumStripes> m_Stripes;
+};
@@ -19,16 +19,16 @@ public:
 	{
         if (g_Scene->m_bEnableBloom)
         {
-            renderGraph.AddReadDependency(g_BloomRDGTextureHandle);
+            renderGraph.AddReadDependency(g_BloomRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
         }
 
         if (g_Scene->IsTAAEnabled())
         {
-            renderGraph.AddReadDependency(g_AntiAliasedLightingOutputRDGTextureHandle);
+            renderGraph.AddReadDependency(g_AntiAliasedLightingOutputRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
         }
         else
         {
-            renderGraph.AddReadDependency(g_LightingOutputRDGTextureHandle);
+            renderGraph.AddReadDependency(g_LightingOutputRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
         }
 
 		return true;
@@ -66,7 +66,7 @@ public:
         fullScreenPassParams.m_CommandList = commandList;
         fullScreenPassParams.m_FrameBufferDesc = frameBufferDesc;
         fullScreenPassParams.m_BindingSetDesc = bindingSetDesc;
-        fullScreenPassParams.m_ShaderName = "postprocess_PS_PostProcess";
+        fullScreenPassParams.m_ShaderID = "postprocess_PS_PostProcess";
         fullScreenPassParams.m_PushConstantsData = &passParameters;
         fullScreenPassParams.m_PushConstantsBytes = sizeof(passParameters);
 
@@ -65,9 +65,9 @@ public:
 
     bool Setup(RenderGraph& renderGraph) override
     {
-        renderGraph.AddReadDependency(g_GBufferARDGTextureHandle);
-        renderGraph.AddReadDependency(g_GBufferMotionRDGTextureHandle);
-        renderGraph.AddReadDependency(g_DepthBufferCopyRDGTextureHandle);
+        renderGraph.AddReadDependency(g_GBufferARDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
+        renderGraph.AddReadDependency(g_GBufferMotionRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
+        renderGraph.AddReadDependency(g_DepthBufferCopyRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
 
         nvrhi::TextureDesc restirOutputDesc;
         restirOutputDesc.width = g_Graphic.m_RenderResolution.x;
@@ -100,7 +100,7 @@ public:
         restirLightingConstants.m_OutputResolutionInv = Vector2{ 1.0f / g_Graphic.m_RenderResolution.x, 1.0f / g_Graphic.m_RenderResolution.y };
         restirLightingConstants.m_OutputBufferIndex = 0;
 
-        nvrhi::BufferHandle constantBuffer = g_Graphic.CreateConstantBuffer(commandList, restirLightingConstants);
+        nvrhi::BufferHandle constantBuffer = g_Graphic.WriteConstantBuffer(commandList, restirLightingConstants);
 
         ReSTIRLightInfo dirLightInfo;
         dirLightInfo.m_Direction = g_Scene->m_DirLightVec;
@@ -126,7 +126,7 @@ public:
 
         Graphic::ComputePassParams passParams;
         passParams.m_CommandList = commandList;
-        passParams.m_ShaderName = "restirshading_CS_Main";
+        passParams.m_ShaderID = "restirshading_CS_Main";
         passParams.m_BindingSetDesc = bindingSetDesc;
         passParams.m_DispatchGroupSize = ComputeShaderUtils::GetGroupCount(g_Graphic.m_RenderResolution, Vector2U{ 8, 8 });
         g_Graphic.AddComputePass(passParams);
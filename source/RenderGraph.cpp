@@ -1,10 +1,12 @@
 #include "RenderGraph.h"
 
+#include <sstream>
+
 #include "extern/imgui/imgui.h"
 
-#include "Engine.h"
-#include "Graphic.h"
-#include "Scene.h"
+#include "ChildCommandLists.h"
+#include "EngineCore.h"
+#include "Renderer.h"
 
 // NOTE: jank solution to access the correct ResourceAccess array index via PassID of the currently executing thread
 thread_local RenderGraph::PassID tl_CurrentThreadPassID = RenderGraph::kInvalidPassID;
@@ -17,46 +19,51 @@ static const uint32_t kMaxTransientResourceAge = 2;
 
 static std::size_t HashResourceDesc(const nvrhi::TextureDesc& desc)
 {
-	std::size_t seed = 0;
-	HashCombine(seed, desc.width);
-	HashCombine(seed, desc.height);
-	HashCombine(seed, desc.depth);
-	HashCombine(seed, desc.arraySize);
-	HashCombine(seed, desc.mipLevels);
-	HashCombine(seed, desc.sampleCount);
-	HashCombine(seed, desc.sampleQuality);
-	HashCombine(seed, desc.format);
-	HashCombine(seed, desc.dimension);
-	HashCombine(seed, desc.isRenderTarget);
-	HashCombine(seed, desc.isUAV);
-	HashCombine(seed, desc.isTypeless);
-	HashCombine(seed, desc.isShadingRateSurface);
-	HashCombine(seed, HashRawMem(desc.clearValue));
-	HashCombine(seed, desc.useClearValue);
-	return seed;
+	Hasher hasher;
+	hasher.Update(desc.width);
+	hasher.Update(desc.height);
+	hasher.Update(desc.depth);
+	hasher.Update(desc.arraySize);
+	hasher.Update(desc.mipLevels);
+	hasher.Update(desc.sampleCount);
+	hasher.Update(desc.sampleQuality);
+	hasher.Update(desc.format);
+	hasher.Update(desc.dimension);
+	hasher.Update(desc.isRenderTarget);
+	hasher.Update(desc.isUAV);
+	hasher.Update(desc.isTypeless);
+	hasher.Update(desc.isShadingRateSurface);
+	hasher.Update(desc.clearValue.r);
+	hasher.Update(desc.clearValue.g);
+	hasher.Update(desc.clearValue.b);
+	hasher.Update(desc.clearValue.a);
+	hasher.Update(desc.useClearValue);
+	return (std::size_t)hasher.Finalize();
 }
 
 static std::size_t HashResourceDesc(const nvrhi::BufferDesc& desc)
 {
-	std::size_t seed = 0;
-	HashCombine(seed, desc.byteSize);
-	HashCombine(seed, desc.structStride);
-	HashCombine(seed, desc.format);
-	HashCombine(seed, desc.canHaveUAVs);
-	HashCombine(seed, desc.canHaveTypedViews);
-	HashCombine(seed, desc.canHaveRawViews);
-	HashCombine(seed, desc.isVertexBuffer);
-	HashCombine(seed, desc.isIndexBuffer);
-	HashCombine(seed, desc.isConstantBuffer);
-	HashCombine(seed, desc.isDrawIndirectArgs);
-	HashCombine(seed, desc.isAccelStructBuildInput);
-	HashCombine(seed, desc.isAccelStructStorage);
-	HashCombine(seed, desc.isShaderBindingTable);
-	return seed;
-}
-
-void RenderGraph::Initialize()
+	Hasher hasher;
+	hasher.Update(desc.byteSize);
+	hasher.Update(desc.structStride);
+	hasher.Update(desc.format);
+	hasher.Update(desc.canHaveUAVs);
+	hasher.Update(desc.canHaveTypedViews);
+	hasher.Update(desc.canHaveRawViews);
+	hasher.Update(desc.isVertexBuffer);
+	hasher.Update(desc.isIndexBuffer);
+	hasher.Update(desc.isConstantBuffer);
+	hasher.Update(desc.isDrawIndirectArgs);
+	hasher.Update(desc.isAccelStructBuildInput);
+	hasher.Update(desc.isAccelStructStorage);
+	hasher.Update(desc.isShaderBindingTable);
+	return (std::size_t)hasher.Finalize();
+}
+
+void RenderGraph::Initialize(RenderGraphBackend& backend)
 {
+	m_Backend = &backend;
+
     CreateNewHeap(kDefaultHeapBlockSize);
 }
 
@@ -64,10 +71,31 @@ void RenderGraph::InitializeForFrame(tf::Taskflow& taskFlow)
 {
 	PROFILE_FUNCTION();
 
+	// passes of the previous frame are done executing at this point
+	if (!m_ExportTraceFileName.empty())
+	{
+		ExportTrace(m_ExportTraceFileName);
+		m_ExportTraceFileName.clear();
+	}
+
+	if (!m_ExportDeclarationsFileName.empty())
+	{
+		ExportDeclarations(m_ExportDeclarationsFileName);
+		m_ExportDeclarationsFileName.clear();
+	}
+
 	m_TaskFlow = &taskFlow;
+	m_FrameStartTick = SDL_GetTicksNS();
 	m_CommandListQueueTasks.clear();
 
-	m_Passes.clear();
+	// NOTE: release passes before rewinding the allocator, as they hold memory from it. 'clear' alone would keep their storage
+	const size_t numPassesLastFrame = m_Passes.size();
+	std::pmr::vector<Pass>{ &m_FrameAllocator }.swap(m_Passes);
+	m_FrameAllocator.Reset();
+
+	// frames usually add the same passes: avoid leaving the storage of every growth step behind in the allocator
+	m_Passes.reserve(numPassesLastFrame);
+	m_SetupHash = 0;
 
 	// get ready for next frame
 	m_CurrentPhase = Phase::Setup;
@@ -79,63 +107,117 @@ void RenderGraph::Shutdown()
 	{
         resourceHandle->m_Resource = nullptr;
 	}
+
+	m_RendererCommandLists.clear();
 }
 
 void RenderGraph::Compile()
 {
 	PROFILE_FUNCTION();
 
+	Timer compileTimer;
+
 	m_CurrentPhase = Phase::Execute;
 
+	// last frame's barrier plan left every accessed resource in the state of its first access
+	for (ResourceHandle* resourceHandle : m_ResourceHandles)
+	{
+		if (resourceHandle->m_Resource && (resourceHandle->m_PlannedWrapState != nvrhi::ResourceStates::Unknown))
+		{
+			resourceHandle->m_PlannedState = resourceHandle->m_PlannedWrapState;
+		}
+	}
+
     // set ordered execution of command list queuing tasks
 	for (uint32_t i = 1; i < m_CommandListQueueTasks.size(); ++i)
 	{
         m_CommandListQueueTasks[i].succeed(m_CommandListQueueTasks[i - 1]);
 	}
 
-	// Track first/last Renderer access
-	for (size_t i = 0; i < m_Passes.size(); i++)
+	// frame-to-frame, the declared passes & resources are almost always identical. No need to re-compute access intervals
+	const bool bCompileCacheHit = m_bEnableCompileCache && (m_SetupHash == m_CompiledSetupHash);
+
+	if (bCompileCacheHit)
 	{
-		const Pass& pass = m_Passes.at(i);
+		++m_NumCompileCacheHits;
+	}
+	else
+	{
+		PROFILE_SCOPED("Compute Resource Access Intervals");
 
-		const PassID passID = i;
-		for (const ResourceAccess& resourceAccess : pass.m_ResourceAccesses)
-		{
-			ResourceHandle& resource = *resourceAccess.m_ResourceHandle;
+		++m_NumCompileCacheMisses;
 
-			// update first and last access
-			if (resource.m_FirstAccess == kInvalidPassID)
-			{
-				// first access to resource must always be a write
-				check(resourceAccess.m_AccessType == ResourceHandle::AccessType::Write);
+		for (ResourceHandle* resourceHandle : m_ResourceHandles)
+		{
+			resourceHandle->m_FirstAccess = kInvalidPassID;
+			resourceHandle->m_LastAccess = kInvalidPassID;
+		}
 
-				resource.m_FirstAccess = passID;
-			}
-			resource.m_LastAccess = passID;
+		// Track first/last Renderer access
+		for (size_t i = 0; i < m_Passes.size(); i++)
+		{
+			const Pass& pass = m_Passes.at(i);
 
-			if (resourceAccess.m_AccessType == ResourceHandle::AccessType::Write)
+			const PassID passID = i;
+			for (const ResourceAccess& resourceAccess : pass.m_ResourceAccesses)
 			{
-				//resource.m_LastWrite = passID;
+				ResourceHandle& resource = *resourceAccess.m_ResourceHandle;
+
+				// update first and last access
+				if (resource.m_FirstAccess == kInvalidPassID)
+				{
+					// first access to resource must always be a write
+					check(resourceAccess.m_AccessType == ResourceHandle::AccessType::Write);
+
+					resource.m_FirstAccess = passID;
+				}
+				resource.m_LastAccess = passID;
+
+				if (resourceAccess.m_AccessType == ResourceHandle::AccessType::Write)
+				{
+					//resource.m_LastWrite = passID;
+				}
 			}
 		}
+
+		BuildBarrierPlan();
+
+#if _DEBUG
+		ValidateBarrierPlan();
+#endif // _DEBUG
+
+		m_CompiledSetupHash = m_SetupHash;
+
+		// set of accessed resources may have changed. force an aging pass
+		m_NextResourceAgingFrameIdx = 0;
 	}
 
-	for (ResourceHandle* resourceHandle : m_ResourceHandles)
+	// on a cache hit, the same resources are accessed as the previous frame. Only resources that were not accessed can age out
+	if (m_Backend->GetFrameCounter() >= m_NextResourceAgingFrameIdx)
 	{
-		check(resourceHandle->m_AllocatedFrameIdx != UINT32_MAX);
+		PROFILE_SCOPED("Age Transient Resources");
 
-		const int32_t resourceAge = g_Graphic.m_FrameCounter - resourceHandle->m_AllocatedFrameIdx;
-		check(resourceAge >= 0);
+		m_NextResourceAgingFrameIdx = UINT32_MAX;
 
-		// free transient resources that are too old
-		if (resourceHandle->m_Resource && (resourceAge > kMaxTransientResourceAge))
+		for (ResourceHandle* resourceHandle : m_ResourceHandles)
 		{
-			FreeResource(*resourceHandle);
+			check(resourceHandle->m_AllocatedFrameIdx != UINT32_MAX);
+
+			const int32_t resourceAge = m_Backend->GetFrameCounter() - resourceHandle->m_AllocatedFrameIdx;
+			check(resourceAge >= 0);
+
+			// free transient resources that are too old
+			if (resourceHandle->m_Resource && (resourceAge > kMaxTransientResourceAge))
+			{
+				FreeResource(*resourceHandle);
+			}
+			else if (resourceHandle->m_Resource && (resourceAge > 0))
+			{
+				m_NextResourceAgingFrameIdx = std::min(m_NextResourceAgingFrameIdx, resourceHandle->m_AllocatedFrameIdx + kMaxTransientResourceAge + 1);
+			}
 		}
 	}
 
-	nvrhi::DeviceHandle device = g_Graphic.m_NVRHIDevice;
-
 	// allocate resources
 	for (ResourceHandle* resource : m_ResourcesToAlloc)
 	{
@@ -145,13 +227,11 @@ void RenderGraph::Compile()
 
 		if (resource->m_Type == ResourceHandle::Type::Texture)
 		{
-			resource->m_Resource = device->createTexture(m_ResourceDescs.at(resource->m_DescIdx).m_TextureDesc);
-			memReq = device->getTextureMemoryRequirements((nvrhi::ITexture*)resource->m_Resource.Get()).size;
+			resource->m_Resource = m_Backend->CreateTexture(m_ResourceDescs.at(resource->m_DescIdx).m_TextureDesc, memReq);
 		}
 		else
 		{
-			resource->m_Resource = device->createBuffer(m_ResourceDescs.at(resource->m_DescIdx).m_BufferDesc);
-			memReq = device->getBufferMemoryRequirements((nvrhi::IBuffer*)resource->m_Resource.Get()).size;
+			resource->m_Resource = m_Backend->CreateBuffer(m_ResourceDescs.at(resource->m_DescIdx).m_BufferDesc, memReq);
 		}
 
 		check(memReq != 0);
@@ -189,16 +269,20 @@ void RenderGraph::Compile()
 
         resource->m_HeapIdx = foundHeapIdx;
         resource->m_HeapOffset = foundHeapOffset;
+		resource->m_HeapSize = memReq;
+		resource->m_PlannedState = resource->m_Type == ResourceHandle::Type::Texture ?
+			m_ResourceDescs.at(resource->m_DescIdx).m_TextureDesc.initialState :
+			m_ResourceDescs.at(resource->m_DescIdx).m_BufferDesc.initialState;
         {
             PROFILE_SCOPED("Bind Resource Memory");
 
             if (resource->m_Type == ResourceHandle::Type::Texture)
             {
-                verify(g_Graphic.m_NVRHIDevice->bindTextureMemory((nvrhi::ITexture*)resource->m_Resource.Get(), m_Heaps[foundHeapIdx].m_Heap, foundHeapOffset));
+                verify(m_Backend->BindTextureMemory(resource->m_Resource, m_Heaps[foundHeapIdx].m_Heap, foundHeapOffset));
             }
             else
             {
-                verify(g_Graphic.m_NVRHIDevice->bindBufferMemory((nvrhi::IBuffer*)resource->m_Resource.Get(), m_Heaps[foundHeapIdx].m_Heap, foundHeapOffset));
+                verify(m_Backend->BindBufferMemory(resource->m_Resource, m_Heaps[foundHeapIdx].m_Heap, foundHeapOffset));
             }
         }
 
@@ -218,6 +302,8 @@ void RenderGraph::Compile()
         m_Heaps.at(elem.m_Idx).Free(elem.m_Offset);
 	}
 	m_HeapsToFree.clear();
+
+	m_LastCompileTimeUs = compileTimer.GetElapsedMicroSeconds();
 }
 
 tf::Task RenderGraph::AddRenderer(IRenderer* renderer)
@@ -227,14 +313,18 @@ tf::Task RenderGraph::AddRenderer(IRenderer* renderer)
 	check(renderer);
 
 	// increase PassID type size if needed
-	check(m_Passes.size() < std::numeric_limits<PassID>::max());
+	check(m_Passes.size() < kInvalidPassID);
 
 	const PassID passIdx = m_Passes.size();
 
 	// just append a a new Pass. will pop it if the renderer is not used
-	Pass& newPass = m_Passes.emplace_back();
+	Pass& newPass = m_Passes.emplace_back(&m_FrameAllocator);
+
+	newPass.m_SetupStartTick = SDL_GetTicksNS();
+	const bool bRendererActive = renderer->Setup(*this);
+	newPass.m_SetupEndTick = SDL_GetTicksNS();
 
-	if (!renderer->Setup(*this))
+	if (!bRendererActive)
 	{
 		// ensure that no read/write dependencies were requested
 		// allocating a transient resource will implicitly add a write dependency as well
@@ -248,57 +338,142 @@ tf::Task RenderGraph::AddRenderer(IRenderer* renderer)
 	}
 
 	newPass.m_Renderer = renderer;
-	newPass.m_CommandList = g_Graphic.AllocateCommandList(); // TODO: compute queue
 
-    // main Renderer task
-	tf::Task renderTask = m_TaskFlow->emplace([this, passIdx]
-		{
-			// NOTE: see comment in declaration of this threadlocal variable
-			tl_CurrentThreadPassID = passIdx;
+	HashCombine(m_SetupHash, renderer);
+	HashCombine(m_SetupHash, newPass.m_ResourceAccesses.size());
+
+	const uint32_t numChildCommandLists = newPass.m_NumChildCommandLists;
 
-			Pass& pass = m_Passes.at(passIdx);
-			IRenderer* renderer = pass.m_Renderer;
-			check(renderer);
-			check(pass.m_CommandList);
+	RendererCommandLists& rendererCommandLists = m_RendererCommandLists[renderer];
+	check(rendererCommandLists.m_LastFrameStartTick != m_FrameStartTick); // renderer added twice in a frame
+	rendererCommandLists.m_LastFrameStartTick = m_FrameStartTick;
 
-			PROFILE_SCOPED(renderer->m_Name.c_str());
-			Timer passTimer;
+	if (rendererCommandLists.m_NumChildCommandLists != numChildCommandLists)
+	{
+		const uint32_t numCommandLists = ChildCommandLists::GetNumCommandLists(numChildCommandLists);
+		rendererCommandLists.m_NumChildCommandLists = numChildCommandLists;
+		rendererCommandLists.m_CommandLists.resize(numCommandLists);
+		rendererCommandLists.m_Names.resize(numCommandLists);
 
-			SCOPED_COMMAND_LIST(pass.m_CommandList, renderer->m_Name.c_str());
+		for (uint32_t i = 0; i < numCommandLists; ++i)
+		{
+			rendererCommandLists.m_Names[i] =
+				(i == 0) ? renderer->m_Name :
+				ChildCommandLists::IsChild(i, numChildCommandLists) ? StringFormat("%s Child %u", renderer->m_Name.c_str(), i - 1) :
+				renderer->m_Name + " End";
+		}
+	}
 
-			nvrhi::TimerQueryHandle& rendererTimerQuery = renderer->m_FrameTimerQuery[g_Graphic.m_FrameCounter % 2];
+	// last frame's command lists are released to their pool, & their timestamps dont leak into this frame's trace
+	for (PassCommandList& passCommandList : rendererCommandLists.m_CommandLists)
+	{
+		passCommandList = PassCommandList{};
+	}
 
-			if (!rendererTimerQuery)
+	newPass.m_CommandLists = rendererCommandLists.m_CommandLists;
+	newPass.m_CommandListNames = rendererCommandLists.m_Names;
+
+	const ChildCommandLists::Tasks tasks = ChildCommandLists::Emplace(*m_TaskFlow, numChildCommandLists,
+		[this, passIdx](uint32_t commandListIdx) { RecordPassCommandList(passIdx, commandListIdx); },
+		[this, passIdx]
+		{
+			for (const PassCommandList& passCommandList : m_Passes.at(passIdx).m_CommandLists)
 			{
-				rendererTimerQuery = g_Graphic.m_NVRHIDevice->createTimerQuery();
+				check(passCommandList.m_CommandList);
+				m_Backend->QueueCommandList(passCommandList.m_CommandList);
 			}
+		});
+
+    m_CommandListQueueTasks.push_back(tasks.m_Queue);
+	
+	return tasks.m_Record;
+}
+
+void RenderGraph::SetNumChildCommandLists(uint32_t numChildCommandLists)
+{
+	check(m_CurrentPhase == Phase::Setup);
+	check(!m_Passes.empty());
+
+	// only valid from 'IRenderer::Setup', for the pass being set up
+	Pass& pass = m_Passes.back();
+	check(!pass.m_Renderer);
+
+	pass.m_NumChildCommandLists = numChildCommandLists;
+}
 
-			renderer->m_GPUFrameTime = Timer::SecondsToMilliSeconds(g_Graphic.m_NVRHIDevice->getTimerQueryTime(rendererTimerQuery));
-			
-			g_Graphic.m_NVRHIDevice->resetTimerQuery(rendererTimerQuery);
-        	pass.m_CommandList->beginTimerQuery(rendererTimerQuery);
+void RenderGraph::RecordPassCommandList(PassID passID, uint32_t commandListIdx)
+{
+	// NOTE: see comment in declaration of this threadlocal variable
+	tl_CurrentThreadPassID = passID;
 
-			renderer->Render(pass.m_CommandList, *this);
+	Pass& pass = m_Passes.at(passID);
+	IRenderer* renderer = pass.m_Renderer;
+	check(renderer);
 
-			pass.m_CommandList->endTimerQuery(rendererTimerQuery);
+	const uint32_t numChildCommandLists = pass.m_NumChildCommandLists;
+	const bool bIsChild = ChildCommandLists::IsChild(commandListIdx, numChildCommandLists);
+	const bool bIsLast = (commandListIdx == pass.m_CommandLists.size() - 1);
 
-			renderer->m_CPUFrameTime = passTimer.GetElapsedMilliseconds();
+	check(commandListIdx < pass.m_CommandLists.size());
+	PassCommandList& passCommandList = pass.m_CommandLists[commandListIdx];
 
-			tl_CurrentThreadPassID = RenderGraph::kInvalidPassID;
-		});
+	// NOTE: allocated lazily, so that passes that are set up but never executed (i.e. benchmarks) dont take any command lists
+	passCommandList.m_CommandList = m_Backend->AllocateCommandList(); // TODO: compute queue
+	nvrhi::CommandListHandle commandList = passCommandList.m_CommandList;
 
-	// command list queuing task
-	tf::Task queueCommandListTask = m_TaskFlow->emplace([this, passIdx]
+	const std::string& commandListName = pass.m_CommandListNames[commandListIdx];
+
+	PROFILE_SCOPED(commandListName.c_str());
+
+	passCommandList.m_RecordStartTick = SDL_GetTicksNS();
+	passCommandList.m_RecordThreadID = SDL_GetCurrentThreadID();
+
+	m_Backend->BeginCommandList(commandList, commandListName.c_str());
+
+	// NOTE: begins in the pass' own command list & ends in the last one, so that it covers the children
+	if (commandListIdx == 0)
+	{
+		m_Backend->BeginRendererTimer(*renderer, commandList);
+
+		CommitPassBeginBarriers(passID, commandList);
+
+		renderer->Render(commandList, *this);
+	}
+	else
+	{
+		BeginChildCommandList(passID, commandList);
+
+		if (bIsChild)
 		{
-			Pass& pass = m_Passes.at(passIdx);
-			check(pass.m_CommandList);
+			renderer->RenderChild(commandList, *this, commandListIdx - 1);
 
-			g_Graphic.QueueCommandList(pass.m_CommandList);
-		});
+			EndChildCommandList(passID, commandList);
+		}
+	}
 
-    m_CommandListQueueTasks.push_back(queueCommandListTask);
-	
-	return renderTask;
+	if (bIsLast)
+	{
+		CommitPassEndBarriers(passID, commandList);
+
+		m_Backend->EndRendererTimer(*renderer, commandList);
+	}
+
+	m_Backend->EndCommandList(commandList);
+
+	passCommandList.m_RecordEndTick = SDL_GetTicksNS();
+
+	if (bIsLast)
+	{
+		// CPU cost of the pass. Children are recorded in parallel, so it can be more than the time between the 1st & last command list
+		uint64_t recordTicks = 0;
+		for (const PassCommandList& recordedCommandList : pass.m_CommandLists)
+		{
+			recordTicks += recordedCommandList.m_RecordEndTick - recordedCommandList.m_RecordStartTick;
+		}
+		renderer->m_CPUFrameTime = (float)(SDL_NS_TO_US((double)recordTicks) / 1000.0);
+	}
+
+	tl_CurrentThreadPassID = RenderGraph::kInvalidPassID;
 }
 
 template <typename ResourceDescT>
@@ -319,18 +494,12 @@ void RenderGraph::CreateTransientResource(ResourceHandle& resourceHandle, const
 		m_ResourceDescs.emplace_back();
 	}
 
+	const std::size_t descHash = HashResourceDesc(inputDesc);
+
 	bool bReallocResource = false;
     bReallocResource |= resourceType != resourceHandle.m_Type;
-	bReallocResource |= (g_Graphic.m_FrameCounter - resourceHandle.m_AllocatedFrameIdx) > kMaxTransientResourceAge;
-
-	if constexpr (resourceType == ResourceHandle::Type::Texture)
-	{
-		bReallocResource |= HashResourceDesc(m_ResourceDescs.at(resourceHandle.m_DescIdx).m_TextureDesc) != HashResourceDesc(inputDesc);
-	}
-	else
-	{
-        bReallocResource |= HashResourceDesc(m_ResourceDescs.at(resourceHandle.m_DescIdx).m_BufferDesc) != HashResourceDesc(inputDesc);
-	}
+	bReallocResource |= (m_Backend->GetFrameCounter() - resourceHandle.m_AllocatedFrameIdx) > kMaxTransientResourceAge;
+	bReallocResource |= resourceHandle.m_DescHash != descHash;
 
     if (bReallocResource)
     {
@@ -338,8 +507,11 @@ void RenderGraph::CreateTransientResource(ResourceHandle& resourceHandle, const
 		m_ResourcesToAlloc.push_back(&resourceHandle);
     }
 
-	resourceHandle.m_AllocatedFrameIdx = g_Graphic.m_FrameCounter;
+	resourceHandle.m_AllocatedFrameIdx = m_Backend->GetFrameCounter();
     resourceHandle.m_Type = resourceType;
+	resourceHandle.m_DescHash = descHash;
+
+	HashCombine(m_SetupHash, descHash);
 
     if constexpr (resourceType == ResourceHandle::Type::Texture)
     {
@@ -355,16 +527,19 @@ void RenderGraph::CreateTransientResource(ResourceHandle& resourceHandle, const
     }
 
 	// creator implicitly has a write dependency on the resource
-	AddWriteDependency(resourceHandle);
+	AddDependencyInternal(resourceHandle, ResourceHandle::AccessType::Write, nvrhi::ResourceStates::Unknown, true /*bCreatesResource*/);
 }
 template void RenderGraph::CreateTransientResource(ResourceHandle& resourceHandle, const nvrhi::TextureDesc& inputDesc);
 template void RenderGraph::CreateTransientResource(ResourceHandle& resourceHandle, const nvrhi::BufferDesc& inputDesc);
 
-void RenderGraph::AddDependencyInternal(ResourceHandle& resourceHandle, ResourceHandle::AccessType accessType)
+void RenderGraph::AddDependencyInternal(ResourceHandle& resourceHandle, ResourceHandle::AccessType accessType, nvrhi::ResourceStates state, bool bCreatesResource)
 {
 	check(m_CurrentPhase == Phase::Setup);
 
-	std::vector<ResourceAccess>& accesses = m_Passes.back().m_ResourceAccesses;
+	// write states can be derived from the desc, but a read state cant: the same resource may be read as SRV, depth, indirect args or copy source
+	check(accessType == ResourceHandle::AccessType::Write || state != nvrhi::ResourceStates::Unknown);
+
+	std::pmr::vector<ResourceAccess>& accesses = m_Passes.back().m_ResourceAccesses;
 
 	// check if resource already requested a dependency
 #if _DEBUG
@@ -374,18 +549,405 @@ void RenderGraph::AddDependencyInternal(ResourceHandle& resourceHandle, Resource
 	}
 #endif // _DEBUG
 
-	accesses.push_back(ResourceAccess{ &resourceHandle, accessType });
+	accesses.push_back(ResourceAccess{ &resourceHandle, accessType, state, bCreatesResource });
+
+	HashCombine(m_SetupHash, &resourceHandle);
+	HashCombine(m_SetupHash, accessType);
+	HashCombine(m_SetupHash, state);
+}
+
+nvrhi::ResourceStates RenderGraph::GetDefaultWriteState(const ResourceHandle& resourceHandle) const
+{
+	if (resourceHandle.m_Type == ResourceHandle::Type::Texture)
+	{
+		const nvrhi::TextureDesc& desc = m_ResourceDescs.at(resourceHandle.m_DescIdx).m_TextureDesc;
+
+		if (desc.isRenderTarget)
+		{
+			return nvrhi::getFormatInfo(desc.format).hasDepth ? nvrhi::ResourceStates::DepthWrite : nvrhi::ResourceStates::RenderTarget;
+		}
+		return desc.isUAV ? nvrhi::ResourceStates::UnorderedAccess : nvrhi::ResourceStates::CopyDest;
+	}
+
+	const nvrhi::BufferDesc& desc = m_ResourceDescs.at(resourceHandle.m_DescIdx).m_BufferDesc;
+	return desc.canHaveUAVs ? nvrhi::ResourceStates::UnorderedAccess : nvrhi::ResourceStates::CopyDest;
+}
+
+// Whether 'state' is a valid way for the access to use the resource, from the access type & what the resource desc allows only
+bool RenderGraph::IsLegalAccessState(const ResourceAccess& resourceAccess, nvrhi::ResourceStates state) const
+{
+	const nvrhi::ResourceStates kWriteStates =
+		nvrhi::ResourceStates::RenderTarget | nvrhi::ResourceStates::UnorderedAccess | nvrhi::ResourceStates::DepthWrite |
+		nvrhi::ResourceStates::CopyDest | nvrhi::ResourceStates::ResolveDest | nvrhi::ResourceStates::StreamOut | nvrhi::ResourceStates::AccelStructWrite;
+
+	auto HasState = [state](nvrhi::ResourceStates flag) { return (state & flag) != nvrhi::ResourceStates::Unknown; };
+
+	if (state == nvrhi::ResourceStates::Unknown)
+	{
+		return false;
+	}
+
+	// reads must not use any writable state & writes must use one
+	const bool bIsWrite = resourceAccess.m_AccessType == ResourceHandle::AccessType::Write;
+	if (HasState(kWriteStates) != bIsWrite)
+	{
+		return false;
+	}
+
+	const ResourceHandle& resourceHandle = *resourceAccess.m_ResourceHandle;
+	if (resourceHandle.m_Type == ResourceHandle::Type::Texture)
+	{
+		const nvrhi::TextureDesc& desc = m_ResourceDescs.at(resourceHandle.m_DescIdx).m_TextureDesc;
+		const bool bHasDepth = nvrhi::getFormatInfo(desc.format).hasDepth;
+
+		if (HasState(nvrhi::ResourceStates::IndirectArgument | nvrhi::ResourceStates::ConstantBuffer | nvrhi::ResourceStates::VertexBuffer | nvrhi::ResourceStates::IndexBuffer))
+		{
+			return false;
+		}
+		if (HasState(nvrhi::ResourceStates::RenderTarget) && (!desc.isRenderTarget || bHasDepth))
+		{
+			return false;
+		}
+		if (HasState(nvrhi::ResourceStates::DepthWrite | nvrhi::ResourceStates::DepthRead) && (!desc.isRenderTarget || !bHasDepth))
+		{
+			return false;
+		}
+		if (HasState(nvrhi::ResourceStates::UnorderedAccess) && !desc.isUAV)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	const nvrhi::BufferDesc& desc = m_ResourceDescs.at(resourceHandle.m_DescIdx).m_BufferDesc;
+
+	if (HasState(nvrhi::ResourceStates::RenderTarget | nvrhi::ResourceStates::DepthWrite | nvrhi::ResourceStates::DepthRead))
+	{
+		return false;
+	}
+	if ((HasState(nvrhi::ResourceStates::UnorderedAccess) && !desc.canHaveUAVs) ||
+		(HasState(nvrhi::ResourceStates::IndirectArgument) && !desc.isDrawIndirectArgs) ||
+		(HasState(nvrhi::ResourceStates::ConstantBuffer) && !desc.isConstantBuffer) ||
+		(HasState(nvrhi::ResourceStates::VertexBuffer) && !desc.isVertexBuffer) ||
+		(HasState(nvrhi::ResourceStates::IndexBuffer) && !desc.isIndexBuffer))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void RenderGraph::BuildBarrierPlan()
+{
+	PROFILE_FUNCTION();
+
+	struct LastPlannedAccess
+	{
+		uint32_t m_PlannedAccessIdx = UINT32_MAX;
+		ResourceHandle::AccessType m_AccessType;
+	};
+
+	m_PlannedAccesses.clear();
+	m_PassPlannedAccessOffsets.clear();
+	m_NumPlannedBarriers = 0;
+	m_NumPlannedBarrierBatches = 0;
+
+	for (ResourceHandle* resourceHandle : m_ResourceHandles)
+	{
+		resourceHandle->m_PlannedWrapState = nvrhi::ResourceStates::Unknown;
+	}
+
+	// NOTE: indexed by 'ResourceHandle::m_DescIdx', which is unique per registered handle
+	std::vector<LastPlannedAccess> lastPlannedAccesses(m_ResourceDescs.size());
+	std::vector<uint32_t> firstPlannedAccesses(m_ResourceDescs.size(), UINT32_MAX);
+
+	for (const Pass& pass : m_Passes)
+	{
+		m_PassPlannedAccessOffsets.push_back(m_PlannedAccesses.size());
+
+		for (const ResourceAccess& resourceAccess : pass.m_ResourceAccesses)
+		{
+			ResourceHandle& resourceHandle = *resourceAccess.m_ResourceHandle;
+
+			// nvrhi already tracks these across command lists
+			const bool bKeepInitialState = resourceHandle.m_Type == ResourceHandle::Type::Texture ?
+				m_ResourceDescs.at(resourceHandle.m_DescIdx).m_TextureDesc.keepInitialState :
+				m_ResourceDescs.at(resourceHandle.m_DescIdx).m_BufferDesc.keepInitialState;
+
+			if (bKeepInitialState)
+			{
+				continue;
+			}
+
+			const uint32_t plannedAccessIdx = m_PlannedAccesses.size();
+			const nvrhi::ResourceStates accessState = (resourceAccess.m_State != nvrhi::ResourceStates::Unknown) ? resourceAccess.m_State : GetDefaultWriteState(resourceHandle);
+
+			PlannedAccess& plannedAccess = m_PlannedAccesses.emplace_back();
+			plannedAccess.m_ResourceHandle = &resourceHandle;
+			plannedAccess.m_BeginState = nvrhi::ResourceStates::Unknown;
+			plannedAccess.m_AccessState = accessState;
+			plannedAccess.m_EndState = accessState;
+			plannedAccess.m_bEndUAVBarrier = false;
+
+			LastPlannedAccess& lastPlannedAccess = lastPlannedAccesses.at(resourceHandle.m_DescIdx);
+			if (lastPlannedAccess.m_PlannedAccessIdx == UINT32_MAX)
+			{
+				firstPlannedAccesses.at(resourceHandle.m_DescIdx) = plannedAccessIdx;
+			}
+			else
+			{
+				// hoist the transition to the end of the previous accessor
+				PlannedAccess& prevPlannedAccess = m_PlannedAccesses.at(lastPlannedAccess.m_PlannedAccessIdx);
+				prevPlannedAccess.m_EndState = accessState;
+				prevPlannedAccess.m_bEndUAVBarrier = (accessState == nvrhi::ResourceStates::UnorderedAccess) &&
+					(prevPlannedAccess.m_AccessState == nvrhi::ResourceStates::UnorderedAccess) &&
+					((lastPlannedAccess.m_AccessType == ResourceHandle::AccessType::Write) || (resourceAccess.m_AccessType == ResourceHandle::AccessType::Write));
+
+				plannedAccess.m_BeginState = accessState;
+			}
+
+			lastPlannedAccess.m_PlannedAccessIdx = plannedAccessIdx;
+			lastPlannedAccess.m_AccessType = resourceAccess.m_AccessType;
+		}
+	}
+	m_PassPlannedAccessOffsets.push_back(m_PlannedAccesses.size());
+
+	// the last accessor returns the resource to the state of its first access, so that next frame's first access needs no transition
+	for (ResourceHandle* resourceHandle : m_ResourceHandles)
+	{
+		const uint32_t lastPlannedAccessIdx = lastPlannedAccesses.at(resourceHandle->m_DescIdx).m_PlannedAccessIdx;
+		if (lastPlannedAccessIdx == UINT32_MAX)
+		{
+			continue;
+		}
+
+		const nvrhi::ResourceStates wrapState = m_PlannedAccesses.at(firstPlannedAccesses.at(resourceHandle->m_DescIdx)).m_AccessState;
+
+		m_PlannedAccesses.at(lastPlannedAccessIdx).m_EndState = wrapState;
+		resourceHandle->m_PlannedWrapState = wrapState;
+	}
+
+	for (uint32_t passIdx = 0; passIdx < m_Passes.size(); ++passIdx)
+	{
+		bool bHasEndBarriers = false;
+
+		for (uint32_t i = m_PassPlannedAccessOffsets[passIdx]; i < m_PassPlannedAccessOffsets[passIdx + 1]; ++i)
+		{
+			const PlannedAccess& plannedAccess = m_PlannedAccesses[i];
+			if ((plannedAccess.m_EndState != plannedAccess.m_AccessState) || plannedAccess.m_bEndUAVBarrier)
+			{
+				++m_NumPlannedBarriers;
+				bHasEndBarriers = true;
+			}
+		}
+
+		m_NumPlannedBarrierBatches += bHasEndBarriers ? 1 : 0;
+	}
+}
+
+void RenderGraph::ValidateBarrierPlan() const
+{
+	PROFILE_FUNCTION();
+
+	check(m_PassPlannedAccessOffsets.size() == m_Passes.size() + 1);
+
+	// simulate the state of every planned resource through the frame
+	std::unordered_map<const ResourceHandle*, nvrhi::ResourceStates> simulatedStates;
+
+	for (uint32_t passIdx = 0; passIdx < m_Passes.size(); ++passIdx)
+	{
+		// every declared access of a resource not tracked by nvrhi must be planned
+		for (const ResourceAccess& access : m_Passes[passIdx].m_ResourceAccesses)
+		{
+			const ResourceHandle& resourceHandle = *access.m_ResourceHandle;
+			const bool bKeepInitialState = resourceHandle.m_Type == ResourceHandle::Type::Texture ?
+				m_ResourceDescs.at(resourceHandle.m_DescIdx).m_TextureDesc.keepInitialState :
+				m_ResourceDescs.at(resourceHandle.m_DescIdx).m_BufferDesc.keepInitialState;
+
+			const std::span<const PlannedAccess> passPlannedAccesses = GetPlannedAccesses(passIdx);
+			check(bKeepInitialState || std::ranges::find(passPlannedAccesses, &resourceHandle, &PlannedAccess::m_ResourceHandle) != passPlannedAccesses.end());
+		}
+
+		for (uint32_t i = m_PassPlannedAccessOffsets[passIdx]; i < m_PassPlannedAccessOffsets[passIdx + 1]; ++i)
+		{
+			const PlannedAccess& plannedAccess = m_PlannedAccesses[i];
+			check(plannedAccess.m_AccessState != nvrhi::ResourceStates::Unknown);
+			check(plannedAccess.m_EndState != nvrhi::ResourceStates::Unknown);
+
+			// every access must be declared by its pass, in the state it was declared with
+			const std::pmr::vector<ResourceAccess>& accesses = m_Passes[passIdx].m_ResourceAccesses;
+			auto declaredIt = std::ranges::find_if(accesses, [&plannedAccess](const ResourceAccess& access) { return access.m_ResourceHandle == plannedAccess.m_ResourceHandle; });
+			check(declaredIt != accesses.end());
+			check(declaredIt->m_State == nvrhi::ResourceStates::Unknown || plannedAccess.m_AccessState == declaredIt->m_State);
+
+			// & that state must be legal for the access type & the resource desc
+			check(IsLegalAccessState(*declaredIt, plannedAccess.m_AccessState));
+
+			auto it = simulatedStates.find(plannedAccess.m_ResourceHandle);
+			if (it == simulatedStates.end())
+			{
+				check(plannedAccess.m_BeginState == nvrhi::ResourceStates::Unknown);
+				it = simulatedStates.emplace(plannedAccess.m_ResourceHandle, plannedAccess.m_AccessState).first;
+			}
+			else
+			{
+				// previous accessor must have left the resource in the state this pass expects
+				check(plannedAccess.m_BeginState == it->second);
+				check(plannedAccess.m_BeginState == plannedAccess.m_AccessState);
+			}
+
+			it->second = plannedAccess.m_EndState;
+		}
+	}
+
+	// end of frame state must match the state next frame begins in
+	for (const auto& [resourceHandle, state] : simulatedStates)
+	{
+		check(state == resourceHandle->m_PlannedWrapState);
+	}
+}
+
+void RenderGraph::CommitPassBeginBarriers(PassID passID, nvrhi::CommandListHandle commandList) const
+{
+	PROFILE_FUNCTION();
+
+	bool bHasBarriers = false;
+
+	for (uint32_t i = m_PassPlannedAccessOffsets[passID]; i < m_PassPlannedAccessOffsets[passID + 1]; ++i)
+	{
+		const PlannedAccess& plannedAccess = m_PlannedAccesses[i];
+		const ResourceHandle& resourceHandle = *plannedAccess.m_ResourceHandle;
+
+		const nvrhi::ResourceStates beginState = plannedAccess.m_BeginState != nvrhi::ResourceStates::Unknown ? plannedAccess.m_BeginState : resourceHandle.m_PlannedState;
+		check(beginState != nvrhi::ResourceStates::Unknown);
+
+		if (resourceHandle.m_Type == ResourceHandle::Type::Texture)
+		{
+			nvrhi::ITexture* texture = (nvrhi::ITexture*)resourceHandle.m_Resource.Get();
+			commandList->beginTrackingTextureState(texture, nvrhi::AllSubresources, beginState);
+
+			if (beginState != plannedAccess.m_AccessState)
+			{
+				commandList->setTextureState(texture, nvrhi::AllSubresources, plannedAccess.m_AccessState);
+				bHasBarriers = true;
+			}
+		}
+		else
+		{
+			nvrhi::IBuffer* buffer = (nvrhi::IBuffer*)resourceHandle.m_Resource.Get();
+			commandList->beginTrackingBufferState(buffer, beginState);
+
+			if (beginState != plannedAccess.m_AccessState)
+			{
+				commandList->setBufferState(buffer, plannedAccess.m_AccessState);
+				bHasBarriers = true;
+			}
+		}
+	}
+
+	if (bHasBarriers)
+	{
+		commandList->commitBarriers();
+	}
+}
+
+void RenderGraph::CommitPassEndBarriers(PassID passID, nvrhi::CommandListHandle commandList) const
+{
+	PROFILE_FUNCTION();
+
+	bool bHasBarriers = false;
+
+	for (uint32_t i = m_PassPlannedAccessOffsets[passID]; i < m_PassPlannedAccessOffsets[passID + 1]; ++i)
+	{
+		const PlannedAccess& plannedAccess = m_PlannedAccesses[i];
+		const ResourceHandle& resourceHandle = *plannedAccess.m_ResourceHandle;
+
+		// NOTE: the Renderer may have transitioned the resource itself. Always hand it over in the planned end state, nvrhi skips redundant transitions
+		// Only skip UAV->UAV without a write hazard, as nvrhi would emit a UAV barrier for it
+		const bool bUAVToUAV = (plannedAccess.m_AccessState == nvrhi::ResourceStates::UnorderedAccess) && (plannedAccess.m_EndState == nvrhi::ResourceStates::UnorderedAccess);
+		if (bUAVToUAV && !plannedAccess.m_bEndUAVBarrier)
+		{
+			continue;
+		}
+
+		if (resourceHandle.m_Type == ResourceHandle::Type::Texture)
+		{
+			commandList->setTextureState((nvrhi::ITexture*)resourceHandle.m_Resource.Get(), nvrhi::AllSubresources, plannedAccess.m_EndState);
+		}
+		else
+		{
+			commandList->setBufferState((nvrhi::IBuffer*)resourceHandle.m_Resource.Get(), plannedAccess.m_EndState);
+		}
+		bHasBarriers = true;
+	}
+
+	if (bHasBarriers)
+	{
+		commandList->commitBarriers();
+	}
+}
+
+void RenderGraph::BeginChildCommandList(PassID passID, nvrhi::CommandListHandle commandList) const
+{
+	PROFILE_FUNCTION();
+
+	// the pass' own command list already transitioned everything to its access state
+	for (uint32_t i = m_PassPlannedAccessOffsets[passID]; i < m_PassPlannedAccessOffsets[passID + 1]; ++i)
+	{
+		const PlannedAccess& plannedAccess = m_PlannedAccesses[i];
+		const ResourceHandle& resourceHandle = *plannedAccess.m_ResourceHandle;
+
+		if (resourceHandle.m_Type == ResourceHandle::Type::Texture)
+		{
+			commandList->beginTrackingTextureState((nvrhi::ITexture*)resourceHandle.m_Resource.Get(), nvrhi::AllSubresources, plannedAccess.m_AccessState);
+		}
+		else
+		{
+			commandList->beginTrackingBufferState((nvrhi::IBuffer*)resourceHandle.m_Resource.Get(), plannedAccess.m_AccessState);
+		}
+	}
+}
+
+void RenderGraph::EndChildCommandList(PassID passID, nvrhi::CommandListHandle commandList) const
+{
+	PROFILE_FUNCTION();
+
+	bool bHasBarriers = false;
+
+	// hand everything over to the next child in its access state, as it began
+	// NOTE: no implicit sync between command lists of the same submission. UAV->UAV is kept on purpose, as nvrhi emits a UAV barrier for it
+	for (uint32_t i = m_PassPlannedAccessOffsets[passID]; i < m_PassPlannedAccessOffsets[passID + 1]; ++i)
+	{
+		const PlannedAccess& plannedAccess = m_PlannedAccesses[i];
+		const ResourceHandle& resourceHandle = *plannedAccess.m_ResourceHandle;
+
+		if (resourceHandle.m_Type == ResourceHandle::Type::Texture)
+		{
+			commandList->setTextureState((nvrhi::ITexture*)resourceHandle.m_Resource.Get(), nvrhi::AllSubresources, plannedAccess.m_AccessState);
+		}
+		else
+		{
+			commandList->setBufferState((nvrhi::IBuffer*)resourceHandle.m_Resource.Get(), plannedAccess.m_AccessState);
+		}
+		bHasBarriers = true;
+	}
+
+	if (bHasBarriers)
+	{
+		commandList->commitBarriers();
+	}
 }
 
 nvrhi::IResource* RenderGraph::GetResourceInternal(const ResourceHandle& resourceHandle, ResourceHandle::Type resourceType) const
 {
 	check(m_CurrentPhase == Phase::Execute);
 	check(resourceHandle.m_AllocatedFrameIdx != UINT32_MAX); // un-allocated transient resource
-    check(resourceHandle.m_AllocatedFrameIdx == g_Graphic.m_FrameCounter); // resource is too old
+    check(resourceHandle.m_AllocatedFrameIdx == m_Backend->GetFrameCounter()); // resource is too old
 	check(tl_CurrentThreadPassID != kInvalidPassID);
 
 #if _DEBUG
-	const std::vector<ResourceAccess>& accesses = m_Passes.at(tl_CurrentThreadPassID).m_ResourceAccesses;
+	const std::pmr::vector<ResourceAccess>& accesses = m_Passes.at(tl_CurrentThreadPassID).m_ResourceAccesses;
 
 	// check if resource is requested by the current Pass
 	auto it = std::ranges::find_if(accesses, [&resourceHandle](const ResourceAccess& access) { return access.m_ResourceHandle == &resourceHandle; });
@@ -400,7 +962,13 @@ nvrhi::IResource* RenderGraph::GetResourceInternal(const ResourceHandle& resourc
 
 void RenderGraph::FreeResource(ResourceHandle& resourceHandle)
 {
+	if (resourceHandle.m_Resource)
+	{
+		m_Backend->OnTransientResourceFreed(resourceHandle.m_Resource);
+	}
+
 	resourceHandle.m_Resource = nullptr;
+	resourceHandle.m_PlannedState = nvrhi::ResourceStates::Unknown;
 	resourceHandle.m_FirstAccess = kInvalidPassID;
 	resourceHandle.m_LastAccess = kInvalidPassID;
 	//resourceHandle.m_LastWrite = kInvalidPassID;
@@ -419,6 +987,7 @@ void RenderGraph::FreeResource(ResourceHandle& resourceHandle)
 
     resourceHandle.m_HeapIdx = UINT32_MAX;
 	resourceHandle.m_HeapOffset = UINT32_MAX;
+	resourceHandle.m_HeapSize = 0;
 }
 
 const char* RenderGraph::GetResourceName(const ResourceHandle& resourceHandle) const
@@ -432,7 +1001,7 @@ void RenderGraph::CreateNewHeap(uint64_t size)
 {
 	Heap& newHeap = m_Heaps.emplace_back();
 	newHeap.m_Blocks.push_back({ size, false });
-	newHeap.m_Heap = g_Graphic.m_NVRHIDevice->createHeap(nvrhi::HeapDesc{ size, nvrhi::HeapType::DeviceLocal, "RDG Heap" });
+	newHeap.m_Heap = m_Backend->CreateHeap(nvrhi::HeapDesc{ size, nvrhi::HeapType::DeviceLocal, "RDG Heap" });
 
 	if constexpr (kDoDebugLogging)
 	{
@@ -506,6 +1075,9 @@ void RenderGraph::Heap::Free(uint64_t heapOffset)
 	}
     check(foundIdx < m_Blocks.size());
 
+	// NOTE: before merging w/ the neighbours, which grows the block past the size of the allocation
+	const uint64_t freedSize = m_Blocks[foundIdx].m_Size;
+
     m_Blocks[foundIdx].m_Allocated = false;
 
 	// merge next block if possible
@@ -534,8 +1106,9 @@ void RenderGraph::Heap::Free(uint64_t heapOffset)
 
 	// sanity check
     check(!m_Blocks.empty());
-	
-    m_Used -= m_Blocks[foundIdx].m_Size;
+	check(m_Used >= freedSize);
+
+    m_Used -= freedSize;
 }
 
 void RenderGraph::Heap::FindBest(uint64_t size, uint32_t& foundIdx, uint64_t& heapOffset)
@@ -578,3 +1151,432 @@ void RenderGraph::Heap::FindFirst(uint64_t size, uint32_t& foundIdx, uint64_t& h
         }
     }
 }
+
+uint64_t RenderGraph::GetPeakTransientMemory() const
+{
+	uint64_t peak = 0;
+	for (const Heap& heap : m_Heaps)
+	{
+		peak += heap.m_Peak;
+	}
+	return peak;
+}
+
+uint64_t RenderGraph::Heap::GetLargestFreeBlockSize() const
+{
+	uint64_t largestFreeBlockSize = 0;
+	for (const Block& block : m_Blocks)
+	{
+		if (!block.m_Allocated)
+		{
+			largestFreeBlockSize = std::max(largestFreeBlockSize, block.m_Size);
+		}
+	}
+	return largestFreeBlockSize;
+}
+
+RenderGraph::Heap::Stats RenderGraph::Heap::GetStats() const
+{
+	Stats stats;
+	for (const Block& block : m_Blocks)
+	{
+		stats.m_Capacity += block.m_Size;
+	}
+	stats.m_Used = m_Used;
+	stats.m_Free = stats.m_Capacity - m_Used;
+	stats.m_LargestFreeBlock = GetLargestFreeBlockSize();
+
+	// 0: all free memory is contiguous, ~1: free memory is scattered in small blocks
+	stats.m_Fragmentation = stats.m_Free > 0 ? 1.0f - (float)stats.m_LargestFreeBlock / stats.m_Free : 0.0f;
+
+	return stats;
+}
+
+// minimal escaping for renderer & resource names
+static void WriteJSONString(FILE* f, std::string_view str)
+{
+	fputc('"', f);
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+		{
+			fputc('\\', f);
+		}
+		fputc(c, f);
+	}
+	fputc('"', f);
+}
+
+void RenderGraph::ExportTrace(std::string_view fileName) const
+{
+	PROFILE_FUNCTION();
+
+	const std::string filePath = (std::filesystem::path{ GetExecutableDirectory() } / fileName).string();
+	SDL_Log("Exporting Render Graph trace: %s", filePath.c_str());
+
+	ScopedFile f{ filePath, "w" };
+
+	auto TickToUs = [this](uint64_t tick) { return tick > m_FrameStartTick ? SDL_NS_TO_US((double)(tick - m_FrameStartTick)) : 0.0; };
+
+	// Chrome trace events:
+	//  pid 0: CPU timeline of pass Setup & Record, in microseconds since 'InitializeForFrame'
+	//  pid 1: transient resource lifetimes. NOTE: the time axis is the *pass index*, 1 "us" per pass
+	fprintf(f, "{\n\"displayTimeUnit\": \"ns\",\n\"traceEvents\": [\n");
+	fprintf(f, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"args\": {\"name\": \"Render Graph Passes (CPU)\"}},\n");
+	fprintf(f, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"Transient Resource Lifetimes (pass index)\"}}");
+
+	for (uint32_t i = 0; i < m_Passes.size(); ++i)
+	{
+		const Pass& pass = m_Passes[i];
+
+		fprintf(f, ",\n{\"name\": ");
+		WriteJSONString(f, pass.m_Renderer->m_Name);
+		fprintf(f, ", \"cat\": \"Setup\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0, \"ts\": %.3f, \"dur\": %.3f, \"args\": {\"passID\": %u}}",
+			TickToUs(pass.m_SetupStartTick), TickToUs(pass.m_SetupEndTick) - TickToUs(pass.m_SetupStartTick), i);
+
+		for (uint32_t commandListIdx = 0; commandListIdx < pass.m_CommandLists.size(); ++commandListIdx)
+		{
+			const PassCommandList& passCommandList = pass.m_CommandLists[commandListIdx];
+
+			// not recorded, i.e. benchmark passes
+			if (passCommandList.m_RecordEndTick == 0)
+			{
+				continue;
+			}
+
+			fprintf(f, ",\n{\"name\": ");
+			WriteJSONString(f, pass.m_Renderer->m_Name);
+			fprintf(f, ", \"cat\": \"Record\", \"ph\": \"X\", \"pid\": 0, \"tid\": %llu, \"ts\": %.3f, \"dur\": %.3f, \"args\": {\"passID\": %u, \"commandList\": %u}}",
+				(unsigned long long)passCommandList.m_RecordThreadID, TickToUs(passCommandList.m_RecordStartTick), TickToUs(passCommandList.m_RecordEndTick) - TickToUs(passCommandList.m_RecordStartTick), i, commandListIdx);
+		}
+	}
+
+	for (uint32_t i = 0; i < m_ResourceHandles.size(); ++i)
+	{
+		const ResourceHandle& resourceHandle = *m_ResourceHandles[i];
+		if (!resourceHandle.m_Resource || resourceHandle.m_FirstAccess == kInvalidPassID)
+		{
+			continue;
+		}
+
+		fprintf(f, ",\n{\"name\": ");
+		WriteJSONString(f, GetResourceName(resourceHandle));
+		fprintf(f, ", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %u, \"dur\": %u, \"args\": {\"size\": %llu, \"heapOffset\": %llu}}",
+			EnumUtils::ToString(resourceHandle.m_Type), resourceHandle.m_HeapIdx, resourceHandle.m_FirstAccess, resourceHandle.m_LastAccess - resourceHandle.m_FirstAccess + 1, (unsigned long long)resourceHandle.m_HeapSize, (unsigned long long)resourceHandle.m_HeapOffset);
+	}
+
+	fprintf(f, "\n],\n");
+
+	// raw data, for offline diffing of allocation strategies
+	fprintf(f, "\"renderGraph\": {\n\"frame\": %u,\n\"passes\": [", m_Backend->GetFrameCounter());
+
+	for (uint32_t i = 0; i < m_Passes.size(); ++i)
+	{
+		const Pass& pass = m_Passes[i];
+
+		// summed over all command lists of the pass
+		double recordUs = 0.0;
+		for (const PassCommandList& passCommandList : pass.m_CommandLists)
+		{
+			recordUs += TickToUs(passCommandList.m_RecordEndTick) - TickToUs(passCommandList.m_RecordStartTick);
+		}
+
+		fprintf(f, "%s\n{\"id\": %u, \"name\": ", i > 0 ? "," : "", i);
+		WriteJSONString(f, pass.m_Renderer->m_Name);
+		fprintf(f, ", \"setupUs\": %.3f, \"recordUs\": %.3f, \"numCommandLists\": %u, \"numAccesses\": %u}",
+			TickToUs(pass.m_SetupEndTick) - TickToUs(pass.m_SetupStartTick), recordUs, (uint32_t)pass.m_CommandLists.size(), (uint32_t)pass.m_ResourceAccesses.size());
+	}
+
+	fprintf(f, "\n],\n\"resources\": [");
+
+	bool bFirstResource = true;
+	for (const ResourceHandle* resourceHandle : m_ResourceHandles)
+	{
+		if (!resourceHandle->m_Resource)
+		{
+			continue;
+		}
+
+		fprintf(f, "%s\n{\"name\": ", bFirstResource ? "" : ",");
+		WriteJSONString(f, GetResourceName(*resourceHandle));
+		fprintf(f, ", \"type\": \"%s\", \"firstPass\": %d, \"lastPass\": %d, \"size\": %llu, \"heap\": %u, \"heapOffset\": %llu, \"allocatedFrame\": %u}",
+			EnumUtils::ToString(resourceHandle->m_Type),
+			resourceHandle->m_FirstAccess == kInvalidPassID ? -1 : (int)resourceHandle->m_FirstAccess,
+			resourceHandle->m_LastAccess == kInvalidPassID ? -1 : (int)resourceHandle->m_LastAccess,
+			(unsigned long long)resourceHandle->m_HeapSize, resourceHandle->m_HeapIdx, (unsigned long long)resourceHandle->m_HeapOffset, resourceHandle->m_AllocatedFrameIdx);
+
+		bFirstResource = false;
+	}
+
+	fprintf(f, "\n],\n\"heaps\": [");
+
+	for (uint32_t i = 0; i < m_Heaps.size(); ++i)
+	{
+		const Heap& heap = m_Heaps[i];
+
+		const Heap::Stats stats = heap.GetStats();
+
+		fprintf(f, "%s\n{\"id\": %u, \"capacity\": %llu, \"used\": %llu, \"free\": %llu, \"peak\": %llu, \"numBlocks\": %u, \"largestFreeBlock\": %llu, \"fragmentation\": %.4f, \"blocks\": [",
+			i > 0 ? "," : "", i, (unsigned long long)stats.m_Capacity, (unsigned long long)stats.m_Used, (unsigned long long)stats.m_Free, (unsigned long long)heap.m_Peak, (uint32_t)heap.m_Blocks.size(), (unsigned long long)stats.m_LargestFreeBlock, stats.m_Fragmentation);
+
+		uint64_t blockOffset = 0;
+		for (uint32_t j = 0; j < heap.m_Blocks.size(); ++j)
+		{
+			const Heap::Block& block = heap.m_Blocks[j];
+			fprintf(f, "%s{\"offset\": %llu, \"size\": %llu, \"allocated\": %s}", j > 0 ? ", " : "", (unsigned long long)blockOffset, (unsigned long long)block.m_Size, block.m_Allocated ? "true" : "false");
+			blockOffset += block.m_Size;
+		}
+
+		fprintf(f, "]}");
+	}
+
+	fprintf(f, "\n]\n}\n}\n");
+}
+
+// NOTE: 'ExportDeclarations' & 'ImportDeclarations' must write & read desc fields in the same order. Enums are written as integers
+static void WriteDeclaredDesc(FILE* f, const nvrhi::TextureDesc& desc)
+{
+	fprintf(f, "%u %u %u %u %u %u %u %u %u %d %d %d %d %d %.9g %.9g %.9g %.9g %u %d",
+		desc.width, desc.height, desc.depth, desc.arraySize, desc.mipLevels, desc.sampleCount, desc.sampleQuality, (uint32_t)desc.format, (uint32_t)desc.dimension,
+		desc.isRenderTarget, desc.isUAV, desc.isTypeless, desc.isShadingRateSurface, desc.useClearValue,
+		desc.clearValue.r, desc.clearValue.g, desc.clearValue.b, desc.clearValue.a, (uint32_t)desc.initialState, desc.keepInitialState);
+}
+
+static void WriteDeclaredDesc(FILE* f, const nvrhi::BufferDesc& desc)
+{
+	fprintf(f, "%llu %u %u %d %d %d %d %d %d %d %d %d %d %u %d",
+		(unsigned long long)desc.byteSize, desc.structStride, (uint32_t)desc.format,
+		desc.canHaveUAVs, desc.canHaveTypedViews, desc.canHaveRawViews, desc.isVertexBuffer, desc.isIndexBuffer, desc.isConstantBuffer,
+		desc.isDrawIndirectArgs, desc.isAccelStructBuildInput, desc.isAccelStructStorage, desc.isShaderBindingTable, (uint32_t)desc.initialState, desc.keepInitialState);
+}
+
+template <typename EnumT>
+static void ReadDeclaredEnum(std::istream& is, EnumT& e)
+{
+	uint32_t value = 0;
+	is >> value;
+	e = (EnumT)value;
+}
+
+static void ReadDeclaredDesc(std::istream& is, nvrhi::TextureDesc& desc)
+{
+	is >> desc.width >> desc.height >> desc.depth >> desc.arraySize >> desc.mipLevels >> desc.sampleCount >> desc.sampleQuality;
+	ReadDeclaredEnum(is, desc.format);
+	ReadDeclaredEnum(is, desc.dimension);
+	is >> desc.isRenderTarget >> desc.isUAV >> desc.isTypeless >> desc.isShadingRateSurface >> desc.useClearValue;
+	is >> desc.clearValue.r >> desc.clearValue.g >> desc.clearValue.b >> desc.clearValue.a;
+	ReadDeclaredEnum(is, desc.initialState);
+	is >> desc.keepInitialState;
+}
+
+static void ReadDeclaredDesc(std::istream& is, nvrhi::BufferDesc& desc)
+{
+	is >> desc.byteSize >> desc.structStride;
+	ReadDeclaredEnum(is, desc.format);
+	is >> desc.canHaveUAVs >> desc.canHaveTypedViews >> desc.canHaveRawViews >> desc.isVertexBuffer >> desc.isIndexBuffer >> desc.isConstantBuffer;
+	is >> desc.isDrawIndirectArgs >> desc.isAccelStructBuildInput >> desc.isAccelStructStorage >> desc.isShaderBindingTable;
+	ReadDeclaredEnum(is, desc.initialState);
+	is >> desc.keepInitialState;
+}
+
+static const uint32_t kDeclarationsFileVersion = 1;
+
+// Format:
+//   RenderGraphDeclarations <version> <num resources>
+//   pass <num child command lists> <renderer name>
+//   create Texture|Buffer <resource idx> <desc fields, see 'WriteDeclaredDesc'> <debug name>
+//   read|write <resource idx> <nvrhi::ResourceStates>
+// Accesses follow the line of the pass that declared them. Names are the rest of the line
+void RenderGraph::ExportDeclarations(std::string_view fileName) const
+{
+	PROFILE_FUNCTION();
+
+	const std::string filePath = (std::filesystem::path{ GetExecutableDirectory() } / fileName).string();
+	SDL_Log("Exporting Render Graph declarations: %s", filePath.c_str());
+
+	std::unordered_map<const ResourceHandle*, uint32_t> resourceIndices;
+	for (uint32_t i = 0; i < m_ResourceHandles.size(); ++i)
+	{
+		resourceIndices[m_ResourceHandles[i]] = i;
+	}
+
+	ScopedFile f{ filePath, "w" };
+
+	fprintf(f, "RenderGraphDeclarations %u %u\n", kDeclarationsFileVersion, (uint32_t)m_ResourceHandles.size());
+
+	for (const Pass& pass : m_Passes)
+	{
+		fprintf(f, "pass %u %s\n", pass.m_NumChildCommandLists, pass.m_Renderer->m_Name.c_str());
+
+		for (const ResourceAccess& resourceAccess : pass.m_ResourceAccesses)
+		{
+			const ResourceHandle& resourceHandle = *resourceAccess.m_ResourceHandle;
+			const uint32_t resourceIdx = resourceIndices.at(&resourceHandle);
+
+			if (!resourceAccess.m_bCreatesResource)
+			{
+				fprintf(f, "%s %u %u\n", resourceAccess.m_AccessType == ResourceHandle::AccessType::Read ? "read" : "write", resourceIdx, (uint32_t)resourceAccess.m_State);
+				continue;
+			}
+
+			const ResourceDesc& resourceDesc = m_ResourceDescs.at(resourceHandle.m_DescIdx);
+
+			fprintf(f, "create %s %u ", EnumUtils::ToString(resourceHandle.m_Type), resourceIdx);
+			if (resourceHandle.m_Type == ResourceHandle::Type::Texture)
+			{
+				WriteDeclaredDesc(f, resourceDesc.m_TextureDesc);
+			}
+			else
+			{
+				WriteDeclaredDesc(f, resourceDesc.m_BufferDesc);
+			}
+			fprintf(f, " %s\n", GetResourceName(resourceHandle));
+		}
+	}
+}
+
+bool RenderGraph::ImportDeclarations(std::string_view fileName, Declarations& outDeclarations)
+{
+	PROFILE_FUNCTION();
+
+	std::ifstream file{ fileName.data() };
+	if (!file)
+	{
+		SDL_Log("Can't open Render Graph declarations: %s", fileName.data());
+		return false;
+	}
+
+	outDeclarations = Declarations{};
+
+	std::string line;
+	uint32_t lineIdx = 0;
+
+	// rest of the line. Resource debug names can be empty
+	auto ReadName = [](std::istream& is)
+		{
+			std::string name;
+			if (is >> std::ws; !is.eof())
+			{
+				std::getline(is, name);
+			}
+			return name;
+		};
+
+	while (std::getline(file, line))
+	{
+		++lineIdx;
+
+		std::istringstream is{ line };
+		std::string keyword;
+		is >> keyword;
+
+		if (lineIdx == 1)
+		{
+			uint32_t version = 0;
+			is >> version >> outDeclarations.m_NumResources;
+
+			if (keyword != "RenderGraphDeclarations" || version != kDeclarationsFileVersion)
+			{
+				SDL_Log("Render Graph declarations: %s is not a version %u declarations file", fileName.data(), kDeclarationsFileVersion);
+				return false;
+			}
+			continue;
+		}
+
+		Declarations::Access access{};
+
+		if (keyword == "pass")
+		{
+			Declarations::Pass& pass = outDeclarations.m_Passes.emplace_back();
+			is >> pass.m_NumChildCommandLists;
+			pass.m_Name = ReadName(is);
+		}
+		else if (outDeclarations.m_Passes.empty())
+		{
+			SDL_Log("Render Graph declarations: %s(%u): access declared before the 1st pass", fileName.data(), lineIdx);
+			return false;
+		}
+		else if (keyword == "create")
+		{
+			std::string resourceTypeStr;
+			is >> resourceTypeStr >> access.m_ResourceIdx;
+
+			access.m_AccessType = ResourceHandle::AccessType::Write;
+			access.m_State = nvrhi::ResourceStates::Unknown;
+			access.m_ResourceType = EnumUtils::ToEnum<ResourceHandle::Type>(resourceTypeStr);
+			access.m_CreateDescIdx = outDeclarations.m_CreateDescs.size();
+
+			ResourceDesc& resourceDesc = outDeclarations.m_CreateDescs.emplace_back();
+			if (access.m_ResourceType == ResourceHandle::Type::Texture)
+			{
+				ReadDeclaredDesc(is, resourceDesc.m_TextureDesc);
+				resourceDesc.m_TextureDesc.debugName = ReadName(is);
+			}
+			else
+			{
+				ReadDeclaredDesc(is, resourceDesc.m_BufferDesc);
+				resourceDesc.m_BufferDesc.debugName = ReadName(is);
+			}
+		}
+		else if (keyword == "read" || keyword == "write")
+		{
+			is >> access.m_ResourceIdx;
+			ReadDeclaredEnum(is, access.m_State);
+			access.m_AccessType = keyword == "read" ? ResourceHandle::AccessType::Read : ResourceHandle::AccessType::Write;
+		}
+		else
+		{
+			SDL_Log("Render Graph declarations: %s(%u): unknown declaration '%s'", fileName.data(), lineIdx, keyword.c_str());
+			return false;
+		}
+
+		if (!is || (keyword != "pass" && access.m_ResourceIdx >= outDeclarations.m_NumResources))
+		{
+			SDL_Log("Render Graph declarations: %s(%u): malformed declaration", fileName.data(), lineIdx);
+			return false;
+		}
+
+		if (keyword != "pass")
+		{
+			outDeclarations.m_Passes.back().m_Accesses.push_back(access);
+		}
+	}
+
+	return lineIdx > 0;
+}
+
+void RenderGraph::UpdateIMGUI()
+{
+	ImGui::Checkbox("Enable Compile Cache", &m_bEnableCompileCache);
+
+	ImGui::Text("Passes: %u, Transient Resources: %u", (uint32_t)m_Passes.size(), (uint32_t)m_ResourceHandles.size());
+	ImGui::Text("Compile: %.2f us", m_LastCompileTimeUs);
+	ImGui::Text("Frame Allocator: Used: %.2f KB, Peak: %.2f KB, Capacity: %.2f KB", BYTES_TO_KB(m_FrameAllocator.GetUsedBytes()), BYTES_TO_KB(m_FrameAllocator.GetPeakBytes()), BYTES_TO_KB(m_FrameAllocator.GetCapacity()));
+	ImGui::Text("Compile Cache Hits: %u, Misses: %u", m_NumCompileCacheHits, m_NumCompileCacheMisses);
+	ImGui::Text("Planned Barriers: %u, Batches: %u", m_NumPlannedBarriers, m_NumPlannedBarrierBatches);
+
+	for (uint32_t i = 0; i < m_Heaps.size(); ++i)
+	{
+		const Heap& heap = m_Heaps[i];
+		ImGui::Text("Heap %u: Used: %.2f MB, Peak: %.2f MB, Capacity: %.2f MB", i, BYTES_TO_MB(heap.m_Used), BYTES_TO_MB(heap.m_Peak), BYTES_TO_MB(heap.m_Heap->getDesc().capacity));
+	}
+
+	static int s_BenchmarkNumPasses = 1000;
+	ImGui::SliderInt("Benchmark Passes", &s_BenchmarkNumPasses, 16, 2000);
+
+	if (ImGui::Button("Export Frame Trace"))
+	{
+		TriggerExportTrace("RenderGraphTrace.json");
+	}
+
+	if (ImGui::Button("Export Frame Declarations"))
+	{
+		TriggerExportDeclarations("RenderGraphDeclarations.txt");
+	}
+
+	if (ImGui::Button("Run Compile Benchmark"))
+	{
+		extern void RunRenderGraphCompileBenchmark(uint32_t numPasses);
+		RunRenderGraphCompileBenchmark(s_BenchmarkNumPasses);
+	}
+}
@@ -3,12 +3,42 @@
 #include "extern/nvrhi/include/nvrhi/nvrhi.h"
 #include "extern/taskflow/taskflow/taskflow.hpp"
 
+#include "Utilities.h"
+
 class IRenderer;
 
+// The few device calls made by the render graph. Abstracted so that the graph can be simulated without a GPU, see 'NullRenderGraphBackend'
+// The device implementation lives in Graphic.cpp, so that the graph itself builds w/o the device. See 'Graphic::GetRenderGraphBackend'
+class RenderGraphBackend
+{
+public:
+	virtual ~RenderGraphBackend() = default;
+
+	virtual uint32_t GetFrameCounter() const = 0;
+	virtual nvrhi::HeapHandle CreateHeap(const nvrhi::HeapDesc& heapDesc) = 0;
+	virtual nvrhi::ResourceHandle CreateTexture(const nvrhi::TextureDesc& textureDesc, uint64_t& outMemReq) = 0;
+	virtual nvrhi::ResourceHandle CreateBuffer(const nvrhi::BufferDesc& bufferDesc, uint64_t& outMemReq) = 0;
+	virtual bool BindTextureMemory(nvrhi::IResource* texture, nvrhi::IHeap* heap, uint64_t heapOffset) = 0;
+	virtual bool BindBufferMemory(nvrhi::IResource* buffer, nvrhi::IHeap* heap, uint64_t heapOffset) = 0;
+
+	// the transient resource is released & its heap memory re-used. (Re-)allocations always create new resources, so anything that references this one by pointer must be dropped
+	virtual void OnTransientResourceFreed(nvrhi::IResource* resource) {}
+
+	// Recording of the passes. Never called if frames are only set up & compiled, i.e. simulations
+	virtual nvrhi::CommandListHandle AllocateCommandList() = 0;
+	virtual void BeginCommandList(nvrhi::ICommandList* commandList, const char* name) = 0;
+	virtual void EndCommandList(nvrhi::ICommandList* commandList) = 0;
+	virtual void QueueCommandList(nvrhi::ICommandList* commandList) = 0;
+
+	// GPU time of a renderer, from the 1st command list of its pass to the last one. Updates 'IRenderer::m_GPUFrameTime'
+	virtual void BeginRendererTimer(IRenderer& renderer, nvrhi::ICommandList* commandList) = 0;
+	virtual void EndRendererTimer(IRenderer& renderer, nvrhi::ICommandList* commandList) = 0;
+};
+
 class RenderGraph
 {
 public:
-	using PassID = uint8_t;
+	using PassID = uint16_t;
 
 	static const PassID kInvalidPassID = std::numeric_limits<PassID>::max();
 
@@ -21,16 +51,21 @@ public:
 
 		nvrhi::ResourceHandle m_Resource;
 		uint64_t m_HeapOffset = UINT64_MAX;
+		uint64_t m_HeapSize = 0;
 		uint32_t m_HeapIdx = UINT32_MAX;
 
 		uint32_t m_AllocatedFrameIdx = UINT32_MAX;
 		uint32_t m_DescIdx = UINT32_MAX;
+		std::size_t m_DescHash = 0;
 		Type m_Type;
 
 		// Compile-time data
 		PassID m_FirstAccess = kInvalidPassID; // First pass that accesses this resource
 		PassID m_LastAccess = kInvalidPassID;  // Last pass that accesses this resource
 		//PassID m_LastWrite = kInvalidPassID;   // Last pass that wrote to this resource. Used for pass culling
+
+		nvrhi::ResourceStates m_PlannedState = nvrhi::ResourceStates::Unknown;     // state of the resource before its first access this frame
+		nvrhi::ResourceStates m_PlannedWrapState = nvrhi::ResourceStates::Unknown; // state the barrier plan leaves the resource in at the end of the frame
 	};
 
 	struct ResourceDesc
@@ -43,13 +78,59 @@ public:
 	{
 		ResourceHandle* m_ResourceHandle;
 		ResourceHandle::AccessType m_AccessType;
+		nvrhi::ResourceStates m_State; // always declared for reads. 'Unknown' for writes = derived from the resource desc, see 'GetDefaultWriteState'
+		bool m_bCreatesResource;       // implicit write of 'CreateTransientResource'
 	};
 
-	struct Pass
+	// Explicit state transitions computed by Compile, one per graph-owned resource access
+	// The pass begins tracking the resource in 'm_BeginState' & transitions to 'm_AccessState' before it records anything
+	// After recording, the resource is transitioned to the state of its next access. This way, transitions are batched per pass boundary
+	// and issued as early as the resource lifetime permits, instead of being resolved lazily by nvrhi's automatic state tracking at the next draw/dispatch
+	// 'm_BeginState' == Unknown for the first access of the frame, which begins in 'ResourceHandle::m_PlannedState' instead
+	struct PlannedAccess
+	{
+		ResourceHandle* m_ResourceHandle;
+		nvrhi::ResourceStates m_BeginState;
+		nvrhi::ResourceStates m_AccessState;
+		nvrhi::ResourceStates m_EndState;
+		bool m_bEndUAVBarrier;
+	};
+
+	struct PassCommandList
 	{
-		IRenderer* m_Renderer;
-		std::vector<ResourceAccess> m_ResourceAccesses;
 		nvrhi::CommandListHandle m_CommandList;
+
+		// CPU timestamps, for trace export
+		uint64_t m_RecordStartTick = 0;
+		uint64_t m_RecordEndTick = 0;
+		SDL_ThreadID m_RecordThreadID = 0;
+	};
+
+	struct Pass
+	{
+		explicit Pass(std::pmr::memory_resource* frameAllocator) : m_ResourceAccesses(frameAllocator) {}
+
+		IRenderer* m_Renderer = nullptr;
+		std::pmr::vector<ResourceAccess> m_ResourceAccesses; // lives in 'm_FrameAllocator'
+
+		// in submission order. Just 1, unless the pass is split into child command lists. See 'ChildCommandLists.h'
+		// both point into the renderer's 'RendererCommandLists'
+		uint32_t m_NumChildCommandLists = 0;
+		std::span<PassCommandList> m_CommandLists;
+		std::span<const std::string> m_CommandListNames;
+
+		// CPU timestamps, for trace export
+		uint64_t m_SetupStartTick = 0;
+		uint64_t m_SetupEndTick = 0;
+	};
+
+	// command list slots & names of a renderer's pass, kept across frames so that adding the pass doesn't allocate
+	struct RendererCommandLists
+	{
+		std::vector<PassCommandList> m_CommandLists;
+		std::vector<std::string> m_Names; // only re-built when the number of child command lists changes
+		uint32_t m_NumChildCommandLists = UINT32_MAX;
+		uint64_t m_LastFrameStartTick = 0; // a renderer is added at most once per frame
 	};
 
 	struct Heap
@@ -59,6 +140,18 @@ public:
 		void Free(uint64_t heapOffset);
 		void FindBest(uint64_t size, uint32_t& foundIdx, uint64_t& heapOffset);
 		void FindFirst(uint64_t size, uint32_t& foundIdx, uint64_t& heapOffset);
+		uint64_t GetLargestFreeBlockSize() const;
+
+		// as exported by 'ExportTrace'
+		struct Stats
+		{
+			uint64_t m_Capacity = 0;
+			uint64_t m_Used = 0;
+			uint64_t m_Free = 0;
+			uint64_t m_LargestFreeBlock = 0;
+			float m_Fragmentation = 0.0f;
+		};
+		Stats GetStats() const;
 
 		nvrhi::HeapHandle m_Heap;
 
@@ -73,35 +166,100 @@ public:
 		uint64_t m_Peak = 0;
 	};
 	
-	void Initialize();
+	void Initialize(RenderGraphBackend& backend);
 	void InitializeForFrame(tf::Taskflow& taskFlow);
 	void Shutdown();
 	void Compile();
 	tf::Task AddRenderer(IRenderer* renderer);
 	void UpdateIMGUI();
+	void ValidateBarrierPlan() const;
+	uint32_t GetNumPasses() const { return m_Passes.size(); }
+	std::span<const PlannedAccess> GetPlannedAccesses(PassID passID) const { return std::span{ m_PlannedAccesses }.subspan(m_PassPlannedAccessOffsets.at(passID), m_PassPlannedAccessOffsets.at(passID + 1) - m_PassPlannedAccessOffsets.at(passID)); }
+	uint64_t GetPeakTransientMemory() const;
+
+	// Dumps the passes & transient resources of the last executed frame as a Chrome trace (chrome://tracing, ui.perfetto.dev)
+	void TriggerExportTrace(std::string_view fileName) { m_ExportTraceFileName = fileName; }
+	void ExportTrace(std::string_view fileName) const;
+
+	// Everything the passes of a frame declared during Setup, in declaration order. Replayed on a null backend by 'RunRenderGraphReplay'
+	// Resources are indices, so that the declarations dont depend on the renderers that own the handles
+	struct Declarations
+	{
+		struct Access
+		{
+			uint32_t m_ResourceIdx;
+			ResourceHandle::AccessType m_AccessType;
+			nvrhi::ResourceStates m_State;
+			ResourceHandle::Type m_ResourceType = ResourceHandle::Type::Texture;
+			uint32_t m_CreateDescIdx = UINT32_MAX; // into 'm_CreateDescs' if declared by 'CreateTransientResource'
+		};
+
+		struct Pass
+		{
+			std::string m_Name;
+			uint32_t m_NumChildCommandLists = 0;
+			std::vector<Access> m_Accesses;
+		};
+
+		std::vector<Pass> m_Passes;
+		std::vector<ResourceDesc> m_CreateDescs;
+		uint32_t m_NumResources = 0;
+	};
+
+	// Text file, 1 declaration per line. See 'ExportDeclarations' for the format
+	void TriggerExportDeclarations(std::string_view fileName) { m_ExportDeclarationsFileName = fileName; }
+	void ExportDeclarations(std::string_view fileName) const;
+	static bool ImportDeclarations(std::string_view fileName, Declarations& outDeclarations);
+
+	bool m_bEnableCompileCache = true;
+	uint32_t m_NumPlannedBarriers = 0;
+	uint32_t m_NumPlannedBarrierBatches = 0;
+	float m_LastCompileTimeUs = 0.0f;
 
 	// Setup Phase funcs
 	template <typename ResourceDescT>
 	void CreateTransientResource(ResourceHandle& resourceHandle, const ResourceDescT& resourceDesc);
 
-	void AddReadDependency(ResourceHandle& resourceHandle) { AddDependencyInternal(resourceHandle, ResourceHandle::AccessType::Read); }
-	void AddWriteDependency(ResourceHandle& resourceHandle) { AddDependencyInternal(resourceHandle, ResourceHandle::AccessType::Write); }
+	// 'state' is how the pass actually uses the resource: ShaderResource, DepthRead (read-only depth attachment), IndirectArgument, CopySource, ConstantBuffer...
+	void AddReadDependency(ResourceHandle& resourceHandle, nvrhi::ResourceStates state) { AddDependencyInternal(resourceHandle, ResourceHandle::AccessType::Read, state); }
+	void AddWriteDependency(ResourceHandle& resourceHandle, nvrhi::ResourceStates state = nvrhi::ResourceStates::Unknown) { AddDependencyInternal(resourceHandle, ResourceHandle::AccessType::Write, state); }
+
+	// Splits the recording of the pass into 'IRenderer::Render', then 'numChildCommandLists' calls to 'IRenderer::RenderChild' recorded in parallel
+	// Each child records into its own command list & they are submitted in child order, right after the pass' own command list
+	// Children begin & end with the pass' resources in their access state. Resources not owned by the graph are tracked per command list, as for any pass
+	void SetNumChildCommandLists(uint32_t numChildCommandLists);
 
 	// Execute Phase funcs
 	[[nodiscard]] nvrhi::TextureHandle GetTexture(const ResourceHandle& resourceHandle) const { return (nvrhi::ITexture*)GetResourceInternal(resourceHandle, ResourceHandle::Type::Texture); }
 	[[nodiscard]] nvrhi::BufferHandle GetBuffer(const ResourceHandle& resourceHandle) const { return (nvrhi::IBuffer*)GetResourceInternal(resourceHandle, ResourceHandle::Type::Buffer); }
 
 private:
-	void AddDependencyInternal(ResourceHandle& resourceHandle, ResourceHandle::AccessType accessType);
+	void AddDependencyInternal(ResourceHandle& resourceHandle, ResourceHandle::AccessType accessType, nvrhi::ResourceStates state, bool bCreatesResource = false);
+	nvrhi::ResourceStates GetDefaultWriteState(const ResourceHandle& resourceHandle) const;
+	bool IsLegalAccessState(const ResourceAccess& resourceAccess, nvrhi::ResourceStates state) const;
+	void BuildBarrierPlan();
+	void CommitPassBeginBarriers(PassID passID, nvrhi::CommandListHandle commandList) const;
+	void CommitPassEndBarriers(PassID passID, nvrhi::CommandListHandle commandList) const;
+	void BeginChildCommandList(PassID passID, nvrhi::CommandListHandle commandList) const;
+	void EndChildCommandList(PassID passID, nvrhi::CommandListHandle commandList) const;
+	void RecordPassCommandList(PassID passID, uint32_t commandListIdx);
 	nvrhi::IResource* GetResourceInternal(const ResourceHandle& resourceHandle, ResourceHandle::Type resourceType) const;
     void FreeResource(ResourceHandle& resourceHandle);
     const char* GetResourceName(const ResourceHandle& resourceHandle) const;
 	void CreateNewHeap(uint64_t size);
 
+	RenderGraphBackend* m_Backend = nullptr;
 	tf::Taskflow* m_TaskFlow;
 	
 	std::vector<tf::Task> m_CommandListQueueTasks;
-	std::vector<Pass> m_Passes;
+
+	// per-frame bookkeeping of the Setup phase. Rewound in 'InitializeForFrame' rather than freed
+	LinearAllocator m_FrameAllocator;
+
+	std::pmr::vector<Pass> m_Passes{ &m_FrameAllocator };
+
+	// NOTE: not in 'm_FrameAllocator': kept across frames, so that adding a pass neither allocates nor re-builds names
+	std::unordered_map<const IRenderer*, RendererCommandLists> m_RendererCommandLists; // node based, so 'Pass' spans stay valid as renderers are added
 
 	std::vector<ResourceHandle*> m_ResourceHandles;
 	std::vector<ResourceDesc> m_ResourceDescs;
@@ -117,5 +275,22 @@ private:
 
 	Phase m_CurrentPhase = Phase::Setup;
 
+	uint64_t m_FrameStartTick = 0;
+	std::string m_ExportTraceFileName;
+	std::string m_ExportDeclarationsFileName;
+
 	std::vector<Heap> m_Heaps;
+
+	// Compile cache. Hash of everything declared during the Setup phase (pass set, access patterns & transient descs)
+	// If it matches the previously compiled hash, access intervals from the last Compile are still valid & are re-used
+	std::size_t m_SetupHash = 0;
+	std::size_t m_CompiledSetupHash = 0;
+	uint32_t m_NextResourceAgingFrameIdx = 0; // earliest frame where an un-accessed transient resource can be freed
+
+	// Barrier plan. Re-used as long as the compile cache hits
+	std::vector<PlannedAccess> m_PlannedAccesses;
+	std::vector<uint32_t> m_PassPlannedAccessOffsets; // [passID, passID + 1) range into 'm_PlannedAccesses'
+
+	uint32_t m_NumCompileCacheHits = 0;
+	uint32_t m_NumCompileCacheMisses = 0;
 };
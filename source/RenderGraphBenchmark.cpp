@@ -0,0 +1,746 @@
+#include "RenderGraph.h"
+
+#include "ChildCommandLists.h"
+#include "EngineCore.h"
+#include "HeadlessRuns.h"
+#include "IntegerMath.h"
+#include "Renderer.h"
+
+// Pass that creates a single transient resource & reads the outputs of a couple of earlier passes
+class SyntheticRenderer : public IRenderer
+{
+public:
+	SyntheticRenderer(uint32_t passIdx, std::vector<RenderGraph::ResourceHandle>& outputHandles)
+		: IRenderer{ StringFormat("SyntheticRenderer %u", passIdx) }
+		, m_PassIdx(passIdx)
+		, m_OutputHandles(outputHandles)
+	{}
+
+	~SyntheticRenderer()
+	{
+		// dont let 'Graphic::Shutdown' & the IMGUI profiler touch this renderer after the benchmark is done
+		std::erase(ms_AllRenderers, this);
+	}
+
+	bool Setup(RenderGraph& renderGraph) override
+	{
+		// mix of textures & buffers, to exercise both paths
+		if (m_PassIdx % 4 == 3)
+		{
+			nvrhi::BufferDesc desc;
+			desc.byteSize = KB_TO_BYTES(64) * (1 + m_PassIdx % 3);
+			desc.structStride = sizeof(uint32_t);
+			desc.canHaveUAVs = true;
+			desc.debugName = "Synthetic Buffer";
+			desc.initialState = nvrhi::ResourceStates::ShaderResource;
+
+			renderGraph.CreateTransientResource(m_OutputHandles[m_PassIdx], desc);
+		}
+		else
+		{
+			nvrhi::TextureDesc desc;
+			desc.width = 256 >> (m_PassIdx % 3);
+			desc.height = 256 >> (m_PassIdx % 3);
+			desc.format = nvrhi::Format::RGBA8_UNORM;
+			desc.isRenderTarget = true;
+			desc.debugName = "Synthetic Texture";
+			desc.initialState = nvrhi::ResourceStates::ShaderResource;
+
+			renderGraph.CreateTransientResource(m_OutputHandles[m_PassIdx], desc);
+		}
+
+		if (m_PassIdx >= 1)
+		{
+			renderGraph.AddReadDependency(m_OutputHandles[m_PassIdx - 1], nvrhi::ResourceStates::ShaderResource);
+		}
+
+		if (m_PassIdx >= 7)
+		{
+			// explicit state, so that the barrier plan sees more than 1 transition per resource
+			renderGraph.AddReadDependency(m_OutputHandles[m_PassIdx - 7], nvrhi::ResourceStates::CopySource);
+		}
+
+		return true;
+	}
+
+	void Render(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph) override {}
+
+	const uint32_t m_PassIdx;
+	std::vector<RenderGraph::ResourceHandle>& m_OutputHandles;
+};
+
+// Stub device for running the render graph without a GPU. Resources are empty ref-counted objects & memory requirements are estimated from the desc
+class NullRenderGraphBackend : public RenderGraphBackend
+{
+public:
+	class NullResource : public nvrhi::RefCounter<nvrhi::IResource> {};
+
+	class NullHeap : public nvrhi::RefCounter<nvrhi::IHeap>
+	{
+	public:
+		explicit NullHeap(const nvrhi::HeapDesc& desc) : m_Desc(desc) {}
+		const nvrhi::HeapDesc& getDesc() override { return m_Desc; }
+
+		nvrhi::HeapDesc m_Desc;
+	};
+
+	// D3D12 placed resources are 64KB aligned
+	static constexpr uint64_t kPlacementAlignment = KB_TO_BYTES(64);
+
+	uint32_t GetFrameCounter() const override { return m_FrameCounter; }
+	nvrhi::HeapHandle CreateHeap(const nvrhi::HeapDesc& heapDesc) override { return nvrhi::HeapHandle::Create(new NullHeap{ heapDesc }); }
+
+	nvrhi::ResourceHandle CreateTexture(const nvrhi::TextureDesc& textureDesc, uint64_t& outMemReq) override
+	{
+		const nvrhi::FormatInfo& formatInfo = nvrhi::getFormatInfo(textureDesc.format);
+		const uint32_t nbSlices = textureDesc.dimension == nvrhi::TextureDimension::Texture3D ? textureDesc.depth : textureDesc.arraySize;
+
+		uint64_t size = 0;
+		for (uint32_t mip = 0; mip < textureDesc.mipLevels; ++mip)
+		{
+			const uint64_t nbBlocksX = DivideAndRoundUp(std::max(1u, textureDesc.width >> mip), formatInfo.blockSize);
+			const uint64_t nbBlocksY = DivideAndRoundUp(std::max(1u, textureDesc.height >> mip), formatInfo.blockSize);
+			size += nbBlocksX * nbBlocksY * formatInfo.bytesPerBlock;
+		}
+		size *= nbSlices * textureDesc.sampleCount;
+
+		outMemReq = std::max(kPlacementAlignment, (size + kPlacementAlignment - 1) & ~(kPlacementAlignment - 1));
+		return nvrhi::ResourceHandle::Create(new NullResource);
+	}
+
+	nvrhi::ResourceHandle CreateBuffer(const nvrhi::BufferDesc& bufferDesc, uint64_t& outMemReq) override
+	{
+		outMemReq = std::max(kPlacementAlignment, (bufferDesc.byteSize + kPlacementAlignment - 1) & ~(kPlacementAlignment - 1));
+		return nvrhi::ResourceHandle::Create(new NullResource);
+	}
+
+	bool BindTextureMemory(nvrhi::IResource* texture, nvrhi::IHeap* heap, uint64_t heapOffset) override { return heapOffset < heap->getDesc().capacity; }
+	bool BindBufferMemory(nvrhi::IResource* buffer, nvrhi::IHeap* heap, uint64_t heapOffset) override { return heapOffset < heap->getDesc().capacity; }
+
+	// passes are only set up & compiled, never recorded
+	nvrhi::CommandListHandle AllocateCommandList() override { check(false); return nullptr; }
+	void BeginCommandList(nvrhi::ICommandList* commandList, const char* name) override { check(false); }
+	void EndCommandList(nvrhi::ICommandList* commandList) override { check(false); }
+	void QueueCommandList(nvrhi::ICommandList* commandList) override { check(false); }
+	void BeginRendererTimer(IRenderer& renderer, nvrhi::ICommandList* commandList) override { check(false); }
+	void EndRendererTimer(IRenderer& renderer, nvrhi::ICommandList* commandList) override { check(false); }
+
+	uint32_t m_FrameCounter = 0;
+};
+
+// Sets up & compiles the passes of 'renderers' for a few frames on a null backend. Reports the cost of both & the resulting barrier plan & transient memory
+static void RunRenderGraphFrames(const char* runName, std::span<IRenderer* const> renderers, const char* traceFileName)
+{
+	PROFILE_FUNCTION();
+
+	const uint32_t kNumFrames = 32;
+
+	NullRenderGraphBackend nullBackend;
+
+	RenderGraph renderGraph;
+	renderGraph.Initialize(nullBackend);
+
+	auto RunFrames = [&](const char* label, bool bEnableCompileCache)
+		{
+			renderGraph.m_bEnableCompileCache = bEnableCompileCache;
+
+			float totalSetupTimeUs = 0.0f;
+			float totalCompileTimeUs = 0.0f;
+
+			for (uint32_t frame = 0; frame < kNumFrames; ++frame)
+			{
+				tf::Taskflow tf;
+
+				Timer setupTimer;
+				renderGraph.InitializeForFrame(tf);
+				for (IRenderer* renderer : renderers)
+				{
+					renderGraph.AddRenderer(renderer);
+				}
+				totalSetupTimeUs += setupTimer.GetElapsedMicroSeconds();
+
+				renderGraph.Compile();
+				totalCompileTimeUs += renderGraph.m_LastCompileTimeUs;
+
+				renderGraph.ValidateBarrierPlan();
+
+				++nullBackend.m_FrameCounter;
+			}
+
+			SDL_Log("%s [%s]: %u passes, avg setup: %.2f us, avg compile: %.2f us, avg setup + compile: %.2f us, planned barriers: %u in %u batches, peak transient memory: %.2f MB",
+				runName, label, renderGraph.GetNumPasses(),
+				totalSetupTimeUs / kNumFrames, totalCompileTimeUs / kNumFrames, (totalSetupTimeUs + totalCompileTimeUs) / kNumFrames,
+				renderGraph.m_NumPlannedBarriers, renderGraph.m_NumPlannedBarrierBatches, BYTES_TO_MB(renderGraph.GetPeakTransientMemory()));
+		};
+
+	// 1st frame allocates all transient resources. dont let it skew the results
+	RunFrames("warm up", false);
+
+	RunFrames("cache misses", false);
+	RunFrames("cache hits", true);
+
+	// passes are never recorded, so the trace only has Setup timings, transient resource lifetimes & heap layout
+	renderGraph.ExportTrace(traceFileName);
+
+	renderGraph.Shutdown();
+}
+
+CommandLineOption<int> g_RenderGraphCompileBenchmarkPasses{ "rendergraphcompilebenchmarkpasses", 1000 };
+
+// NOTE: always on a null backend, also when run from the app's UI: it must not create resources or heaps on the live device in the middle of a frame
+void RunRenderGraphCompileBenchmark(uint32_t numPasses)
+{
+	std::vector<RenderGraph::ResourceHandle> outputHandles(numPasses);
+
+	std::vector<std::unique_ptr<SyntheticRenderer>> renderers;
+	std::vector<IRenderer*> rendererPtrs;
+	for (uint32_t i = 0; i < numPasses; ++i)
+	{
+		rendererPtrs.push_back(renderers.emplace_back(std::make_unique<SyntheticRenderer>(i, outputHandles)).get());
+	}
+
+	// copy: the 'StringFormat' buffer gets overwritten while the frames run
+	const std::string traceFileName = StringFormat("RenderGraphBenchmarkTrace_%u.json", numPasses);
+	RunRenderGraphFrames("Render Graph Compile Benchmark", rendererPtrs, traceFileName.c_str());
+}
+REGISTER_HEADLESS_RUN("rendergraphcompilebenchmark", HeadlessRunType::Benchmark, [] { RunRenderGraphCompileBenchmark(g_RenderGraphCompileBenchmarkPasses.Get()); });
+
+// Pass that re-declares what a pass of a recorded frame declared. See 'RenderGraph::ExportDeclarations'
+class ReplayRenderer : public IRenderer
+{
+public:
+	ReplayRenderer(const RenderGraph::Declarations& declarations, uint32_t passIdx, std::vector<RenderGraph::ResourceHandle>& resourceHandles)
+		: IRenderer{ declarations.m_Passes.at(passIdx).m_Name.c_str() }
+		, m_Declarations(declarations)
+		, m_Pass(declarations.m_Passes.at(passIdx))
+		, m_ResourceHandles(resourceHandles)
+	{}
+
+	~ReplayRenderer()
+	{
+		std::erase(ms_AllRenderers, this);
+	}
+
+	bool Setup(RenderGraph& renderGraph) override
+	{
+		if (m_Pass.m_NumChildCommandLists > 0)
+		{
+			renderGraph.SetNumChildCommandLists(m_Pass.m_NumChildCommandLists);
+		}
+
+		for (const RenderGraph::Declarations::Access& access : m_Pass.m_Accesses)
+		{
+			RenderGraph::ResourceHandle& resourceHandle = m_ResourceHandles.at(access.m_ResourceIdx);
+
+			if (access.m_CreateDescIdx != UINT32_MAX)
+			{
+				const RenderGraph::ResourceDesc& desc = m_Declarations.m_CreateDescs.at(access.m_CreateDescIdx);
+				if (access.m_ResourceType == RenderGraph::ResourceHandle::Type::Texture)
+				{
+					renderGraph.CreateTransientResource(resourceHandle, desc.m_TextureDesc);
+				}
+				else
+				{
+					renderGraph.CreateTransientResource(resourceHandle, desc.m_BufferDesc);
+				}
+			}
+			else if (access.m_AccessType == RenderGraph::ResourceHandle::AccessType::Read)
+			{
+				renderGraph.AddReadDependency(resourceHandle, access.m_State);
+			}
+			else
+			{
+				renderGraph.AddWriteDependency(resourceHandle, access.m_State);
+			}
+		}
+
+		return true;
+	}
+
+	void Render(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph) override {}
+
+	const RenderGraph::Declarations& m_Declarations;
+	const RenderGraph::Declarations::Pass& m_Pass;
+	std::vector<RenderGraph::ResourceHandle>& m_ResourceHandles;
+};
+
+CommandLineOption<std::string> g_RenderGraphReplayFile{ "rendergraphreplayfile", "" };
+
+// Replays the declarations of a frame recorded by the app ("Export Frame Declarations" in the Render Graph UI) w/o a GPU
+// So that allocator, barrier & scheduling changes are measured on real frames. i.e.: "-run=rendergraphreplay -rendergraphreplayfile=RenderGraphDeclarations.txt"
+static void RunRenderGraphReplay()
+{
+	if (g_RenderGraphReplayFile.Get().empty())
+	{
+		SDL_Log("Render Graph Replay: no declarations file. Use '-rendergraphreplayfile=<file>'");
+		return;
+	}
+
+	RenderGraph::Declarations declarations;
+	if (!RenderGraph::ImportDeclarations(g_RenderGraphReplayFile.Get(), declarations))
+	{
+		return;
+	}
+
+	std::vector<RenderGraph::ResourceHandle> resourceHandles(declarations.m_NumResources);
+
+	std::vector<std::unique_ptr<ReplayRenderer>> renderers;
+	std::vector<IRenderer*> rendererPtrs;
+	for (uint32_t i = 0; i < declarations.m_Passes.size(); ++i)
+	{
+		rendererPtrs.push_back(renderers.emplace_back(std::make_unique<ReplayRenderer>(declarations, i, resourceHandles)).get());
+	}
+
+	SDL_Log("Render Graph Replay: %s, %u passes, %u transient resources", g_RenderGraphReplayFile.Get().c_str(), (uint32_t)declarations.m_Passes.size(), declarations.m_NumResources);
+
+	RunRenderGraphFrames("Render Graph Replay", rendererPtrs, "RenderGraphReplayTrace.json");
+}
+REGISTER_HEADLESS_RUN("rendergraphreplay", HeadlessRunType::Benchmark, RunRenderGraphReplay);
+
+// Pass whose Setup declares a fixed list of accesses
+class ScriptedRenderer : public IRenderer
+{
+public:
+	using SetupFunc = std::function<void(RenderGraph&)>;
+
+	ScriptedRenderer(const char* name, SetupFunc setupFunc)
+		: IRenderer{ name }
+		, m_SetupFunc(std::move(setupFunc))
+	{}
+
+	~ScriptedRenderer()
+	{
+		std::erase(ms_AllRenderers, this);
+	}
+
+	bool Setup(RenderGraph& renderGraph) override
+	{
+		if (!m_bActive)
+		{
+			return false;
+		}
+
+		m_SetupFunc(renderGraph);
+		return true;
+	}
+
+	void Render(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph) override {}
+
+	const SetupFunc m_SetupFunc;
+	bool m_bActive = true;
+};
+
+struct ExpectedPlannedAccess
+{
+	uint32_t m_PassIdx;
+	uint32_t m_ResourceIdx;
+	nvrhi::ResourceStates m_BeginState;
+	nvrhi::ResourceStates m_AccessState;
+	nvrhi::ResourceStates m_EndState;
+	bool m_bEndUAVBarrier = false;
+};
+
+// Compiles the graph for a few frames & compares its barrier plan against transitions written by hand
+// NOTE: the expected plans are never derived from the graph's own state mapping, so that a wrong mapping fails the test
+static void RunBarrierPlanCase(const char* caseName, std::vector<RenderGraph::ResourceHandle>& resourceHandles, std::vector<std::unique_ptr<ScriptedRenderer>>& renderers,
+	std::span<const ExpectedPlannedAccess> expectedPlannedAccesses, uint32_t expectedNumBarriers, uint32_t expectedNumBarrierBatches)
+{
+	NullRenderGraphBackend nullBackend;
+
+	RenderGraph renderGraph;
+	renderGraph.Initialize(nullBackend);
+
+	// 2nd frame re-uses the plan of the 1st through the compile cache
+	for (uint32_t frame = 0; frame < 2; ++frame)
+	{
+		tf::Taskflow tf;
+		renderGraph.InitializeForFrame(tf);
+		for (const std::unique_ptr<ScriptedRenderer>& renderer : renderers)
+		{
+			renderGraph.AddRenderer(renderer.get());
+		}
+		renderGraph.Compile();
+		renderGraph.ValidateBarrierPlan();
+
+		uint32_t numPlannedAccesses = 0;
+		for (uint32_t passIdx = 0; passIdx < renderGraph.GetNumPasses(); ++passIdx)
+		{
+			numPlannedAccesses += renderGraph.GetPlannedAccesses(passIdx).size();
+		}
+		test_verify(numPlannedAccesses == expectedPlannedAccesses.size());
+
+		for (const ExpectedPlannedAccess& expected : expectedPlannedAccesses)
+		{
+			const std::span<const RenderGraph::PlannedAccess> passPlannedAccesses = renderGraph.GetPlannedAccesses(expected.m_PassIdx);
+			auto it = std::ranges::find(passPlannedAccesses, &resourceHandles.at(expected.m_ResourceIdx), &RenderGraph::PlannedAccess::m_ResourceHandle);
+			test_verify(it != passPlannedAccesses.end());
+			test_verify(it->m_BeginState == expected.m_BeginState);
+			test_verify(it->m_AccessState == expected.m_AccessState);
+			test_verify(it->m_EndState == expected.m_EndState);
+			test_verify(it->m_bEndUAVBarrier == expected.m_bEndUAVBarrier);
+		}
+
+		test_verify(renderGraph.m_NumPlannedBarriers == expectedNumBarriers);
+		test_verify(renderGraph.m_NumPlannedBarrierBatches == expectedNumBarrierBatches);
+
+		++nullBackend.m_FrameCounter;
+	}
+
+	renderGraph.Shutdown();
+
+	SDL_Log("Render Graph Barrier Plan Self Test [%s]: %u planned accesses, %u barriers in %u batches", caseName, (uint32_t)expectedPlannedAccesses.size(), expectedNumBarriers, expectedNumBarrierBatches);
+}
+
+static void RunRenderGraphBarrierPlanSelfTest()
+{
+	PROFILE_FUNCTION();
+
+	using enum nvrhi::ResourceStates;
+
+	auto MakeTextureDesc = [](nvrhi::Format format)
+		{
+			nvrhi::TextureDesc desc;
+			desc.width = 64;
+			desc.height = 64;
+			desc.format = format;
+			desc.isRenderTarget = true;
+			desc.debugName = "Self Test Texture";
+			desc.initialState = ShaderResource;
+			return desc;
+		};
+
+	// render target, sampled, then copied from
+	{
+		std::vector<RenderGraph::ResourceHandle> handles(1);
+		std::vector<std::unique_ptr<ScriptedRenderer>> renderers;
+		renderers.push_back(std::make_unique<ScriptedRenderer>("Draw", [&](RenderGraph& rg) { rg.CreateTransientResource(handles[0], MakeTextureDesc(nvrhi::Format::RGBA8_UNORM)); }));
+		renderers.push_back(std::make_unique<ScriptedRenderer>("Sample", [&](RenderGraph& rg) { rg.AddReadDependency(handles[0], ShaderResource); }));
+		renderers.push_back(std::make_unique<ScriptedRenderer>("Copy", [&](RenderGraph& rg) { rg.AddReadDependency(handles[0], CopySource); }));
+
+		const ExpectedPlannedAccess expected[] =
+		{
+			{ 0, 0, Unknown,        RenderTarget,   ShaderResource },
+			{ 1, 0, ShaderResource, ShaderResource, CopySource },
+			{ 2, 0, CopySource,     CopySource,     RenderTarget }, // wraps to the state of the 1st access
+		};
+		RunBarrierPlanCase("RT -> SRV -> CopySource", handles, renderers, expected, 3, 3);
+	}
+
+	// UAV buffer written twice, then consumed as indirect args
+	{
+		std::vector<RenderGraph::ResourceHandle> handles(1);
+		std::vector<std::unique_ptr<ScriptedRenderer>> renderers;
+		renderers.push_back(std::make_unique<ScriptedRenderer>("Clear Args", [&](RenderGraph& rg)
+			{
+				nvrhi::BufferDesc desc;
+				desc.byteSize = 64;
+				desc.structStride = sizeof(uint32_t);
+				desc.canHaveUAVs = true;
+				desc.isDrawIndirectArgs = true;
+				desc.debugName = "Self Test Indirect Args";
+				desc.initialState = IndirectArgument;
+				rg.CreateTransientResource(handles[0], desc);
+			}));
+		renderers.push_back(std::make_unique<ScriptedRenderer>("Cull", [&](RenderGraph& rg) { rg.AddWriteDependency(handles[0]); }));
+		renderers.push_back(std::make_unique<ScriptedRenderer>("Draw Indirect", [&](RenderGraph& rg) { rg.AddReadDependency(handles[0], IndirectArgument); }));
+
+		const ExpectedPlannedAccess expected[] =
+		{
+			{ 0, 0, Unknown,          UnorderedAccess,  UnorderedAccess, true }, // UAV write after UAV write
+			{ 1, 0, UnorderedAccess,  UnorderedAccess,  IndirectArgument },
+			{ 2, 0, IndirectArgument, IndirectArgument, UnorderedAccess },
+		};
+		RunBarrierPlanCase("UAV -> UAV -> IndirectArgument", handles, renderers, expected, 3, 3);
+	}
+
+	// depth written, tested read-only, sampled, written again. Color target sampled in between
+	{
+		std::vector<RenderGraph::ResourceHandle> handles(2);
+		std::vector<std::unique_ptr<ScriptedRenderer>> renderers;
+		renderers.push_back(std::make_unique<ScriptedRenderer>("Depth Prepass", [&](RenderGraph& rg) { rg.CreateTransientResource(handles[0], MakeTextureDesc(nvrhi::Format::D32)); }));
+		renderers.push_back(std::make_unique<ScriptedRenderer>("Lighting", [&](RenderGraph& rg)
+			{
+				rg.CreateTransientResource(handles[1], MakeTextureDesc(nvrhi::Format::RGBA16_FLOAT));
+				rg.AddReadDependency(handles[0], DepthRead);
+			}));
+		renderers.push_back(std::make_unique<ScriptedRenderer>("Post Process", [&](RenderGraph& rg)
+			{
+				rg.AddReadDependency(handles[1], ShaderResource);
+				rg.AddReadDependency(handles[0], ShaderResource);
+			}));
+		renderers.push_back(std::make_unique<ScriptedRenderer>("Debug Draw", [&](RenderGraph& rg) { rg.AddWriteDependency(handles[0]); }));
+
+		const ExpectedPlannedAccess expected[] =
+		{
+			{ 0, 0, Unknown,        DepthWrite,     DepthRead },
+			{ 1, 1, Unknown,        RenderTarget,   ShaderResource },
+			{ 1, 0, DepthRead,      DepthRead,      ShaderResource },
+			{ 2, 1, ShaderResource, ShaderResource, RenderTarget },
+			{ 2, 0, ShaderResource, ShaderResource, DepthWrite },
+			{ 3, 0, DepthWrite,     DepthWrite,     DepthWrite }, // already in the state of the 1st access
+		};
+		RunBarrierPlanCase("Depth -> DepthRead -> SRV -> Depth", handles, renderers, expected, 5, 3);
+	}
+}
+REGISTER_HEADLESS_RUN("rendergraphbarrierplanselftest", HeadlessRunType::SelfTest, RunRenderGraphBarrierPlanSelfTest);
+
+// Used & free bytes of the transient heaps, as 'ExportTrace' reports them, against a known sequence of allocations & frees
+static void RunRenderGraphHeapSelfTest()
+{
+	PROFILE_FUNCTION();
+
+	const uint64_t kBlockSize = KB_TO_BYTES(64);
+
+	// bytes of allocated blocks, counted independently of 'Heap::m_Used'
+	auto GetAllocatedBytes = [](const RenderGraph::Heap& heap)
+		{
+			uint64_t allocatedBytes = 0;
+			for (const RenderGraph::Heap::Block& block : heap.m_Blocks)
+			{
+				allocatedBytes += block.m_Allocated ? block.m_Size : 0;
+			}
+			return allocatedBytes;
+		};
+
+	auto VerifyStats = [&](const RenderGraph::Heap& heap, uint64_t expectedUsed, uint64_t expectedLargestFreeBlock, uint32_t expectedNumBlocks)
+		{
+			const RenderGraph::Heap::Stats stats = heap.GetStats();
+			test_verify(stats.m_Capacity == 16 * kBlockSize);
+			test_verify(stats.m_Used == expectedUsed);
+			test_verify(stats.m_Free == stats.m_Capacity - expectedUsed);
+			test_verify(stats.m_LargestFreeBlock == expectedLargestFreeBlock);
+			test_verify(GetAllocatedBytes(heap) == expectedUsed);
+			test_verify(heap.m_Blocks.size() == expectedNumBlocks);
+		};
+
+	// heap alone. Frees merge w/ free neighbours on either side
+	{
+		RenderGraph::Heap heap;
+		heap.m_Blocks.push_back({ 16 * kBlockSize, false });
+
+		const uint64_t a = heap.Allocate(1 * kBlockSize);
+		const uint64_t b = heap.Allocate(2 * kBlockSize);
+		const uint64_t c = heap.Allocate(1 * kBlockSize);
+		const uint64_t d = heap.Allocate(4 * kBlockSize);
+		test_verify(a == 0 && b == 1 * kBlockSize && c == 3 * kBlockSize && d == 4 * kBlockSize);
+		VerifyStats(heap, 8 * kBlockSize, 8 * kBlockSize, 5);
+
+		heap.Free(b); // both neighbours allocated
+		VerifyStats(heap, 6 * kBlockSize, 8 * kBlockSize, 5);
+
+		heap.Free(c); // merges w/ the previous block
+		VerifyStats(heap, 5 * kBlockSize, 8 * kBlockSize, 4);
+
+		const uint64_t e = heap.Allocate(1 * kBlockSize); // best fit: the 3 block hole left by 'b' & 'c'
+		test_verify(e == 1 * kBlockSize);
+		VerifyStats(heap, 6 * kBlockSize, 8 * kBlockSize, 5);
+
+		heap.Free(a);
+		VerifyStats(heap, 5 * kBlockSize, 8 * kBlockSize, 5);
+		test_verify(heap.GetStats().m_Fragmentation == 1.0f - 8.0f / 11.0f);
+
+		heap.Free(d); // merges w/ the next & previous blocks
+		VerifyStats(heap, 1 * kBlockSize, 14 * kBlockSize, 3);
+
+		heap.Free(e);
+		VerifyStats(heap, 0, 16 * kBlockSize, 1);
+		test_verify(heap.m_Peak == 8 * kBlockSize);
+	}
+
+	// through the graph: the last transient resource of the heap ages out, so its free merges w/ the free tail of the heap
+	{
+		NullRenderGraphBackend nullBackend;
+
+		std::vector<RenderGraph::ResourceHandle> handles(2);
+		nvrhi::TextureDesc desc;
+		desc.width = 256;
+		desc.height = 256; // 256 KB
+		desc.format = nvrhi::Format::RGBA8_UNORM;
+		desc.isRenderTarget = true;
+		desc.debugName = "Self Test Texture";
+		desc.initialState = nvrhi::ResourceStates::ShaderResource;
+
+		std::vector<std::unique_ptr<ScriptedRenderer>> renderers;
+		renderers.push_back(std::make_unique<ScriptedRenderer>("A", [&](RenderGraph& rg) { rg.CreateTransientResource(handles[0], desc); }));
+		renderers.push_back(std::make_unique<ScriptedRenderer>("B", [&](RenderGraph& rg) { rg.CreateTransientResource(handles[1], desc); }));
+
+		RenderGraph renderGraph;
+		renderGraph.Initialize(nullBackend);
+
+		for (uint32_t frame = 0; frame < 8; ++frame)
+		{
+			renderers[1]->m_bActive = frame < 2;
+
+			tf::Taskflow tf;
+			renderGraph.InitializeForFrame(tf);
+			for (const std::unique_ptr<ScriptedRenderer>& renderer : renderers)
+			{
+				renderGraph.AddRenderer(renderer.get());
+			}
+			renderGraph.Compile();
+
+			++nullBackend.m_FrameCounter;
+		}
+
+		test_verify(handles[0].m_Resource && handles[0].m_HeapOffset == 0);
+		test_verify(!handles[1].m_Resource);
+
+		const char* kTraceFileName = "RenderGraphHeapSelfTestTrace.json";
+		renderGraph.ExportTrace(kTraceFileName);
+		renderGraph.Shutdown();
+
+		std::string trace;
+		ReadTextFromFile((std::filesystem::path{ GetExecutableDirectory() } / kTraceFileName).string(), trace);
+
+		auto ReadHeapValue = [&trace](const char* key)
+			{
+				const size_t heapsPos = trace.find("\"heaps\": [");
+				test_verify(heapsPos != std::string::npos);
+
+				const std::string keyStr = StringFormat("\"%s\": ", key);
+				const size_t valuePos = trace.find(keyStr, heapsPos);
+				test_verify(valuePos != std::string::npos);
+
+				return std::strtoull(trace.c_str() + valuePos + keyStr.size(), nullptr, 10);
+			};
+
+		const uint64_t kTextureSize = 4 * kBlockSize;
+		const uint64_t kHeapCapacity = MB_TO_BYTES(16);
+		test_verify(ReadHeapValue("capacity") == kHeapCapacity);
+		test_verify(ReadHeapValue("used") == kTextureSize);
+		test_verify(ReadHeapValue("free") == kHeapCapacity - kTextureSize);
+		test_verify(ReadHeapValue("largestFreeBlock") == kHeapCapacity - kTextureSize);
+		test_verify(ReadHeapValue("peak") == 2 * kTextureSize);
+	}
+}
+REGISTER_HEADLESS_RUN("rendergraphheapselftest", HeadlessRunType::SelfTest, RunRenderGraphHeapSelfTest);
+
+// Stand-in for a command list of a pass split into child command lists
+struct StubCommandList
+{
+	uint32_t m_PassIdx = UINT32_MAX;
+	uint32_t m_CommandListIdx = UINT32_MAX;
+	uint32_t m_RecordOrder = UINT32_MAX; // in which order it finished recording, across all passes
+	std::thread::id m_RecordThreadID;
+};
+
+// Runs the recording & queuing tasks of 'ChildCommandLists' the way the render graph does, on stub command lists w/ random recording times
+// The submission order must always be: pass by pass, then the pass' own command list, its children in order & its closing command list
+static void RunChildCommandListsSelfTest()
+{
+	PROFILE_FUNCTION();
+
+	const uint32_t kNumPasses = 32;
+	const uint32_t kMaxNumChildren = 8;
+	const uint32_t kNumRuns = 50;
+
+	tf::Executor executor{ 8 };
+
+	// mix of passes w/ & w/o children
+	std::mt19937 rng{ 42 };
+	std::vector<uint32_t> numChildrenPerPass(kNumPasses);
+	std::vector<std::pair<uint32_t, uint32_t>> expectedSubmissions;
+	for (uint32_t passIdx = 0; passIdx < kNumPasses; ++passIdx)
+	{
+		numChildrenPerPass[passIdx] = rng() % (kMaxNumChildren + 1);
+
+		for (uint32_t i = 0; i < ChildCommandLists::GetNumCommandLists(numChildrenPerPass[passIdx]); ++i)
+		{
+			expectedSubmissions.push_back({ passIdx, i });
+		}
+	}
+
+	uint32_t numChildrenRecordedOutOfOrder = 0;
+	uint32_t maxNumThreadsPerPass = 0;
+
+	for (uint32_t runIdx = 0; runIdx < kNumRuns; ++runIdx)
+	{
+		std::vector<std::vector<StubCommandList>> passCommandLists(kNumPasses);
+		std::atomic<uint32_t> recordCounter = 0;
+
+		std::mutex submissionLock;
+		std::vector<StubCommandList> submittedCommandLists;
+
+		tf::Taskflow taskFlow;
+		std::vector<tf::Task> queueTasks;
+
+		for (uint32_t passIdx = 0; passIdx < kNumPasses; ++passIdx)
+		{
+			const uint32_t numChildren = numChildrenPerPass[passIdx];
+			passCommandLists[passIdx].resize(ChildCommandLists::GetNumCommandLists(numChildren));
+
+			const ChildCommandLists::Tasks tasks = ChildCommandLists::Emplace(taskFlow, numChildren,
+				[&, passIdx, runIdx](uint32_t commandListIdx)
+				{
+					// random recording cost, so that children finish out of order
+					std::mt19937 recordRng{ runIdx * 7919 + passIdx * 131 + commandListIdx };
+					std::this_thread::sleep_for(std::chrono::microseconds{ recordRng() % 200 });
+
+					StubCommandList& commandList = passCommandLists[passIdx].at(commandListIdx);
+					test_verify(commandList.m_PassIdx == UINT32_MAX); // recorded exactly once
+
+					commandList.m_PassIdx = passIdx;
+					commandList.m_CommandListIdx = commandListIdx;
+					commandList.m_RecordOrder = recordCounter++;
+					commandList.m_RecordThreadID = std::this_thread::get_id();
+				},
+				[&, passIdx]
+				{
+					AUTO_LOCK(submissionLock);
+					for (const StubCommandList& commandList : passCommandLists[passIdx])
+					{
+						test_verify(commandList.m_PassIdx == passIdx);
+						submittedCommandLists.push_back(commandList);
+					}
+				});
+
+			queueTasks.push_back(tasks.m_Queue);
+		}
+
+		// as in 'RenderGraph::Compile'
+		for (uint32_t i = 1; i < queueTasks.size(); ++i)
+		{
+			queueTasks[i].succeed(queueTasks[i - 1]);
+		}
+
+		executor.run(taskFlow).wait();
+
+		// deterministic submission order, regardless of recording order
+		test_verify(submittedCommandLists.size() == expectedSubmissions.size());
+		for (uint32_t i = 0; i < submittedCommandLists.size(); ++i)
+		{
+			test_verify(submittedCommandLists[i].m_PassIdx == expectedSubmissions[i].first);
+			test_verify(submittedCommandLists[i].m_CommandListIdx == expectedSubmissions[i].second);
+		}
+
+		// children are recorded after the pass' own command list & before its closing one
+		for (uint32_t passIdx = 0; passIdx < kNumPasses; ++passIdx)
+		{
+			const std::vector<StubCommandList>& commandLists = passCommandLists[passIdx];
+			const uint32_t numChildren = numChildrenPerPass[passIdx];
+
+			std::vector<std::thread::id> recordThreadIDs;
+			for (uint32_t i = 1; i <= numChildren; ++i)
+			{
+				test_verify(ChildCommandLists::IsChild(i, numChildren));
+				test_verify(commandLists[i].m_RecordOrder > commandLists[0].m_RecordOrder);
+				test_verify(commandLists[i].m_RecordOrder < commandLists[numChildren + 1].m_RecordOrder);
+
+				numChildrenRecordedOutOfOrder += (i > 1 && commandLists[i].m_RecordOrder < commandLists[i - 1].m_RecordOrder) ? 1 : 0;
+
+				if (std::find(recordThreadIDs.begin(), recordThreadIDs.end(), commandLists[i].m_RecordThreadID) == recordThreadIDs.end())
+				{
+					recordThreadIDs.push_back(commandLists[i].m_RecordThreadID);
+				}
+			}
+			test_verify(!ChildCommandLists::IsChild(0, numChildren));
+			test_verify(ChildCommandLists::IsTail(numChildren + 1, numChildren) == (numChildren > 0));
+
+			maxNumThreadsPerPass = std::max(maxNumThreadsPerPass, (uint32_t)recordThreadIDs.size());
+		}
+	}
+
+	SDL_Log("Child Command Lists self test: %u runs, %u command lists per run, %u children recorded out of order, up to %u threads per pass",
+		kNumRuns, (uint32_t)expectedSubmissions.size(), numChildrenRecordedOutOfOrder, maxNumThreadsPerPass);
+}
+REGISTER_HEADLESS_RUN("childcommandlistsselftest", HeadlessRunType::SelfTest, RunChildCommandListsSelfTest);
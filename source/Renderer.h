@@ -0,0 +1,43 @@
+#pragma once
+
+#include "extern/nvrhi/include/nvrhi/nvrhi.h"
+
+#include "GraphicConstants.h"
+
+class RenderGraph;
+
+class IRenderer
+{
+public:
+    IRenderer(const char* rendererName)
+        : m_Name(rendererName)
+    {
+        ms_AllRenderers.push_back(this);
+    }
+
+    virtual ~IRenderer() = default;
+    virtual void Initialize() {};
+    virtual void PostSceneLoad() {};
+    virtual bool HasImguiControls() const { return false; }
+    virtual void UpdateImgui() {};
+
+    // return false if the renderer is not going to be used
+    virtual bool Setup(RenderGraph& renderGraph) { return true; }
+
+    virtual void Render(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph) = 0;
+
+    // only called if 'RenderGraph::SetNumChildCommandLists' was used in Setup. Called in parallel, after 'Render'
+    virtual void RenderChild(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph, uint32_t childIdx) { check(false); }
+
+    const std::string m_Name;
+
+    float m_CPUFrameTime = 0.0f;
+    float m_GPUFrameTime = 0.0f;
+    nvrhi::TimerQueryHandle m_FrameTimerQuery[GraphicConstants::kMaxFramesInFlight];
+
+    inline static std::vector<IRenderer*> ms_AllRenderers;
+};
+
+#define DEFINE_RENDERER(name) \
+    static name gs_##name; \
+    IRenderer* g_##name = &gs_##name;
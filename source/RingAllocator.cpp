@@ -0,0 +1,163 @@
+#include "RingAllocator.h"
+
+#include "Engine.h"
+#include "HeadlessRuns.h"
+#include "MathUtilities.h"
+
+void RingAllocator::Initialize(uint64_t capacity)
+{
+    check(capacity > 0);
+
+    m_Capacity = capacity;
+    m_Head = 0;
+    m_Tail = 0;
+    m_TotalAllocated = 0;
+    m_TotalRetired = 0;
+    m_PeakUsedSize = 0;
+    m_FrameMarkers.clear();
+}
+
+uint64_t RingAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+    check(size > 0);
+    check(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    if (size > m_Capacity)
+    {
+        return kInvalidOffset;
+    }
+
+    // nothing in use, restart at the beginning to keep big allocations possible
+    if (GetUsedSize() == 0)
+    {
+        m_Head = 0;
+        m_Tail = 0;
+    }
+
+    const uint64_t alignedHead = AlignUp(m_Head, alignment);
+    const uint64_t freeSize = m_Capacity - GetUsedSize();
+
+    uint64_t offset = kInvalidOffset;
+    uint64_t consumedSize = 0;
+
+    if ((m_Head >= m_Tail) && (GetUsedSize() < m_Capacity))
+    {
+        // free memory: [head, capacity) & [0, tail)
+        if (alignedHead + size <= m_Capacity)
+        {
+            offset = alignedHead;
+            consumedSize = alignedHead + size - m_Head;
+        }
+        else if (size <= m_Tail)
+        {
+            // wrap around. The end of the ring is wasted until this frame retires
+            offset = 0;
+            consumedSize = (m_Capacity - m_Head) + size;
+        }
+    }
+    else if (alignedHead + size <= m_Tail)
+    {
+        // free memory: [head, tail)
+        offset = alignedHead;
+        consumedSize = alignedHead + size - m_Head;
+    }
+
+    if (offset == kInvalidOffset || consumedSize > freeSize)
+    {
+        return kInvalidOffset;
+    }
+
+    m_Head = offset + size;
+    m_TotalAllocated += consumedSize;
+    m_PeakUsedSize = std::max(m_PeakUsedSize, GetUsedSize());
+
+    return offset;
+}
+
+void RingAllocator::FinishFrame(uint64_t frameIdx)
+{
+    check(m_FrameMarkers.empty() || m_FrameMarkers.back().m_FrameIdx < frameIdx);
+
+    m_FrameMarkers.push_back(FrameMarker{ frameIdx, m_Head, m_TotalAllocated });
+}
+
+void RingAllocator::RetireFrames(uint64_t numRetiredFrames)
+{
+    while (!m_FrameMarkers.empty() && (m_FrameMarkers.front().m_FrameIdx < numRetiredFrames))
+    {
+        const FrameMarker& frameMarker = m_FrameMarkers.front();
+
+        m_Tail = frameMarker.m_Head;
+        m_TotalRetired = frameMarker.m_TotalAllocated;
+
+        m_FrameMarkers.pop_front();
+    }
+
+    check(m_TotalRetired <= m_TotalAllocated);
+}
+
+static void RunRingAllocatorSelfTest()
+{
+    PROFILE_FUNCTION();
+
+    // alignment
+    {
+        RingAllocator ring;
+        ring.Initialize(KB_TO_BYTES(1));
+
+        test_verify(ring.Allocate(4, 4) == 0);
+        test_verify(ring.Allocate(4, 256) == 256);
+        test_verify(ring.Allocate(1, 1) == 260);
+        test_verify(ring.Allocate(16, 16) == 272);
+        test_verify(ring.GetUsedSize() == 288);
+    }
+
+    // overflow
+    {
+        RingAllocator ring;
+        ring.Initialize(KB_TO_BYTES(1));
+
+        test_verify(ring.Allocate(KB_TO_BYTES(2), 4) == RingAllocator::kInvalidOffset);
+        test_verify(ring.Allocate(768, 256) == 0);
+        test_verify(ring.Allocate(512, 256) == RingAllocator::kInvalidOffset); // no room at the end & nothing retired to wrap into
+        test_verify(ring.Allocate(256, 256) == 768);
+        test_verify(ring.GetUsedSize() == ring.GetCapacity());
+        test_verify(ring.Allocate(1, 1) == RingAllocator::kInvalidOffset);
+    }
+
+    // wraparound & retirement
+    {
+        RingAllocator ring;
+        ring.Initialize(KB_TO_BYTES(1));
+
+        test_verify(ring.Allocate(512, 256) == 0);
+        ring.FinishFrame(0);
+
+        test_verify(ring.Allocate(256, 256) == 512);
+        ring.FinishFrame(1);
+
+        // frame 0 still in flight: end of the ring is too small & the start is still in use
+        test_verify(ring.Allocate(512, 256) == RingAllocator::kInvalidOffset);
+
+        ring.RetireFrames(1);
+        test_verify(ring.GetUsedSize() == 256);
+
+        // 256 bytes at the end are skipped, wraps to the start
+        test_verify(ring.Allocate(512, 256) == 0);
+        test_verify(ring.GetUsedSize() == KB_TO_BYTES(1));
+        test_verify(ring.Allocate(1, 1) == RingAllocator::kInvalidOffset);
+        ring.FinishFrame(2);
+
+        // frame 1 retires: [512, 768) is free again, between the wrapped head & the tail
+        ring.RetireFrames(2);
+        test_verify(ring.GetUsedSize() == 768);
+        test_verify(ring.Allocate(256, 256) == 512);
+        test_verify(ring.Allocate(1, 1) == RingAllocator::kInvalidOffset);
+        ring.FinishFrame(3);
+
+        ring.RetireFrames(4);
+        test_verify(ring.GetUsedSize() == 0);
+        test_verify(ring.Allocate(KB_TO_BYTES(1), 256) == 0); // empty ring restarts at 0
+    }
+}
+REGISTER_HEADLESS_RUN("ringallocatorselftest", HeadlessRunType::SelfTest, RunRingAllocatorSelfTest);
@@ -0,0 +1,44 @@
+#pragma once
+
+// Offset-only ring allocator for memory that is written by the CPU & read by the GPU for the duration of a frame
+// Allocations are linear & wrap around to the start of the ring. Memory is recycled in bulk when the frame it was allocated in retires
+// CPU only, no device calls. Not thread safe
+class RingAllocator
+{
+public:
+    static constexpr uint64_t kInvalidOffset = UINT64_MAX;
+
+    void Initialize(uint64_t capacity);
+
+    // returns 'kInvalidOffset' if the ring is full
+    [[nodiscard]] uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+    // everything allocated so far belongs to 'frameIdx'
+    void FinishFrame(uint64_t frameIdx);
+
+    // recycles the memory of all finished frames before 'numRetiredFrames'
+    void RetireFrames(uint64_t numRetiredFrames);
+
+    uint64_t GetCapacity() const { return m_Capacity; }
+    uint64_t GetUsedSize() const { return m_TotalAllocated - m_TotalRetired; }
+    uint64_t GetPeakUsedSize() const { return m_PeakUsedSize; }
+
+private:
+    struct FrameMarker
+    {
+        uint64_t m_FrameIdx;
+        uint64_t m_Head;
+        uint64_t m_TotalAllocated;
+    };
+
+    uint64_t m_Capacity = 0;
+    uint64_t m_Head = 0; // next free byte
+    uint64_t m_Tail = 0; // oldest byte in use
+
+    // monotonic byte counters, including padding & bytes skipped when wrapping around
+    uint64_t m_TotalAllocated = 0;
+    uint64_t m_TotalRetired = 0;
+    uint64_t m_PeakUsedSize = 0;
+
+    std::deque<FrameMarker> m_FrameMarkers;
+};
@@ -164,7 +164,7 @@ void Scene::Initialize()
     m_View.Update();
 
     m_RenderGraph = std::make_shared<RenderGraph>();
-    m_RenderGraph->Initialize();
+    m_RenderGraph->Initialize(g_Graphic.GetRenderGraphBackend());
 
     UpdateDirectionalLightVector();
 }
@@ -609,6 +609,12 @@ void Scene::UpdateIMGUI()
         ImGui::TreePop();
     }
 
+    if (ImGui::TreeNode("Render Graph"))
+    {
+        m_RenderGraph->UpdateIMGUI();
+        ImGui::TreePop();
+    }
+
     for (IRenderer* renderer : IRenderer::ms_AllRenderers)
     {
         if (!renderer->HasImguiControls())
@@ -9,6 +9,7 @@
 #include "DescriptorTableManager.h"
 #include "Graphic.h"
 #include "Scene.h"
+#include "TextureFeedbackManager.h"
 #include "Utilities.h"
 #include "Visual.h"
 
@@ -56,7 +57,7 @@ struct GLTFSceneLoader
 
     struct CachedData
     {
-        static const uint32_t kCurrentVersion = 3; // increment this if the cached mesh data format changes
+        static const uint32_t kCurrentVersion = 4; // increment this if the cached mesh data format changes
 
         struct Header
         {
@@ -75,6 +76,7 @@ struct GLTFSceneLoader
             uint32_t m_NumIndices = 0;
             uint32_t m_NumVertices = 0;
             AABB m_AABB = { Vector3::Zero, Vector3::Zero };
+            float m_LODUVDensities[kMaxNumMeshLODs] = {};
         };
     };
 
@@ -483,6 +485,50 @@ struct GLTFSceneLoader
 
             sceneMaterial.m_MaterialDataBufferIdx = i;
 
+			SDL_Log("New Material: [%s]", materialName);
+        }
+
+        // albedo, normal & ORM are sampled with the same UVs (only the first UV set is read): the sampler feedback of one can drive the residency of all 3
+        std::vector<TextureFeedbackSet> textureFeedbackSets;
+        for (const Material& sceneMaterial : m_SceneMaterials)
+        {
+            const Material::TextureView* textureViews[] = { &sceneMaterial.m_Albedo, &sceneMaterial.m_Normal, &sceneMaterial.m_MetallicRoughness };
+
+            TextureFeedbackSet feedbackSet;
+            const Material::TextureView* firstTextureView = nullptr;
+            for (uint32_t j = 0; j < std::size(textureViews); ++j)
+            {
+                const Material::TextureView& textureView = *textureViews[j];
+                if (!textureView.IsValid() || g_Graphic.m_Textures.at(textureView.m_TextureIdx).m_TiledTextureID == UINT_MAX)
+                {
+                    continue; // no texture, or not streamed
+                }
+
+                // UVs outside [0, 1] land on different texels with different address modes
+                if (firstTextureView && firstTextureView->m_AddressMode != textureView.m_AddressMode)
+                {
+                    continue;
+                }
+
+                firstTextureView = firstTextureView ? firstTextureView : &textureView;
+                feedbackSet.m_TextureIndices[j] = textureView.m_TextureIdx;
+            }
+
+            textureFeedbackSets.push_back(feedbackSet);
+
+            // emissive is sampled on its own: as the primary of its own set, it keeps its feedback wherever else it's used
+            if (sceneMaterial.m_Emissive.IsValid())
+            {
+                TextureFeedbackSet& emissiveFeedbackSet = textureFeedbackSets.emplace_back();
+                emissiveFeedbackSet.m_TextureIndices[0] = sceneMaterial.m_Emissive.m_TextureIdx;
+            }
+        }
+        g_TextureFeedbackManager->InitializeFeedbackSets(textureFeedbackSets);
+
+        for (uint32_t i = 0; i < m_GLTFData->materials_count; ++i)
+        {
+            const Material& sceneMaterial = m_SceneMaterials[i];
+
             auto SetTextureData = [this](TextureData& textureData, const Material::TextureView& sceneTextureView)
             {
                 textureData.m_GlobalIndex = UINT32_MAX;
@@ -506,7 +552,11 @@ struct GLTFSceneLoader
                     check(tex.m_SamplerFeedbackTextureHandle);
                     check(tex.m_MinMipTextureHandle);
 
-                    textureData.m_FeedbackTextureDescriptorIndex = g_Graphic.GetIndexInHeap(tex.m_SamplerFeedbackIndexInTable);
+                    // followers don't write feedback, their primary's feedback is used instead. See 'TextureFeedbackManager::InitializeFeedbackSets'
+                    if (tex.m_FeedbackPrimaryTextureIdx == UINT_MAX)
+                    {
+                        textureData.m_FeedbackTextureDescriptorIndex = g_Graphic.GetIndexInHeap(tex.m_SamplerFeedbackIndexInTable);
+                    }
                     textureData.m_MinMapTextureDescriptorIndex = g_Graphic.GetIndexInHeap(tex.m_MinMipIndexInTable);
                 }
 
@@ -524,8 +574,6 @@ struct GLTFSceneLoader
             materialData.m_ConstRoughness = sceneMaterial.m_ConstRoughness;
             materialData.m_ConstMetallic = sceneMaterial.m_ConstMetallic;
             materialData.m_AlphaCutoff = sceneMaterial.m_AlphaCutoff;
-
-			SDL_Log("New Material: [%s]", materialName);
         }
 
         MaterialData defaultMaterialData{};
@@ -770,6 +818,7 @@ struct GLTFSceneLoader
                 meshLOD.m_MeshletDataBufferIdx = meshLODData.m_MeshletDataBufferIdx;
                 meshLOD.m_NumMeshlets = meshLODData.m_NumMeshlets;
                 meshLOD.m_Error = meshLODData.m_Error;
+                meshLOD.m_UVDensity = meshSpecificDataArray[i].m_LODUVDensities[meshLODIdx];
             }
 
             mesh.m_NumLODs = m_GlobalMeshData[i].m_NumLODs;
@@ -1124,6 +1173,11 @@ struct GLTFSceneLoader
             meshSpecificData.m_NumIndices = mesh.m_NumIndices;
             meshSpecificData.m_NumVertices = mesh.m_NumVertices;
             meshSpecificData.m_AABB = mesh.m_AABB;
+
+            for (uint32_t meshLODIdx = 0; meshLODIdx < mesh.m_NumLODs; ++meshLODIdx)
+            {
+                meshSpecificData.m_LODUVDensities[meshLODIdx] = mesh.m_LODs[meshLODIdx].m_UVDensity;
+            }
         }
 
         fwrite(meshSpecificDataArray.data(), sizeof(CachedData::MeshSpecificData), meshSpecificDataArray.size(), cachedDataFile);
@@ -0,0 +1,41 @@
+#pragma once
+
+// Hashed shader name, i.e. "<bin file name>[ <sorted permutation defines>]" as listed by 'Graphic::InitShaders'
+// Built from a string literal, the hash is folded at compile time ('consteval'), so per-pass shader lookups never touch strings
+// Names only known at runtime (e.g. permutations picked with 'StringFormat') go through the explicit constructor, which computes the same hash
+// Structural type: usable as a non-type template parameter
+struct ShaderID
+{
+    static constexpr uint64_t kFNVOffsetBasis = 0xcbf29ce484222325ull;
+    static constexpr uint64_t kFNVPrime = 0x100000001b3ull;
+
+    // 64-bit FNV-1a
+    static constexpr uint64_t Hash(std::string_view name)
+    {
+        uint64_t hash = kFNVOffsetBasis;
+        for (char c : name)
+        {
+            hash ^= (uint8_t)c;
+            hash *= kFNVPrime;
+        }
+        return hash;
+    }
+
+    constexpr ShaderID() = default;
+    explicit constexpr ShaderID(std::string_view name) : m_Hash(Hash(name)) {}
+
+    template <size_t N>
+    consteval ShaderID(const char (&name)[N]) : m_Hash(Hash({ name, N - 1 })) {}
+
+    constexpr bool IsValid() const { return m_Hash != 0; }
+    constexpr bool operator==(const ShaderID&) const = default;
+
+    uint64_t m_Hash = 0;
+};
+
+template <>
+struct std::hash<ShaderID>
+{
+    // already a well distributed 64-bit hash
+    size_t operator()(ShaderID shaderID) const { return (size_t)shaderID.m_Hash; }
+};
@@ -0,0 +1,137 @@
+#include "Engine.h"
+#include "HeadlessRuns.h"
+#include "ShaderID.h"
+#include "Utilities.h"
+
+// shaders looked up by 'AddFullScreenPass' & 'AddComputePass' in a typical frame, in submission order
+static constexpr const char* kFramePassShaderNames[] =
+{
+    "updateinstanceconsts_CS_UpdateInstanceConstsAndBuildTLAS",
+    "gpuculling_CS_GPUCulling LATE_CULL=0",
+    "gpuculling_CS_BuildLateCullIndirectArgs",
+    "basepass_AS_Main LATE_CULL=0",
+    "basepass_MS_Main",
+    "minmaxdownsample_CS_Main",
+    "ffx_spd_downsample_pass_CS FFX_SPD_OPTION_DOWNSAMPLE_FILTER=1",
+    "gpuculling_CS_GPUCulling LATE_CULL=1",
+    "basepass_AS_Main LATE_CULL=1",
+    "basepass_MS_Main",
+    "fullscreen_MS_FullScreenTriangle",
+    "sky_PS_HosekWilkieSky",
+    "shadowmask_CS_ShadowMask",
+    "shadowmask_CS_PackNormalAndRoughness",
+    "SIGMA_Shadow_Classify.cs",
+    "SIGMA_Shadow_SmoothTiles.cs",
+    "SIGMA_Shadow_Blur.cs",
+    "SIGMA_Shadow_PostBlur.cs",
+    "SIGMA_Shadow_TemporalStabilization.cs",
+    "ambientocclusion_CS_XeGTAO_PrefilterDepths",
+    "ambientocclusion_CS_XeGTAO_MainPass DEBUG_OUTPUT_MODE=0",
+    "ambientocclusion_CS_XeGTAO_Denoise",
+    "giprobetrace_CS_ProbeTrace",
+    "ProbeBlendingCS_DDGIProbeBlendingCS RTXGI_DDGI_BLEND_RADIANCE=1",
+    "ProbeBlendingCS_DDGIProbeBlendingCS RTXGI_DDGI_BLEND_RADIANCE=0",
+    "ProbeRelocationCS_DDGIProbeRelocationCS",
+    "ProbeClassificationCS_DDGIProbeClassificationCS",
+    "ReductionCS_DDGIReductionCS REDUCTION=1",
+    "ReductionCS_DDGIExtraReductionCS",
+    "restirshading_CS_Main",
+    "fullscreen_MS_FullScreenTriangle",
+    "deferredlighting_PS_Main",
+    "fullscreen_MS_FullScreenTriangle",
+    "bloom_PS_Downsample",
+    "bloom_PS_Downsample",
+    "bloom_PS_Downsample",
+    "bloom_PS_Downsample",
+    "fullscreen_MS_FullScreenTriangle",
+    "bloom_PS_Upsample",
+    "bloom_PS_Upsample",
+    "bloom_PS_Upsample",
+    "adaptluminance_CS_GenerateLuminanceHistogram",
+    "adaptluminance_CS_AdaptExposure",
+    "fullscreen_MS_FullScreenTriangle",
+    "postprocess_PS_PostProcess",
+    "imgui_VS_Main",
+    "imgui_PS_Main",
+};
+
+CommandLineOption<int> g_ShaderIDBenchmarkFrames{ "shaderidbenchmarkframes", 1000 };
+
+// Per-pass shader lookup cost over a frame's worth of passes: runtime string hashing (the old path) vs precomputed 'ShaderID's
+static void RunShaderIDBenchmark(uint32_t numFrames)
+{
+    PROFILE_FUNCTION();
+
+    // roughly the # of shader permutations in 'shaderstocompile.txt'
+    const uint32_t kNumShaders = 256;
+
+    std::vector<std::string> allShaderNames{ std::begin(kFramePassShaderNames), std::end(kFramePassShaderNames) };
+    for (uint32_t i = 0; allShaderNames.size() < kNumShaders; ++i)
+    {
+        allShaderNames.push_back(StringFormat("filler_CS_Main PERMUTATION=%u", i));
+    }
+
+    // stand-in for the shader handles, so that the lookups can't be optimized away
+    uint64_t checksum = 0;
+
+    // old path: pass params held the name as a 'std::string', hashed once by 'GetShader' & once more by the GPU profiler scope
+    {
+        std::unordered_map<size_t, uint64_t> shadersByNameHash;
+        for (const std::string& shaderName : allShaderNames)
+        {
+            shadersByNameHash[std::hash<std::string_view>{}(shaderName)] = shadersByNameHash.size();
+        }
+
+        Timer timer;
+        for (uint32_t frame = 0; frame < numFrames; ++frame)
+        {
+            for (const char* passShaderName : kFramePassShaderNames)
+            {
+                const std::string shaderName = passShaderName;
+                checksum += std::hash<std::string_view>{}(shaderName);
+                checksum += shadersByNameHash.at(std::hash<std::string_view>{}(shaderName));
+            }
+        }
+        const float elapsedMs = timer.GetElapsedMilliseconds();
+
+        SDL_Log("Shader ID Benchmark [string hashing]: %u frames of %u passes, %.2f ms, %.1f ns per pass",
+            numFrames, (uint32_t)std::size(kFramePassShaderNames), elapsedMs, (elapsedMs * 1e6) / (numFrames * std::size(kFramePassShaderNames)));
+    }
+
+    // new path: integer lookups only. The IDs are precomputed here, as they are folded at compile time at the call sites
+    {
+        std::unordered_map<ShaderID, uint64_t> shadersByID;
+        for (const std::string& shaderName : allShaderNames)
+        {
+            shadersByID[ShaderID{ shaderName }] = shadersByID.size();
+        }
+
+        std::vector<ShaderID> framePassShaderIDs;
+        for (const char* passShaderName : kFramePassShaderNames)
+        {
+            framePassShaderIDs.push_back(ShaderID{ passShaderName });
+        }
+
+        // IDs built from literals at compile time & from runtime strings must match
+        static_assert(ShaderID{ "basepass_MS_Main" }.m_Hash == ShaderID::Hash("basepass_MS_Main"));
+        test_verify(shadersByID.contains("basepass_MS_Main"));
+        test_verify(shadersByID.size() == std::unordered_set<std::string>(allShaderNames.begin(), allShaderNames.end()).size());
+
+        Timer timer;
+        for (uint32_t frame = 0; frame < numFrames; ++frame)
+        {
+            for (ShaderID shaderID : framePassShaderIDs)
+            {
+                checksum += shaderID.m_Hash;
+                checksum += shadersByID.at(shaderID);
+            }
+        }
+        const float elapsedMs = timer.GetElapsedMilliseconds();
+
+        SDL_Log("Shader ID Benchmark [ShaderID]: %u frames of %u passes, %.2f ms, %.1f ns per pass",
+            numFrames, (uint32_t)std::size(kFramePassShaderNames), elapsedMs, (elapsedMs * 1e6) / (numFrames * std::size(kFramePassShaderNames)));
+    }
+
+    SDL_Log("Shader ID Benchmark checksum: %llu", (unsigned long long)checksum);
+}
+REGISTER_HEADLESS_RUN("shaderidbenchmark", HeadlessRunType::Benchmark, [] { RunShaderIDBenchmark(g_ShaderIDBenchmarkFrames.Get()); });
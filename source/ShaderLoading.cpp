@@ -0,0 +1,299 @@
+#include "ShaderLoading.h"
+
+#include "extern/cxxopts/include/cxxopts.hpp"
+#include "extern/shadermake/ShaderMake/ShaderBlob.h"
+
+#include "Engine.h"
+#include "HeadlessRuns.h"
+#include "Utilities.h"
+
+std::vector<ShaderListEntry> ParseShaderList(std::string_view shaderListText, std::string_view binDirectory)
+{
+    PROFILE_FUNCTION();
+
+    std::vector<ShaderListEntry> entries;
+
+    std::stringstream stringStream{ std::string{ shaderListText } };
+    std::string shaderEntryLine;
+    while (std::getline(stringStream, shaderEntryLine))
+    {
+        if (shaderEntryLine.empty())
+        {
+            continue;
+        }
+
+        // Tokenize for argparse to read
+        std::vector<const char*> configLineTokens;
+        TokenizeLine((char*)shaderEntryLine.c_str(), configLineTokens);
+
+        // use cxxopts lib to conveniently retrieve shader type & entry point, so we can reconstruct bin file name
+        cxxopts::Options options{ "Shader Line Parser", "" };
+        options.allow_unrecognised_options();
+        options.add_options()
+            ("T", "profile", cxxopts::value<std::string>())
+            ("E", "entryPoint", cxxopts::value<std::string>());
+
+        const cxxopts::ParseResult parseResult = options.parse(configLineTokens.size(), configLineTokens.data());
+
+        ShaderListEntry& entry = entries.emplace_back();
+        entry.m_EntryPoint = parseResult["E"].as<std::string>();
+
+        // kinda manual... but it's robust enough
+        std::string profileStr = parseResult["T"].as<std::string>();
+        StringUtils::ToLower(profileStr);
+        if (profileStr == "vs")
+            entry.m_ShaderType = nvrhi::ShaderType::Vertex;
+        else if (profileStr == "ps")
+            entry.m_ShaderType = nvrhi::ShaderType::Pixel;
+        else if (profileStr == "cs")
+            entry.m_ShaderType = nvrhi::ShaderType::Compute;
+        else if (profileStr == "ms")
+            entry.m_ShaderType = nvrhi::ShaderType::Mesh;
+        else if (profileStr == "as")
+            entry.m_ShaderType = nvrhi::ShaderType::Amplification;
+
+        // NOTE: for raytracing, only support inline ray query, so dont have to parse weird shader file extensions
+
+        check(entry.m_ShaderType != nvrhi::ShaderType::None);
+
+        // reconstruct bin file name
+        // NOTE: after tokenization the line string is the 1st token of the line, which is the file name
+        // if the entry point is 'main', it won't be appended to the bin file name. Thanks ShaderMake. That's retarded.
+        const std::string fileStem = std::filesystem::path{ shaderEntryLine }.stem().string();
+        entry.m_BinFileName = (entry.m_EntryPoint == "main") ? fileStem : fileStem + "_" + entry.m_EntryPoint;
+        entry.m_BinFilePath = (std::filesystem::path{ binDirectory } / (entry.m_BinFileName + ".bin")).string();
+    }
+
+    return entries;
+}
+
+static void LoadShaderBinary(const ShaderListEntry& entry, std::vector<ShaderBinary>& outBinaries)
+{
+    PROFILE_SCOPED("Load Shader Binary");
+
+    std::shared_ptr<std::vector<std::byte>> fileData = std::make_shared<std::vector<std::byte>>();
+    {
+        PROFILE_SCOPED("Read Shader bin");
+        ReadDataFromFile(entry.m_BinFilePath, *fileData);
+    }
+    check(!fileData->empty());
+
+    auto AddBinary = [&](const void* pBinary, size_t binarySize, std::string_view shaderDebugName)
+        {
+            ShaderBinary& binary = outBinaries.emplace_back();
+            binary.m_DebugName = shaderDebugName;
+            binary.m_EntryPoint = entry.m_EntryPoint;
+            binary.m_ShaderType = entry.m_ShaderType;
+            binary.m_ShaderID = ShaderID{ shaderDebugName };
+            binary.m_BinaryHash = HashRange((std::byte*)pBinary, binarySize);
+            binary.m_FileData = fileData;
+            binary.m_Binary = std::span{ (const std::byte*)pBinary, binarySize };
+        };
+
+    std::vector<std::string> permutationDefines;
+    ShaderMake::EnumeratePermutationsInBlob(fileData->data(), fileData->size(), permutationDefines);
+
+    // no permutations
+    if (permutationDefines.empty())
+    {
+        AddBinary(fileData->data(), fileData->size(), entry.m_BinFileName);
+        return;
+    }
+
+    // permutations. enumerate through all
+    const uint32_t kNbMaxConstants = 8;
+
+    // 'enumeratePermutationsInBlob' will return an array of strings of all combinations of permutation defines
+    // assume each instance of '=' character represents a Shader #define
+    const int64_t nbConstants = std::count(permutationDefines[0].begin(), permutationDefines[0].end(), '=');
+    check(nbConstants <= kNbMaxConstants);
+
+    for (std::string permutationDefine : permutationDefines) // NOTE: deliberately not by const ref
+    {
+        // for debug name purposes
+        const std::string definesStringCopy = permutationDefine;
+
+        ShaderMake::ShaderConstant shaderConstants[kNbMaxConstants]{};
+
+        std::vector<const char*> constantAndValueStrings;
+        TokenizeLine((char*)permutationDefine.c_str(), constantAndValueStrings);
+
+        uint32_t i = 0;
+        for (const char* constantAndValueString : constantAndValueStrings)
+        {
+            ShaderMake::ShaderConstant& shaderConstant = shaderConstants[i++];
+
+            char* nextToken = nullptr;
+            shaderConstant.name = strtok_s((char*)constantAndValueString, "=", &nextToken);
+            shaderConstant.value = strtok_s(nullptr, "=", &nextToken);
+        }
+
+        const void* pBinary = nullptr;
+        size_t binarySize = 0;
+        if (!ShaderMake::FindPermutationInBlob(fileData->data(), fileData->size(), shaderConstants, (uint32_t)nbConstants, &pBinary, &binarySize))
+        {
+            SDL_Log("%s", ShaderMake::FormatShaderNotFoundMessage(fileData->data(), fileData->size(), shaderConstants, (uint32_t)nbConstants).c_str());
+            check(false);
+        }
+
+        AddBinary(pBinary, binarySize, StringFormat("%s %s", entry.m_BinFileName.c_str(), definesStringCopy.c_str()));
+    }
+}
+
+std::vector<ShaderBinary> LoadShaderBinaries(std::span<const ShaderListEntry> entries, tf::Executor& executor)
+{
+    PROFILE_FUNCTION();
+
+    std::vector<std::vector<ShaderBinary>> binariesPerEntry;
+    binariesPerEntry.resize(entries.size());
+
+    tf::Taskflow tf;
+    tf.for_each_index(0u, (uint32_t)entries.size(), 1u, [&](uint32_t i) { LoadShaderBinary(entries[i], binariesPerEntry[i]); });
+    executor.corun(tf);
+
+    // flatten, in the order of the shader list
+    std::vector<ShaderBinary> binaries;
+    for (std::vector<ShaderBinary>& entryBinaries : binariesPerEntry)
+    {
+        binaries.insert(binaries.end(), std::make_move_iterator(entryBinaries.begin()), std::make_move_iterator(entryBinaries.end()));
+    }
+
+    return binaries;
+}
+
+ShaderDiff DiffShaderBinaries(std::span<const ShaderBinary> binaries, const std::unordered_map<ShaderID, size_t>& loadedBinaryHashes)
+{
+    ShaderDiff diff;
+
+    std::unordered_set<ShaderID> shaderIDs;
+    for (uint32_t i = 0; i < binaries.size(); ++i)
+    {
+        const ShaderBinary& binary = binaries[i];
+        shaderIDs.insert(binary.m_ShaderID);
+
+        auto it = loadedBinaryHashes.find(binary.m_ShaderID);
+        if ((it == loadedBinaryHashes.end()) || (it->second != binary.m_BinaryHash))
+        {
+            diff.m_NewOrChanged.push_back(i);
+        }
+        else
+        {
+            ++diff.m_NumUnchanged;
+        }
+    }
+
+    for (const auto& [shaderID, binaryHash] : loadedBinaryHashes)
+    {
+        if (!shaderIDs.contains(shaderID))
+        {
+            diff.m_Removed.push_back(shaderID);
+        }
+    }
+
+    return diff;
+}
+
+static void RunShaderLoadingSelfTest()
+{
+    PROFILE_FUNCTION();
+
+    const std::filesystem::path binDirectory = std::filesystem::path{ GetExecutableDirectory() } / "ShaderLoadingSelfTest";
+    std::filesystem::create_directories(binDirectory);
+
+    // raw blobs w/o ShaderMake permutation headers, like single-permutation shaders
+    auto WriteFakeBlob = [&](const char* binFileName, uint8_t seed)
+        {
+            std::vector<uint8_t> blob(256);
+            for (uint32_t i = 0; i < blob.size(); ++i)
+            {
+                blob[i] = (uint8_t)(seed + i * 31);
+            }
+
+            ScopedFile file{ (binDirectory / binFileName).string(), "wb" };
+            fwrite(blob.data(), 1, blob.size(), file);
+        };
+
+    WriteFakeBlob("gbuffer.bin", 1);
+    WriteFakeBlob("tonemap_PS_Main.bin", 2);
+    WriteFakeBlob("fullscreen.bin", 3);
+
+    tf::Executor executor{ 4 };
+
+    auto ParseAndLoad = [&](std::string_view shaderListText)
+        {
+            const std::vector<ShaderListEntry> entries = ParseShaderList(shaderListText, binDirectory.string());
+
+            std::vector<ShaderBinary> binaries;
+            executor.async([&] { binaries = LoadShaderBinaries(entries, executor); }).wait();
+            return binaries;
+        };
+
+    // parsing
+    {
+        const std::vector<ShaderListEntry> entries = ParseShaderList("shaders/gbuffer.hlsl -T cs -E main\n\nshaders/tonemap.hlsl -T ps -E PS_Main -D FOO=1\n", binDirectory.string());
+        test_verify(entries.size() == 2);
+        test_verify(entries[0].m_BinFileName == "gbuffer");
+        test_verify(entries[0].m_EntryPoint == "main");
+        test_verify(entries[0].m_ShaderType == nvrhi::ShaderType::Compute);
+        test_verify(entries[1].m_BinFileName == "tonemap_PS_Main");
+        test_verify(entries[1].m_EntryPoint == "PS_Main");
+        test_verify(entries[1].m_ShaderType == nvrhi::ShaderType::Pixel);
+        test_verify(std::filesystem::path{ entries[1].m_BinFilePath }.filename() == "tonemap_PS_Main.bin");
+    }
+
+    const char* kShaderList = "shaders/gbuffer.hlsl -T cs -E main\nshaders/tonemap.hlsl -T ps -E PS_Main\nshaders/fullscreen.hlsl -T vs -E main\n";
+
+    std::unordered_map<ShaderID, size_t> loadedBinaryHashes;
+    auto ApplyLoad = [&](std::span<const ShaderBinary> binaries, const ShaderDiff& diff)
+        {
+            for (uint32_t i : diff.m_NewOrChanged)
+            {
+                loadedBinaryHashes[binaries[i].m_ShaderID] = binaries[i].m_BinaryHash;
+            }
+            for (ShaderID shaderID : diff.m_Removed)
+            {
+                loadedBinaryHashes.erase(shaderID);
+            }
+        };
+
+    // 1st load: everything is new, in list order
+    {
+        const std::vector<ShaderBinary> binaries = ParseAndLoad(kShaderList);
+        test_verify(binaries.size() == 3);
+        test_verify(binaries[0].m_DebugName == "gbuffer");
+        test_verify(binaries[1].m_DebugName == "tonemap_PS_Main");
+        test_verify(binaries[2].m_DebugName == "fullscreen");
+        test_verify(binaries[0].m_Binary.size() == 256);
+        test_verify(binaries[1].m_ShaderID == ShaderID{ "tonemap_PS_Main" });
+
+        const ShaderDiff diff = DiffShaderBinaries(binaries, loadedBinaryHashes);
+        test_verify(diff.m_NewOrChanged.size() == 3);
+        test_verify(diff.m_Removed.empty());
+        ApplyLoad(binaries, diff);
+    }
+
+    // reload w/o changes
+    {
+        const std::vector<ShaderBinary> binaries = ParseAndLoad(kShaderList);
+        const ShaderDiff diff = DiffShaderBinaries(binaries, loadedBinaryHashes);
+        test_verify(diff.m_NewOrChanged.empty());
+        test_verify(diff.m_Removed.empty());
+        test_verify(diff.m_NumUnchanged == 3);
+    }
+
+    // 1 shader recompiled, 1 removed from the list
+    {
+        WriteFakeBlob("tonemap_PS_Main.bin", 42);
+
+        const std::vector<ShaderBinary> binaries = ParseAndLoad("shaders/gbuffer.hlsl -T cs -E main\nshaders/tonemap.hlsl -T ps -E PS_Main\n");
+        const ShaderDiff diff = DiffShaderBinaries(binaries, loadedBinaryHashes);
+        test_verify(diff.m_NewOrChanged.size() == 1);
+        test_verify(binaries[diff.m_NewOrChanged[0]].m_DebugName == "tonemap_PS_Main");
+        test_verify(diff.m_Removed.size() == 1);
+        test_verify(diff.m_Removed[0] == ShaderID{ "fullscreen" });
+        test_verify(diff.m_NumUnchanged == 1);
+    }
+
+    std::filesystem::remove_all(binDirectory);
+}
+REGISTER_HEADLESS_RUN("shaderloadingselftest", HeadlessRunType::SelfTest, RunShaderLoadingSelfTest);
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "extern/nvrhi/include/nvrhi/nvrhi.h"
+
+#include "ShaderID.h"
+
+namespace tf { class Executor; }
+
+// Device-free half of shader loading: parses the shader list, reads & hashes the shader binaries & their permutations, and diffs them against what is already loaded
+// 'Graphic::InitShaders' only creates the nvrhi shaders of what the diff reports as new or changed
+
+// 1 line of 'shaderstocompile.txt'
+struct ShaderListEntry
+{
+    std::string m_BinFilePath;
+    std::string m_BinFileName; // w/o extension
+    std::string m_EntryPoint;
+    nvrhi::ShaderType m_ShaderType = nvrhi::ShaderType::None;
+};
+
+// 1 permutation of a shader binary
+struct ShaderBinary
+{
+    std::string m_DebugName;
+    std::string m_EntryPoint;
+    nvrhi::ShaderType m_ShaderType = nvrhi::ShaderType::None;
+    ShaderID m_ShaderID; // of 'm_DebugName', computed once here so that lookups at runtime are integer only
+    size_t m_BinaryHash = 0;
+
+    // points into the .bin file data, which is shared by all permutations of the file
+    std::shared_ptr<const std::vector<std::byte>> m_FileData;
+    std::span<const std::byte> m_Binary;
+};
+
+struct ShaderDiff
+{
+    std::vector<uint32_t> m_NewOrChanged; // indices into the loaded binaries
+    std::vector<ShaderID> m_Removed;
+    uint32_t m_NumUnchanged = 0;
+};
+
+// 'binDirectory' is where ShaderMake outputs the .bin files
+std::vector<ShaderListEntry> ParseShaderList(std::string_view shaderListText, std::string_view binDirectory);
+
+// reads all .bin files & enumerates their permutations in parallel. Must be called from a worker of 'executor'
+std::vector<ShaderBinary> LoadShaderBinaries(std::span<const ShaderListEntry> entries, tf::Executor& executor);
+
+// 'loadedBinaryHashes': binary hashes of the shaders that are currently loaded
+ShaderDiff DiffShaderBinaries(std::span<const ShaderBinary> binaries, const std::unordered_map<ShaderID, size_t>& loadedBinaryHashes);
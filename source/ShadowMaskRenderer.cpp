@@ -81,6 +81,7 @@ class ShadowMaskRenderer : public IRenderer
     std::vector<nvrhi::TextureDesc> m_NRDTemporaryTextureDescs;
     std::vector<nvrhi::TextureHandle> m_NRDPermanentTextures;
     std::vector<RenderGraph::ResourceHandle> m_NRDTemporaryTextureHandles;
+    std::vector<ShaderID> m_NRDPipelineShaderIDs;
     RenderGraph::ResourceHandle m_ShadowPenumbraRDGTextureHandle;
     RenderGraph::ResourceHandle m_NormalRoughnessRDGTextureHandle;
 
@@ -117,6 +118,12 @@ public:
 
         const nrd::InstanceDesc* instanceDesc = nrd::GetInstanceDesc(*m_NRDInstance);
 
+        // NRD pipelines are fixed once the instance is created, so their shader names are only parsed & hashed here
+        for (uint32_t i = 0; i < instanceDesc->pipelinesNum; ++i)
+        {
+            m_NRDPipelineShaderIDs.push_back(GetNRDShaderID(instanceDesc->pipelines[i].shaderIdentifier));
+        }
+
         const nvrhi::BufferDesc constantBufferDesc = nvrhi::utils::CreateVolatileConstantBufferDesc(instanceDesc->constantBufferMaxDataSize, "NrdConstantBuffer", 1);
         m_NRDConstantBuffer = device->createBuffer(constantBufferDesc);
 
@@ -174,6 +181,36 @@ public:
         }
     }
 
+    // NRD shader identifier -> ID of the matching ShaderMake permutation
+    static ShaderID GetNRDShaderID(const char* shaderIdentifier)
+    {
+        // Format: "fileName|macro1=value1|macro2=value2..."
+        // ex: input: "Clear.cs.hlsl|FLOAT=1"
+        //     output: "Clear.cs FLOAT=0"
+        std::string shaderIdentifierStr = shaderIdentifier;
+
+        // get initial Shader name first. Since all NRD shader files use NRD_CS_MAIN, which is a macro defined as "main", the file name itself is used.
+        std::string shaderName = shaderIdentifierStr.substr(0, shaderIdentifierStr.find(".hlsl"));
+
+        // now parse permutations
+        std::vector<std::string> shaderPermutations;
+        while (shaderIdentifierStr.find("|") != std::string::npos)
+        {
+            shaderIdentifierStr = shaderIdentifierStr.substr(shaderIdentifierStr.find("|") + 1);
+            shaderPermutations.push_back(shaderIdentifierStr.substr(0, shaderIdentifierStr.find("|")));
+        }
+
+        // 'ShaderMake::EnumeratePermutationsInBlob' always retrieves the permutation strings in a sorted manner, so we need to sort them here as well to match.
+        std::ranges::sort(shaderPermutations);
+
+        for (const std::string& permutation : shaderPermutations)
+        {
+            shaderName += " " + permutation;
+        }
+
+        return ShaderID{ shaderName };
+    }
+
     bool HasImguiControls() const override { return true; }
 
     void UpdateImgui() override
@@ -243,9 +280,9 @@ public:
             renderGraph.CreateTransientResource(g_LinearViewDepthRDGTextureHandle, desc);
         }
 
-        renderGraph.AddReadDependency(g_DepthBufferCopyRDGTextureHandle);
-        renderGraph.AddReadDependency(g_GBufferARDGTextureHandle);
-        renderGraph.AddReadDependency(g_GBufferMotionRDGTextureHandle);
+        renderGraph.AddReadDependency(g_DepthBufferCopyRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
+        renderGraph.AddReadDependency(g_GBufferARDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
+        renderGraph.AddReadDependency(g_GBufferMotionRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
 
         return true;
     }
@@ -273,7 +310,7 @@ public:
         passConstants.m_bDoDenoising = m_bEnableShadowDenoising;
         passConstants.m_RayStartOffset = (g_Scene->m_BoundingSphere.Radius < 3.0f) ? 0.01f : 0.1f;
 
-        nvrhi::BufferHandle passConstantBuffer = g_Graphic.CreateConstantBuffer(commandList, passConstants);
+        nvrhi::BufferHandle passConstantBuffer = g_Graphic.WriteConstantBuffer(commandList, passConstants);
 
         nvrhi::BindingSetDesc bindingSetDesc;
         bindingSetDesc.bindings = {
@@ -295,7 +332,7 @@ public:
 
         Graphic::ComputePassParams computePassParams;
         computePassParams.m_CommandList = commandList;
-        computePassParams.m_ShaderName = "shadowmask_CS_ShadowMask";
+        computePassParams.m_ShaderID = "shadowmask_CS_ShadowMask";
         computePassParams.m_BindingSetDesc = bindingSetDesc;
         computePassParams.m_ExtraBindingSets = { g_Graphic.GetSrvUavCbvDescriptorTable() };
         computePassParams.m_ExtraBindingLayouts = { g_Graphic.m_SrvUavCbvBindlessLayout };
@@ -321,7 +358,7 @@ public:
 
         Graphic::ComputePassParams computePassParams;
         computePassParams.m_CommandList = commandList;
-        computePassParams.m_ShaderName = "shadowmask_CS_PackNormalAndRoughness";
+        computePassParams.m_ShaderID = "shadowmask_CS_PackNormalAndRoughness";
         computePassParams.m_BindingSetDesc = bindingSetDesc;
         computePassParams.m_DispatchGroupSize = ComputeShaderUtils::GetGroupCount(passConstants.m_OutputResolution, 8);
         computePassParams.m_PushConstantsData = &passConstants;
@@ -470,33 +507,9 @@ public:
             }
             check(resourceIndex == dispatchDesc.resourcesNum);
 
-            // Format: "fileName|macro1=value1|macro2=value2..."
-            // ex: input: "Clear.cs.hlsl|FLOAT=1"
-            //     output: "Clear.cs FLOAT=0"
-            std::string shaderIdentifierStr = nrdPipelineDesc.shaderIdentifier;
-
-            // get initial Shader name first. Since all NRD shader files use NRD_CS_MAIN, which is a macro defined as "main", the file name itself is used.
-            std::string shaderName = shaderIdentifierStr.substr(0, shaderIdentifierStr.find(".hlsl"));
-
-            // now parse permutations
-            std::vector<std::string> shaderPermutations;
-            while (shaderIdentifierStr.find("|") != std::string::npos)
-            {
-                shaderIdentifierStr = shaderIdentifierStr.substr(shaderIdentifierStr.find("|") + 1);
-                shaderPermutations.push_back(shaderIdentifierStr.substr(0, shaderIdentifierStr.find("|")));
-            }
-
-            // 'ShaderMake::EnumeratePermutationsInBlob' always retrieves the permutation strings in a sorted manner, so we need to sort them here as well to match.
-            std::ranges::sort(shaderPermutations);
-
-            for (const std::string& permutation : shaderPermutations)
-            {
-                shaderName += " " + permutation;
-            }
-
             Graphic::ComputePassParams computePassParams;
             computePassParams.m_CommandList = commandList;
-            computePassParams.m_ShaderName = shaderName;
+            computePassParams.m_ShaderID = m_NRDPipelineShaderIDs[dispatchDesc.pipelineIndex];
             computePassParams.m_BindingSetDesc = bindingSetDesc;
             computePassParams.m_DispatchGroupSize = {dispatchDesc.gridWidth, dispatchDesc.gridHeight, 1};
 
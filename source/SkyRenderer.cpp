@@ -154,8 +154,8 @@ public:
             return false;
         }
 
-        renderGraph.AddReadDependency(g_LightingOutputRDGTextureHandle);
-        renderGraph.AddReadDependency(g_DepthStencilBufferRDGTextureHandle);
+        renderGraph.AddWriteDependency(g_LightingOutputRDGTextureHandle);
+        renderGraph.AddReadDependency(g_DepthStencilBufferRDGTextureHandle, nvrhi::ResourceStates::DepthRead);
 
 		return true;
 	}
@@ -186,7 +186,7 @@ public:
             skyPassParameters.m_HosekParams.m_Params[i] = Vector4{ Vector3{ skyParams[i] } };
         }
 
-        nvrhi::BufferHandle passConstantBuffer = g_Graphic.CreateConstantBuffer(commandList, skyPassParameters);
+        nvrhi::BufferHandle passConstantBuffer = g_Graphic.WriteConstantBuffer(commandList, skyPassParameters);
 
         nvrhi::BindingSetDesc bindingSetDesc;
         bindingSetDesc.bindings = 
@@ -201,7 +201,7 @@ public:
         fullScreenPassParams.m_CommandList = commandList;
         fullScreenPassParams.m_FrameBufferDesc = frameBufferDesc;
         fullScreenPassParams.m_BindingSetDesc = bindingSetDesc;
-        fullScreenPassParams.m_ShaderName = "sky_PS_HosekWilkieSky";
+        fullScreenPassParams.m_ShaderID = "sky_PS_HosekWilkieSky";
         fullScreenPassParams.m_DepthStencilState = &depthStencilState;
 
         g_Graphic.AddFullScreenPass(fullScreenPassParams);
@@ -0,0 +1,641 @@
+#include "StreamingIO.h"
+
+#include <thread>
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#include "Engine.h"
+#include "HeadlessRuns.h"
+#include "Utilities.h"
+
+class ThreadPoolStreamingIOBackend final : public StreamingIOBackend
+{
+public:
+    explicit ThreadPoolStreamingIOBackend(uint32_t numThreads)
+    {
+        check(numThreads > 0);
+
+        for (uint32_t i = 0; i < numThreads; ++i)
+        {
+            m_Threads.emplace_back([this] { ThreadLoop(); });
+        }
+    }
+
+    ~ThreadPoolStreamingIOBackend() override
+    {
+        {
+            AUTO_LOCK(m_Lock);
+            m_bExit = true;
+        }
+        m_JobsCondition.notify_all();
+
+        for (std::thread& thread : m_Threads)
+        {
+            thread.join();
+        }
+
+        check(m_Jobs.empty());
+    }
+
+    FileHandle OpenFile(std::string_view filePath) override
+    {
+        const std::string filePathStr{ filePath };
+
+#if defined(_WIN32)
+        // overlapped, otherwise the I/O manager serializes all reads on the handle & the pool reads 1 block at a time per file
+        const HANDLE fileHandle = CreateFileA(filePathStr.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS | FILE_FLAG_OVERLAPPED, nullptr);
+        return (fileHandle == INVALID_HANDLE_VALUE) ? nullptr : fileHandle;
+#else
+        const int fd = open(filePathStr.c_str(), O_RDONLY);
+        return (fd < 0) ? nullptr : (FileHandle)(intptr_t)(fd + 1);
+#endif
+    }
+
+    void CloseFile(FileHandle fileHandle) override
+    {
+#if defined(_WIN32)
+        CloseHandle((HANDLE)fileHandle);
+#else
+        close((int)(intptr_t)fileHandle - 1);
+#endif
+    }
+
+    void SubmitRead(FileHandle fileHandle, uint64_t offset, uint32_t size, std::byte* dest, OnCompleteFunc&& onComplete) override
+    {
+        {
+            AUTO_LOCK(m_Lock);
+            m_Jobs.push_back({ fileHandle, offset, size, dest, std::move(onComplete) });
+        }
+        m_JobsCondition.notify_one();
+    }
+
+private:
+    struct Job
+    {
+        FileHandle m_FileHandle;
+        uint64_t m_Offset;
+        uint32_t m_Size;
+        std::byte* m_Dest;
+        OnCompleteFunc m_OnComplete;
+    };
+
+    // 'readEvent': the calling thread's own event. Unused w/o overlapped I/O
+    static bool ReadAt(FileHandle fileHandle, uint64_t offset, uint32_t size, std::byte* dest, void* readEvent)
+    {
+#if defined(_WIN32)
+        // issued asynchronously & waited for right away, so that I/O threads reading the same file have their reads in flight at once
+        // each waits on its own event: the handle itself is signaled by whichever read completes
+        OVERLAPPED overlapped{};
+        overlapped.Offset = (DWORD)offset;
+        overlapped.OffsetHigh = (DWORD)(offset >> 32);
+        overlapped.hEvent = (HANDLE)readEvent;
+
+        if (!ReadFile((HANDLE)fileHandle, dest, size, nullptr, &overlapped) && (GetLastError() != ERROR_IO_PENDING))
+        {
+            return false;
+        }
+
+        DWORD bytesRead = 0;
+        return GetOverlappedResult((HANDLE)fileHandle, &overlapped, &bytesRead, TRUE) && (bytesRead == size);
+#else
+        // 'pread' has no shared file pointer, so reads on the same descriptor run in parallel
+        const int fd = (int)(intptr_t)fileHandle - 1;
+
+        uint32_t totalBytesRead = 0;
+        while (totalBytesRead < size)
+        {
+            const ssize_t bytesRead = pread(fd, dest + totalBytesRead, size - totalBytesRead, (off_t)(offset + totalBytesRead));
+            if (bytesRead <= 0)
+            {
+                return false;
+            }
+            totalBytesRead += (uint32_t)bytesRead;
+        }
+        return true;
+#endif
+    }
+
+    void ThreadLoop()
+    {
+#if defined(_WIN32)
+        const HANDLE readEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        check(readEvent);
+        ON_EXIT_SCOPE_LAMBDA([readEvent] { CloseHandle(readEvent); });
+#else
+        void* readEvent = nullptr;
+#endif
+
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock lock{ m_Lock };
+                m_JobsCondition.wait(lock, [this] { return m_bExit || !m_Jobs.empty(); });
+
+                if (m_Jobs.empty())
+                {
+                    return;
+                }
+
+                job = std::move(m_Jobs.front());
+                m_Jobs.pop_front();
+            }
+
+            const bool bSuccess = ReadAt(job.m_FileHandle, job.m_Offset, job.m_Size, job.m_Dest, readEvent);
+            job.m_OnComplete(bSuccess);
+        }
+    }
+
+    std::mutex m_Lock;
+    std::condition_variable m_JobsCondition;
+    std::deque<Job> m_Jobs;
+    bool m_bExit = false;
+
+    std::vector<std::thread> m_Threads;
+};
+
+std::unique_ptr<StreamingIOBackend> CreateThreadPoolStreamingIOBackend(uint32_t numThreads)
+{
+    return std::make_unique<ThreadPoolStreamingIOBackend>(numThreads);
+}
+
+void StreamingIO::BuildCoalescedReads(std::vector<QueuedRequest>& requests, const Config& config, std::vector<CoalescedRead>& outReads)
+{
+    outReads.clear();
+
+    std::sort(requests.begin(), requests.end(), [](const QueuedRequest& lhs, const QueuedRequest& rhs)
+        {
+            return std::tie(lhs.m_Request.m_FileID, lhs.m_Request.m_Offset, lhs.m_RequestID) < std::tie(rhs.m_Request.m_FileID, rhs.m_Request.m_Offset, rhs.m_RequestID);
+        });
+
+    for (uint32_t i = 0; i < requests.size();)
+    {
+        const ReadRequest& firstRequest = requests[i].m_Request;
+
+        CoalescedRead& read = outReads.emplace_back();
+        read.m_FileID = firstRequest.m_FileID;
+        read.m_Offset = firstRequest.m_Offset;
+        read.m_Priority = firstRequest.m_Priority;
+        read.m_OldestRequestID = requests[i].m_RequestID;
+        read.m_FirstRequest = i;
+        read.m_NumRequests = 1;
+
+        uint64_t readEnd = firstRequest.m_Offset + firstRequest.m_Size;
+
+        uint32_t next = i + 1;
+        for (; next < requests.size(); ++next)
+        {
+            const ReadRequest& nextRequest = requests[next].m_Request;
+
+            if ((nextRequest.m_FileID != read.m_FileID) || (nextRequest.m_Offset < readEnd) || (nextRequest.m_Offset - readEnd > config.m_MaxCoalesceGap))
+            {
+                break;
+            }
+
+            const uint64_t nextReadEnd = nextRequest.m_Offset + nextRequest.m_Size;
+            if (nextReadEnd - read.m_Offset > config.m_MaxCoalescedReadSize)
+            {
+                break;
+            }
+
+            readEnd = nextReadEnd;
+            read.m_Priority = std::min(read.m_Priority, nextRequest.m_Priority);
+            read.m_OldestRequestID = std::min(read.m_OldestRequestID, requests[next].m_RequestID);
+            ++read.m_NumRequests;
+        }
+
+        read.m_Size = (uint32_t)(readEnd - read.m_Offset);
+        i = next;
+    }
+
+    std::sort(outReads.begin(), outReads.end(), [](const CoalescedRead& lhs, const CoalescedRead& rhs)
+        {
+            return std::tie(lhs.m_Priority, lhs.m_OldestRequestID) < std::tie(rhs.m_Priority, rhs.m_OldestRequestID);
+        });
+}
+
+void StreamingIO::Initialize(std::unique_ptr<StreamingIOBackend> backend, const Config& config)
+{
+    check(!m_Backend);
+    check(backend);
+    check(config.m_MaxInFlightReads > 0 && config.m_MaxOutstandingRequests > 0);
+
+    m_Backend = std::move(backend);
+    m_Config = config;
+    m_Completions = std::make_unique<MPMCQueue<Completion>>(config.m_MaxOutstandingRequests);
+}
+
+void StreamingIO::Shutdown()
+{
+    if (!m_Backend)
+    {
+        return;
+    }
+
+    WaitForIdle();
+
+    AUTO_LOCK(m_Lock);
+
+    m_QueuedRequests.clear();
+
+    for (StreamingIOBackend::FileHandle fileHandle : m_FileHandles)
+    {
+        m_Backend->CloseFile(fileHandle);
+    }
+    m_FileHandles.clear();
+    m_FilePathToFileID.clear();
+
+    m_Backend.reset();
+    m_Completions.reset();
+}
+
+StreamingIO::FileID StreamingIO::OpenFile(std::string_view filePath)
+{
+    AUTO_LOCK(m_Lock);
+
+    auto it = m_FilePathToFileID.find(std::string{ filePath });
+    if (it != m_FilePathToFileID.end())
+    {
+        return it->second;
+    }
+
+    StreamingIOBackend::FileHandle fileHandle = m_Backend->OpenFile(filePath);
+    check(fileHandle);
+
+    const FileID fileID = (FileID)m_FileHandles.size();
+    m_FileHandles.push_back(fileHandle);
+    m_FilePathToFileID[std::string{ filePath }] = fileID;
+
+    return fileID;
+}
+
+StreamingIO::RequestID StreamingIO::Enqueue(const ReadRequest& request)
+{
+    check(request.m_Size > 0);
+    check(request.m_Dest);
+
+    AUTO_LOCK(m_Lock);
+
+    check(request.m_FileID < m_FileHandles.size());
+
+    const RequestID requestID = m_NextRequestID++;
+    m_QueuedRequests.push_back({ requestID, request });
+
+    return requestID;
+}
+
+bool StreamingIO::Cancel(RequestID requestID)
+{
+    AUTO_LOCK(m_Lock);
+
+    auto it = std::find_if(m_QueuedRequests.begin(), m_QueuedRequests.end(), [requestID](const QueuedRequest& queuedRequest) { return queuedRequest.m_RequestID == requestID; });
+    if (it == m_QueuedRequests.end())
+    {
+        return false;
+    }
+
+    // order doesn't matter, queued requests are sorted when issued
+    std::swap(*it, m_QueuedRequests.back());
+    m_QueuedRequests.pop_back();
+
+    ++m_NumRequestsCancelled;
+
+    return true;
+}
+
+void StreamingIO::Submit()
+{
+    PROFILE_FUNCTION();
+
+    AUTO_LOCK(m_Lock);
+    IssueReadsInternal();
+}
+
+void StreamingIO::IssueReadsInternal()
+{
+    if (m_QueuedRequests.empty() || m_NumInFlightReads >= m_Config.m_MaxInFlightReads)
+    {
+        return;
+    }
+
+    m_SortedRequestsScratch.swap(m_QueuedRequests);
+    m_QueuedRequests.clear();
+
+    BuildCoalescedReads(m_SortedRequestsScratch, m_Config, m_CoalescedReadsScratch);
+
+    for (const CoalescedRead& read : m_CoalescedReadsScratch)
+    {
+        const std::span<const QueuedRequest> readRequests{ m_SortedRequestsScratch.data() + read.m_FirstRequest, read.m_NumRequests };
+
+        const bool bCanIssue = (m_NumInFlightReads < m_Config.m_MaxInFlightReads) && (m_NumOutstandingRequests + read.m_NumRequests <= m_Config.m_MaxOutstandingRequests);
+        if (!bCanIssue)
+        {
+            m_QueuedRequests.insert(m_QueuedRequests.end(), readRequests.begin(), readRequests.end());
+            continue;
+        }
+
+        InFlightRead* inFlightRead = new InFlightRead;
+        inFlightRead->m_Read = read;
+        inFlightRead->m_Requests.assign(readRequests.begin(), readRequests.end());
+
+        std::byte* dest = readRequests[0].m_Request.m_Dest;
+        if (read.m_NumRequests > 1)
+        {
+            inFlightRead->m_StagingBuffer.resize(read.m_Size);
+            dest = inFlightRead->m_StagingBuffer.data();
+        }
+
+        ++m_NumInFlightReads;
+        m_NumOutstandingRequests += read.m_NumRequests;
+
+        ++m_NumReadsIssued;
+        m_NumRequestsIssued += read.m_NumRequests;
+        m_NumBytesRead += read.m_Size;
+
+        m_Backend->SubmitRead(m_FileHandles[read.m_FileID], read.m_Offset, read.m_Size, dest, [this, inFlightRead](bool bSuccess) { OnReadComplete(inFlightRead, bSuccess); });
+    }
+
+    m_SortedRequestsScratch.clear();
+}
+
+void StreamingIO::OnReadComplete(InFlightRead* inFlightRead, bool bSuccess)
+{
+    PROFILE_FUNCTION();
+
+    // scatter coalesced reads, gaps between requests are discarded
+    if (bSuccess && inFlightRead->m_Read.m_NumRequests > 1)
+    {
+        for (const QueuedRequest& queuedRequest : inFlightRead->m_Requests)
+        {
+            const uint64_t stagingOffset = queuedRequest.m_Request.m_Offset - inFlightRead->m_Read.m_Offset;
+            memcpy(queuedRequest.m_Request.m_Dest, inFlightRead->m_StagingBuffer.data() + stagingOffset, queuedRequest.m_Request.m_Size);
+        }
+    }
+
+    for (const QueuedRequest& queuedRequest : inFlightRead->m_Requests)
+    {
+        // can't fail: the queue holds 'm_MaxOutstandingRequests' & no more are issued before they're polled
+        verify(m_Completions->try_push(Completion{ queuedRequest.m_RequestID, queuedRequest.m_Request.m_UserData, bSuccess }));
+    }
+
+    delete inFlightRead;
+
+    AUTO_LOCK(m_Lock);
+
+    --m_NumInFlightReads;
+    IssueReadsInternal();
+
+    if (m_NumInFlightReads == 0)
+    {
+        m_IdleCondition.notify_all();
+    }
+}
+
+void StreamingIO::PollCompletions(std::vector<Completion>& outCompletions)
+{
+    uint32_t numCompletions = 0;
+
+    Completion completion;
+    while (m_Completions->try_pop(completion))
+    {
+        outCompletions.push_back(completion);
+        ++numCompletions;
+    }
+
+    if (numCompletions > 0)
+    {
+        m_NumOutstandingRequests -= numCompletions;
+
+        // requests held back by the outstanding requests limit
+        AUTO_LOCK(m_Lock);
+        IssueReadsInternal();
+    }
+}
+
+void StreamingIO::WaitForIdle()
+{
+    std::unique_lock lock{ m_Lock };
+    m_IdleCondition.wait(lock, [this] { return m_NumInFlightReads == 0; });
+}
+
+uint32_t StreamingIO::GetNumQueuedRequests() const
+{
+    AUTO_LOCK(m_Lock);
+    return (uint32_t)m_QueuedRequests.size();
+}
+
+static void RunStreamingIOSelfTest()
+{
+    PROFILE_FUNCTION();
+
+    using QueuedRequest = StreamingIO::QueuedRequest;
+    using CoalescedRead = StreamingIO::CoalescedRead;
+
+    const uint32_t kTileSize = KB_TO_BYTES(64);
+
+    auto MakeRequest = [](StreamingIO::RequestID requestID, StreamingIO::FileID fileID, uint64_t offset, uint32_t size, uint32_t priority)
+        {
+            return QueuedRequest{ requestID, StreamingIO::ReadRequest{ fileID, offset, size, priority, nullptr, requestID } };
+        };
+
+    // coalescing
+    {
+        StreamingIO::Config config;
+
+        std::vector<QueuedRequest> requests;
+        requests.push_back(MakeRequest(1, 0, kTileSize * 2, kTileSize, 5));
+        requests.push_back(MakeRequest(2, 0, 0, kTileSize, 5));
+        requests.push_back(MakeRequest(3, 0, kTileSize, kTileSize, 5));
+        requests.push_back(MakeRequest(4, 0, kTileSize * 3 + config.m_MaxCoalesceGap, 100, 5));               // gap at the limit: merged
+        requests.push_back(MakeRequest(5, 0, kTileSize * 3 + config.m_MaxCoalesceGap + 100 + config.m_MaxCoalesceGap + 1, 100, 5)); // gap over the limit
+        requests.push_back(MakeRequest(6, 1, kTileSize * 3, kTileSize, 5));                                  // adjacent offset, other file
+        requests.push_back(MakeRequest(7, 1, kTileSize * 3 + 10, kTileSize, 5));                             // overlaps request 6
+
+        std::vector<CoalescedRead> reads;
+        StreamingIO::BuildCoalescedReads(requests, config, reads);
+
+        test_verify(reads.size() == 4);
+
+        test_verify(reads[0].m_FileID == 0 && reads[0].m_Offset == 0 && reads[0].m_NumRequests == 4);
+        test_verify(reads[0].m_Size == kTileSize * 3 + config.m_MaxCoalesceGap + 100);
+        test_verify(reads[0].m_OldestRequestID == 1);
+        for (uint32_t i = 0; i < reads[0].m_NumRequests; ++i)
+        {
+            const QueuedRequest& request = requests[reads[0].m_FirstRequest + i];
+            test_verify(request.m_Request.m_Offset >= reads[0].m_Offset && request.m_Request.m_Offset + request.m_Request.m_Size <= reads[0].m_Offset + reads[0].m_Size);
+        }
+
+        test_verify(reads[1].m_NumRequests == 1 && requests[reads[1].m_FirstRequest].m_RequestID == 5);
+        test_verify(reads[2].m_NumRequests == 1 && requests[reads[2].m_FirstRequest].m_RequestID == 6);
+        test_verify(reads[3].m_NumRequests == 1 && requests[reads[3].m_FirstRequest].m_RequestID == 7);
+    }
+
+    // size cap & priority order
+    {
+        StreamingIO::Config config;
+        config.m_MaxCoalescedReadSize = kTileSize * 16;
+
+        std::vector<QueuedRequest> requests;
+        for (uint32_t i = 0; i < 20; ++i)
+        {
+            requests.push_back(MakeRequest(i + 1, 0, i * kTileSize, kTileSize, 10));
+        }
+        requests.push_back(MakeRequest(21, 2, 0, kTileSize, 10));
+        requests.push_back(MakeRequest(22, 3, 0, kTileSize, 1));   // most urgent
+        requests[18].m_Request.m_Priority = 3;                       // makes the 2nd run of file 0 more urgent than the 1st
+
+        std::vector<CoalescedRead> reads;
+        StreamingIO::BuildCoalescedReads(requests, config, reads);
+
+        test_verify(reads.size() == 4);
+        test_verify(reads[0].m_FileID == 3 && reads[0].m_Priority == 1);
+        test_verify(reads[1].m_FileID == 0 && reads[1].m_Offset == kTileSize * 16 && reads[1].m_NumRequests == 4 && reads[1].m_Priority == 3);
+        test_verify(reads[2].m_FileID == 0 && reads[2].m_Offset == 0 && reads[2].m_NumRequests == 16 && reads[2].m_Size == config.m_MaxCoalescedReadSize);
+        test_verify(reads[3].m_FileID == 2); // same priority as the 1st run of file 0, but requested later
+    }
+
+    // end to end on a temp file: random requests, many of them adjacent, must all complete once with the right bytes
+    const std::string filePath = (std::filesystem::temp_directory_path() / "StreamingIOSelfTest.bin").string();
+
+    const uint32_t kFileSize = MB_TO_BYTES(8);
+    std::vector<std::byte> fileData(kFileSize);
+    {
+        std::mt19937 rng{ 1234 };
+        for (std::byte& b : fileData)
+        {
+            b = (std::byte)rng();
+        }
+
+        ScopedFile f{ filePath, "wb" };
+        test_verify(fwrite(fileData.data(), 1, fileData.size(), f) == fileData.size());
+    }
+
+    {
+        StreamingIO::Config config;
+        config.m_MaxInFlightReads = 4;
+        config.m_MaxOutstandingRequests = 64;
+
+        StreamingIO streamingIO;
+        streamingIO.Initialize(CreateThreadPoolStreamingIOBackend(4), config);
+
+        const StreamingIO::FileID fileID = streamingIO.OpenFile(filePath);
+        test_verify(streamingIO.OpenFile(filePath) == fileID); // handles are cached
+
+        std::mt19937 rng{ 5678 };
+
+        struct TestRequest
+        {
+            uint64_t m_Offset;
+            uint32_t m_Size;
+            std::vector<std::byte> m_Dest;
+            uint32_t m_NumCompletions = 0;
+        };
+        std::vector<TestRequest> testRequests(512);
+
+        for (uint32_t i = 0; i < testRequests.size(); ++i)
+        {
+            TestRequest& testRequest = testRequests[i];
+
+            // every other request continues the previous one, as neighbor tiles do
+            testRequest.m_Size = std::uniform_int_distribution<uint32_t>{ 1, kTileSize * 2 }(rng);
+            if ((i % 2) && (testRequests[i - 1].m_Offset + testRequests[i - 1].m_Size + testRequest.m_Size <= kFileSize))
+            {
+                testRequest.m_Offset = testRequests[i - 1].m_Offset + testRequests[i - 1].m_Size;
+            }
+            else
+            {
+                testRequest.m_Offset = std::uniform_int_distribution<uint64_t>{ 0, kFileSize - testRequest.m_Size }(rng);
+            }
+            testRequest.m_Dest.resize(testRequest.m_Size);
+
+            streamingIO.Enqueue({ fileID, testRequest.m_Offset, testRequest.m_Size, std::uniform_int_distribution<uint32_t>{ 0, 3 }(rng), testRequest.m_Dest.data(), i });
+        }
+
+        streamingIO.Submit();
+
+        std::vector<StreamingIO::Completion> completions;
+        uint32_t numCompleted = 0;
+        while (numCompleted < testRequests.size())
+        {
+            completions.clear();
+            streamingIO.PollCompletions(completions);
+            test_verify(completions.size() <= config.m_MaxOutstandingRequests);
+
+            for (const StreamingIO::Completion& completion : completions)
+            {
+                test_verify(completion.m_bSuccess);
+
+                TestRequest& testRequest = testRequests.at(completion.m_UserData);
+                test_verify(++testRequest.m_NumCompletions == 1);
+                test_verify(memcmp(testRequest.m_Dest.data(), fileData.data() + testRequest.m_Offset, testRequest.m_Size) == 0);
+            }
+            numCompleted += (uint32_t)completions.size();
+
+            std::this_thread::yield();
+        }
+
+        streamingIO.WaitForIdle();
+        test_verify(streamingIO.GetNumQueuedRequests() == 0);
+        test_verify(streamingIO.m_NumRequestsIssued == testRequests.size());
+        test_verify(streamingIO.m_NumReadsIssued < testRequests.size()); // some were coalesced
+
+        SDL_Log("Streaming IO Self Test: %u requests in %llu reads", (uint32_t)testRequests.size(), (unsigned long long)streamingIO.m_NumReadsIssued);
+
+        streamingIO.Shutdown();
+    }
+
+    // cancellation
+    {
+        StreamingIO streamingIO;
+        streamingIO.Initialize(CreateThreadPoolStreamingIOBackend(2));
+
+        const StreamingIO::FileID fileID = streamingIO.OpenFile(filePath);
+
+        // far apart, so that none are coalesced
+        std::vector<std::byte> dest(kTileSize * 64);
+        std::vector<StreamingIO::RequestID> requestIDs;
+        for (uint32_t i = 0; i < 64; ++i)
+        {
+            requestIDs.push_back(streamingIO.Enqueue({ fileID, i * kTileSize * 2, kTileSize, 0, dest.data() + i * kTileSize, i }));
+        }
+
+        // queued requests are dropped
+        for (uint32_t i = 0; i < requestIDs.size(); i += 2)
+        {
+            test_verify(streamingIO.Cancel(requestIDs[i]));
+            test_verify(!streamingIO.Cancel(requestIDs[i]));
+        }
+        test_verify(streamingIO.GetNumQueuedRequests() == requestIDs.size() / 2);
+
+        streamingIO.Submit();
+        streamingIO.WaitForIdle();
+
+        // issued requests can't be cancelled & complete as usual
+        for (uint32_t i = 1; i < requestIDs.size(); i += 2)
+        {
+            test_verify(!streamingIO.Cancel(requestIDs[i]));
+        }
+
+        std::vector<StreamingIO::Completion> completions;
+        streamingIO.PollCompletions(completions);
+        test_verify(completions.size() == requestIDs.size() / 2);
+
+        for (const StreamingIO::Completion& completion : completions)
+        {
+            test_verify(completion.m_bSuccess);
+            test_verify(completion.m_UserData % 2 == 1);
+            test_verify(completion.m_RequestID == requestIDs[completion.m_UserData]);
+            test_verify(memcmp(dest.data() + completion.m_UserData * kTileSize, fileData.data() + completion.m_UserData * kTileSize * 2, kTileSize) == 0);
+        }
+
+        test_verify(streamingIO.m_NumRequestsCancelled == requestIDs.size() / 2);
+
+        streamingIO.Shutdown();
+    }
+
+    std::filesystem::remove(filePath);
+}
+REGISTER_HEADLESS_RUN("streamingioselftest", HeadlessRunType::SelfTest, RunStreamingIOSelfTest);
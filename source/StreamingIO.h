@@ -0,0 +1,140 @@
+#pragma once
+
+#include <condition_variable>
+
+#include "MPMCQueue.h"
+
+// Reads at explicit file offsets, completed asynchronously. 'onComplete' is called exactly once per read, from any thread but never from within 'SubmitRead'
+// Implementations must accept reads & file opens from any thread
+class StreamingIOBackend
+{
+public:
+    using FileHandle = void*;
+    using OnCompleteFunc = std::function<void(bool bSuccess)>;
+
+    virtual ~StreamingIOBackend() = default;
+
+    virtual FileHandle OpenFile(std::string_view filePath) = 0; // nullptr on failure
+    virtual void CloseFile(FileHandle fileHandle) = 0;
+    virtual void SubmitRead(FileHandle fileHandle, uint64_t offset, uint32_t size, std::byte* dest, OnCompleteFunc&& onComplete) = 0;
+};
+
+// Positional reads ('pread', overlapped 'ReadFile') on a pool of dedicated threads, in parallel on the same file. Unlike executor workers, I/O threads blocking on disk never stall the frame
+std::unique_ptr<StreamingIOBackend> CreateThreadPoolStreamingIOBackend(uint32_t numThreads);
+
+struct StreamingIOConfig
+{
+    uint32_t m_MaxInFlightReads = 16;            // backend reads, after coalescing
+    uint32_t m_MaxOutstandingRequests = 4096;    // issued requests whose completions aren't collected yet. Bounds the completion queue
+    uint32_t m_MaxCoalescedReadSize = MB_TO_BYTES(1);
+    uint32_t m_MaxCoalesceGap = KB_TO_BYTES(4);  // bytes between 2 requests that may be read & discarded to merge them. Covers 'TiledTextureFile' tile alignment
+};
+
+// Asynchronous I/O for texture streaming
+// Read requests are queued with a priority & issued by 'Submit', most urgent first. Queued requests on the same file that are adjacent on disk are coalesced into 1 read
+// Files stay open until 'Shutdown'. Completions are delivered through a lock-free queue & collected by 'PollCompletions', on the thread that owns the requests
+class StreamingIO
+{
+public:
+    using FileID = uint32_t;
+    using RequestID = uint64_t;
+
+    static const RequestID kInvalidRequestID = 0;
+
+    using Config = StreamingIOConfig;
+
+    struct ReadRequest
+    {
+        FileID m_FileID;
+        uint64_t m_Offset;
+        uint32_t m_Size;
+        uint32_t m_Priority;  // lower is more urgent
+        std::byte* m_Dest;    // must hold 'm_Size' bytes until the request completes or is cancelled
+        uint64_t m_UserData;  // returned in the completion
+    };
+
+    struct Completion
+    {
+        RequestID m_RequestID;
+        uint64_t m_UserData;
+        bool m_bSuccess;
+    };
+
+    // queued requests merged into 1 backend read of [m_Offset, m_Offset + m_Size). See 'BuildCoalescedReads'
+    struct CoalescedRead
+    {
+        FileID m_FileID;
+        uint64_t m_Offset;
+        uint32_t m_Size;
+        uint32_t m_Priority;             // most urgent of its requests
+        RequestID m_OldestRequestID;     // runs of the same priority are issued in request order
+        uint32_t m_FirstRequest;         // range into the sorted requests
+        uint32_t m_NumRequests;
+    };
+
+    struct QueuedRequest
+    {
+        RequestID m_RequestID;
+        ReadRequest m_Request;
+    };
+
+    // Sorts 'requests' by file & offset & merges runs of adjacent ones, most urgent run first. Runs are capped to 'config.m_MaxCoalescedReadSize'
+    // Overlapping requests are never merged. Device & backend agnostic, see 'RunStreamingIOSelfTest'
+    static void BuildCoalescedReads(std::vector<QueuedRequest>& requests, const Config& config, std::vector<CoalescedRead>& outReads);
+
+    void Initialize(std::unique_ptr<StreamingIOBackend> backend, const Config& config = Config{});
+    void Shutdown(); // waits for all issued reads
+
+    FileID OpenFile(std::string_view filePath);
+
+    RequestID Enqueue(const ReadRequest& request);
+
+    // True if the request was still queued: it's dropped & won't complete. False if already issued: its completion is delivered as usual
+    bool Cancel(RequestID requestID);
+
+    // Issues queued requests, up to the in-flight limits. The rest is issued as reads complete
+    void Submit();
+
+    void PollCompletions(std::vector<Completion>& outCompletions);
+
+    // Blocks until all issued requests completed. Completions still have to be polled
+    void WaitForIdle();
+
+    uint32_t GetNumQueuedRequests() const;
+
+    // stats, since 'Initialize'
+    uint64_t m_NumRequestsIssued = 0;
+    uint64_t m_NumReadsIssued = 0;
+    uint64_t m_NumBytesRead = 0;   // includes coalesced gap bytes
+    uint64_t m_NumRequestsCancelled = 0;
+
+private:
+    struct InFlightRead
+    {
+        CoalescedRead m_Read;
+        std::vector<QueuedRequest> m_Requests;
+        std::vector<std::byte> m_StagingBuffer; // only for reads of more than 1 request
+    };
+
+    void IssueReadsInternal(); // 'm_Lock' must be held
+    void OnReadComplete(InFlightRead* inFlightRead, bool bSuccess);
+
+    std::unique_ptr<StreamingIOBackend> m_Backend;
+    Config m_Config;
+
+    mutable std::mutex m_Lock;
+    std::condition_variable m_IdleCondition;
+
+    std::vector<StreamingIOBackend::FileHandle> m_FileHandles;
+    std::unordered_map<std::string, FileID> m_FilePathToFileID;
+
+    RequestID m_NextRequestID = kInvalidRequestID + 1;
+    std::vector<QueuedRequest> m_QueuedRequests;
+    std::vector<CoalescedRead> m_CoalescedReadsScratch;
+    std::vector<QueuedRequest> m_SortedRequestsScratch;
+
+    uint32_t m_NumInFlightReads = 0;
+    std::atomic<uint32_t> m_NumOutstandingRequests = 0;
+
+    std::unique_ptr<MPMCQueue<Completion>> m_Completions;
+};
@@ -0,0 +1,129 @@
+#include "Engine.h"
+#include "HeadlessRuns.h"
+#include "StreamingIO.h"
+#include "Utilities.h"
+
+CommandLineOption<int> g_StreamingIOBenchmarkFileSizeMB{ "streamingiobenchmarkfilesizemb", 256 };
+
+// Tile reads as texture streaming issues them, from a local file: per request 'ScopedFile' + 'fseek' + 'fread' on executor workers, as before 'StreamingIO', vs 'StreamingIO'
+// NOTE: the file was just written, so reads mostly hit the OS file cache. This measures per request overhead & coalescing rather than the disk
+static void RunStreamingIOBenchmark(uint32_t fileSizeMB)
+{
+    PROFILE_FUNCTION();
+
+    const uint32_t kTileSize = KB_TO_BYTES(64);
+    const uint32_t kNumFrames = 64;
+    const uint32_t kNumTilesPerFrame = 64;
+    const uint32_t kNumAdjacentTiles = 8; // half the tiles of a frame come in rows of neighbors, as when a region of a mip becomes visible
+    const uint32_t kNumIOThreads = 4;
+
+    const uint64_t fileSize = std::max<uint64_t>(MB_TO_BYTES(fileSizeMB), kTileSize * kNumTilesPerFrame);
+    const uint32_t numFileTiles = (uint32_t)(fileSize / kTileSize);
+
+    const std::string filePath = (std::filesystem::temp_directory_path() / "StreamingIOBenchmark.bin").string();
+    {
+        ScopedFile f{ filePath, "wb" };
+
+        std::vector<std::byte> chunk(MB_TO_BYTES(1));
+        for (uint64_t offset = 0; offset < fileSize; offset += chunk.size())
+        {
+            std::fill(chunk.begin(), chunk.end(), (std::byte)(offset >> 20));
+            const size_t chunkSize = std::min<size_t>(chunk.size(), fileSize - offset);
+            test_verify(fwrite(chunk.data(), 1, chunkSize, f) == chunkSize);
+        }
+    }
+
+    // same tile offsets for both runs
+    std::mt19937 rng{ 1234 };
+    std::vector<uint64_t> tileOffsets;
+    for (uint32_t frame = 0; frame < kNumFrames; ++frame)
+    {
+        for (uint32_t i = 0; i < kNumTilesPerFrame / 2; ++i)
+        {
+            tileOffsets.push_back(std::uniform_int_distribution<uint32_t>{ 0, numFileTiles - 1 }(rng) * (uint64_t)kTileSize);
+        }
+        for (uint32_t i = 0; i < kNumTilesPerFrame / 2; i += kNumAdjacentTiles)
+        {
+            const uint32_t firstTile = std::uniform_int_distribution<uint32_t>{ 0, numFileTiles - kNumAdjacentTiles }(rng);
+            for (uint32_t j = 0; j < kNumAdjacentTiles; ++j)
+            {
+                tileOffsets.push_back((firstTile + j) * (uint64_t)kTileSize);
+            }
+        }
+    }
+
+    std::vector<std::byte> tileDatas(kNumTilesPerFrame * kTileSize);
+
+    const float totalMB = BYTES_TO_MB(tileOffsets.size() * kTileSize);
+
+    float legacyElapsedMs = 0.0f;
+    {
+        tf::Executor executor{ kNumIOThreads };
+
+        Timer timer;
+        for (uint32_t frame = 0; frame < kNumFrames; ++frame)
+        {
+            for (uint32_t i = 0; i < kNumTilesPerFrame; ++i)
+            {
+                const uint64_t tileOffset = tileOffsets[frame * kNumTilesPerFrame + i];
+                std::byte* dest = tileDatas.data() + i * kTileSize;
+
+                executor.silent_async([&filePath, tileOffset, dest]
+                    {
+                        ScopedFile f{ filePath, "rb" };
+                        _fseeki64(f, tileOffset, SEEK_SET);
+                        test_verify(fread(dest, 1, kTileSize, f) == kTileSize);
+                    });
+            }
+            executor.wait_for_all();
+        }
+        legacyElapsedMs = timer.GetElapsedMilliseconds();
+    }
+
+    float newElapsedMs = 0.0f;
+    uint64_t numReadsIssued = 0;
+    {
+        StreamingIO streamingIO;
+        streamingIO.Initialize(CreateThreadPoolStreamingIOBackend(kNumIOThreads));
+
+        const StreamingIO::FileID fileID = streamingIO.OpenFile(filePath);
+
+        std::vector<StreamingIO::Completion> completions;
+
+        Timer timer;
+        for (uint32_t frame = 0; frame < kNumFrames; ++frame)
+        {
+            for (uint32_t i = 0; i < kNumTilesPerFrame; ++i)
+            {
+                const uint64_t tileOffset = tileOffsets[frame * kNumTilesPerFrame + i];
+                streamingIO.Enqueue({ fileID, tileOffset, kTileSize, 0, tileDatas.data() + i * kTileSize, i });
+            }
+            streamingIO.Submit();
+
+            uint32_t numCompleted = 0;
+            while (numCompleted < kNumTilesPerFrame)
+            {
+                completions.clear();
+                streamingIO.PollCompletions(completions);
+                for (const StreamingIO::Completion& completion : completions)
+                {
+                    test_verify(completion.m_bSuccess);
+                }
+                numCompleted += (uint32_t)completions.size();
+            }
+        }
+        newElapsedMs = timer.GetElapsedMilliseconds();
+        numReadsIssued = streamingIO.m_NumReadsIssued;
+
+        streamingIO.Shutdown();
+    }
+
+    std::filesystem::remove(filePath);
+
+    SDL_Log("Streaming IO Benchmark [%u tiles of %u KB, %.0f MB file]: legacy %.1f ms (%.0f MB/s, %u reads), new %.1f ms (%.0f MB/s, %llu reads) (%.1fx)",
+        (uint32_t)tileOffsets.size(), (uint32_t)BYTES_TO_KB(kTileSize), BYTES_TO_MB(fileSize),
+        legacyElapsedMs, totalMB / (legacyElapsedMs / 1000.0f), (uint32_t)tileOffsets.size(),
+        newElapsedMs, totalMB / (newElapsedMs / 1000.0f), (unsigned long long)numReadsIssued,
+        legacyElapsedMs / std::max(newElapsedMs, 1e-6f));
+}
+REGISTER_HEADLESS_RUN("streamingiobenchmark", HeadlessRunType::Benchmark, [] { RunStreamingIOBenchmark(g_StreamingIOBenchmarkFileSizeMB.Get()); });
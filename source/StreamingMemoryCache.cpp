@@ -0,0 +1,648 @@
+#include "StreamingMemoryCache.h"
+
+#include <bit>
+
+#include "EngineCore.h"
+#include "HeadlessRuns.h"
+
+// budget of 'TextureFeedbackManager'. Defined here rather than there, so that the streaming simulator builds w/o the renderer
+CommandLineOption<int> g_StreamingMemoryBudgetMB{ "streamingmemorybudgetmb", 1024 };
+
+void SlabAllocator::Initialize(uint32_t minBlockSize, uint32_t slabSize)
+{
+    check(std::has_single_bit(minBlockSize));
+    check(slabSize >= minBlockSize);
+
+    m_MinBlockSize = minBlockSize;
+    m_SlabSize = slabSize;
+
+    // up to 2 GB blocks
+    for (uint64_t blockSize = minBlockSize; blockSize <= (1ULL << 31); blockSize *= 2)
+    {
+        SizeClass& sizeClass = m_SizeClasses.emplace_back();
+        sizeClass.m_BlockSize = (uint32_t)blockSize;
+        sizeClass.m_BlocksPerSlab = std::max(1u, slabSize / (uint32_t)blockSize); // bigger blocks get a slab of their own
+    }
+}
+
+void SlabAllocator::Shutdown()
+{
+    check(m_AllocatedBytes == 0); // leak
+
+    m_SizeClasses.clear();
+    m_PooledBytes = 0;
+}
+
+uint32_t SlabAllocator::GetSizeClassIndex(uint32_t size) const
+{
+    check(size > 0);
+    const uint32_t blockSize = std::max(m_MinBlockSize, std::bit_ceil(size));
+    return std::countr_zero(blockSize) - std::countr_zero(m_MinBlockSize);
+}
+
+uint32_t SlabAllocator::GetBlockSize(uint32_t size) const
+{
+    return m_SizeClasses.at(GetSizeClassIndex(size)).m_BlockSize;
+}
+
+uint64_t SlabAllocator::GetGrowthBytes(uint32_t size) const
+{
+    const SizeClass& sizeClass = m_SizeClasses.at(GetSizeClassIndex(size));
+    return (sizeClass.m_NumFreeBlocks > 0) ? 0 : (uint64_t)sizeClass.m_BlockSize * sizeClass.m_BlocksPerSlab;
+}
+
+uint64_t SlabAllocator::ReleaseEmptySlabs()
+{
+    const uint64_t pooledBytes = m_PooledBytes;
+
+    for (SizeClass& sizeClass : m_SizeClasses)
+    {
+        if (sizeClass.m_EmptySlab)
+        {
+            ReleaseSlab(sizeClass, sizeClass.m_EmptySlab);
+            sizeClass.m_EmptySlab = nullptr;
+        }
+    }
+
+    return pooledBytes - m_PooledBytes;
+}
+
+void SlabAllocator::ReleaseSlab(SizeClass& sizeClass, Slab* slab)
+{
+    check(slab->m_FreeBlocks.size() == sizeClass.m_BlocksPerSlab);
+
+    m_PooledBytes -= (uint64_t)sizeClass.m_BlockSize * sizeClass.m_BlocksPerSlab;
+    sizeClass.m_NumFreeBlocks -= sizeClass.m_BlocksPerSlab;
+    std::erase_if(sizeClass.m_Slabs, [slab](const std::unique_ptr<Slab>& other) { return other.get() == slab; });
+}
+
+uint32_t SlabAllocator::GetNumSlabs() const
+{
+    uint32_t numSlabs = 0;
+    for (const SizeClass& sizeClass : m_SizeClasses)
+    {
+        numSlabs += (uint32_t)sizeClass.m_Slabs.size();
+    }
+    return numSlabs;
+}
+
+SlabAllocator::Allocation SlabAllocator::Allocate(uint32_t size)
+{
+    const uint32_t sizeClassIndex = GetSizeClassIndex(size);
+    SizeClass& sizeClass = m_SizeClasses.at(sizeClassIndex);
+
+    Slab* slab = nullptr;
+    for (const std::unique_ptr<Slab>& candidate : sizeClass.m_Slabs)
+    {
+        if (!candidate->m_FreeBlocks.empty())
+        {
+            slab = candidate.get();
+            break;
+        }
+    }
+
+    if (!slab)
+    {
+        const uint64_t slabSize = (uint64_t)sizeClass.m_BlockSize * sizeClass.m_BlocksPerSlab;
+
+        slab = sizeClass.m_Slabs.emplace_back(std::make_unique<Slab>()).get();
+        slab->m_Memory = std::make_unique_for_overwrite<std::byte[]>(slabSize);
+        slab->m_SizeClassIndex = sizeClassIndex;
+
+        // last block on top, so that blocks are handed out in address order
+        slab->m_FreeBlocks.reserve(sizeClass.m_BlocksPerSlab);
+        for (uint32_t i = sizeClass.m_BlocksPerSlab; i > 0; --i)
+        {
+            slab->m_FreeBlocks.push_back(slab->m_Memory.get() + (uint64_t)(i - 1) * sizeClass.m_BlockSize);
+        }
+
+        m_PooledBytes += slabSize;
+        sizeClass.m_NumFreeBlocks += sizeClass.m_BlocksPerSlab;
+    }
+
+    Allocation allocation;
+    allocation.m_Data = slab->m_FreeBlocks.back();
+    allocation.m_Slab = slab;
+    slab->m_FreeBlocks.pop_back();
+
+    --sizeClass.m_NumFreeBlocks;
+    if (sizeClass.m_EmptySlab == slab)
+    {
+        sizeClass.m_EmptySlab = nullptr;
+    }
+
+    m_AllocatedBytes += sizeClass.m_BlockSize;
+
+    return allocation;
+}
+
+void SlabAllocator::Free(Allocation& allocation)
+{
+    check(allocation.IsValid());
+
+    Slab* slab = allocation.m_Slab;
+    SizeClass& sizeClass = m_SizeClasses.at(slab->m_SizeClassIndex);
+
+    check(slab->m_FreeBlocks.size() < sizeClass.m_BlocksPerSlab);
+    slab->m_FreeBlocks.push_back(allocation.m_Data);
+    ++sizeClass.m_NumFreeBlocks;
+
+    check(m_AllocatedBytes >= sizeClass.m_BlockSize);
+    m_AllocatedBytes -= sizeClass.m_BlockSize;
+
+    allocation = Allocation{};
+
+    if (slab->m_FreeBlocks.size() < sizeClass.m_BlocksPerSlab)
+    {
+        return;
+    }
+
+    if (sizeClass.m_EmptySlab)
+    {
+        ReleaseSlab(sizeClass, slab);
+    }
+    else
+    {
+        sizeClass.m_EmptySlab = slab;
+    }
+}
+
+void StreamingMemoryCache::Initialize(uint64_t budgetInBytes, uint32_t minBlockSize, uint32_t slabSize)
+{
+    m_Allocator.Initialize(minBlockSize, slabSize);
+    m_BudgetInBytes = budgetInBytes;
+}
+
+void StreamingMemoryCache::Shutdown()
+{
+    for (uint32_t i = 0; i < m_Entries.size(); ++i)
+    {
+        if (m_Entries[i].m_bInUse)
+        {
+            ReleaseEntry(i);
+        }
+    }
+    m_Entries.clear();
+    m_FreeEntryIndices.clear();
+
+    m_Allocator.Shutdown();
+}
+
+void StreamingMemoryCache::SetBudget(uint64_t budgetInBytes)
+{
+    m_BudgetInBytes = budgetInBytes;
+    EvictToFit(0);
+}
+
+StreamingMemoryCache::Entry* StreamingMemoryCache::GetEntry(EntryID entryID)
+{
+    return const_cast<Entry*>(static_cast<const StreamingMemoryCache*>(this)->GetEntry(entryID));
+}
+
+const StreamingMemoryCache::Entry* StreamingMemoryCache::GetEntry(EntryID entryID) const
+{
+    const uint32_t entryIdx = (uint32_t)entryID;
+    const uint32_t generation = (uint32_t)(entryID >> 32);
+
+    if (entryIdx >= m_Entries.size())
+    {
+        return nullptr;
+    }
+
+    const Entry& entry = m_Entries[entryIdx];
+    return (entry.m_bInUse && entry.m_Generation == generation) ? &entry : nullptr;
+}
+
+void StreamingMemoryCache::LinkLRUTail(uint32_t entryIdx)
+{
+    Entry& entry = m_Entries[entryIdx];
+    entry.m_LRUPrev = m_LRUTail;
+    entry.m_LRUNext = kInvalidIndex;
+
+    if (m_LRUTail != kInvalidIndex)
+    {
+        m_Entries[m_LRUTail].m_LRUNext = entryIdx;
+    }
+    else
+    {
+        m_LRUHead = entryIdx;
+    }
+    m_LRUTail = entryIdx;
+}
+
+void StreamingMemoryCache::UnlinkLRU(uint32_t entryIdx)
+{
+    Entry& entry = m_Entries[entryIdx];
+
+    if (entry.m_LRUPrev != kInvalidIndex)
+    {
+        m_Entries[entry.m_LRUPrev].m_LRUNext = entry.m_LRUNext;
+    }
+    else
+    {
+        m_LRUHead = entry.m_LRUNext;
+    }
+
+    if (entry.m_LRUNext != kInvalidIndex)
+    {
+        m_Entries[entry.m_LRUNext].m_LRUPrev = entry.m_LRUPrev;
+    }
+    else
+    {
+        m_LRUTail = entry.m_LRUPrev;
+    }
+
+    entry.m_LRUPrev = kInvalidIndex;
+    entry.m_LRUNext = kInvalidIndex;
+}
+
+void StreamingMemoryCache::ReleaseEntry(uint32_t entryIdx)
+{
+    Entry& entry = m_Entries[entryIdx];
+    check(entry.m_bInUse);
+
+    if (entry.m_NumPins == 0)
+    {
+        UnlinkLRU(entryIdx);
+    }
+
+    m_Allocator.Free(entry.m_Allocation);
+
+    entry.m_bInUse = false;
+    entry.m_NumPins = 0;
+    entry.m_Size = 0;
+    ++entry.m_Generation; // outstanding IDs of this entry are now stale
+
+    m_FreeEntryIndices.push_back(entryIdx);
+
+    check(m_NumResidentEntries > 0);
+    --m_NumResidentEntries;
+}
+
+void StreamingMemoryCache::EvictToFit(uint32_t incomingSize)
+{
+    // evicting only helps once it drains a slab, or frees a block of the incoming size class
+    auto GetRequiredPooledBytes = [this, incomingSize] { return GetPooledBytes() + ((incomingSize > 0) ? m_Allocator.GetGrowthBytes(incomingSize) : 0); };
+
+    if (GetRequiredPooledBytes() <= m_BudgetInBytes)
+    {
+        return;
+    }
+
+    m_Allocator.ReleaseEmptySlabs();
+
+    while ((m_LRUHead != kInvalidIndex) && (GetRequiredPooledBytes() > m_BudgetInBytes))
+    {
+        const uint32_t entryIdx = m_LRUHead;
+
+        ++m_NumEvictions;
+        m_NumEvictedBytes += m_Entries[entryIdx].m_Size;
+
+        ReleaseEntry(entryIdx);
+        m_Allocator.ReleaseEmptySlabs();
+    }
+
+    const uint64_t requiredPooledBytes = GetRequiredPooledBytes();
+    if (requiredPooledBytes > m_BudgetInBytes)
+    {
+        m_PeakOverBudgetBytes = std::max(m_PeakOverBudgetBytes, requiredPooledBytes - m_BudgetInBytes);
+    }
+}
+
+StreamingMemoryCache::EntryID StreamingMemoryCache::Allocate(uint32_t size)
+{
+    EvictToFit(size);
+
+    uint32_t entryIdx;
+    if (!m_FreeEntryIndices.empty())
+    {
+        entryIdx = m_FreeEntryIndices.back();
+        m_FreeEntryIndices.pop_back();
+    }
+    else
+    {
+        entryIdx = (uint32_t)m_Entries.size();
+        m_Entries.emplace_back();
+    }
+
+    Entry& entry = m_Entries[entryIdx];
+    check(!entry.m_bInUse);
+
+    entry.m_Allocation = m_Allocator.Allocate(size);
+    entry.m_Size = size;
+    entry.m_NumPins = 1;
+    entry.m_bInUse = true;
+
+    ++m_NumResidentEntries;
+
+    return ((EntryID)entry.m_Generation << 32) | entryIdx;
+}
+
+void StreamingMemoryCache::Free(EntryID entryID)
+{
+    if (GetEntry(entryID))
+    {
+        ReleaseEntry((uint32_t)entryID);
+    }
+}
+
+bool StreamingMemoryCache::IsResident(EntryID entryID) const
+{
+    return GetEntry(entryID) != nullptr;
+}
+
+std::byte* StreamingMemoryCache::GetData(EntryID entryID) const
+{
+    const Entry* entry = GetEntry(entryID);
+    check(entry);
+    return entry->m_Allocation.m_Data;
+}
+
+uint32_t StreamingMemoryCache::GetSize(EntryID entryID) const
+{
+    const Entry* entry = GetEntry(entryID);
+    check(entry);
+    return entry->m_Size;
+}
+
+bool StreamingMemoryCache::Pin(EntryID entryID)
+{
+    Entry* entry = GetEntry(entryID);
+    if (!entry)
+    {
+        return false;
+    }
+
+    if (entry->m_NumPins++ == 0)
+    {
+        UnlinkLRU((uint32_t)entryID);
+    }
+    return true;
+}
+
+bool StreamingMemoryCache::Unpin(EntryID entryID)
+{
+    Entry* entry = GetEntry(entryID);
+    if (!entry)
+    {
+        return false;
+    }
+
+    check(entry->m_NumPins > 0);
+    if (--entry->m_NumPins == 0)
+    {
+        LinkLRUTail((uint32_t)entryID);
+    }
+    return true;
+}
+
+static void RunStreamingMemoryCacheSelfTest()
+{
+    PROFILE_FUNCTION();
+
+    const uint32_t kTileSize = KB_TO_BYTES(64);
+
+    // slab allocator
+    {
+        SlabAllocator allocator;
+        allocator.Initialize(KB_TO_BYTES(4), MB_TO_BYTES(1));
+
+        test_verify(allocator.GetBlockSize(1) == KB_TO_BYTES(4));
+        test_verify(allocator.GetBlockSize(KB_TO_BYTES(4)) == KB_TO_BYTES(4));
+        test_verify(allocator.GetBlockSize(KB_TO_BYTES(4) + 1) == KB_TO_BYTES(8));
+        test_verify(allocator.GetBlockSize(kTileSize) == kTileSize);
+        test_verify(allocator.GetBlockSize(MB_TO_BYTES(3)) == MB_TO_BYTES(4));
+
+        // 16 tiles per slab, distinct & inside their slab
+        std::vector<SlabAllocator::Allocation> tiles;
+        for (uint32_t i = 0; i < 32; ++i)
+        {
+            tiles.push_back(allocator.Allocate(kTileSize));
+            memset(tiles.back().m_Data, i, kTileSize);
+        }
+        test_verify(allocator.GetNumSlabs() == 2);
+        test_verify(allocator.GetAllocatedBytes() == 32 * kTileSize);
+        test_verify(allocator.GetPooledBytes() == MB_TO_BYTES(2));
+
+        for (uint32_t i = 0; i < tiles.size(); ++i)
+        {
+            const std::byte* slabMemory = tiles[i].m_Slab->m_Memory.get();
+            test_verify(tiles[i].m_Data >= slabMemory && tiles[i].m_Data + kTileSize <= slabMemory + MB_TO_BYTES(1));
+            test_verify(tiles[i].m_Data[0] == (std::byte)i && tiles[i].m_Data[kTileSize - 1] == (std::byte)i);
+        }
+
+        // freed blocks are reused before a new slab is created
+        std::byte* freedBlock = tiles[5].m_Data;
+        allocator.Free(tiles[5]);
+        test_verify(!tiles[5].IsValid());
+        tiles[5] = allocator.Allocate(kTileSize - 100);
+        test_verify(tiles[5].m_Data == freedBlock);
+        test_verify(allocator.GetNumSlabs() == 2);
+
+        // 1 empty slab is kept per class...
+        for (uint32_t i = 16; i < 32; ++i)
+        {
+            allocator.Free(tiles[i]);
+        }
+        test_verify(allocator.GetNumSlabs() == 2);
+        test_verify(allocator.GetPooledBytes() == MB_TO_BYTES(2));
+
+        // ...but not 2
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            allocator.Free(tiles[i]);
+        }
+        test_verify(allocator.GetNumSlabs() == 1);
+        test_verify(allocator.GetPooledBytes() == MB_TO_BYTES(1));
+        test_verify(allocator.GetAllocatedBytes() == 0);
+
+        // blocks bigger than a slab get a slab of their own
+        SlabAllocator::Allocation bigAllocation = allocator.Allocate(MB_TO_BYTES(3));
+        test_verify(allocator.GetNumSlabs() == 2);
+        test_verify(allocator.GetPooledBytes() == MB_TO_BYTES(5));
+        allocator.Free(bigAllocation);
+        test_verify(allocator.GetAllocatedBytes() == 0);
+        test_verify(allocator.GetGrowthBytes(kTileSize) == 0); // the kept empty slab
+
+        test_verify(allocator.ReleaseEmptySlabs() == MB_TO_BYTES(5)); // the empty tile slab & the 4 MB class slab of the big block
+        test_verify(allocator.GetNumSlabs() == 0 && allocator.GetPooledBytes() == 0);
+        test_verify(allocator.GetGrowthBytes(kTileSize) == MB_TO_BYTES(1));
+
+        allocator.Shutdown();
+    }
+
+    // LRU eviction under budget
+    {
+        // a slab per tile: pooled bytes are resident bytes
+        StreamingMemoryCache cache;
+        cache.Initialize(kTileSize * 8, KB_TO_BYTES(4), kTileSize);
+
+        std::vector<StreamingMemoryCache::EntryID> entries;
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            entries.push_back(cache.Allocate(kTileSize));
+            test_verify(cache.IsResident(entries.back()));
+            test_verify(cache.GetSize(entries.back()) == kTileSize);
+        }
+        test_verify(cache.GetResidentBytes() == kTileSize * 8);
+
+        // all pinned: over budget, nothing evicted
+        const StreamingMemoryCache::EntryID overBudgetEntry = cache.Allocate(kTileSize);
+        test_verify(cache.m_NumEvictions == 0);
+        test_verify(cache.m_PeakOverBudgetBytes == kTileSize);
+        cache.Free(overBudgetEntry);
+        test_verify(!cache.IsResident(overBudgetEntry));
+        test_verify(!cache.Unpin(overBudgetEntry));
+
+        // unpin in order 3, 1, 0, 2...: least recently used goes first
+        const uint32_t unpinOrder[] = { 3, 1, 0, 2, 4, 5, 6, 7 };
+        for (uint32_t i : unpinOrder)
+        {
+            test_verify(cache.Unpin(entries[i]));
+        }
+
+        // ...except when it's used again
+        test_verify(cache.Pin(entries[1]));
+        test_verify(cache.Unpin(entries[1]));
+
+        const StreamingMemoryCache::EntryID newEntry1 = cache.Allocate(kTileSize);
+        test_verify(!cache.IsResident(entries[3]));
+        test_verify(cache.m_NumEvictions == 1 && cache.m_NumEvictedBytes == kTileSize);
+
+        const StreamingMemoryCache::EntryID newEntry2 = cache.Allocate(kTileSize * 2);
+        test_verify(!cache.IsResident(entries[0]) && !cache.IsResident(entries[2]));
+        test_verify(cache.IsResident(entries[1]));
+        test_verify(cache.m_NumEvictions == 3);
+        test_verify(cache.GetResidentBytes() <= cache.GetBudget());
+
+        // stale IDs stay stale when their entry slot is reused
+        test_verify(!cache.Pin(entries[3]));
+        test_verify(!cache.IsResident(entries[0]) && !cache.IsResident(entries[2]) && !cache.IsResident(entries[3]));
+
+        // pinned entries are never evicted
+        test_verify(cache.Pin(entries[1]));
+        cache.SetBudget(kTileSize * 2);
+        test_verify(cache.IsResident(entries[1]) && cache.IsResident(newEntry1) && cache.IsResident(newEntry2));
+        test_verify(!cache.IsResident(entries[4]) && !cache.IsResident(entries[7]));
+        test_verify(cache.GetNumResidentEntries() == 3);
+
+        test_verify(cache.Unpin(entries[1]));
+        test_verify(cache.Unpin(newEntry1));
+        test_verify(cache.Unpin(newEntry2));
+        cache.SetBudget(0);
+        test_verify(cache.GetNumResidentEntries() == 0);
+        test_verify(cache.GetResidentBytes() == 0);
+
+        cache.Shutdown();
+    }
+
+    // random churn: the budget holds whenever pinned entries fit, & data survives until evicted
+    {
+        const uint64_t kBudget = MB_TO_BYTES(4);
+
+        StreamingMemoryCache cache;
+        cache.Initialize(kBudget);
+
+        struct Owner
+        {
+            StreamingMemoryCache::EntryID m_EntryID = StreamingMemoryCache::kInvalidEntryID;
+            uint32_t m_NumPins = 0;
+            std::byte m_Pattern;
+        };
+        std::vector<Owner> owners(256);
+
+        std::mt19937 rng{ 42 };
+        uint32_t numHits = 0;
+        uint32_t numMisses = 0;
+        for (uint32_t i = 0; i < 20000; ++i)
+        {
+            const uint32_t ownerIdx = std::uniform_int_distribution<uint32_t>{ 0, (uint32_t)owners.size() - 1 }(rng);
+            Owner& owner = owners[ownerIdx];
+
+            if (cache.IsResident(owner.m_EntryID))
+            {
+                test_verify(cache.GetData(owner.m_EntryID)[cache.GetSize(owner.m_EntryID) - 1] == owner.m_Pattern);
+
+                if (owner.m_NumPins > 0 && (rng() % 2))
+                {
+                    test_verify(cache.Unpin(owner.m_EntryID));
+                    --owner.m_NumPins;
+                }
+                else if (owner.m_NumPins < 2)
+                {
+                    test_verify(cache.Pin(owner.m_EntryID));
+                    ++owner.m_NumPins;
+                    ++numHits;
+                }
+            }
+            else
+            {
+                test_verify(owner.m_NumPins == 0); // pinned entries are never evicted
+
+                const uint32_t size = std::uniform_int_distribution<uint32_t>{ 1, kTileSize * 2 }(rng);
+                owner.m_EntryID = cache.Allocate(size);
+                owner.m_NumPins = 1;
+                owner.m_Pattern = (std::byte)(rng() & UINT8_MAX);
+                memset(cache.GetData(owner.m_EntryID), (int)owner.m_Pattern, size);
+                ++numMisses;
+            }
+
+            // keep few pins, so that pinned data fits the budget
+            for (Owner& other : owners)
+            {
+                if (other.m_NumPins > 0 && (rng() % 64) == 0)
+                {
+                    test_verify(cache.Unpin(other.m_EntryID));
+                    --other.m_NumPins;
+                }
+            }
+        }
+
+        test_verify(cache.m_NumEvictions > 0);
+        test_verify(cache.GetPooledBytes() >= cache.GetResidentBytes());
+
+        SDL_Log("Streaming Memory Cache Self Test: %u hits, %u misses, %llu evictions, %.1f MB resident, %.1f MB pooled, %.1f MB peak over budget",
+            numHits, numMisses, (unsigned long long)cache.m_NumEvictions, BYTES_TO_MB(cache.GetResidentBytes()), BYTES_TO_MB(cache.GetPooledBytes()), BYTES_TO_MB(cache.m_PeakOverBudgetBytes));
+
+        cache.Shutdown();
+    }
+
+    // churn of mixed size classes, w/ entries unpinned right after use: pooled bytes never exceed the budget, however fragmented the slabs get
+    {
+        const uint64_t kBudget = MB_TO_BYTES(4);
+
+        StreamingMemoryCache cache;
+        cache.Initialize(kBudget);
+
+        std::vector<StreamingMemoryCache::EntryID> owners(512, StreamingMemoryCache::kInvalidEntryID);
+
+        std::mt19937 rng{ 7 };
+        uint64_t peakPooledBytes = 0;
+        for (uint32_t i = 0; i < 50000; ++i)
+        {
+            StreamingMemoryCache::EntryID& entryID = owners[std::uniform_int_distribution<uint32_t>{ 0, (uint32_t)owners.size() - 1 }(rng)];
+
+            if (cache.Pin(entryID))
+            {
+                test_verify(cache.Unpin(entryID));
+                continue;
+            }
+
+            const uint32_t size = std::uniform_int_distribution<uint32_t>{ 1, kTileSize * 4 }(rng);
+            entryID = cache.Allocate(size);
+            test_verify(cache.Unpin(entryID));
+
+            test_verify(cache.GetPooledBytes() <= kBudget);
+            peakPooledBytes = std::max(peakPooledBytes, cache.GetPooledBytes());
+        }
+
+        test_verify(cache.m_NumEvictions > 0);
+        test_verify(cache.m_PeakOverBudgetBytes == 0);
+
+        SDL_Log("Streaming Memory Cache Self Test [churn]: %llu evictions, %.1f MB resident, %.1f MB peak pooled, %.1f MB budget",
+            (unsigned long long)cache.m_NumEvictions, BYTES_TO_MB(cache.GetResidentBytes()), BYTES_TO_MB(peakPooledBytes), BYTES_TO_MB(kBudget));
+
+        cache.Shutdown();
+    }
+}
+REGISTER_HEADLESS_RUN("streamingmemorycacheselftest", HeadlessRunType::SelfTest, RunStreamingMemoryCacheSelfTest);
@@ -0,0 +1,134 @@
+#pragma once
+
+// Pool of CPU memory in power of 2 size classes. Each class carves its blocks out of slabs of at least 'slabSize' bytes, so steady state streaming never hits the heap
+// A slab is released once all of its blocks are free, unless it's the only empty slab of its class, to not thrash on a slab boundary
+// NOTE: not thread safe
+class SlabAllocator
+{
+public:
+    struct Slab
+    {
+        std::unique_ptr<std::byte[]> m_Memory;
+        uint32_t m_SizeClassIndex;
+        std::vector<std::byte*> m_FreeBlocks;
+    };
+
+    struct Allocation
+    {
+        std::byte* m_Data = nullptr;
+        Slab* m_Slab = nullptr;
+
+        bool IsValid() const { return m_Data != nullptr; }
+    };
+
+    void Initialize(uint32_t minBlockSize, uint32_t slabSize);
+    void Shutdown();
+
+    Allocation Allocate(uint32_t size);
+    void Free(Allocation& allocation);
+
+    uint32_t GetBlockSize(uint32_t size) const; // size of the block 'Allocate' hands out for 'size' bytes
+    uint64_t GetGrowthBytes(uint32_t size) const; // pooled bytes 'Allocate' would add for 'size' bytes: 0 if its class has a free block, else a new slab
+
+    // releases the empty slab kept by each class. Returns the released bytes
+    uint64_t ReleaseEmptySlabs();
+
+    uint64_t GetAllocatedBytes() const { return m_AllocatedBytes; } // in blocks, so includes rounding to size classes
+    uint64_t GetPooledBytes() const { return m_PooledBytes; }       // in slabs
+    uint32_t GetNumSlabs() const;
+
+private:
+    struct SizeClass
+    {
+        uint32_t m_BlockSize;
+        uint32_t m_BlocksPerSlab;
+        std::vector<std::unique_ptr<Slab>> m_Slabs; // oldest first. Allocations fill older slabs first, so that newer ones drain & get released
+        uint32_t m_NumFreeBlocks = 0; // in all slabs
+        Slab* m_EmptySlab = nullptr;  // the 1 empty slab kept, if any
+    };
+
+    uint32_t GetSizeClassIndex(uint32_t size) const;
+    void ReleaseSlab(SizeClass& sizeClass, Slab* slab);
+
+    uint32_t m_MinBlockSize = 0;
+    uint32_t m_SlabSize = 0;
+    std::vector<SizeClass> m_SizeClasses;
+
+    uint64_t m_AllocatedBytes = 0;
+    uint64_t m_PooledBytes = 0;
+};
+
+// System memory of streamed texture data, under a budget
+// The budget is on pooled bytes, i.e. slabs taken from the system, not on the blocks in use: blocks freed in slabs that still hold others aren't given back
+// Entries are pinned while in use, i.e. while their data is read or waits for upload. Unpinned entries stay cached & are evicted least recently used first,
+// only when an allocation would need a new slab over the budget. Owners keep 'EntryID's & check 'IsResident' before reuse: an evicted entry's ID is never valid again, its data must be re-read
+// If pinned entries alone exceed the budget, allocations still succeed & the overshoot is reported. Device agnostic, see 'RunStreamingMemoryCacheSelfTest'
+// NOTE: not thread safe
+class StreamingMemoryCache
+{
+public:
+    using EntryID = uint64_t; // generation in the high 32 bits, entry index in the low 32 bits
+
+    static const EntryID kInvalidEntryID = 0;
+
+    void Initialize(uint64_t budgetInBytes, uint32_t minBlockSize = KB_TO_BYTES(4), uint32_t slabSize = MB_TO_BYTES(1));
+    void Shutdown();
+
+    void SetBudget(uint64_t budgetInBytes); // evicts down to the new budget
+    uint64_t GetBudget() const { return m_BudgetInBytes; }
+
+    // the new entry is pinned once. Evicts unpinned entries first if needed
+    EntryID Allocate(uint32_t size);
+    void Free(EntryID entryID); // no-op on evicted entries
+
+    bool IsResident(EntryID entryID) const;
+    std::byte* GetData(EntryID entryID) const; // entry must be resident
+    uint32_t GetSize(EntryID entryID) const;
+
+    // pins nest. The last 'Unpin' makes the entry the most recently used. Both are no-ops on evicted or freed entries & return false then
+    bool Pin(EntryID entryID);
+    bool Unpin(EntryID entryID);
+
+    uint64_t GetResidentBytes() const { return m_Allocator.GetAllocatedBytes(); }
+    uint64_t GetPooledBytes() const { return m_Allocator.GetPooledBytes(); }
+    uint32_t GetNumResidentEntries() const { return m_NumResidentEntries; }
+
+    // stats, since 'Initialize'
+    uint64_t m_NumEvictions = 0;
+    uint64_t m_NumEvictedBytes = 0;
+    uint64_t m_PeakOverBudgetBytes = 0; // pooled bytes over budget, when the slabs of pinned entries didn't fit
+
+private:
+    static const uint32_t kInvalidIndex = UINT_MAX;
+
+    struct Entry
+    {
+        SlabAllocator::Allocation m_Allocation;
+        uint32_t m_Size = 0;
+        uint32_t m_Generation = 1;
+        uint32_t m_NumPins = 0;
+        bool m_bInUse = false;
+
+        // LRU list of unpinned entries, least recently used at 'm_LRUHead'
+        uint32_t m_LRUPrev = kInvalidIndex;
+        uint32_t m_LRUNext = kInvalidIndex;
+    };
+
+    Entry* GetEntry(EntryID entryID);
+    const Entry* GetEntry(EntryID entryID) const;
+
+    void LinkLRUTail(uint32_t entryIdx);
+    void UnlinkLRU(uint32_t entryIdx);
+    void ReleaseEntry(uint32_t entryIdx);
+    void EvictToFit(uint32_t incomingSize); // 0: just evict down to the budget
+
+    SlabAllocator m_Allocator;
+    uint64_t m_BudgetInBytes = 0;
+
+    std::vector<Entry> m_Entries;
+    std::vector<uint32_t> m_FreeEntryIndices;
+    uint32_t m_NumResidentEntries = 0;
+
+    uint32_t m_LRUHead = kInvalidIndex;
+    uint32_t m_LRUTail = kInvalidIndex;
+};
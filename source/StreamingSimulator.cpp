@@ -0,0 +1,388 @@
+#include "extern/nvidia/RTXTS-TTM/include/rtxts-ttm/TiledTextureManager.h"
+
+#include "EngineCore.h"
+#include "FeedbackTrace.h"
+#include "HeadlessRuns.h"
+#include "StreamingMemoryCache.h"
+#include "TileUploadScheduler.h"
+#include "Utilities.h"
+
+extern CommandLineOption<int> g_StreamingMemoryBudgetMB;
+extern CommandLineOption<int> g_TileUploadBudgetMB;
+
+CommandLineOption<int> g_StreamingSimulatorReadMBPerFrame{ "streamingsimulatorreadmbperframe", 64 };
+CommandLineOption<int> g_StreamingSimulatorNumTilesToDefragment{ "streamingsimulatordefragtiles", 16 };
+
+CommandLineOption<std::string> g_StreamingSimulatorTracePath{ "streamingsimulatortrace", "" };
+
+// Replays a 'FeedbackTrace' through the tiled texture manager, the streaming memory cache & the tile upload scheduler as 'TextureFeedbackManager::BeginFrame' drives them,
+// w/o a device or the texture files: reads are modeled as a queue completing at most "-streamingsimulatorreadmbperframe" per frame, coarser mips first, & uploads only counted
+// Policies come from the same options as the renderer, so that their changes can be compared offline. Writes per frame stats next to the trace, as "<trace>.csv"
+// NOTE: the feedback resolve budget is baked in the trace: each frame replays the feedback of the textures resolved when it was recorded
+static void RunStreamingSimulator(std::string_view tracePath)
+{
+    PROFILE_FUNCTION();
+
+    FeedbackTrace trace;
+    if (!trace.Load(tracePath))
+    {
+        SDL_Log("Streaming Simulator: failed to load feedback trace '%s'", tracePath.data());
+        return;
+    }
+
+    const uint64_t kReadBytesPerFrame = MB_TO_BYTES(g_StreamingSimulatorReadMBPerFrame.Get());
+    const uint32_t kNumTilesToDefragment = g_StreamingSimulatorNumTilesToDefragment.Get();
+    const uint32_t kHeapSizeInBytes = rtxts::TiledTextureManagerDesc{}.heapTilesCapacity * GraphicConstants::kTiledResourceSizeInBytes;
+    const uint32_t kWholeMipTileIndex = UINT_MAX;
+
+    struct SimTileData
+    {
+        StreamingMemoryCache::EntryID m_CacheEntryID = StreamingMemoryCache::kInvalidEntryID;
+        uint64_t m_ReadID = 0; // of its queued read, 0 if none
+        bool m_bDataReady = false;
+    };
+
+    struct SimMip
+    {
+        uint32_t m_FirstTileIndex;
+        std::vector<bool> m_bTilesMapped;
+        std::vector<SimTileData> m_TileDatas; // 1 per tile, or 1 for the whole mip
+    };
+
+    struct SimTexture
+    {
+        const FeedbackTrace::TextureDesc* m_Desc;
+        uint32_t m_TiledTextureID = UINT_MAX;
+        uint32_t m_NumStandardTiles = 0;
+        std::vector<SimMip> m_Mips;
+        std::vector<rtxts::TileCoord> m_TileCoordinates; // copied, to look up tiles w/o the manager
+    };
+
+    struct SimRead
+    {
+        uint32_t m_Priority;
+        uint64_t m_ReadID;
+        uint32_t m_TextureIdx;
+        uint32_t m_Mip;
+        uint32_t m_MipTileIndex; // 'kWholeMipTileIndex' for a whole mip
+        uint32_t m_NumBytes;
+    };
+
+    struct SimUpload
+    {
+        uint32_t m_TextureIdx;
+        uint32_t m_Mip;
+        uint32_t m_MipTileIndex;
+        StreamingMemoryCache::EntryID m_CacheEntryID;
+        uint32_t m_NumBytes;
+    };
+
+    struct FrameStats
+    {
+        uint32_t m_NumFeedbacks = 0;
+        uint32_t m_NumTilesMapped = 0;
+        uint32_t m_NumTilesUnmapped = 0;
+        uint64_t m_NumBytesRead = 0;
+        uint32_t m_NumTilesUploaded = 0;
+        uint64_t m_NumBytesUploaded = 0;
+        uint32_t m_NumUnmetRequests = 0; // mapped tiles still waiting for their data to be read or uploaded
+        uint32_t m_NumHeaps = 0;
+        uint64_t m_StreamingMemoryBytes = 0;
+    };
+
+    std::unique_ptr<rtxts::TiledTextureManager> tiledTextureManager{ rtxts::CreateTiledTextureManager(rtxts::TiledTextureManagerDesc{}) };
+    tiledTextureManager->SetConfig(rtxts::TiledTextureManagerConfig{ 0 }); // no extra standby tiles, as 'TextureFeedbackManager'
+
+    StreamingMemoryCache streamingMemoryCache;
+    streamingMemoryCache.Initialize(MB_TO_BYTES(g_StreamingMemoryBudgetMB.Get()));
+
+    TileUploadScheduler<SimUpload> tileUploadScheduler;
+    tileUploadScheduler.SetConfig({ (uint32_t)MB_TO_BYTES(g_TileUploadBudgetMB.Get()) });
+
+    std::vector<SimTexture> textures(trace.m_Textures.size());
+    std::unordered_map<uint32_t, uint32_t> recordedIDToTextureIdx;
+    for (uint32_t textureIdx = 0; textureIdx < trace.m_Textures.size(); ++textureIdx)
+    {
+        const FeedbackTrace::TextureDesc& textureDesc = trace.m_Textures[textureIdx];
+        SimTexture& texture = textures[textureIdx];
+        texture.m_Desc = &textureDesc;
+
+        rtxts::TiledLevelDesc tiledLevelDescs[16]{};
+        rtxts::TiledTextureDesc tiledTextureDesc{};
+        tiledTextureDesc.textureWidth = textureDesc.m_Width;
+        tiledTextureDesc.textureHeight = textureDesc.m_Height;
+        tiledTextureDesc.tiledLevelDescs = tiledLevelDescs;
+        tiledTextureDesc.regularMipLevelsNum = textureDesc.m_NumStandardMips;
+        tiledTextureDesc.packedMipLevelsNum = textureDesc.m_NumPackedMips;
+        tiledTextureDesc.packedTilesNum = textureDesc.m_NumPackedTiles;
+        tiledTextureDesc.tileWidth = textureDesc.m_TileWidth;
+        tiledTextureDesc.tileHeight = textureDesc.m_TileHeight;
+
+        texture.m_Mips.resize(textureDesc.m_NumStandardMips);
+        for (uint32_t mip = 0; mip < textureDesc.m_NumStandardMips; ++mip)
+        {
+            const FeedbackTrace::Mip& mipDesc = textureDesc.m_Mips[mip];
+            tiledLevelDescs[mip].widthInTiles = mipDesc.m_WidthInTiles;
+            tiledLevelDescs[mip].heightInTiles = mipDesc.m_HeightInTiles;
+
+            const uint32_t numTiles = mipDesc.m_WidthInTiles * mipDesc.m_HeightInTiles;
+
+            SimMip& simMip = texture.m_Mips[mip];
+            simMip.m_FirstTileIndex = texture.m_NumStandardTiles;
+            simMip.m_bTilesMapped.resize(numTiles);
+            simMip.m_TileDatas.resize(textureDesc.m_bReadsWholeMips ? 1 : numTiles);
+
+            texture.m_NumStandardTiles += numTiles;
+        }
+
+        tiledTextureManager->AddTiledTexture(tiledTextureDesc, texture.m_TiledTextureID);
+        texture.m_TileCoordinates = tiledTextureManager->GetTileCoordinates(texture.m_TiledTextureID);
+
+        const rtxts::TextureDesc feedbackDesc = tiledTextureManager->GetTextureDesc(texture.m_TiledTextureID, rtxts::eFeedbackTexture);
+        test_verify(feedbackDesc.textureOrMipRegionWidth == textureDesc.m_FeedbackRegionWidth && feedbackDesc.textureOrMipRegionHeight == textureDesc.m_FeedbackRegionHeight);
+
+        recordedIDToTextureIdx[textureDesc.m_TiledTextureID] = textureIdx;
+    }
+
+    std::vector<SimRead> pendingReads;
+    uint64_t nextReadID = 1;
+
+    std::vector<uint32_t> freeHeapIDs;
+    uint32_t numHeapIDs = 0;
+    uint32_t numHeaps = 0;
+
+    std::vector<uint32_t> tilesToMap;
+    std::vector<uint32_t> tilesToUnmap;
+    std::vector<uint32_t> emptyHeaps;
+    std::vector<SimUpload> scheduledUploads;
+
+    std::vector<FrameStats> frameStats(trace.m_Frames.size());
+
+    Timer timer;
+    for (uint32_t frameIdx = 0; frameIdx < trace.m_Frames.size(); ++frameIdx)
+    {
+        FrameStats& stats = frameStats[frameIdx];
+
+        for (const FeedbackTrace::Feedback& feedback : trace.m_Frames[frameIdx].m_Feedbacks)
+        {
+            const SimTexture& texture = textures.at(recordedIDToTextureIdx.at(feedback.m_TiledTextureID));
+            test_verify(feedback.m_MinMipData.size() == texture.m_Desc->GetNumFeedbackRegions());
+
+            rtxts::SamplerFeedbackDesc samplerFeedbackDesc;
+            samplerFeedbackDesc.pMinMipData = (uint8_t*)feedback.m_MinMipData.data();
+            tiledTextureManager->UpdateWithSamplerFeedback(texture.m_TiledTextureID, samplerFeedbackDesc, 0.0f, 0.0f);
+
+            ++stats.m_NumFeedbacks;
+        }
+
+        tiledTextureManager->TrimStandbyTiles();
+
+        const uint32_t numRequiredHeaps = tiledTextureManager->GetNumDesiredHeaps();
+        if (numRequiredHeaps > numHeaps)
+        {
+            while (numHeaps < numRequiredHeaps)
+            {
+                uint32_t heapID = numHeapIDs;
+                if (freeHeapIDs.empty())
+                {
+                    ++numHeapIDs;
+                }
+                else
+                {
+                    heapID = freeHeapIDs.back();
+                    freeHeapIDs.pop_back();
+                }
+                tiledTextureManager->AddHeap(heapID);
+                ++numHeaps;
+            }
+        }
+        else
+        {
+            tiledTextureManager->GetEmptyHeaps(emptyHeaps);
+            for (uint32_t heapID : emptyHeaps)
+            {
+                tiledTextureManager->RemoveHeap(heapID);
+                freeHeapIDs.push_back(heapID);
+                --numHeaps;
+            }
+        }
+
+        tiledTextureManager->AllocateRequestedTiles();
+
+        for (uint32_t textureIdx = 0; textureIdx < textures.size(); ++textureIdx)
+        {
+            SimTexture& texture = textures[textureIdx];
+
+            tiledTextureManager->GetTilesToMap(texture.m_TiledTextureID, tilesToMap);
+            tiledTextureManager->GetTilesToUnmap(texture.m_TiledTextureID, tilesToUnmap);
+
+            stats.m_NumTilesMapped += (uint32_t)tilesToMap.size();
+            stats.m_NumTilesUnmapped += (uint32_t)tilesToUnmap.size();
+
+            for (uint32_t tileIndex : tilesToUnmap)
+            {
+                if (tileIndex >= texture.m_NumStandardTiles)
+                {
+                    continue; // packed
+                }
+
+                const uint32_t mip = texture.m_TileCoordinates[tileIndex].mipLevel;
+                SimMip& simMip = texture.m_Mips.at(mip);
+                const uint32_t mipTileIndex = tileIndex - simMip.m_FirstTileIndex;
+                simMip.m_bTilesMapped[mipTileIndex] = false;
+
+                // queued tile reads are cancelled, as 'StreamingIO::Cancel' does. The read is dropped when it reaches the front of the queue
+                if (!texture.m_Desc->m_bReadsWholeMips)
+                {
+                    SimTileData& tileData = simMip.m_TileDatas[mipTileIndex];
+                    if (tileData.m_ReadID != 0)
+                    {
+                        streamingMemoryCache.Free(tileData.m_CacheEntryID);
+                        tileData = SimTileData{};
+                    }
+                }
+            }
+
+            if (tilesToMap.empty())
+            {
+                continue;
+            }
+
+            for (uint32_t tileIndex : tilesToMap)
+            {
+                if (tileIndex >= texture.m_NumStandardTiles)
+                {
+                    continue; // packed mips are persistently loaded in memory
+                }
+
+                const uint32_t mip = texture.m_TileCoordinates[tileIndex].mipLevel;
+                const FeedbackTrace::Mip& mipDesc = texture.m_Desc->m_Mips[mip];
+                SimMip& simMip = texture.m_Mips.at(mip);
+                const uint32_t mipTileIndex = tileIndex - simMip.m_FirstTileIndex;
+                simMip.m_bTilesMapped[mipTileIndex] = true;
+
+                SimTileData& tileData = simMip.m_TileDatas[texture.m_Desc->m_bReadsWholeMips ? 0 : mipTileIndex];
+
+                // every mapped tile pins its data until its upload
+                if (!streamingMemoryCache.Pin(tileData.m_CacheEntryID))
+                {
+                    tileData.m_CacheEntryID = streamingMemoryCache.Allocate(mipDesc.m_ReadNumBytes);
+                    tileData.m_bDataReady = false;
+                    tileData.m_ReadID = nextReadID++;
+
+                    const uint32_t readTileIndex = texture.m_Desc->m_bReadsWholeMips ? kWholeMipTileIndex : mipTileIndex;
+                    pendingReads.push_back({ GraphicConstants::kMaxTextureMips - mip, tileData.m_ReadID, textureIdx, mip, readTileIndex, mipDesc.m_ReadNumBytes });
+                }
+
+                tileUploadScheduler.Enqueue({ mip, (float)tilesToMap.size(), mipDesc.m_UploadNumBytes, { textureIdx, mip, mipTileIndex, tileData.m_CacheEntryID, mipDesc.m_UploadNumBytes } });
+            }
+        }
+
+        tiledTextureManager->DefragmentTiles(kNumTilesToDefragment);
+
+        for (SimTexture& texture : textures)
+        {
+            tiledTextureManager->GetTilesToMap(texture.m_TiledTextureID, tilesToMap);
+            if (!tilesToMap.empty())
+            {
+                tiledTextureManager->UpdateTilesMapping(texture.m_TiledTextureID, tilesToMap);
+            }
+        }
+
+        // reads complete in priority order, then enqueue order, until the frame's read bandwidth is spent
+        std::stable_sort(pendingReads.begin(), pendingReads.end(), [](const SimRead& lhs, const SimRead& rhs) { return lhs.m_Priority > rhs.m_Priority; });
+
+        uint64_t numBytesReadThisFrame = 0;
+        uint32_t numReadsDone = 0;
+        for (const SimRead& read : pendingReads)
+        {
+            if (numBytesReadThisFrame >= kReadBytesPerFrame)
+            {
+                break;
+            }
+            ++numReadsDone;
+
+            SimMip& simMip = textures[read.m_TextureIdx].m_Mips[read.m_Mip];
+            SimTileData& tileData = simMip.m_TileDatas[(read.m_MipTileIndex == kWholeMipTileIndex) ? 0 : read.m_MipTileIndex];
+            if (tileData.m_ReadID != read.m_ReadID)
+            {
+                continue; // cancelled
+            }
+
+            tileData.m_bDataReady = true;
+            tileData.m_ReadID = 0;
+            numBytesReadThisFrame += read.m_NumBytes;
+        }
+        pendingReads.erase(pendingReads.begin(), pendingReads.begin() + numReadsDone);
+        stats.m_NumBytesRead = numBytesReadThisFrame;
+
+        auto GetUploadState = [&](const SimUpload& upload)
+            {
+                if (!streamingMemoryCache.IsResident(upload.m_CacheEntryID))
+                {
+                    return TileUploadScheduler<SimUpload>::UploadState::Dropped;
+                }
+
+                const SimMip& simMip = textures[upload.m_TextureIdx].m_Mips[upload.m_Mip];
+                const SimTileData& tileData = simMip.m_TileDatas[(simMip.m_TileDatas.size() == 1) ? 0 : upload.m_MipTileIndex];
+                return tileData.m_bDataReady ? TileUploadScheduler<SimUpload>::UploadState::Ready : TileUploadScheduler<SimUpload>::UploadState::NotReady;
+            };
+
+        scheduledUploads.clear();
+        tileUploadScheduler.ScheduleFrame(GetUploadState, scheduledUploads);
+
+        for (const SimUpload& upload : scheduledUploads)
+        {
+            if (textures[upload.m_TextureIdx].m_Mips[upload.m_Mip].m_bTilesMapped[upload.m_MipTileIndex])
+            {
+                ++stats.m_NumTilesUploaded;
+                stats.m_NumBytesUploaded += upload.m_NumBytes;
+            }
+
+            streamingMemoryCache.Unpin(upload.m_CacheEntryID);
+        }
+
+        stats.m_NumUnmetRequests = tileUploadScheduler.GetNumPendingUploads();
+        stats.m_NumHeaps = numHeaps;
+        stats.m_StreamingMemoryBytes = streamingMemoryCache.GetResidentBytes();
+    }
+    const float elapsedMs = timer.GetElapsedMilliseconds();
+
+    const std::string csvFilePath = std::filesystem::path{ tracePath }.replace_extension(".csv").string();
+    {
+        ScopedFile f{ csvFilePath, "w" };
+        fprintf(f, "Frame,Feedbacks,TilesMapped,TilesUnmapped,BytesRead,TilesUploaded,BytesUploaded,UnmetRequests,Heaps,StreamingMemoryBytes\n");
+        for (uint32_t frameIdx = 0; frameIdx < frameStats.size(); ++frameIdx)
+        {
+            const FrameStats& stats = frameStats[frameIdx];
+            fprintf(f, "%u,%u,%u,%u,%llu,%u,%llu,%u,%u,%llu\n", frameIdx, stats.m_NumFeedbacks, stats.m_NumTilesMapped, stats.m_NumTilesUnmapped, (unsigned long long)stats.m_NumBytesRead,
+                stats.m_NumTilesUploaded, (unsigned long long)stats.m_NumBytesUploaded, stats.m_NumUnmetRequests, stats.m_NumHeaps, (unsigned long long)stats.m_StreamingMemoryBytes);
+        }
+    }
+
+    FrameStats totals;
+    uint32_t peakNumHeaps = 0;
+    uint32_t peakNumUnmetRequests = 0;
+    uint32_t numFramesWithUnmetRequests = 0;
+    for (const FrameStats& stats : frameStats)
+    {
+        totals.m_NumTilesMapped += stats.m_NumTilesMapped;
+        totals.m_NumTilesUnmapped += stats.m_NumTilesUnmapped;
+        totals.m_NumBytesRead += stats.m_NumBytesRead;
+        totals.m_NumTilesUploaded += stats.m_NumTilesUploaded;
+        totals.m_NumBytesUploaded += stats.m_NumBytesUploaded;
+        peakNumHeaps = std::max(peakNumHeaps, stats.m_NumHeaps);
+        peakNumUnmetRequests = std::max(peakNumUnmetRequests, stats.m_NumUnmetRequests);
+        numFramesWithUnmetRequests += (stats.m_NumUnmetRequests > 0) ? 1 : 0;
+    }
+
+    SDL_Log("Streaming Simulator [%u textures, %u frames, %d MB memory budget, %d MB upload budget, %d MB read per frame, %u tiles defragmented]: "
+        "%u tiles mapped, %u unmapped, %.0f MB read, %u tiles uploaded (%.0f MB), unmet requests in %u frames (peak %u), peak %u heaps (%.0f MB), %llu evictions. Simulated in %.1f ms, stats in '%s'",
+        (uint32_t)textures.size(), (uint32_t)frameStats.size(), g_StreamingMemoryBudgetMB.Get(), g_TileUploadBudgetMB.Get(), g_StreamingSimulatorReadMBPerFrame.Get(), kNumTilesToDefragment,
+        totals.m_NumTilesMapped, totals.m_NumTilesUnmapped, BYTES_TO_MB(totals.m_NumBytesRead), totals.m_NumTilesUploaded, BYTES_TO_MB(totals.m_NumBytesUploaded),
+        numFramesWithUnmetRequests, peakNumUnmetRequests, peakNumHeaps, BYTES_TO_MB((uint64_t)peakNumHeaps * kHeapSizeInBytes), (unsigned long long)streamingMemoryCache.m_NumEvictions,
+        elapsedMs, csvFilePath.c_str());
+
+    streamingMemoryCache.Shutdown();
+}
+REGISTER_HEADLESS_RUN("streamingsimulator", HeadlessRunType::Tool, [] { RunStreamingSimulator(g_StreamingSimulatorTracePath.Get()); });
@@ -270,9 +270,9 @@ public:
 
         renderGraph.CreateTransientResource(g_AntiAliasedLightingOutputRDGTextureHandle, desc);
 
-        renderGraph.AddReadDependency(g_LightingOutputRDGTextureHandle);
-        renderGraph.AddReadDependency(g_DepthBufferCopyRDGTextureHandle);
-        renderGraph.AddReadDependency(g_GBufferMotionRDGTextureHandle);
+        renderGraph.AddReadDependency(g_LightingOutputRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
+        renderGraph.AddReadDependency(g_DepthBufferCopyRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
+        renderGraph.AddReadDependency(g_GBufferMotionRDGTextureHandle, nvrhi::ResourceStates::ShaderResource);
 
         return true;
     }
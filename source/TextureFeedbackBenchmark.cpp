@@ -0,0 +1,223 @@
+#include "TextureFeedbackManager.h"
+
+#include "Engine.h"
+#include "HeadlessRuns.h"
+#include "MathUtilities.h"
+#include "Utilities.h"
+
+CommandLineOption<int> g_TextureFeedbackBenchmarkNumTextures{ "texturefeedbackbenchmarktextures", 10000 };
+
+// Drives a tiled texture manager w/ synthetic sampler feedback for 'numTextures' textures, each frame focused on a different spot of every texture so that tiles keep getting mapped & unmapped
+// Times the per texture work 'TextureFeedbackManager::BeginFrame' does on the manager's results: tile (un)mapping lists & their grouping per heap, w/ 'TextureTileMappings'
+// Built on the calling thread vs in parallel on the executor, as 'BeginFrame' does
+// NOTE: no device. Streaming, uploads & the 'updateTextureTileMappings' calls themselves are left out
+static void RunTextureFeedbackBenchmark(uint32_t numTextures)
+{
+    PROFILE_FUNCTION();
+
+    const uint32_t kNumFrames = 32;
+    const uint32_t kTextureSize = 2048;
+    const uint32_t kTileSize = 256;      // 64 KB tiles of BC7
+    const uint32_t kNumStandardMips = 4; // 8x8 down to 1x1 tiles
+    const uint32_t kNumPackedMips = 8;
+    const uint32_t kNumMips = kNumStandardMips + kNumPackedMips;
+    const uint32_t kNumWorkerThreads = 8;
+
+    struct BenchmarkTexture
+    {
+        uint32_t m_TiledTextureID = UINT_MAX;
+        std::vector<uint32_t> m_TilesToMap;
+        std::vector<uint32_t> m_TilesToUnmap;
+        const std::vector<rtxts::TileCoord>* m_TileCoordinates = nullptr;
+        const std::vector<rtxts::TileAllocation>* m_TileAllocations = nullptr;
+        TextureTileMappings m_Mappings;
+    };
+
+    struct RunResult
+    {
+        float m_ElapsedMs = 0.0f;
+        uint64_t m_NumMappedRegions = 0;
+        uint64_t m_NumUnmappedRegions = 0;
+        uint64_t m_NumHeapMappings = 0;
+    };
+
+    auto Run = [&](bool bParallel, tf::Executor& executor)
+        {
+            std::unique_ptr<rtxts::TiledTextureManager> tiledTextureManager{ rtxts::CreateTiledTextureManager(rtxts::TiledTextureManagerDesc{}) };
+            tiledTextureManager->SetConfig(rtxts::TiledTextureManagerConfig{ 0 });
+
+            std::vector<BenchmarkTexture> textures(numTextures);
+            for (BenchmarkTexture& texture : textures)
+            {
+                rtxts::TiledLevelDesc tiledLevelDescs[16]{};
+                rtxts::TiledTextureDesc tiledTextureDesc{};
+                tiledTextureDesc.textureWidth = kTextureSize;
+                tiledTextureDesc.textureHeight = kTextureSize;
+                tiledTextureDesc.tiledLevelDescs = tiledLevelDescs;
+                tiledTextureDesc.regularMipLevelsNum = kNumStandardMips;
+                tiledTextureDesc.packedMipLevelsNum = kNumPackedMips;
+                tiledTextureDesc.packedTilesNum = 1;
+                tiledTextureDesc.tileWidth = kTileSize;
+                tiledTextureDesc.tileHeight = kTileSize;
+
+                for (uint32_t i = 0; i < kNumStandardMips; ++i)
+                {
+                    tiledLevelDescs[i].widthInTiles = (kTextureSize >> i) / kTileSize;
+                    tiledLevelDescs[i].heightInTiles = (kTextureSize >> i) / kTileSize;
+                }
+
+                tiledTextureManager->AddTiledTexture(tiledTextureDesc, texture.m_TiledTextureID);
+            }
+
+            const rtxts::TextureDesc feedbackDesc = tiledTextureManager->GetTextureDesc(textures[0].m_TiledTextureID, rtxts::eFeedbackTexture);
+            const uint32_t numRegionsX = DivideAndRoundUp(kTextureSize, feedbackDesc.textureOrMipRegionWidth);
+            const uint32_t numRegionsY = DivideAndRoundUp(kTextureSize, feedbackDesc.textureOrMipRegionHeight);
+            std::vector<uint8_t> minMipData(numRegionsX * numRegionsY);
+
+            std::vector<uint32_t> freeHeapIDs;
+            uint32_t numHeapIDs = 0;
+
+            std::vector<uint32_t> dirtyTextureIndices;
+            std::vector<uint32_t> texturesWithTilesToMap;
+
+            RunResult result;
+            for (uint32_t frame = 0; frame < kNumFrames; ++frame)
+            {
+                // finest mip at a random spot of each texture, 1 mip coarser every few regions away from it. Same feedback for both runs
+                for (uint32_t textureIdx = 0; textureIdx < numTextures; ++textureIdx)
+                {
+                    std::minstd_rand rng{ frame * 7919 + textureIdx + 1 };
+                    const int32_t focusX = rng() % numRegionsX;
+                    const int32_t focusY = rng() % numRegionsY;
+                    const int32_t regionsPerMip = 1 + rng() % 3;
+
+                    for (uint32_t y = 0; y < numRegionsY; ++y)
+                    {
+                        for (uint32_t x = 0; x < numRegionsX; ++x)
+                        {
+                            const int32_t distance = std::max(std::abs((int32_t)x - focusX), std::abs((int32_t)y - focusY));
+                            minMipData[y * numRegionsX + x] = (uint8_t)std::min<int32_t>(distance / regionsPerMip, kNumMips - 1);
+                        }
+                    }
+
+                    rtxts::SamplerFeedbackDesc samplerFeedbackDesc;
+                    samplerFeedbackDesc.pMinMipData = minMipData.data();
+                    tiledTextureManager->UpdateWithSamplerFeedback(textures[textureIdx].m_TiledTextureID, samplerFeedbackDesc, 0.0f, 0.0f);
+                }
+
+                tiledTextureManager->TrimStandbyTiles();
+
+                const uint32_t numRequiredHeaps = tiledTextureManager->GetNumDesiredHeaps();
+                while (numHeapIDs - (uint32_t)freeHeapIDs.size() < numRequiredHeaps)
+                {
+                    uint32_t heapID = numHeapIDs;
+                    if (freeHeapIDs.empty())
+                    {
+                        ++numHeapIDs;
+                    }
+                    else
+                    {
+                        heapID = freeHeapIDs.back();
+                        freeHeapIDs.pop_back();
+                    }
+                    tiledTextureManager->AddHeap(heapID);
+                }
+
+                std::vector<uint32_t> emptyHeaps;
+                tiledTextureManager->GetEmptyHeaps(emptyHeaps);
+                for (uint32_t heapID : emptyHeaps)
+                {
+                    tiledTextureManager->RemoveHeap(heapID);
+                    freeHeapIDs.push_back(heapID);
+                }
+
+                tiledTextureManager->AllocateRequestedTiles();
+
+                Timer timer;
+
+                // per texture work, independent across textures
+                auto ForEachTexture = [&](std::span<const uint32_t> textureIndices, auto&& func)
+                    {
+                        if (!bParallel)
+                        {
+                            for (uint32_t textureIdx : textureIndices)
+                            {
+                                func(textures[textureIdx]);
+                            }
+                            return;
+                        }
+
+                        tf::Taskflow tf;
+                        tf.for_each_index(0u, (uint32_t)textureIndices.size(), 1u, [&](uint32_t i) { func(textures[textureIndices[i]]); });
+                        executor.corun(tf);
+                    };
+
+                // as 'BeginFrame': manager calls on this thread, per texture work through 'ForEachTexture'
+                dirtyTextureIndices.clear();
+                for (uint32_t textureIdx = 0; textureIdx < numTextures; ++textureIdx)
+                {
+                    BenchmarkTexture& texture = textures[textureIdx];
+                    tiledTextureManager->GetTilesToMap(texture.m_TiledTextureID, texture.m_TilesToMap);
+                    tiledTextureManager->GetTilesToUnmap(texture.m_TiledTextureID, texture.m_TilesToUnmap);
+
+                    if (!texture.m_TilesToUnmap.empty() || !texture.m_TilesToMap.empty())
+                    {
+                        texture.m_TileCoordinates = &tiledTextureManager->GetTileCoordinates(texture.m_TiledTextureID);
+                        dirtyTextureIndices.push_back(textureIdx);
+                    }
+                }
+
+                ForEachTexture(dirtyTextureIndices, [](BenchmarkTexture& texture) { texture.m_Mappings.BuildUnmappings(texture.m_TilesToUnmap, *texture.m_TileCoordinates); });
+
+                texturesWithTilesToMap.clear();
+                for (uint32_t textureIdx : dirtyTextureIndices)
+                {
+                    BenchmarkTexture& texture = textures[textureIdx];
+                    result.m_NumUnmappedRegions += texture.m_Mappings.m_UnmapCoordinates.size();
+
+                    if (!texture.m_TilesToMap.empty())
+                    {
+                        tiledTextureManager->UpdateTilesMapping(texture.m_TiledTextureID, texture.m_TilesToMap);
+                        texture.m_TileAllocations = &tiledTextureManager->GetTileAllocations(texture.m_TiledTextureID);
+                        texturesWithTilesToMap.push_back(textureIdx);
+                    }
+                }
+
+                ForEachTexture(texturesWithTilesToMap, [](BenchmarkTexture& texture) { texture.m_Mappings.BuildMappings(texture.m_TilesToMap, *texture.m_TileCoordinates, *texture.m_TileAllocations); });
+
+                for (uint32_t textureIdx : texturesWithTilesToMap)
+                {
+                    const TextureTileMappings& mappings = textures[textureIdx].m_Mappings;
+                    result.m_NumMappedRegions += mappings.m_MapCoordinates.size();
+                    result.m_NumHeapMappings += mappings.m_MapHeapRanges.size();
+                }
+
+                result.m_ElapsedMs += timer.GetElapsedMilliseconds();
+            }
+
+            return result;
+        };
+
+    tf::Executor executor{ kNumWorkerThreads };
+
+    // 'corun' must be called from a worker, as 'BeginFrame' is
+    RunResult serialResult;
+    RunResult parallelResult;
+    tf::Taskflow taskflow;
+    taskflow.emplace([&]
+        {
+            serialResult = Run(false, executor);
+            parallelResult = Run(true, executor);
+        });
+    executor.run(taskflow).wait();
+
+    // same feedback, so the same tiles must be (un)mapped
+    test_verify(serialResult.m_NumMappedRegions == parallelResult.m_NumMappedRegions);
+    test_verify(serialResult.m_NumUnmappedRegions == parallelResult.m_NumUnmappedRegions);
+    test_verify(serialResult.m_NumHeapMappings == parallelResult.m_NumHeapMappings);
+
+    SDL_Log("Texture Feedback Benchmark [%u textures, %u frames, %llu tiles mapped, %llu unmapped, %llu heap mappings]: serial %.1f ms, parallel %.1f ms on %u threads (%.1fx)",
+        numTextures, kNumFrames, (unsigned long long)parallelResult.m_NumMappedRegions, (unsigned long long)parallelResult.m_NumUnmappedRegions, (unsigned long long)parallelResult.m_NumHeapMappings,
+        serialResult.m_ElapsedMs, parallelResult.m_ElapsedMs, kNumWorkerThreads, serialResult.m_ElapsedMs / std::max(parallelResult.m_ElapsedMs, 1e-6f));
+}
+REGISTER_HEADLESS_RUN("texturefeedbackbenchmark", HeadlessRunType::Benchmark, [] { RunTextureFeedbackBenchmark(g_TextureFeedbackBenchmarkNumTextures.Get()); });
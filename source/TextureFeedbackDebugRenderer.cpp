@@ -113,7 +113,7 @@ public:
                 fullScreenPassParams.m_CommandList = commandList;
                 fullScreenPassParams.m_FrameBufferDesc = frameBufferDesc;
                 fullScreenPassParams.m_BindingSetDesc = bindingSetDesc;
-                fullScreenPassParams.m_ShaderName = "fullscreen_PS_Passthrough";
+                fullScreenPassParams.m_ShaderID = "fullscreen_PS_Passthrough";
                 fullScreenPassParams.m_ViewPort = &viewport;
 
                 g_Graphic.AddFullScreenPass(fullScreenPassParams);
@@ -147,7 +147,7 @@ public:
                     fullScreenPassParams.m_CommandList = commandList;
                     fullScreenPassParams.m_FrameBufferDesc = frameBufferDesc;
                     fullScreenPassParams.m_BindingSetDesc = bindingSetDesc;
-                    fullScreenPassParams.m_ShaderName = "visualizeminmip_PS_VisualizeMinMip";
+                    fullScreenPassParams.m_ShaderID = "visualizeminmip_PS_VisualizeMinMip";
                     fullScreenPassParams.m_ViewPort = &viewport;
                     fullScreenPassParams.m_PushConstantsData = &passParameters;
                     fullScreenPassParams.m_PushConstantsBytes = sizeof(passParameters);
@@ -161,7 +161,7 @@ public:
 
                 nvrhi::TextureHandle feedbackTextureHandle = renderGraph.GetTexture(m_FeedbackTextureHandle);
 
-                nvrhi::BufferHandle resolveBuffer = texture.m_FeedbackResolveBuffers[g_Graphic.m_FrameCounter % 2];
+                nvrhi::BufferHandle resolveBuffer = texture.m_FeedbackResolveBuffers[g_Graphic.GetFrameSlot()];
                 void* pReadbackData = device->mapBuffer(resolveBuffer, nvrhi::CpuAccessMode::Read);
 
                 std::vector<uint8_t> feedbackData;
@@ -5,7 +5,155 @@
 #include "Engine.h"
 #include "Graphic.h"
 #include "Scene.h"
-#include "TextureLoading.h"
+
+extern CommandLineOption<int> g_StreamingMemoryBudgetMB;
+extern CommandLineOption<int> g_TileUploadBudgetMB;
+
+CommandLineOption<std::string> g_RecordFeedbackTracePath{ "recordfeedbacktrace", "" };
+CommandLineOption<bool> g_EnableTexturePrefetch{ "textureprefetch", true };
+
+// row-major index of a standard tile in its mip. Same as rtxts tile indices relative to 'TextureMipData::m_FirstTileIndex'
+static uint32_t GetMipTileIndex(const Texture& texture, const FeedbackTextureTileInfo& tile)
+{
+    const uint32_t tileX = tile.m_XInTexels / texture.m_TileShape.widthInTexels;
+    const uint32_t tileY = tile.m_YInTexels / texture.m_TileShape.heightInTexels;
+    return tileY * texture.m_TilingsInfo.at(tile.m_Mip).widthInTiles + tileX;
+}
+
+// tiles of a standard mip read whole from the DDS. The texture's tile shape matches 'TiledTextureFile::GetStandardTileShapeInBlocks'
+static MipTileLayout GetMipTileLayout(const Texture& texture, uint32_t mip)
+{
+    const nvrhi::FormatInfo& formatInfo = nvrhi::getFormatInfo(texture.m_NVRHITextureHandle->getDesc().format);
+    const TextureMipData& mipData = texture.m_TextureMipDatas.at(mip);
+
+    MipTileLayout layout;
+    layout.m_WidthInBlocks = mipData.m_RowPitch / formatInfo.bytesPerBlock;
+    layout.m_HeightInBlocks = mipData.m_NumBytes / mipData.m_RowPitch;
+    layout.m_TileWidthInBlocks = texture.m_TileShape.widthInTexels / formatInfo.blockSize;
+    layout.m_TileHeightInBlocks = texture.m_TileShape.heightInTexels / formatInfo.blockSize;
+    layout.m_BytesPerBlock = formatInfo.bytesPerBlock;
+    return layout;
+}
+
+static uint32_t GetTileUploadNumBytes(const Texture& texture, const FeedbackTextureTileInfo& tile)
+{
+    const nvrhi::FormatInfo& formatInfo = nvrhi::getFormatInfo(texture.m_NVRHITextureHandle->getDesc().format);
+    return DivideAndRoundUp(tile.m_WidthInTexels, formatInfo.blockSize) * DivideAndRoundUp(tile.m_HeightInTexels, formatInfo.blockSize) * formatInfo.bytesPerBlock;
+}
+
+// 'StreamingIO' user data of a read: texture, mip & tile in the mip, or 'kWholeMipReadTileIndex' for a whole mip read from the DDS
+static const uint32_t kWholeMipReadTileIndex = 0xFFFFFF;
+
+static uint64_t PackReadUserData(uint32_t textureIdx, uint32_t mip, uint32_t mipTileIndex)
+{
+    check(mip <= UINT8_MAX);
+    check(mipTileIndex <= kWholeMipReadTileIndex);
+    return ((uint64_t)textureIdx << 32) | (mip << 24) | mipTileIndex;
+}
+
+static void UnpackReadUserData(uint64_t userData, uint32_t& outTextureIdx, uint32_t& outMip, uint32_t& outMipTileIndex)
+{
+    outTextureIdx = (uint32_t)(userData >> 32);
+    outMip = (uint32_t)(userData >> 24) & UINT8_MAX;
+    outMipTileIndex = (uint32_t)userData & kWholeMipReadTileIndex;
+}
+
+// coarser mips first: finer mips are of no use until the mips they fall back to are resident
+// prefetch reads go after all others
+static uint32_t GetReadPriority(uint32_t mip, bool bPrefetch)
+{
+    return bPrefetch ? 0 : GraphicConstants::kMaxTextureMips - mip;
+}
+
+void TextureTileMappings::BuildUnmappings(std::span<const uint32_t> tilesToUnmap, const std::vector<rtxts::TileCoord>& tileCoordinates)
+{
+    m_UnmapCoordinates.clear();
+    m_UnmapRegions.clear();
+
+    for (uint32_t tileIndex : tilesToUnmap)
+    {
+        nvrhi::TiledTextureCoordinate& tiledTextureCoordinate = m_UnmapCoordinates.emplace_back();
+        tiledTextureCoordinate.mipLevel = tileCoordinates[tileIndex].mipLevel;
+        tiledTextureCoordinate.arrayLevel = 0;
+        tiledTextureCoordinate.x = tileCoordinates[tileIndex].x;
+        tiledTextureCoordinate.y = tileCoordinates[tileIndex].y;
+        tiledTextureCoordinate.z = 0;
+
+        nvrhi::TiledTextureRegion& tiledTextureRegion = m_UnmapRegions.emplace_back();
+        tiledTextureRegion.tilesNum = 1;
+    }
+}
+
+void TextureTileMappings::BuildMappings(std::span<const uint32_t> tilesToMap, const std::vector<rtxts::TileCoord>& tileCoordinates, const std::vector<rtxts::TileAllocation>& tileAllocations)
+{
+    // sort by heap rather than bucket in a map, so that nothing is allocated once the arrays have grown
+    m_SortedTilesToMap.assign(tilesToMap.begin(), tilesToMap.end());
+    std::sort(m_SortedTilesToMap.begin(), m_SortedTilesToMap.end(), [&tileAllocations](uint32_t lhs, uint32_t rhs)
+        {
+            return (tileAllocations[lhs].heapId != tileAllocations[rhs].heapId) ? (tileAllocations[lhs].heapId < tileAllocations[rhs].heapId) : (lhs < rhs);
+        });
+
+    m_MapCoordinates.clear();
+    m_MapRegions.clear();
+    m_MapByteOffsets.clear();
+    m_MapHeapRanges.clear();
+
+    for (uint32_t tileIndex : m_SortedTilesToMap)
+    {
+        const rtxts::TileAllocation& tileAllocation = tileAllocations[tileIndex];
+        if (m_MapHeapRanges.empty() || m_MapHeapRanges.back().m_HeapID != tileAllocation.heapId)
+        {
+            m_MapHeapRanges.push_back({ tileAllocation.heapId, (uint32_t)m_MapCoordinates.size(), 0 });
+        }
+        ++m_MapHeapRanges.back().m_NumRegions;
+
+        nvrhi::TiledTextureCoordinate& tiledTextureCoordinate = m_MapCoordinates.emplace_back();
+        tiledTextureCoordinate.mipLevel = tileCoordinates[tileIndex].mipLevel;
+        tiledTextureCoordinate.x = tileCoordinates[tileIndex].x;
+        tiledTextureCoordinate.y = tileCoordinates[tileIndex].y;
+        tiledTextureCoordinate.z = 0;
+
+        nvrhi::TiledTextureRegion& tiledTextureRegion = m_MapRegions.emplace_back();
+        tiledTextureRegion.tilesNum = 1;
+
+        m_MapByteOffsets.push_back((uint64_t)tileAllocation.heapTileIndex * GraphicConstants::kTiledResourceSizeInBytes);
+    }
+}
+
+static FeedbackTrace::TextureDesc GetFeedbackTraceTextureDesc(const Texture& texture, const rtxts::TiledTextureDesc& tiledTextureDesc, const rtxts::TextureDesc& feedbackDesc)
+{
+    const nvrhi::FormatInfo& formatInfo = nvrhi::getFormatInfo(texture.m_NVRHITextureHandle->getDesc().format);
+
+    FeedbackTrace::TextureDesc textureDesc;
+    textureDesc.m_TiledTextureID = texture.m_TiledTextureID;
+    textureDesc.m_Width = tiledTextureDesc.textureWidth;
+    textureDesc.m_Height = tiledTextureDesc.textureHeight;
+    textureDesc.m_TileWidth = tiledTextureDesc.tileWidth;
+    textureDesc.m_TileHeight = tiledTextureDesc.tileHeight;
+    textureDesc.m_NumStandardMips = tiledTextureDesc.regularMipLevelsNum;
+    textureDesc.m_NumPackedMips = tiledTextureDesc.packedMipLevelsNum;
+    textureDesc.m_NumPackedTiles = tiledTextureDesc.packedTilesNum;
+    textureDesc.m_FeedbackRegionWidth = feedbackDesc.textureOrMipRegionWidth;
+    textureDesc.m_FeedbackRegionHeight = feedbackDesc.textureOrMipRegionHeight;
+    textureDesc.m_bReadsWholeMips = texture.m_TiledTextureFile.IsValid() ? 0 : 1;
+
+    for (uint32_t mip = 0; mip < textureDesc.m_NumStandardMips; ++mip)
+    {
+        // first tile of the mip, clipped to the mip as 'Texture::GetTileInfo' does
+        const uint32_t mipWidth = AlignUp(std::max(textureDesc.m_Width >> mip, 1u), formatInfo.blockSize);
+        const uint32_t mipHeight = AlignUp(std::max(textureDesc.m_Height >> mip, 1u), formatInfo.blockSize);
+        const uint32_t tileWidth = std::min(textureDesc.m_TileWidth, mipWidth);
+        const uint32_t tileHeight = std::min(textureDesc.m_TileHeight, mipHeight);
+
+        FeedbackTrace::Mip& mipDesc = textureDesc.m_Mips[mip];
+        mipDesc.m_WidthInTiles = tiledTextureDesc.tiledLevelDescs[mip].widthInTiles;
+        mipDesc.m_HeightInTiles = tiledTextureDesc.tiledLevelDescs[mip].heightInTiles;
+        mipDesc.m_ReadNumBytes = texture.m_TiledTextureFile.IsValid() ? texture.m_TiledTextureFile.GetTileNumBytes(mip, 0) : texture.m_TextureMipDatas.at(mip).m_NumBytes;
+        mipDesc.m_UploadNumBytes = (tileWidth / formatInfo.blockSize) * (tileHeight / formatInfo.blockSize) * formatInfo.bytesPerBlock;
+    }
+
+    return textureDesc;
+}
 
 void TextureFeedbackManager::AddTexture(Texture& texture, const rtxts::TiledTextureDesc& tiledTextureDesc, rtxts::TextureDesc& feedbackDesc, rtxts::TextureDesc& minMipDesc)
 {
@@ -13,6 +161,45 @@ void TextureFeedbackManager::AddTexture(Texture& texture, const rtxts::TiledText
     m_TiledTextureManager->AddTiledTexture(tiledTextureDesc, texture.m_TiledTextureID);
     feedbackDesc = m_TiledTextureManager->GetTextureDesc(texture.m_TiledTextureID, rtxts::eFeedbackTexture);
     minMipDesc = m_TiledTextureManager->GetTextureDesc(texture.m_TiledTextureID, rtxts::eMinMipTexture);
+
+    if (m_FeedbackTraceRecorder.IsOpen())
+    {
+        m_FeedbackTraceRecorder.RecordTexture(GetFeedbackTraceTextureDesc(texture, tiledTextureDesc, feedbackDesc));
+    }
+}
+
+void TextureFeedbackManager::InitializeFeedbackSets(std::span<const TextureFeedbackSet> sets)
+{
+    PROFILE_FUNCTION();
+
+    std::vector<uint32_t> primaryTextureIndices;
+    BuildTextureFeedbackFollowers(sets, (uint32_t)g_Graphic.m_Textures.size(), primaryTextureIndices);
+
+    for (Texture& texture : g_Graphic.m_Textures)
+    {
+        texture.m_FeedbackPrimaryTextureIdx = UINT_MAX;
+        texture.m_FeedbackFollowerTextureIndices.clear();
+    }
+
+    uint32_t numFollowers = 0;
+    for (uint32_t textureIdx = 0; textureIdx < primaryTextureIndices.size(); ++textureIdx)
+    {
+        const uint32_t primaryTextureIdx = primaryTextureIndices[textureIdx];
+        if (primaryTextureIdx == UINT_MAX)
+        {
+            continue;
+        }
+
+        Texture& texture = g_Graphic.m_Textures.at(textureIdx);
+        Texture& primaryTexture = g_Graphic.m_Textures.at(primaryTextureIdx);
+        check(texture.m_TiledTextureID != UINT_MAX && primaryTexture.m_TiledTextureID != UINT_MAX);
+
+        texture.m_FeedbackPrimaryTextureIdx = primaryTextureIdx;
+        primaryTexture.m_FeedbackFollowerTextureIndices.push_back(textureIdx);
+        ++numFollowers;
+    }
+
+    SDL_Log("Texture Feedback Sets: %u sets, %u textures follow the feedback of another", (uint32_t)sets.size(), numFollowers);
 }
 
 void TextureFeedbackManager::Initialize()
@@ -22,7 +209,22 @@ void TextureFeedbackManager::Initialize()
 
     m_HeapSizeInBytes = rtxts::TiledTextureManagerDesc{}.heapTilesCapacity * GraphicConstants::kTiledResourceSizeInBytes;
 
-    m_UploadTileScratchBuffer.resize(GraphicConstants::kTiledResourceSizeInBytes);
+    const uint32_t kNumStreamingIOThreads = 4;
+    m_StreamingIO.Initialize(CreateThreadPoolStreamingIOBackend(kNumStreamingIOThreads));
+
+    m_StreamingMemoryBudgetMB = g_StreamingMemoryBudgetMB.Get();
+    m_StreamingMemoryCache.Initialize(MB_TO_BYTES(m_StreamingMemoryBudgetMB));
+
+    m_TileUploadBudgetMB = g_TileUploadBudgetMB.Get();
+    m_TileUploadScheduler.SetConfig({ (uint32_t)MB_TO_BYTES(m_TileUploadBudgetMB) });
+
+    m_bEnableTexturePrefetch = g_EnableTexturePrefetch.Get();
+
+    if (!g_RecordFeedbackTracePath.Get().empty())
+    {
+        verify(m_FeedbackTraceRecorder.Open(g_RecordFeedbackTracePath.Get()));
+        SDL_Log("Recording feedback trace to '%s'", g_RecordFeedbackTracePath.Get().c_str());
+    }
 
     m_PCIEBandwidthHistory.resize(10);
     m_SSDBandwidthHistory.resize(10);
@@ -30,6 +232,15 @@ void TextureFeedbackManager::Initialize()
 
 void TextureFeedbackManager::Shutdown()
 {
+    if (m_FeedbackTraceRecorder.IsOpen())
+    {
+        SDL_Log("Recorded %u frames of feedback trace", m_FeedbackTraceRecorder.GetNumFramesRecorded());
+        m_FeedbackTraceRecorder.Close();
+    }
+
+    m_StreamingIO.Shutdown();
+    m_StreamingMemoryCache.Shutdown();
+    m_TileUploadRing.Shutdown();
     m_TiledTextureManager.reset();
 }
 
@@ -41,8 +252,29 @@ void TextureFeedbackManager::UpdateIMGUI()
     ImGui::Text("Tiles Allocated: %u (%.0f MB)", statistics.allocatedTilesNum, BYTES_TO_MB(statistics.allocatedTilesNum * GraphicConstants::kTiledResourceSizeInBytes));
     ImGui::Text("Heaps: %u (%.2f MB)", m_NumHeaps, BYTES_TO_MB(m_NumHeaps * m_HeapSizeInBytes));
     ImGui::Text("Heap Free Tiles: %d (%.0f MB)", statistics.heapFreeTilesNum, BYTES_TO_MB(statistics.heapFreeTilesNum * GraphicConstants::kTiledResourceSizeInBytes));
+    ImGui::Text("Streaming I/O: %llu requests in %llu reads (%.0f MB), %u queued", (unsigned long long)m_StreamingIO.m_NumRequestsIssued, (unsigned long long)m_StreamingIO.m_NumReadsIssued, BYTES_TO_MB(m_StreamingIO.m_NumBytesRead), m_StreamingIO.GetNumQueuedRequests());
+    ImGui::Text("Streaming Memory: %.0f MB resident (%u entries), %.0f MB pooled, %llu evictions (%.0f MB), %.0f MB peak over budget",
+        BYTES_TO_MB(m_StreamingMemoryCache.GetResidentBytes()), m_StreamingMemoryCache.GetNumResidentEntries(), BYTES_TO_MB(m_StreamingMemoryCache.GetPooledBytes()),
+        (unsigned long long)m_StreamingMemoryCache.m_NumEvictions, BYTES_TO_MB(m_StreamingMemoryCache.m_NumEvictedBytes), BYTES_TO_MB(m_StreamingMemoryCache.m_PeakOverBudgetBytes));
+
+    if (ImGui::SliderInt("Streaming Memory Budget (MB)", &m_StreamingMemoryBudgetMB, 64, 8192))
+    {
+        m_StreamingMemoryCache.SetBudget(MB_TO_BYTES(m_StreamingMemoryBudgetMB));
+    }
+
+    ImGui::Text("Tile Uploads: %u pending, %.1f MB last frame, %llu starved", m_TileUploadScheduler.GetNumPendingUploads(), BYTES_TO_MB(m_TileUploadScheduler.GetLastFrameNumBytesScheduled()), (unsigned long long)m_TileUploadScheduler.m_NumStarvedUploads);
+    ImGui::Text("Tile Upload Staging: %u staging tiles (%.0f MB), %u filled last frame, %u shared tile uploads", m_TileUploadRing.GetNumStagingTiles(), BYTES_TO_MB(m_TileUploadRing.GetNumStagingTiles() * GraphicConstants::kTiledResourceSizeInBytes), m_TileUploadRing.m_NumStagingTilesFilledThisFrame, m_TileUploadRing.m_NumSharedTileUploadsThisFrame);
+
+    if (ImGui::SliderInt("Tile Upload Budget Per Frame (MB)", &m_TileUploadBudgetMB, 1, 128))
+    {
+        TileUploadScheduler<TileUpload>::Config config = m_TileUploadScheduler.GetConfig();
+        config.m_MaxBytesPerFrame = MB_TO_BYTES(m_TileUploadBudgetMB);
+        m_TileUploadScheduler.SetConfig(config);
+    }
 
     ImGui::SliderInt("Feedback Textures to Resolve Per Frame", &m_NumFeedbackTexturesToResolvePerFrame, 1, 32);
+    ImGui::Checkbox("Texture Prefetch", &m_bEnableTexturePrefetch);
+    ImGui::SliderFloat("Texture Prefetch Mip Bias", &m_PrefetchMipBias, 0.0f, 4.0f);
     ImGui::Checkbox("Write Sampler Feedback", &g_Scene->m_bWriteSamplerFeedback);
 
     static uint32_t s_TilesUploadedSoFarThisGraphUpdateInterval = 0;
@@ -97,15 +329,12 @@ void TextureFeedbackManager::PrepareTexturesToProcessThisFrame()
 
     PROFILE_FUNCTION();
 
+    // round-robin over the textures resolving their own feedback. Non-tiled textures & followers don't take a slot
     m_TexturesToProcessThisFrame.clear();
-    for (uint32_t i = 0; i < m_NumFeedbackTexturesToResolvePerFrame; ++i)
+    for (uint32_t i = 0; i < g_Graphic.m_Textures.size() && (int)m_TexturesToProcessThisFrame.size() < m_NumFeedbackTexturesToResolvePerFrame; ++i)
     {
-        const uint32_t textureIdx = (m_ResolveFeedbackTexturesCounter + i) % g_Graphic.m_Textures.size();
-
-        if (!m_TexturesToProcessThisFrame.empty() && m_TexturesToProcessThisFrame[0] == textureIdx)
-        {
-            break;
-        }
+        const uint32_t textureIdx = m_ResolveFeedbackTexturesCounter;
+        m_ResolveFeedbackTexturesCounter = (m_ResolveFeedbackTexturesCounter + 1) % g_Graphic.m_Textures.size();
 
         Texture& texture = g_Graphic.m_Textures.at(textureIdx);
         if (texture.m_TiledTextureID == UINT_MAX)
@@ -113,6 +342,11 @@ void TextureFeedbackManager::PrepareTexturesToProcessThisFrame()
             continue; // not a tiled texture
         }
 
+        if (texture.m_FeedbackPrimaryTextureIdx != UINT_MAX)
+        {
+            continue; // follows its primary's feedback
+        }
+
         m_TexturesToProcessThisFrame.push_back(textureIdx);
     }
 
@@ -134,25 +368,85 @@ void TextureFeedbackManager::BeginFrame()
 
     nvrhi::DeviceHandle device = g_Graphic.m_NVRHIDevice;
 
+    m_TextureFrameStates.resize(g_Graphic.m_Textures.size());
+
+    UpdateTexturePrefetchMips();
+
     // Begin frame, readback feedback
-    std::vector<uint32_t>& texturesToReadback = m_TexturesToReadback[g_Graphic.m_FrameCounter % 2];
+    // NOTE: the tiled texture manager isn't thread safe. Its calls stay on this thread, the parallel per texture work of this frame only reads their results
+    std::vector<uint32_t>& texturesToReadback = m_TexturesToReadback[g_Graphic.GetFrameSlot()];
     {
         PROFILE_SCOPED("Readback Feedback Textures");
 
-        for (uint32_t textureIdx : texturesToReadback)
+        m_ReadbackDatas.resize(texturesToReadback.size());
+        for (uint32_t i = 0; i < texturesToReadback.size(); ++i)
         {
-            Texture& texture = g_Graphic.m_Textures.at(textureIdx);
-            nvrhi::BufferHandle resolveBuffer = texture.m_FeedbackResolveBuffers[g_Graphic.m_FrameCounter % 2];
+            const Texture& texture = g_Graphic.m_Textures.at(texturesToReadback[i]);
+            m_ReadbackDatas[i] = (const uint8_t*)device->mapBuffer(texture.m_FeedbackResolveBuffers[g_Graphic.GetFrameSlot()], nvrhi::CpuAccessMode::Read);
+        }
+
+        // feedback is kept, to tell the tiles only prefetch requests apart later this frame
+        auto MergePrefetch = [this](uint32_t textureIdx)
+            {
+                TextureFrameState& textureState = m_TextureFrameStates[textureIdx];
+                textureState.m_PrefetchMip = m_TexturePrefetchMips[textureIdx];
+                textureState.m_PrefetchedFeedback = textureState.m_Feedback;
+                MergePrefetchMip(textureState.m_PrefetchedFeedback, textureState.m_PrefetchMip);
+            };
+
+        // the other textures of its material sets are sampled with the same UVs: they get the same feedback, scaled to their resolution
+        tf::Taskflow tf;
+        tf.for_each_index(0u, (uint32_t)texturesToReadback.size(), 1u, [this, &texturesToReadback, &MergePrefetch](uint32_t i)
+            {
+                const uint32_t textureIdx = texturesToReadback[i];
+                const Texture& texture = g_Graphic.m_Textures.at(textureIdx);
+
+                std::vector<uint8_t>& feedback = m_TextureFrameStates[textureIdx].m_Feedback;
+                feedback.assign(m_ReadbackDatas[i], m_ReadbackDatas[i] + texture.m_FeedbackLayout.GetNumRegionsX() * texture.m_FeedbackLayout.GetNumRegionsY());
+                MergePrefetch(textureIdx);
 
-            void* pReadbackData = device->mapBuffer(resolveBuffer, nvrhi::CpuAccessMode::Read);
+                for (uint32_t followerTextureIdx : texture.m_FeedbackFollowerTextureIndices)
+                {
+                    const Texture& followerTexture = g_Graphic.m_Textures.at(followerTextureIdx);
+                    std::vector<uint8_t>& followerFeedback = m_TextureFrameStates[followerTextureIdx].m_Feedback;
+
+                    followerFeedback.resize(followerTexture.m_FeedbackLayout.GetNumRegionsX() * followerTexture.m_FeedbackLayout.GetNumRegionsY());
+                    RemapMinMipFeedback(texture.m_FeedbackLayout, feedback.data(), followerTexture.m_FeedbackLayout, followerFeedback.data());
+                    MergePrefetch(followerTextureIdx);
+                }
+            });
+        g_Engine.m_Executor->corun(tf);
+
+        for (uint32_t i = 0; i < texturesToReadback.size(); ++i)
+        {
+            const Texture& texture = g_Graphic.m_Textures.at(texturesToReadback[i]);
+            std::vector<uint8_t>& feedback = m_TextureFrameStates[texturesToReadback[i]].m_PrefetchedFeedback;
 
             rtxts::SamplerFeedbackDesc samplerFeedbackDesc;
-            samplerFeedbackDesc.pMinMipData = (uint8_t*)pReadbackData;
+            samplerFeedbackDesc.pMinMipData = feedback.data();
             m_TiledTextureManager->UpdateWithSamplerFeedback(texture.m_TiledTextureID, samplerFeedbackDesc, 0.0f, 0.0f);
 
-            device->unmapBuffer(resolveBuffer);
+            if (m_FeedbackTraceRecorder.IsOpen())
+            {
+                m_FeedbackTraceRecorder.RecordFeedback(texture.m_TiledTextureID, feedback);
+            }
+
+            for (uint32_t followerTextureIdx : texture.m_FeedbackFollowerTextureIndices)
+            {
+                const Texture& followerTexture = g_Graphic.m_Textures.at(followerTextureIdx);
+                std::vector<uint8_t>& followerFeedback = m_TextureFrameStates[followerTextureIdx].m_PrefetchedFeedback;
+
+                rtxts::SamplerFeedbackDesc followerSamplerFeedbackDesc;
+                followerSamplerFeedbackDesc.pMinMipData = followerFeedback.data();
+                m_TiledTextureManager->UpdateWithSamplerFeedback(followerTexture.m_TiledTextureID, followerSamplerFeedbackDesc, 0.0f, 0.0f);
 
-            // TODO: call 'MatchPrimaryTexture' for Material texture sets (albedo, normal, ORM)
+                if (m_FeedbackTraceRecorder.IsOpen())
+                {
+                    m_FeedbackTraceRecorder.RecordFeedback(followerTexture.m_TiledTextureID, followerFeedback);
+                }
+            }
+
+            device->unmapBuffer(texture.m_FeedbackResolveBuffers[g_Graphic.GetFrameSlot()]);
         }
     }
 
@@ -205,149 +499,188 @@ void TextureFeedbackManager::BeginFrame()
         m_TiledTextureManager->AllocateRequestedTiles();
     }
 
-    struct TextureAndTiles
-    {
-        const uint32_t m_TextureIdx;
-        std::vector<uint32_t> m_TileIndices;
-    };
-    std::vector<TextureAndTiles> textureAndTilesToMap;
-
-    std::vector<uint32_t> texturesWithDirtyMinMipTextures;
-
     // Get tiles to unmap and map from the tiled texture manager
+    m_DirtyTextureIndices.clear();
     {
         PROFILE_SCOPED("Get Tiles to Map & Unmap");
 
         // TODO: The current code does not merge unmapping and mapping tiles for the same textures. It would be more optimal.
-        std::vector<uint32_t> tilesToMap;
-        std::vector<uint32_t> tilesToUnmap;
         for (uint32_t textureIdx = 0; textureIdx < g_Graphic.m_Textures.size(); ++textureIdx)
         {
-            Texture& texture = g_Graphic.m_Textures[textureIdx];
+            const Texture& texture = g_Graphic.m_Textures[textureIdx];
             if (texture.m_TiledTextureID == UINT_MAX)
             {
                 continue; // not a tiled texture
             }
 
-            m_TiledTextureManager->GetTilesToMap(texture.m_TiledTextureID, tilesToMap);
-            m_TiledTextureManager->GetTilesToUnmap(texture.m_TiledTextureID, tilesToUnmap);
+            TextureFrameState& textureState = m_TextureFrameStates[textureIdx];
+            m_TiledTextureManager->GetTilesToMap(texture.m_TiledTextureID, textureState.m_TilesToMap);
+            m_TiledTextureManager->GetTilesToUnmap(texture.m_TiledTextureID, textureState.m_TilesToUnmap);
 
-            const std::vector<rtxts::TileCoord>& tilesCoordinates = m_TiledTextureManager->GetTileCoordinates(texture.m_TiledTextureID);
-
-            if (!tilesToUnmap.empty() || !tilesToMap.empty())
+            if (!textureState.m_TilesToUnmap.empty() || !textureState.m_TilesToMap.empty())
             {
-                texturesWithDirtyMinMipTextures.push_back(textureIdx);
+                textureState.m_TileCoordinates = &m_TiledTextureManager->GetTileCoordinates(texture.m_TiledTextureID);
+                m_DirtyTextureIndices.push_back(textureIdx);
             }
+        }
+    }
+
+    {
+        PROFILE_SCOPED("Build Tile Unmappings & Find Prefetched Tiles");
 
-            if (!tilesToUnmap.empty())
+        tf::Taskflow tf;
+        tf.for_each_index(0u, (uint32_t)m_DirtyTextureIndices.size(), 1u, [this](uint32_t i)
             {
-                nvrhi::TiledTextureRegion tiledTextureRegion;
-                tiledTextureRegion.tilesNum = 1;
+                const Texture& texture = g_Graphic.m_Textures[m_DirtyTextureIndices[i]];
+                TextureFrameState& textureState = m_TextureFrameStates[m_DirtyTextureIndices[i]];
+                textureState.m_Mappings.BuildUnmappings(textureState.m_TilesToUnmap, *textureState.m_TileCoordinates);
 
-                nvrhi::TextureTilesMapping textureTilesMapping;
-                textureTilesMapping.numTextureRegions = tilesToUnmap.size();
+                // tiles to map that its last feedback doesn't request are only prefetched: they're read & uploaded after all others
+                textureState.m_bTilesToMapPrefetched.assign(textureState.m_TilesToMap.size(), false);
+                if (textureState.m_PrefetchMip == kNoPrefetchMip)
+                {
+                    return;
+                }
 
-                std::vector<nvrhi::TiledTextureCoordinate> tiledTextureCoordinates;
-                tiledTextureCoordinates.resize(tilesToUnmap.size());
+                for (uint32_t j = 0; j < textureState.m_TilesToMap.size(); ++j)
+                {
+                    const uint32_t tileIndex = textureState.m_TilesToMap[j];
+                    if (texture.IsTilePacked(tileIndex))
+                    {
+                        continue;
+                    }
 
-                std::vector<nvrhi::TiledTextureRegion> tiledTextureRegions;
-                tiledTextureRegions.resize(tilesToUnmap.size(), tiledTextureRegion);
+                    const rtxts::TileCoord& tileCoord = (*textureState.m_TileCoordinates)[tileIndex];
+                    textureState.m_bTilesToMapPrefetched[j] = !IsTileRequestedByFeedback(texture.m_FeedbackLayout, textureState.m_Feedback, tileCoord.x, tileCoord.y, tileCoord.mipLevel, texture.m_TileShape.widthInTexels, texture.m_TileShape.heightInTexels);
+                }
+            });
+        g_Engine.m_Executor->corun(tf);
+    }
 
-                textureTilesMapping.tiledTextureCoordinates = tiledTextureCoordinates.data();
-                textureTilesMapping.tiledTextureRegions = tiledTextureRegions.data();
+    // unmap, then stream in the data of tiles to map. Touches the streaming I/O & memory cache, which aren't thread safe
+    m_TexturesWithTilesToMap.clear();
+    {
+        PROFILE_SCOPED("Unmap Tiles & Read Tiles to Map");
+
+        for (uint32_t textureIdx : m_DirtyTextureIndices)
+        {
+            Texture& texture = g_Graphic.m_Textures[textureIdx];
+            TextureFrameState& textureState = m_TextureFrameStates[textureIdx];
+            const std::vector<rtxts::TileCoord>& tilesCoordinates = *textureState.m_TileCoordinates;
+
+            if (!textureState.m_TilesToUnmap.empty())
+            {
+                nvrhi::TextureTilesMapping textureTilesMapping;
+                textureTilesMapping.numTextureRegions = textureState.m_Mappings.m_UnmapCoordinates.size();
+                textureTilesMapping.tiledTextureCoordinates = textureState.m_Mappings.m_UnmapCoordinates.data();
+                textureTilesMapping.tiledTextureRegions = textureState.m_Mappings.m_UnmapRegions.data();
                 textureTilesMapping.heap = nullptr; // nullptr for heap == unmap
 
-                uint32_t tilesProcessedNum = 0;
-                for (uint32_t tileIndex : tilesToUnmap)
+                for (uint32_t tileIndex : textureState.m_TilesToUnmap)
                 {
                     // Process only unpacked tiles
-                    nvrhi::TiledTextureCoordinate& tiledTextureCoordinate = tiledTextureCoordinates[tilesProcessedNum];
-                    tiledTextureCoordinate.mipLevel = tilesCoordinates[tileIndex].mipLevel;
-                    tiledTextureCoordinate.arrayLevel = 0;
-                    tiledTextureCoordinate.x = tilesCoordinates[tileIndex].x;
-                    tiledTextureCoordinate.y = tilesCoordinates[tileIndex].y;
-                    tiledTextureCoordinate.z = 0;
-
-                    tilesProcessedNum++;
-
                     if (!texture.IsTilePacked(tileIndex))
                     {
                         TextureMipData& mipData = texture.m_TextureMipDatas.at(tilesCoordinates[tileIndex].mipLevel);
                         check(tileIndex >= mipData.m_FirstTileIndex);
                         const uint32_t mipTileIndex = tileIndex - mipData.m_FirstTileIndex;
                         mipData.m_ResidencyBits.ClearBit(mipTileIndex);
+
+                        // reads still queued are cancelled & their memory freed. Otherwise the tile data stays cached, in case it's mapped again
+                        if (!mipData.m_TileDatas.empty())
+                        {
+                            TextureTileData& tileData = mipData.m_TileDatas[mipTileIndex];
+                            if (tileData.m_ReadRequestID != StreamingIO::kInvalidRequestID && m_StreamingIO.Cancel(tileData.m_ReadRequestID))
+                            {
+                                m_StreamingMemoryCache.Free(tileData.m_CacheEntryID);
+                                tileData = TextureTileData{};
+                            }
+                        }
                     }
                 }
 
                 device->updateTextureTileMappings(texture.m_NVRHITextureHandle, &textureTilesMapping, 1);
             }
 
-            if (!tilesToMap.empty())
+            if (!textureState.m_TilesToMap.empty())
             {
-                bool bDoMipDatasToRead[GraphicConstants::kMaxTextureMips]{};
-                for (uint32_t tileIndex : tilesToMap)
+                if (texture.m_StreamingFileID == UINT_MAX)
+                {
+                    texture.m_StreamingFileID = m_StreamingIO.OpenFile(texture.m_TiledTextureFile.IsValid() ? texture.m_TiledTextureFile.GetFilePath() : texture.m_ImageFilePath);
+                }
+
+                for (uint32_t j = 0; j < textureState.m_TilesToMap.size(); ++j)
                 {
+                    const uint32_t tileIndex = textureState.m_TilesToMap[j];
                     if (texture.IsTilePacked(tileIndex))
                     {
                         continue; // skip packed tiles
                     }
 
                     const uint32_t mip = tilesCoordinates[tileIndex].mipLevel;
+                    const bool bPrefetch = textureState.m_bTilesToMapPrefetched[j];
 
                     TextureMipData& mipData = texture.m_TextureMipDatas.at(mip);
                     check(tileIndex >= mipData.m_FirstTileIndex);
                     const uint32_t mipTileIndex = tileIndex - mipData.m_FirstTileIndex;
                     mipData.m_ResidencyBits.SetBit(mipTileIndex);
 
-                    bDoMipDatasToRead[mip] = mipData.m_Data.empty() && !mipData.m_bDataReady;
-                }
+                    // every mapped tile pins its data until its upload, see 'TileUpload::m_CacheEntryID'. Cached data, or data already being read, isn't read again
+                    if (mipData.m_TileDatas.empty())
+                    {
+                        if (m_StreamingMemoryCache.Pin(mipData.m_CacheEntryID))
+                        {
+                            continue;
+                        }
 
-                textureAndTilesToMap.push_back({ textureIdx, std::move(tilesToMap) });
+                        mipData.m_CacheEntryID = m_StreamingMemoryCache.Allocate(mipData.m_NumBytes);
+                        mipData.m_bDataReady = false;
 
-                for (uint32_t mip = 0; mip < GraphicConstants::kMaxTextureMips; ++mip)
-                {
-                    if (!bDoMipDatasToRead[mip])
-                    {
+                        m_TextureBytesStreamedIn += mipData.m_NumBytes;
+
+                        StreamingIO::ReadRequest readRequest;
+                        readRequest.m_FileID = texture.m_StreamingFileID;
+                        readRequest.m_Offset = mipData.m_DataOffset;
+                        readRequest.m_Size = mipData.m_NumBytes;
+                        readRequest.m_Priority = GetReadPriority(mip, bPrefetch);
+                        readRequest.m_Dest = m_StreamingMemoryCache.GetData(mipData.m_CacheEntryID);
+                        readRequest.m_UserData = PackReadUserData(textureIdx, mip, kWholeMipReadTileIndex);
+
+                        m_StreamingIO.Enqueue(readRequest);
                         continue;
                     }
 
-                    TextureMipData& mipData = texture.m_TextureMipDatas.at(mip);
-                    mipData.m_Data.resize(mipData.m_NumBytes);
-
-                    m_TextureBytesStreamedIn += mipData.m_NumBytes;
+                    // read just this tile
+                    TextureTileData& tileData = mipData.m_TileDatas[mipTileIndex];
+                    if (m_StreamingMemoryCache.Pin(tileData.m_CacheEntryID))
+                    {
+                        continue;
+                    }
 
-                    auto DoReadDDSMipData = [textureIdx, mip]()
-                        {
-                            Texture& texture = g_Graphic.m_Textures.at(textureIdx);
-                            TextureMipData& mipData = texture.m_TextureMipDatas.at(mip);
+                    const uint32_t tileNumBytes = texture.m_TiledTextureFile.GetTileNumBytes(mip, mipTileIndex);
+                    tileData.m_CacheEntryID = m_StreamingMemoryCache.Allocate(tileNumBytes);
+                    tileData.m_bDataReady = false;
 
-                            check(!mipData.m_Data.empty());
-                            check(!mipData.m_bDataReady);
+                    m_TextureBytesStreamedIn += tileNumBytes;
 
-                            ScopedFile f{ texture.m_ImageFilePath, "rb" };
-                            ReadDDSMipData(texture, f, mip);
-                        };
+                    StreamingIO::ReadRequest readRequest;
+                    readRequest.m_FileID = texture.m_StreamingFileID;
+                    readRequest.m_Offset = texture.m_TiledTextureFile.GetTileFileOffset(mip, mipTileIndex);
+                    readRequest.m_Size = tileNumBytes;
+                    readRequest.m_Priority = GetReadPriority(mip, bPrefetch);
+                    readRequest.m_Dest = m_StreamingMemoryCache.GetData(tileData.m_CacheEntryID);
+                    readRequest.m_UserData = PackReadUserData(textureIdx, mip, mipTileIndex);
 
-                    g_Engine.m_Executor->silent_async(DoReadDDSMipData);
+                    tileData.m_ReadRequestID = m_StreamingIO.Enqueue(readRequest);
                 }
-            }
-
-            // clear mip data from system memory when entire mip is streamed out
-            for (uint32_t i = 0; i < texture.m_PackedMipDesc.numStandardMips; ++i)
-            {
-                TextureMipData& mipData = texture.m_TextureMipDatas[i];
-                if (mipData.m_ResidencyBits.IsEmpty())
-                {
-                    mipData.m_bDataReady = false;
 
-                    // forcefully remove mip data from system memory. "clear" is not enough
-                    std::vector<std::byte> emptyVec;
-                    mipData.m_Data.swap(emptyVec);
-                }
+                m_TexturesWithTilesToMap.push_back(textureIdx);
             }
         }
     }
 
+    m_StreamingIO.Submit();
+
     {
         PROFILE_SCOPED("Defragment Tiles");
 
@@ -355,110 +688,159 @@ void TextureFeedbackManager::BeginFrame()
         m_TiledTextureManager->DefragmentTiles(kNumTilesToDefragment);
     }
 
-    std::vector<FeedbackTextureTileInfo> tiles;
-    for (TextureAndTiles& texUpdate : textureAndTilesToMap)
     {
         PROFILE_SCOPED("Update Tile Mappings");
 
-        Texture& texture = g_Graphic.m_Textures.at(texUpdate.m_TextureIdx);
-
-        m_TiledTextureManager->UpdateTilesMapping(texture.m_TiledTextureID, texUpdate.m_TileIndices);
-
-        const std::vector<rtxts::TileCoord>& tilesCoordinates = m_TiledTextureManager->GetTileCoordinates(texture.m_TiledTextureID);
-        const std::vector<rtxts::TileAllocation>& tilesAllocations = m_TiledTextureManager->GetTileAllocations(texture.m_TiledTextureID);
-
-        std::unordered_map<uint32_t, std::vector<uint32_t>> heapTilesMapping;
-        for (uint32_t tileIndex : texUpdate.m_TileIndices)
+        for (uint32_t textureIdx : m_TexturesWithTilesToMap)
         {
-            heapTilesMapping[tilesAllocations[tileIndex].heapId].push_back(tileIndex);
+            const Texture& texture = g_Graphic.m_Textures[textureIdx];
+            TextureFrameState& textureState = m_TextureFrameStates[textureIdx];
+
+            m_TiledTextureManager->UpdateTilesMapping(texture.m_TiledTextureID, textureState.m_TilesToMap);
+            textureState.m_TileAllocations = &m_TiledTextureManager->GetTileAllocations(texture.m_TiledTextureID);
         }
+    }
 
-        // update tile mappings
-        for (const auto& [heapId, heapTiles] : heapTilesMapping)
-        {
-            std::vector<nvrhi::TiledTextureCoordinate> tiledTextureCoordinates;
-            std::vector<nvrhi::TiledTextureRegion> tiledTextureRegions;
-            std::vector<uint64_t> byteOffsets;
+    // per heap mappings & tile uploads of each texture
+    {
+        PROFILE_SCOPED("Build Tile Mappings & Uploads");
 
-            for (uint32_t tileIndex : heapTiles)
+        tf::Taskflow tf;
+        tf.for_each_index(0u, (uint32_t)m_TexturesWithTilesToMap.size(), 1u, [this](uint32_t i)
             {
-                nvrhi::TiledTextureCoordinate& tiledTextureCoordinate = tiledTextureCoordinates.emplace_back();
-                tiledTextureCoordinate.mipLevel = tilesCoordinates[tileIndex].mipLevel;
-                tiledTextureCoordinate.x = tilesCoordinates[tileIndex].x;
-                tiledTextureCoordinate.y = tilesCoordinates[tileIndex].y;
-                tiledTextureCoordinate.z = 0;
+                const uint32_t textureIdx = m_TexturesWithTilesToMap[i];
+                const Texture& texture = g_Graphic.m_Textures[textureIdx];
+                TextureFrameState& textureState = m_TextureFrameStates[textureIdx];
 
-                nvrhi::TiledTextureRegion& tiledTextureRegion = tiledTextureRegions.emplace_back();
-                tiledTextureRegion.tilesNum = 1;
+                textureState.m_Mappings.BuildMappings(textureState.m_TilesToMap, *textureState.m_TileCoordinates, *textureState.m_TileAllocations);
 
-                uint64_t& byteOffset = byteOffsets.emplace_back();
-                byteOffset = tilesAllocations[tileIndex].heapTileIndex * GraphicConstants::kTiledResourceSizeInBytes;
-            }
+                textureState.m_PackedTiles.clear();
+                textureState.m_UploadRequests.clear();
+                for (uint32_t j = 0; j < textureState.m_TilesToMap.size(); ++j)
+                {
+                    const uint32_t tileIndex = textureState.m_TilesToMap[j];
+                    if (texture.IsTilePacked(tileIndex))
+                    {
+                        texture.GetTileInfo(tileIndex, textureState.m_PackedTiles);
+                        continue;
+                    }
 
-            nvrhi::TextureTilesMapping textureTilesMapping;
-            textureTilesMapping.numTextureRegions = tiledTextureCoordinates.size();
-            textureTilesMapping.tiledTextureCoordinates = tiledTextureCoordinates.data();
-            textureTilesMapping.tiledTextureRegions = tiledTextureRegions.data();
-            textureTilesMapping.byteOffsets = byteOffsets.data();
-            textureTilesMapping.heap = m_Heaps.at(heapId);
+                    textureState.m_TileInfoScratch.clear();
+                    texture.GetTileInfo(tileIndex, textureState.m_TileInfoScratch);
 
-            device->updateTextureTileMappings(texture.m_NVRHITextureHandle, &textureTilesMapping, 1);
-        }
+                    for (const FeedbackTextureTileInfo& tile : textureState.m_TileInfoScratch)
+                    {
+                        const TextureMipData& mipData = texture.m_TextureMipDatas.at(tile.m_Mip);
+                        const StreamingMemoryCache::EntryID cacheEntryID = mipData.m_TileDatas.empty() ? mipData.m_CacheEntryID : mipData.m_TileDatas.at(GetMipTileIndex(texture, tile)).m_CacheEntryID;
+                        check(m_StreamingMemoryCache.IsResident(cacheEntryID));
+
+                        TileUploadScheduler<TileUpload>::Request& uploadRequest = textureState.m_UploadRequests.emplace_back();
+                        uploadRequest.m_Mip = tile.m_Mip;
+                        uploadRequest.m_Importance = (float)textureState.m_TilesToMap.size(); // tiles of the texture mapped this frame, as a proxy for its screen coverage
+                        uploadRequest.m_NumBytes = GetTileUploadNumBytes(texture, tile);
+                        uploadRequest.m_Payload = { textureIdx, tile, cacheEntryID };
+                        uploadRequest.m_bPrefetch = textureState.m_bTilesToMapPrefetched[j];
+                    }
+                }
+            });
+        g_Engine.m_Executor->corun(tf);
+    }
+
+    {
+        PROFILE_SCOPED("Map Tiles & Enqueue Uploads");
 
-        for (uint32_t tileIndex : texUpdate.m_TileIndices)
+        for (uint32_t textureIdx : m_TexturesWithTilesToMap)
         {
-            tiles.clear();
-            texture.GetTileInfo(tileIndex, tiles);
+            const Texture& texture = g_Graphic.m_Textures[textureIdx];
+            const TextureFrameState& textureState = m_TextureFrameStates[textureIdx];
+            const TextureTileMappings& mappings = textureState.m_Mappings;
 
-            for (FeedbackTextureTileInfo& tile : tiles)
+            for (const TextureTileMappings::HeapRange& heapRange : mappings.m_MapHeapRanges)
             {
-                TextureMipData& mipData = texture.m_TextureMipDatas.at(tile.m_Mip);
-                if (texture.IsTilePacked(tileIndex))
-                {
-                    PROFILE_SCOPED("Upload Packed Tile");
+                nvrhi::TextureTilesMapping textureTilesMapping;
+                textureTilesMapping.numTextureRegions = heapRange.m_NumRegions;
+                textureTilesMapping.tiledTextureCoordinates = mappings.m_MapCoordinates.data() + heapRange.m_FirstRegion;
+                textureTilesMapping.tiledTextureRegions = mappings.m_MapRegions.data() + heapRange.m_FirstRegion;
+                textureTilesMapping.byteOffsets = mappings.m_MapByteOffsets.data() + heapRange.m_FirstRegion;
+                textureTilesMapping.heap = m_Heaps.at(heapRange.m_HeapID);
 
-                    // packed mips are persistently loaded in memory. immediately upload
-                    commandList->writeTexture(texture.m_NVRHITextureHandle, 0, tile.m_Mip, mipData.m_Data.data(), mipData.m_RowPitch);
-                }
-                else
-                {
-                    m_TileUploads.push_back({ texUpdate.m_TextureIdx, std::move(tile) });
-                }
+                device->updateTextureTileMappings(texture.m_NVRHITextureHandle, &textureTilesMapping, 1);
+            }
+
+            // packed mips are persistently loaded in memory. immediately upload
+            for (const FeedbackTextureTileInfo& tile : textureState.m_PackedTiles)
+            {
+                PROFILE_SCOPED("Upload Packed Tile");
+
+                const TextureMipData& mipData = texture.m_TextureMipDatas.at(tile.m_Mip);
+                commandList->writeTexture(texture.m_NVRHITextureHandle, 0, tile.m_Mip, mipData.m_Data.data(), mipData.m_RowPitch);
+            }
+
+            for (const TileUploadScheduler<TileUpload>::Request& uploadRequest : textureState.m_UploadRequests)
+            {
+                m_TileUploadScheduler.Enqueue(uploadRequest);
             }
         }
     }
 
-    std::vector<TileUpload> deferredTileUploads;
-    for (TileUpload& tileUpload : m_TileUploads)
-    {
-        Texture& texture = g_Graphic.m_Textures.at(tileUpload.m_TextureIdx);
-        TextureMipData& mipData = texture.m_TextureMipDatas.at(tileUpload.m_TileInfo.m_Mip);
+    ProcessStreamingIOCompletions();
 
-        if (mipData.m_bDataReady)
+    auto GetTileUploadState = [this](const TileUpload& tileUpload)
         {
-            UploadTile(commandList, tileUpload.m_TextureIdx, tileUpload.m_TileInfo);
-        }
-        else
+            // its read was cancelled, as the tile got unmapped
+            if (!m_StreamingMemoryCache.IsResident(tileUpload.m_CacheEntryID))
+            {
+                return TileUploadScheduler<TileUpload>::UploadState::Dropped;
+            }
+
+            const Texture& texture = g_Graphic.m_Textures.at(tileUpload.m_TextureIdx);
+            const TextureMipData& mipData = texture.m_TextureMipDatas.at(tileUpload.m_TileInfo.m_Mip);
+
+            const bool bDataReady = mipData.m_TileDatas.empty() ? mipData.m_bDataReady : mipData.m_TileDatas.at(GetMipTileIndex(texture, tileUpload.m_TileInfo)).m_bDataReady;
+            return bDataReady ? TileUploadScheduler<TileUpload>::UploadState::Ready : TileUploadScheduler<TileUpload>::UploadState::NotReady;
+        };
+
+    m_ScheduledTileUploads.clear();
+    m_TileUploadScheduler.ScheduleFrame(GetTileUploadState, m_ScheduledTileUploads);
+
+    // all tile copies of the frame back to back, from the staging tiles of this frame slot
+    {
+        PROFILE_GPU_SCOPED(commandList, "Upload Tiles");
+
+        m_TileUploadRing.BeginFrame(g_Graphic.GetFrameSlot());
+
+        for (const TileUpload& tileUpload : m_ScheduledTileUploads)
         {
-            check(!mipData.m_Data.empty()); // sanity check that mip data I/O is at least in progress
-            deferredTileUploads.push_back(std::move(tileUpload)); // try again next frame
+            const Texture& texture = g_Graphic.m_Textures.at(tileUpload.m_TextureIdx);
+            const TextureMipData& mipData = texture.m_TextureMipDatas.at(tileUpload.m_TileInfo.m_Mip);
+
+            // skip tiles unmapped while waiting. Their data stays cached
+            if (mipData.m_ResidencyBits.GetBit(GetMipTileIndex(texture, tileUpload.m_TileInfo)))
+            {
+                UploadTile(commandList, tileUpload.m_TextureIdx, tileUpload.m_TileInfo);
+            }
+
+            m_StreamingMemoryCache.Unpin(tileUpload.m_CacheEntryID);
         }
     }
-    m_TileUploads = std::move(deferredTileUploads);
 
     // Write min mip data
-    std::vector<uint8_t> minMipData;
-    for (uint32_t i : texturesWithDirtyMinMipTextures)
+    for (uint32_t i : m_DirtyTextureIndices)
     {
         Texture& texture = g_Graphic.m_Textures.at(i);
 
         const nvrhi::TextureDesc& minMipTexDesc = texture.m_MinMipTextureHandle->getDesc();
 
-        minMipData.resize(minMipTexDesc.width* minMipTexDesc.height);
-        m_TiledTextureManager->WriteMinMipData(texture.m_TiledTextureID, minMipData.data());
+        m_MinMipScratchBuffer.resize(minMipTexDesc.width * minMipTexDesc.height);
+        m_TiledTextureManager->WriteMinMipData(texture.m_TiledTextureID, m_MinMipScratchBuffer.data());
 
         const uint32_t rowPitch = minMipTexDesc.width;
-        commandList->writeTexture(texture.m_MinMipTextureHandle, 0, 0, minMipData.data(), rowPitch);
+        commandList->writeTexture(texture.m_MinMipTextureHandle, 0, 0, m_MinMipScratchBuffer.data(), rowPitch);
+    }
+
+    if (m_FeedbackTraceRecorder.IsOpen())
+    {
+        m_FeedbackTraceRecorder.EndFrame();
     }
 }
 
@@ -477,10 +859,8 @@ void TextureFeedbackManager::EndFrame()
     for (uint32_t i : m_TexturesToProcessThisFrame)
     {
         Texture& texture = g_Graphic.m_Textures.at(i);
-        commandList->decodeSamplerFeedbackTexture(texture.m_FeedbackResolveBuffers[g_Graphic.m_FrameCounter % 2], texture.m_SamplerFeedbackTextureHandle, nvrhi::Format::R8_UINT);
+        commandList->decodeSamplerFeedbackTexture(texture.m_FeedbackResolveBuffers[g_Graphic.GetFrameSlot()], texture.m_SamplerFeedbackTextureHandle, nvrhi::Format::R8_UINT);
     }
-
-    m_ResolveFeedbackTexturesCounter = (m_ResolveFeedbackTexturesCounter + m_NumFeedbackTexturesToResolvePerFrame) % g_Graphic.m_Textures.size();
 }
 
 uint32_t TextureFeedbackManager::AllocateHeap()
@@ -532,35 +912,132 @@ void TextureFeedbackManager::ReleaseHeap(uint32_t heapID)
     //       extra VRAM cost is not significant, as we'll need to allocate for worst case view in scene anyway
 }
 
+void TextureFeedbackManager::ProcessStreamingIOCompletions()
+{
+    PROFILE_FUNCTION();
+
+    m_StreamingIOCompletions.clear();
+    m_StreamingIO.PollCompletions(m_StreamingIOCompletions);
+
+    for (const StreamingIO::Completion& completion : m_StreamingIOCompletions)
+    {
+        check(completion.m_bSuccess);
+
+        uint32_t textureIdx, mip, mipTileIndex;
+        UnpackReadUserData(completion.m_UserData, textureIdx, mip, mipTileIndex);
+
+        Texture& texture = g_Graphic.m_Textures.at(textureIdx);
+        TextureMipData& mipData = texture.m_TextureMipDatas.at(mip);
+        if (mipTileIndex == kWholeMipReadTileIndex)
+        {
+            check(!mipData.m_bDataReady);
+
+            // once per read, rather than per tile upload
+            PROFILE_SCOPED("Convert Linear Mip To Tiles");
+
+            const std::span<std::byte> mipBytes{ m_StreamingMemoryCache.GetData(mipData.m_CacheEntryID), mipData.m_NumBytes };
+            m_LinearMipScratchBuffer.assign(mipBytes.begin(), mipBytes.end());
+            ConvertLinearMipToTiles(GetMipTileLayout(texture, mip), m_LinearMipScratchBuffer, mipBytes);
+
+            mipData.m_bDataReady = true;
+        }
+        else
+        {
+            TextureTileData& tileData = mipData.m_TileDatas.at(mipTileIndex);
+            check(tileData.m_ReadRequestID == completion.m_RequestID);
+            tileData.m_bDataReady = true;
+            tileData.m_ReadRequestID = StreamingIO::kInvalidRequestID;
+        }
+    }
+}
+
+void TextureFeedbackManager::UpdateTexturePrefetchMips()
+{
+    PROFILE_FUNCTION();
+
+    const View& view = g_Scene->m_View;
+    m_CameraMotionPredictor.AddSample(view.m_Eye, view.m_Orientation, g_Engine.m_CPUFrameTimeMs / 1000.0f);
+
+    m_TexturePrefetchMips.assign(g_Graphic.m_Textures.size(), kNoPrefetchMip);
+    if (!m_bEnableTexturePrefetch)
+    {
+        return;
+    }
+
+    uint32_t numTexturesResolvingFeedback = 0;
+    m_PrefetchTextureLayouts.resize(g_Graphic.m_Textures.size());
+    for (uint32_t i = 0; i < g_Graphic.m_Textures.size(); ++i)
+    {
+        const Texture& texture = g_Graphic.m_Textures[i];
+        const bool bTiled = texture.m_TiledTextureID != UINT_MAX;
+        m_PrefetchTextureLayouts[i] = bTiled ? texture.m_FeedbackLayout : MinMipFeedbackLayout{};
+        numTexturesResolvingFeedback += (bTiled && texture.m_FeedbackPrimaryTextureIdx == UINT_MAX) ? 1 : 0;
+    }
+
+    // a texture's feedback is resolved once per round-robin over all textures, & read back frames later
+    const uint32_t lookAheadFrames = DivideAndRoundUp(numTexturesResolvingFeedback, (uint32_t)m_NumFeedbackTexturesToResolvePerFrame) + GraphicConstants::kMaxFramesInFlight;
+
+    const TexturePrefetchCamera camera = MakeTexturePrefetchCamera(view);
+    TexturePrefetchCamera predictedCamera = camera;
+    m_CameraMotionPredictor.Predict(lookAheadFrames * g_Engine.m_CPUFrameTimeMs / 1000.0f, predictedCamera.m_Eye, predictedCamera.m_Orientation);
+
+    m_PrefetchInstances.resize(g_Scene->m_Primitives.size());
+
+    tf::Taskflow tf;
+    tf.for_each_index(0u, (uint32_t)g_Scene->m_Primitives.size(), 1u, [this](uint32_t i)
+        {
+            // the finest LOD: prefetch errs towards finer mips
+            m_PrefetchInstances[i] = MakeTexturePrefetchInstance(g_Scene->m_Primitives[i], 0);
+        });
+    g_Engine.m_Executor->corun(tf);
+
+    ComputeTexturePrefetchMips(camera, predictedCamera, m_PrefetchInstances, m_PrefetchTextureLayouts, m_PrefetchMipBias, m_CurrentTextureMipEstimates, m_TexturePrefetchMips);
+}
+
 void TextureFeedbackManager::UploadTile(nvrhi::CommandListHandle commandList, uint32_t destTextureIdx, const FeedbackTextureTileInfo& tile)
 {
     PROFILE_FUNCTION();
 
-    nvrhi::DeviceHandle device = g_Graphic.m_NVRHIDevice;
     const Texture& destTexture = g_Graphic.m_Textures.at(destTextureIdx);
     const TextureMipData& mipData = destTexture.m_TextureMipDatas.at(tile.m_Mip);
+    const nvrhi::Format format = destTexture.m_NVRHITextureHandle->getDesc().format;
 
-    // Compute pitches and offsets in 4x4 blocks
+    // Compute pitches in 4x4 blocks
     // Note: The "tile" being copied here might be smaller than a tiled resource tile, for example non-pow2 textures
-    const uint32_t blockSize = nvrhi::getFormatInfo(destTexture.m_NVRHITextureHandle->getDesc().format).blockSize;
-    const uint32_t tileBlocksWidth = tile.m_WidthInTexels / blockSize;
-    const uint32_t tileBlocksHeight = tile.m_HeightInTexels / blockSize;
-    const uint32_t shapeBlocksWidth = destTexture.m_TileShape.widthInTexels / blockSize;
-    const uint32_t shapeBlocksHeight = destTexture.m_TileShape.heightInTexels / blockSize;
-    const uint32_t bytesPerBlock = GraphicConstants::kTiledResourceSizeInBytes / (shapeBlocksWidth * shapeBlocksHeight);
-    const uint32_t sourceBlockX = tile.m_XInTexels / blockSize;
-    const uint32_t sourceBlockY = tile.m_YInTexels / blockSize;
-    const uint32_t rowPitchTile = tileBlocksWidth * bytesPerBlock;
-
-    check(m_UploadTileScratchBuffer.size() >= tileBlocksWidth * tileBlocksHeight * bytesPerBlock);
+    const nvrhi::FormatInfo& formatInfo = nvrhi::getFormatInfo(format);
+    const uint32_t tileBlocksWidth = DivideAndRoundUp(tile.m_WidthInTexels, formatInfo.blockSize);
+    const uint32_t tileBlocksHeight = DivideAndRoundUp(tile.m_HeightInTexels, formatInfo.blockSize);
+    const uint32_t rowPitchTile = tileBlocksWidth * formatInfo.bytesPerBlock;
+
+    // both tiled texture files & whole mips, once read, hold each tile contiguous
+    const std::byte* tileData;
+    if (!mipData.m_TileDatas.empty())
+    {
+        const TextureTileData& textureTileData = mipData.m_TileDatas.at(GetMipTileIndex(destTexture, tile));
+        check(textureTileData.m_bDataReady);
+        check(m_StreamingMemoryCache.GetSize(textureTileData.m_CacheEntryID) == rowPitchTile * tileBlocksHeight);
 
-    for (uint32_t blockRow = 0; blockRow < tileBlocksHeight; blockRow++)
+        tileData = m_StreamingMemoryCache.GetData(textureTileData.m_CacheEntryID);
+    }
+    else
     {
-        const int32_t readOffset = (sourceBlockY + blockRow) * mipData.m_RowPitch + sourceBlockX * bytesPerBlock;
-        const int32_t writeOffset = blockRow * rowPitchTile;
-        memcpy(m_UploadTileScratchBuffer.data() + writeOffset, mipData.m_Data.data() + readOffset, rowPitchTile);
+        check(mipData.m_bDataReady);
+        tileData = m_StreamingMemoryCache.GetData(mipData.m_CacheEntryID) + GetMipTileLayout(destTexture, tile.m_Mip).GetTileOffset(GetMipTileIndex(destTexture, tile));
     }
 
+    // the only CPU copy of the tile: from the cache to mapped staging memory. 1 memcpy for full tiles, whose staging row pitch is the tile's
+    const TileUploadRing::Allocation allocation = m_TileUploadRing.Allocate(format, destTexture.m_TileShape, tile.m_WidthInTexels, tile.m_HeightInTexels);
+    CopyRows(allocation.m_Data, allocation.m_RowPitch, tileData, rowPitchTile, rowPitchTile, tileBlocksHeight);
+
+    nvrhi::TextureSlice srcSlice;
+    srcSlice.x = allocation.m_XInTexels;
+    srcSlice.y = allocation.m_YInTexels;
+    srcSlice.z = 0;
+    srcSlice.width = allocation.m_WidthInTexels; // whole blocks, as copies of block compressed formats require
+    srcSlice.height = allocation.m_HeightInTexels;
+    srcSlice.depth = 1;
+    srcSlice.mipLevel = 0;
+
     nvrhi::TextureSlice destSlice;
     destSlice.x = tile.m_XInTexels;
     destSlice.y = tile.m_YInTexels;
@@ -570,8 +1047,7 @@ void TextureFeedbackManager::UploadTile(nvrhi::CommandListHandle commandList, ui
     destSlice.depth = 1;
     destSlice.mipLevel = tile.m_Mip;
 
-    PROFILE_SCOPED("writeTexture");
-    commandList->writeTexture(destTexture.m_NVRHITextureHandle, destSlice, m_UploadTileScratchBuffer.data(), rowPitchTile);
+    commandList->copyTexture(destTexture.m_NVRHITextureHandle, destSlice, allocation.m_StagingTexture, srcSlice);
 
     ++m_NumTilesUploaded;
 }
@@ -3,6 +3,12 @@
 #include "extern/nvrhi/include/nvrhi/nvrhi.h"
 #include "extern/nvidia/RTXTS-TTM/include/rtxts-ttm/TiledTextureManager.h"
 
+#include "FeedbackTrace.h"
+#include "StreamingIO.h"
+#include "StreamingMemoryCache.h"
+#include "TexturePrefetch.h"
+#include "TileUploadRing.h"
+#include "TileUploadScheduler.h"
 #include "Visual.h"
 
 struct FeedbackTextureTileInfo
@@ -14,6 +20,33 @@ struct FeedbackTextureTileInfo
     uint32_t m_HeightInTexels;
 };
 
+// Tile (un)mappings of a texture for 'updateTextureTileMappings', from the tiled texture manager's tiles to (un)map. Device agnostic & independent per texture, so textures are built in parallel
+// Reused across frames, to not reallocate per frame
+struct TextureTileMappings
+{
+    struct HeapRange
+    {
+        uint32_t m_HeapID;
+        uint32_t m_FirstRegion; // in the 'm_Map*' arrays
+        uint32_t m_NumRegions;
+    };
+
+    void BuildUnmappings(std::span<const uint32_t> tilesToUnmap, const std::vector<rtxts::TileCoord>& tileCoordinates);
+    void BuildMappings(std::span<const uint32_t> tilesToMap, const std::vector<rtxts::TileCoord>& tileCoordinates, const std::vector<rtxts::TileAllocation>& tileAllocations);
+
+    std::vector<nvrhi::TiledTextureCoordinate> m_UnmapCoordinates;
+    std::vector<nvrhi::TiledTextureRegion> m_UnmapRegions;
+
+    // grouped by heap, 1 'updateTextureTileMappings' per heap
+    std::vector<nvrhi::TiledTextureCoordinate> m_MapCoordinates;
+    std::vector<nvrhi::TiledTextureRegion> m_MapRegions;
+    std::vector<uint64_t> m_MapByteOffsets;
+    std::vector<HeapRange> m_MapHeapRanges;
+
+private:
+    std::vector<uint32_t> m_SortedTilesToMap;
+};
+
 class TextureFeedbackManager
 {
 public:
@@ -27,6 +60,9 @@ public:
     void EndFrame();
 
     void AddTexture(Texture& texture, const rtxts::TiledTextureDesc& tiledTextureDesc, rtxts::TextureDesc& feedbackDesc, rtxts::TextureDesc& minMipDesc);
+
+    // secondary textures of each set stop resolving their own feedback & follow their primary's. Call once all textures are loaded
+    void InitializeFeedbackSets(std::span<const TextureFeedbackSet> sets);
     const std::vector<rtxts::TileCoord>& GetTileCoordinates(uint32_t tiledtextureID) const { return m_TiledTextureManager->GetTileCoordinates(tiledtextureID); }
 
 private:
@@ -34,11 +70,33 @@ private:
     {
         uint32_t m_TextureIdx;
         FeedbackTextureTileInfo m_TileInfo;
+        StreamingMemoryCache::EntryID m_CacheEntryID; // of the tile or the mip, pinned until uploaded
+    };
+
+    // per texture state of a frame: its last feedback, its tile (un)mappings & uploads if it has tiles to map or unmap
+    struct TextureFrameState
+    {
+        std::vector<uint32_t> m_TilesToMap;
+        std::vector<bool> m_bTilesToMapPrefetched; // per 'm_TilesToMap', if only its prefetch mip requests it
+        std::vector<uint32_t> m_TilesToUnmap;
+        const std::vector<rtxts::TileCoord>* m_TileCoordinates = nullptr;
+        const std::vector<rtxts::TileAllocation>* m_TileAllocations = nullptr;
+
+        TextureTileMappings m_Mappings;
+        std::vector<FeedbackTextureTileInfo> m_PackedTiles;
+        std::vector<TileUploadScheduler<TileUpload>::Request> m_UploadRequests;
+        std::vector<FeedbackTextureTileInfo> m_TileInfoScratch;
+
+        std::vector<uint8_t> m_Feedback;           // resolved, or remapped from its primary's if it follows one
+        std::vector<uint8_t> m_PrefetchedFeedback; // 'm_Feedback' w/ 'm_PrefetchMip' merged in, fed to the tiled texture manager
+        uint8_t m_PrefetchMip = kNoPrefetchMip;
     };
 
     uint32_t AllocateHeap();
     void ReleaseHeap(uint32_t heapId);
     void UploadTile(nvrhi::CommandListHandle commandList, uint32_t destTextureIdx, const FeedbackTextureTileInfo& tile);
+    void ProcessStreamingIOCompletions();
+    void UpdateTexturePrefetchMips();
 
     std::unique_ptr<rtxts::TiledTextureManager> m_TiledTextureManager;
     std::mutex m_TiledTextureManagerLock;
@@ -46,14 +104,45 @@ private:
     uint32_t m_HeapSizeInBytes;
 
     std::vector<uint32_t> m_TexturesToProcessThisFrame;
-    std::vector<uint32_t> m_TexturesToReadback[2];
+    std::vector<const uint8_t*> m_ReadbackDatas;         // of 'm_TexturesToReadback', mapped
+    std::vector<TextureFrameState> m_TextureFrameStates; // per texture, reused across frames
+    std::vector<uint32_t> m_DirtyTextureIndices;         // with tiles to map or unmap this frame
+    std::vector<uint32_t> m_TexturesWithTilesToMap;
+    std::vector<uint8_t> m_MinMipScratchBuffer;
+    std::vector<uint32_t> m_TexturesToReadback[GraphicConstants::kMaxFramesInFlight];
     std::vector<nvrhi::HeapHandle> m_Heaps;
     std::vector<nvrhi::BufferHandle> m_Buffers;
     std::vector<uint32_t> m_FreeHeapIDs;
 
-    std::vector<TileUpload> m_TileUploads;
+    TileUploadScheduler<TileUpload> m_TileUploadScheduler;
+    std::vector<TileUpload> m_ScheduledTileUploads;
+    int m_TileUploadBudgetMB = 0;
+
+    // tiles are written straight to persistently mapped staging tiles & copied from there
+    TileUploadRing m_TileUploadRing;
+
+    // whole mips read from a DDS are reordered into tiles once read, see 'ConvertLinearMipToTiles'
+    std::vector<std::byte> m_LinearMipScratchBuffer;
+
+    // mip & tile reads. Completions are collected at the start of the tile uploads of every frame
+    StreamingIO m_StreamingIO;
+    std::vector<StreamingIO::Completion> m_StreamingIOCompletions;
+
+    // system memory of streamed mips & tiles, kept after upload in case they're mapped again, until evicted
+    StreamingMemoryCache m_StreamingMemoryCache;
+    int m_StreamingMemoryBudgetMB = 0;
+
+    // see 'TexturePrefetch'
+    CameraMotionPredictor m_CameraMotionPredictor;
+    std::vector<TexturePrefetchInstance> m_PrefetchInstances;     // per scene primitive
+    std::vector<MinMipFeedbackLayout> m_PrefetchTextureLayouts;   // per texture
+    std::vector<uint8_t> m_TexturePrefetchMips;                   // per texture
+    std::vector<uint8_t> m_CurrentTextureMipEstimates;            // per texture, from the current camera
+    bool m_bEnableTexturePrefetch = true;
+    float m_PrefetchMipBias = 1.0f; // prefetch coarser than estimated, feedback refines
 
-    std::vector<std::byte> m_UploadTileScratchBuffer;
+    // see 'FeedbackTrace'
+    FeedbackTraceRecorder m_FeedbackTraceRecorder;
 
     uint32_t m_NumHeaps = 0;
     
@@ -0,0 +1,280 @@
+#include "TextureFeedbackSets.h"
+
+#include "Engine.h"
+#include "HeadlessRuns.h"
+#include "MathUtilities.h"
+
+static const uint8_t kNotSampledMip = 0xFF;
+
+void BuildTextureFeedbackFollowers(std::span<const TextureFeedbackSet> sets, uint32_t numTextures, std::vector<uint32_t>& outPrimaryTextureIndices)
+{
+    PROFILE_FUNCTION();
+
+    static const uint32_t kIsPrimary = UINT_MAX - 1;         // primary of at least 1 set: never follows
+    static const uint32_t kHasDifferentPrimaries = UINT_MAX - 2;
+
+    // per texture: UINT_MAX if not in any set, the one primary of all its sets, or 1 of the 2 states above
+    std::vector<uint32_t> candidatePrimaries(numTextures, UINT_MAX);
+
+    auto GetSetPrimary = [](const TextureFeedbackSet& set)
+        {
+            for (uint32_t textureIdx : set.m_TextureIndices)
+            {
+                if (textureIdx != UINT_MAX)
+                {
+                    return textureIdx;
+                }
+            }
+            return UINT_MAX;
+        };
+
+    for (const TextureFeedbackSet& set : sets)
+    {
+        const uint32_t primaryTextureIdx = GetSetPrimary(set);
+        if (primaryTextureIdx != UINT_MAX)
+        {
+            candidatePrimaries.at(primaryTextureIdx) = kIsPrimary;
+        }
+    }
+
+    for (const TextureFeedbackSet& set : sets)
+    {
+        const uint32_t primaryTextureIdx = GetSetPrimary(set);
+
+        for (uint32_t textureIdx : set.m_TextureIndices)
+        {
+            if (textureIdx == UINT_MAX || textureIdx == primaryTextureIdx)
+            {
+                continue;
+            }
+
+            uint32_t& candidatePrimary = candidatePrimaries.at(textureIdx);
+            if (candidatePrimary == UINT_MAX)
+            {
+                candidatePrimary = primaryTextureIdx;
+            }
+            else if (candidatePrimary != kIsPrimary && candidatePrimary != primaryTextureIdx)
+            {
+                candidatePrimary = kHasDifferentPrimaries;
+            }
+        }
+    }
+
+    outPrimaryTextureIndices.assign(numTextures, UINT_MAX);
+    for (uint32_t i = 0; i < numTextures; ++i)
+    {
+        if (candidatePrimaries[i] < kHasDifferentPrimaries)
+        {
+            outPrimaryTextureIndices[i] = candidatePrimaries[i];
+        }
+    }
+}
+
+uint32_t MinMipFeedbackLayout::GetNumRegionsX() const
+{
+    return DivideAndRoundUp(m_Width, m_RegionWidth);
+}
+
+uint32_t MinMipFeedbackLayout::GetNumRegionsY() const
+{
+    return DivideAndRoundUp(m_Height, m_RegionHeight);
+}
+
+// [outFirst, outLast] source regions overlapping dest region 'destRegion' in UV space, along 1 axis
+static void GetOverlappedSourceRegions(uint32_t destRegion, uint32_t destSize, uint32_t destRegionSize, uint32_t srcSize, uint32_t srcRegionSize, uint32_t& outFirst, uint32_t& outLast)
+{
+    const uint64_t destBegin = (uint64_t)destRegion * destRegionSize;
+    const uint64_t destEnd = std::min<uint64_t>(destBegin + destRegionSize, destSize);
+
+    // source texels [srcBegin, srcEnd) overlap [destBegin / destSize, destEnd / destSize) in UV space
+    const uint64_t srcBegin = destBegin * srcSize / destSize;
+    const uint64_t srcEnd = (destEnd * srcSize + destSize - 1) / destSize;
+
+    outFirst = (uint32_t)(srcBegin / srcRegionSize);
+    outLast = (uint32_t)((srcEnd - 1) / srcRegionSize);
+}
+
+void RemapMinMipFeedback(const MinMipFeedbackLayout& srcLayout, const uint8_t* srcData, const MinMipFeedbackLayout& destLayout, uint8_t* destData)
+{
+    PROFILE_FUNCTION();
+
+    check(destLayout.m_NumMips > 0);
+
+    const uint32_t srcNumRegionsX = srcLayout.GetNumRegionsX();
+    const uint32_t destNumRegionsX = destLayout.GetNumRegionsX();
+    const uint32_t destNumRegionsY = destLayout.GetNumRegionsY();
+
+    // rounded down on the axis with the lowest ratio: never coarser than what the primary's texel density asks for
+    const float widthRatio = (float)destLayout.m_Width / srcLayout.m_Width;
+    const float heightRatio = (float)destLayout.m_Height / srcLayout.m_Height;
+    const int32_t mipOffset = (int32_t)std::floor(std::log2(std::min(widthRatio, heightRatio)));
+
+    for (uint32_t destY = 0; destY < destNumRegionsY; ++destY)
+    {
+        uint32_t srcFirstY, srcLastY;
+        GetOverlappedSourceRegions(destY, destLayout.m_Height, destLayout.m_RegionHeight, srcLayout.m_Height, srcLayout.m_RegionHeight, srcFirstY, srcLastY);
+
+        for (uint32_t destX = 0; destX < destNumRegionsX; ++destX)
+        {
+            uint32_t srcFirstX, srcLastX;
+            GetOverlappedSourceRegions(destX, destLayout.m_Width, destLayout.m_RegionWidth, srcLayout.m_Width, srcLayout.m_RegionWidth, srcFirstX, srcLastX);
+
+            uint8_t srcMip = kNotSampledMip;
+            for (uint32_t srcY = srcFirstY; srcY <= srcLastY; ++srcY)
+            {
+                for (uint32_t srcX = srcFirstX; srcX <= srcLastX; ++srcX)
+                {
+                    srcMip = std::min(srcMip, srcData[srcY * srcNumRegionsX + srcX]);
+                }
+            }
+
+            uint8_t destMip = kNotSampledMip;
+            if (srcMip != kNotSampledMip)
+            {
+                destMip = (uint8_t)std::clamp((int32_t)srcMip + mipOffset, 0, (int32_t)destLayout.m_NumMips - 1);
+            }
+            destData[destY * destNumRegionsX + destX] = destMip;
+        }
+    }
+}
+
+static void RunTextureFeedbackSetsSelfTest()
+{
+    PROFILE_FUNCTION();
+
+    // set matching
+    {
+        enum TextureID : uint32_t { A, N1, O1, O2, B, N2, C, D, E, N3, F, G, H, kNumTextures };
+
+        std::vector<TextureFeedbackSet> sets;
+        sets.push_back({ A, N1, O1 });
+        sets.push_back({ A, N1, O2 });                // shared follower, same primary
+        sets.push_back({ B, N2, UINT_MAX });
+        sets.push_back({ C, A, UINT_MAX });           // a primary elsewhere never follows
+        sets.push_back({ D, N3, UINT_MAX });
+        sets.push_back({ E, N3, UINT_MAX });          // sampled along 2 different primaries: resolves its own feedback
+        sets.push_back({ UINT_MAX, F, G });           // no albedo: the normal map is the primary
+        sets.push_back({ H, UINT_MAX, UINT_MAX });
+
+        std::vector<uint32_t> primaryTextureIndices;
+        BuildTextureFeedbackFollowers(sets, kNumTextures, primaryTextureIndices);
+
+        const uint32_t kExpected[kNumTextures] = { UINT_MAX, A, A, A, UINT_MAX, B, UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX, F, UINT_MAX };
+        test_verify(primaryTextureIndices.size() == kNumTextures);
+        for (uint32_t i = 0; i < kNumTextures; ++i)
+        {
+            test_verify(primaryTextureIndices[i] == kExpected[i]);
+        }
+    }
+
+    // same resolution: identical feedback
+    {
+        const MinMipFeedbackLayout layout{ 1024, 1024, 128, 128, 11 };
+
+        std::vector<uint8_t> src(layout.GetNumRegionsX() * layout.GetNumRegionsY());
+        for (uint32_t i = 0; i < src.size(); ++i)
+        {
+            src[i] = (i % 3 == 0) ? kNotSampledMip : (uint8_t)(i % 11);
+        }
+
+        std::vector<uint8_t> dest(src.size());
+        RemapMinMipFeedback(layout, src.data(), layout, dest.data());
+        test_verify(dest == src);
+    }
+
+    // follower twice as large: 1 mip coarser, each primary region covers 2x2 follower regions
+    {
+        const MinMipFeedbackLayout srcLayout{ 512, 256, 128, 128, 10 };
+        const MinMipFeedbackLayout destLayout{ 1024, 512, 128, 128, 11 };
+
+        const uint8_t src[4 * 2] =
+        {
+            0, 1, kNotSampledMip, 9,
+            3, 2, 5, kNotSampledMip,
+        };
+
+        std::vector<uint8_t> dest(destLayout.GetNumRegionsX() * destLayout.GetNumRegionsY());
+        test_verify(dest.size() == 8 * 4);
+        RemapMinMipFeedback(srcLayout, src, destLayout, dest.data());
+
+        for (uint32_t y = 0; y < 4; ++y)
+        {
+            for (uint32_t x = 0; x < 8; ++x)
+            {
+                const uint8_t srcMip = src[(y / 2) * 4 + x / 2];
+                const uint8_t expected = (srcMip == kNotSampledMip) ? kNotSampledMip : (uint8_t)std::min(srcMip + 1, 10);
+                test_verify(dest[y * 8 + x] == expected);
+            }
+        }
+    }
+
+    // follower half as large: 1 mip finer, clamped to mip 0, finest of the 2x2 primary regions
+    {
+        const MinMipFeedbackLayout srcLayout{ 512, 512, 128, 128, 10 };
+        const MinMipFeedbackLayout destLayout{ 256, 256, 128, 128, 9 };
+
+        const uint8_t src[4 * 4] =
+        {
+            0, 4, 6, 6,
+            4, 4, 7, kNotSampledMip,
+            kNotSampledMip, kNotSampledMip, 3, 8,
+            kNotSampledMip, kNotSampledMip, 8, 8,
+        };
+
+        uint8_t dest[2 * 2];
+        RemapMinMipFeedback(srcLayout, src, destLayout, dest);
+
+        test_verify(dest[0] == 0);
+        test_verify(dest[1] == 5);
+        test_verify(dest[2] == kNotSampledMip);
+        test_verify(dest[3] == 2);
+    }
+
+    // uneven sizes & regions: matches a brute force overlap test
+    {
+        const MinMipFeedbackLayout srcLayout{ 1000, 600, 128, 64, 10 };
+        const MinMipFeedbackLayout destLayout{ 700, 300, 64, 128, 10 };
+
+        std::mt19937 rng{ 7 };
+        std::vector<uint8_t> src(srcLayout.GetNumRegionsX() * srcLayout.GetNumRegionsY());
+        for (uint8_t& mip : src)
+        {
+            mip = (rng() % 4 == 0) ? kNotSampledMip : (uint8_t)(rng() % 10);
+        }
+
+        std::vector<uint8_t> dest(destLayout.GetNumRegionsX() * destLayout.GetNumRegionsY());
+        RemapMinMipFeedback(srcLayout, src.data(), destLayout, dest.data());
+
+        const int32_t kMipOffset = -1; // 0.7 & 0.5 ratios, the lowest one wins
+        for (uint32_t destY = 0; destY < destLayout.GetNumRegionsY(); ++destY)
+        {
+            for (uint32_t destX = 0; destX < destLayout.GetNumRegionsX(); ++destX)
+            {
+                const uint64_t destX0 = destX * destLayout.m_RegionWidth, destX1 = std::min((destX + 1) * destLayout.m_RegionWidth, destLayout.m_Width);
+                const uint64_t destY0 = destY * destLayout.m_RegionHeight, destY1 = std::min((destY + 1) * destLayout.m_RegionHeight, destLayout.m_Height);
+
+                uint8_t srcMip = kNotSampledMip;
+                for (uint32_t srcY = 0; srcY < srcLayout.GetNumRegionsY(); ++srcY)
+                {
+                    for (uint32_t srcX = 0; srcX < srcLayout.GetNumRegionsX(); ++srcX)
+                    {
+                        const uint64_t srcX0 = srcX * srcLayout.m_RegionWidth, srcX1 = std::min((srcX + 1) * srcLayout.m_RegionWidth, srcLayout.m_Width);
+                        const uint64_t srcY0 = srcY * srcLayout.m_RegionHeight, srcY1 = std::min((srcY + 1) * srcLayout.m_RegionHeight, srcLayout.m_Height);
+
+                        // overlap in UV space, cross-multiplied
+                        const bool bOverlapsX = (srcX0 * destLayout.m_Width < destX1 * srcLayout.m_Width) && (destX0 * srcLayout.m_Width < srcX1 * destLayout.m_Width);
+                        const bool bOverlapsY = (srcY0 * destLayout.m_Height < destY1 * srcLayout.m_Height) && (destY0 * srcLayout.m_Height < srcY1 * destLayout.m_Height);
+                        if (bOverlapsX && bOverlapsY)
+                        {
+                            srcMip = std::min(srcMip, src[srcY * srcLayout.GetNumRegionsX() + srcX]);
+                        }
+                    }
+                }
+
+                const uint8_t expected = (srcMip == kNotSampledMip) ? kNotSampledMip : (uint8_t)std::max((int32_t)srcMip + kMipOffset, 0);
+                test_verify(dest[destY * destLayout.GetNumRegionsX() + destX] == expected);
+            }
+        }
+    }
+}
+REGISTER_HEADLESS_RUN("texturefeedbacksetsselftest", HeadlessRunType::SelfTest, RunTextureFeedbackSetsSelfTest);
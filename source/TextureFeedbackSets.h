@@ -0,0 +1,29 @@
+#pragma once
+
+// Textures of a material, sampled with the same UVs. The first valid texture is the primary: its sampler feedback can drive the residency of the others
+// 'm_TextureIndices' in priority order: albedo, normal, ORM. UINT_MAX for no texture, or a texture that isn't streamed
+struct TextureFeedbackSet
+{
+    uint32_t m_TextureIndices[3] = { UINT_MAX, UINT_MAX, UINT_MAX };
+};
+
+// Per texture, the primary texture whose feedback it follows, or UINT_MAX if it resolves its own feedback
+// A texture follows only if it's never a primary & all the sets it's in share the same primary, so that wherever it's sampled, its primary is sampled too
+void BuildTextureFeedbackFollowers(std::span<const TextureFeedbackSet> sets, uint32_t numTextures, std::vector<uint32_t>& outPrimaryTextureIndices);
+
+// Resolved 'MinMipOpaque' sampler feedback of a texture: 1 byte per region of mip 0 texels, row-major, holding the finest mip sampled in the region or 0xFF
+struct MinMipFeedbackLayout
+{
+    uint32_t m_Width = 0;  // texture, in texels
+    uint32_t m_Height = 0;
+    uint32_t m_RegionWidth = 0; // in texels
+    uint32_t m_RegionHeight = 0;
+    uint32_t m_NumMips = 0;
+
+    uint32_t GetNumRegionsX() const;
+    uint32_t GetNumRegionsY() const;
+};
+
+// Maps the feedback of a primary texture onto a follower of possibly different resolution. Each follower region takes the finest mip of the primary regions it overlaps in UV space,
+// offset by the resolution ratio: a follower twice as large needs 1 mip coarser for the same texels on screen. Conservative, rounds towards finer mips. Device agnostic, see 'RunTextureFeedbackSetsSelfTest'
+void RemapMinMipFeedback(const MinMipFeedbackLayout& srcLayout, const uint8_t* srcData, const MinMipFeedbackLayout& destLayout, uint8_t* destData);
@@ -0,0 +1,618 @@
+#include "TexturePrefetch.h"
+
+#include "Engine.h"
+#include "Graphic.h"
+#include "HeadlessRuns.h"
+#include "Scene.h"
+#include "Visual.h"
+
+#include "shaders/ShaderInterop.h"
+
+void CameraMotionPredictor::AddSample(const Vector3& eye, const Quaternion& orientation, float deltaTimeSeconds)
+{
+    m_Samples[m_NextSampleIdx] = { eye, orientation, deltaTimeSeconds };
+    m_NextSampleIdx = (m_NextSampleIdx + 1) % kMaxSamples;
+    m_NumSamples = std::min(m_NumSamples + 1, kMaxSamples);
+}
+
+void CameraMotionPredictor::Predict(float lookAheadSeconds, Vector3& eyeOut, Quaternion& orientationOut) const
+{
+    check(m_NumSamples > 0);
+
+    const Sample& newest = GetSample(0);
+    eyeOut = newest.m_Eye;
+    orientationOut = newest.m_Orientation;
+
+    if (m_NumSamples < 2)
+    {
+        return;
+    }
+
+    const Sample& oldest = GetSample(m_NumSamples - 1);
+
+    float historySeconds = 0.0f;
+    for (uint32_t age = 0; age < m_NumSamples - 1; ++age)
+    {
+        historySeconds += GetSample(age).m_DeltaTimeSeconds;
+    }
+
+    if (historySeconds <= 0.0f)
+    {
+        return;
+    }
+
+    const float t = lookAheadSeconds / historySeconds;
+    eyeOut = newest.m_Eye + (newest.m_Eye - oldest.m_Eye) * t;
+
+    // past 1, slerp keeps rotating along the same arc
+    orientationOut = Quaternion::Slerp(oldest.m_Orientation, newest.m_Orientation, 1.0f + t);
+    orientationOut.Normalize();
+}
+
+float ComputeMeshUVDensity(std::span<const RawVertexFormat> vertices, std::span<const uint32_t> indices, float percentile)
+{
+    check(percentile >= 0.0f && percentile <= 1.0f);
+
+    struct TriangleDensity
+    {
+        float m_UVDensity;
+        float m_WorldArea;
+    };
+
+    std::vector<TriangleDensity> triangles;
+    triangles.reserve(indices.size() / 3);
+
+    double totalWorldArea = 0.0;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        const RawVertexFormat& v0 = vertices[indices[i + 0]];
+        const RawVertexFormat& v1 = vertices[indices[i + 1]];
+        const RawVertexFormat& v2 = vertices[indices[i + 2]];
+
+        // degenerate triangles aren't rasterized
+        const float worldArea = 0.5f * (v1.m_Position - v0.m_Position).Cross(v2.m_Position - v0.m_Position).Length();
+        if (worldArea <= kKindaSmallNumber * kKindaSmallNumber)
+        {
+            continue;
+        }
+
+        const Vector2 uv0{ ConvertHalfToFloat(v0.m_TexCoord.x), ConvertHalfToFloat(v0.m_TexCoord.y) };
+        const Vector2 uv1{ ConvertHalfToFloat(v1.m_TexCoord.x), ConvertHalfToFloat(v1.m_TexCoord.y) };
+        const Vector2 uv2{ ConvertHalfToFloat(v2.m_TexCoord.x), ConvertHalfToFloat(v2.m_TexCoord.y) };
+
+        const Vector2 e1 = uv1 - uv0;
+        const Vector2 e2 = uv2 - uv0;
+        const float uvArea = 0.5f * std::abs(e1.x * e2.y - e1.y * e2.x);
+
+        triangles.push_back({ uvArea / worldArea, worldArea });
+        totalWorldArea += worldArea;
+    }
+
+    if (triangles.empty())
+    {
+        return 0.0f;
+    }
+
+    std::sort(triangles.begin(), triangles.end(), [](const TriangleDensity& lhs, const TriangleDensity& rhs) { return lhs.m_UVDensity < rhs.m_UVDensity; });
+
+    const double targetWorldArea = percentile * totalWorldArea;
+    double accumulatedWorldArea = 0.0;
+    for (const TriangleDensity& triangle : triangles)
+    {
+        accumulatedWorldArea += triangle.m_WorldArea;
+        if (accumulatedWorldArea >= targetWorldArea)
+        {
+            return triangle.m_UVDensity;
+        }
+    }
+
+    return triangles.back().m_UVDensity;
+}
+
+float EstimateTextureMip(float uvDensity, uint32_t textureWidth, uint32_t textureHeight, float viewDepth, float fovY, float viewportHeight)
+{
+    check(uvDensity > 0.0f && viewDepth > 0.0f);
+
+    const float texelsPerWorldUnit = std::sqrt(uvDensity * textureWidth * textureHeight);
+    const float pixelsPerWorldUnit = viewportHeight / (2.0f * viewDepth * std::tan(fovY * 0.5f));
+
+    return std::log2(texelsPerWorldUnit / pixelsPerWorldUnit);
+}
+
+bool GetClosestViewDepth(const TexturePrefetchCamera& camera, const Sphere& worldSphere, float& outViewDepth)
+{
+    Quaternion worldToViewRotation;
+    camera.m_Orientation.Inverse(worldToViewRotation);
+
+    const Vector3 viewCenter = Vector3::Transform(Vector3{ worldSphere.Center } - camera.m_Eye, worldToViewRotation);
+    const float radius = worldSphere.Radius;
+
+    const float viewDepth = -viewCenter.z;
+    if (viewDepth + radius < camera.m_ZNear)
+    {
+        return false;
+    }
+
+    // side planes through the eye, in view space. Inside is where 'Dot(normal, p) <= 0'
+    const float tanHalfFOVY = std::tan(camera.m_FOV * 0.5f);
+    const float tanHalfFOVX = tanHalfFOVY * camera.m_AspectRatio;
+    const Vector3 sidePlaneNormals[] =
+    {
+        Vector3{  1.0f, 0.0f, tanHalfFOVX } / std::sqrt(1.0f + tanHalfFOVX * tanHalfFOVX),
+        Vector3{ -1.0f, 0.0f, tanHalfFOVX } / std::sqrt(1.0f + tanHalfFOVX * tanHalfFOVX),
+        Vector3{ 0.0f,  1.0f, tanHalfFOVY } / std::sqrt(1.0f + tanHalfFOVY * tanHalfFOVY),
+        Vector3{ 0.0f, -1.0f, tanHalfFOVY } / std::sqrt(1.0f + tanHalfFOVY * tanHalfFOVY),
+    };
+
+    for (const Vector3& planeNormal : sidePlaneNormals)
+    {
+        if (planeNormal.Dot(viewCenter) > radius)
+        {
+            return false;
+        }
+    }
+
+    // its closest point may face the camera
+    outViewDepth = std::max(viewDepth - radius, camera.m_ZNear);
+    return true;
+}
+
+bool GetEstimateViewDepth(const TexturePrefetchCamera& camera, const Sphere& worldSphere, float& outViewDepth)
+{
+    if (!GetClosestViewDepth(camera, worldSphere, outViewDepth))
+    {
+        return false;
+    }
+
+    if (outViewDepth <= camera.m_ZNear)
+    {
+        outViewDepth = std::max(worldSphere.Radius, camera.m_ZNear);
+    }
+    return true;
+}
+
+void ComputeTextureMipEstimates(const TexturePrefetchCamera& camera, std::span<const TexturePrefetchInstance> instances, std::span<const MinMipFeedbackLayout> textureLayouts, float mipBias, std::vector<uint8_t>& outMips)
+{
+    PROFILE_FUNCTION();
+
+    outMips.assign(textureLayouts.size(), kNoPrefetchMip);
+
+    for (const TexturePrefetchInstance& instance : instances)
+    {
+        float viewDepth;
+        if (instance.m_UVDensity <= 0.0f || !GetEstimateViewDepth(camera, instance.m_WorldBoundingSphere, viewDepth))
+        {
+            continue;
+        }
+
+        for (uint32_t textureIdx : instance.m_TextureIndices)
+        {
+            if (textureIdx == UINT_MAX)
+            {
+                continue;
+            }
+
+            const MinMipFeedbackLayout& layout = textureLayouts[textureIdx];
+            if (layout.m_NumMips == 0)
+            {
+                continue;
+            }
+
+            const float mip = EstimateTextureMip(instance.m_UVDensity, layout.m_Width, layout.m_Height, viewDepth, camera.m_FOV, camera.m_ViewportHeight) + mipBias;
+            const uint8_t clampedMip = (uint8_t)std::clamp(std::floor(mip), 0.0f, (float)(layout.m_NumMips - 1));
+
+            outMips[textureIdx] = std::min(outMips[textureIdx], clampedMip);
+        }
+    }
+}
+
+void ComputeTexturePrefetchMips(const TexturePrefetchCamera& currentCamera, const TexturePrefetchCamera& predictedCamera, std::span<const TexturePrefetchInstance> instances,
+    std::span<const MinMipFeedbackLayout> textureLayouts, float mipBias, std::vector<uint8_t>& outCurrentMips, std::vector<uint8_t>& outPrefetchMips)
+{
+    PROFILE_FUNCTION();
+
+    ComputeTextureMipEstimates(currentCamera, instances, textureLayouts, mipBias, outCurrentMips);
+    ComputeTextureMipEstimates(predictedCamera, instances, textureLayouts, mipBias, outPrefetchMips);
+
+    for (uint32_t i = 0; i < outPrefetchMips.size(); ++i)
+    {
+        if (outPrefetchMips[i] >= outCurrentMips[i])
+        {
+            outPrefetchMips[i] = kNoPrefetchMip;
+        }
+    }
+}
+
+void MergePrefetchMip(std::span<uint8_t> minMipFeedback, uint8_t prefetchMip)
+{
+    for (uint8_t& minMip : minMipFeedback)
+    {
+        minMip = std::min(minMip, prefetchMip);
+    }
+}
+
+bool IsTileRequestedByFeedback(const MinMipFeedbackLayout& layout, std::span<const uint8_t> minMipFeedback, uint32_t tileX, uint32_t tileY, uint32_t mip, uint32_t tileWidth, uint32_t tileHeight)
+{
+    const uint32_t numRegionsX = layout.GetNumRegionsX();
+    check(minMipFeedback.size() == numRegionsX * layout.GetNumRegionsY());
+
+    // the tile's texels, scaled to mip 0
+    const uint32_t beginX = (tileX * tileWidth) << mip;
+    const uint32_t beginY = (tileY * tileHeight) << mip;
+    const uint32_t endX = std::min(((tileX + 1) * tileWidth) << mip, layout.m_Width);
+    const uint32_t endY = std::min(((tileY + 1) * tileHeight) << mip, layout.m_Height);
+
+    for (uint32_t regionY = beginY / layout.m_RegionHeight; regionY < DivideAndRoundUp(endY, layout.m_RegionHeight); ++regionY)
+    {
+        for (uint32_t regionX = beginX / layout.m_RegionWidth; regionX < DivideAndRoundUp(endX, layout.m_RegionWidth); ++regionX)
+        {
+            if (minMipFeedback[regionY * numRegionsX + regionX] <= mip)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+TexturePrefetchCamera MakeTexturePrefetchCamera(const View& view)
+{
+    TexturePrefetchCamera camera;
+    camera.m_Eye = view.m_Eye;
+    camera.m_Orientation = view.m_Orientation;
+    camera.m_FOV = view.m_FOV;
+    camera.m_AspectRatio = view.m_AspectRatio;
+    camera.m_ZNear = view.m_ZNearP;
+    camera.m_ViewportHeight = (float)g_Graphic.m_RenderResolution.y;
+    return camera;
+}
+
+TexturePrefetchInstance MakeTexturePrefetchInstance(const Primitive& primitive, uint32_t meshLODIdx)
+{
+    const Mesh& mesh = g_Graphic.m_Meshes.at(primitive.m_MeshIdx);
+    check(meshLODIdx < mesh.m_NumLODs);
+
+    TexturePrefetchInstance instance;
+
+    Matrix worldMatrix = g_Scene->m_Nodes.at(primitive.m_NodeID).MakeLocalToWorldMatrix();
+    mesh.m_BoundingSphere.Transform(instance.m_WorldBoundingSphere, worldMatrix);
+
+    // UV density is per world area: scale it by the least stretched axis, so the estimate errs towards finer mips
+    Vector3 scale, translation;
+    Quaternion rotation;
+    verify(worldMatrix.Decompose(scale, rotation, translation));
+    const float minScale = std::min({ std::abs(scale.x), std::abs(scale.y), std::abs(scale.z) });
+    instance.m_UVDensity = (minScale > 0.0f) ? mesh.m_LODs[meshLODIdx].m_UVDensity / (minScale * minScale) : 0.0f;
+
+    const Material& material = primitive.m_Material;
+    instance.m_TextureIndices[0] = material.m_Albedo.m_TextureIdx;
+    instance.m_TextureIndices[1] = material.m_Normal.m_TextureIdx;
+    instance.m_TextureIndices[2] = material.m_MetallicRoughness.m_TextureIdx;
+    instance.m_TextureIndices[3] = material.m_Emissive.m_TextureIdx;
+
+    return instance;
+}
+
+void GetExpectedTextureMips(const View& view, const Primitive& primitive, uint32_t meshLODIdx, float outMips[4])
+{
+    const TexturePrefetchCamera camera = MakeTexturePrefetchCamera(view);
+    const TexturePrefetchInstance instance = MakeTexturePrefetchInstance(primitive, meshLODIdx);
+
+    std::fill(outMips, outMips + std::size(instance.m_TextureIndices), FLT_MAX);
+
+    // the finest mip the primitive can need: unlike the prefetch estimates, not made coarser for primitives reaching the near plane
+    float closestViewDepth;
+    if (instance.m_UVDensity <= 0.0f || !GetClosestViewDepth(camera, instance.m_WorldBoundingSphere, closestViewDepth))
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < std::size(instance.m_TextureIndices); ++i)
+    {
+        if (instance.m_TextureIndices[i] == UINT_MAX)
+        {
+            continue;
+        }
+
+        const nvrhi::TextureDesc& textureDesc = g_Graphic.m_Textures.at(instance.m_TextureIndices[i]).m_NVRHITextureHandle->getDesc();
+        outMips[i] = EstimateTextureMip(instance.m_UVDensity, textureDesc.width, textureDesc.height, closestViewDepth, camera.m_FOV, camera.m_ViewportHeight);
+    }
+}
+
+// 'numX' x 'numY' quads over [0, 'size'] in XY, facing +Z, w/ UVs over [0, 'uvScale']
+static void MakePlaneMesh(uint32_t numX, uint32_t numY, float size, float uvScale, std::vector<RawVertexFormat>& outVertices, std::vector<uint32_t>& outIndices)
+{
+    outVertices.clear();
+    outIndices.clear();
+
+    for (uint32_t y = 0; y <= numY; ++y)
+    {
+        for (uint32_t x = 0; x <= numX; ++x)
+        {
+            const Vector2 uv{ (float)x / numX, (float)y / numY };
+
+            RawVertexFormat& vertex = outVertices.emplace_back();
+            vertex.m_Position = Vector3{ uv.x * size, uv.y * size, 0.0f };
+            vertex.m_TexCoord = Half2{ uv.x * uvScale, uv.y * uvScale };
+        }
+    }
+
+    for (uint32_t y = 0; y < numY; ++y)
+    {
+        for (uint32_t x = 0; x < numX; ++x)
+        {
+            const uint32_t i = y * (numX + 1) + x;
+            outIndices.insert(outIndices.end(), { i, i + 1, i + numX + 1, i + 1, i + numX + 2, i + numX + 1 });
+        }
+    }
+}
+
+// latitude/longitude sphere, w/ U along the longitude & V along the latitude, both over [0, 1]
+static void MakeSphereMesh(uint32_t numLongitudes, uint32_t numLatitudes, float radius, std::vector<RawVertexFormat>& outVertices, std::vector<uint32_t>& outIndices)
+{
+    outVertices.clear();
+    outIndices.clear();
+
+    for (uint32_t lat = 0; lat <= numLatitudes; ++lat)
+    {
+        for (uint32_t lon = 0; lon <= numLongitudes; ++lon)
+        {
+            const Vector2 uv{ (float)lon / numLongitudes, (float)lat / numLatitudes };
+            const float phi = uv.x * 2.0f * std::numbers::pi_v<float>;
+            const float theta = uv.y * std::numbers::pi_v<float>;
+
+            RawVertexFormat& vertex = outVertices.emplace_back();
+            vertex.m_Position = Vector3{ std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) } * radius;
+            vertex.m_TexCoord = Half2{ uv.x, uv.y };
+        }
+    }
+
+    for (uint32_t lat = 0; lat < numLatitudes; ++lat)
+    {
+        for (uint32_t lon = 0; lon < numLongitudes; ++lon)
+        {
+            const uint32_t i = lat * (numLongitudes + 1) + lon;
+            outIndices.insert(outIndices.end(), { i, i + 1, i + numLongitudes + 1, i + 1, i + numLongitudes + 2, i + numLongitudes + 1 }); // degenerate at the poles
+        }
+    }
+}
+
+static void TestMeshUVDensity()
+{
+    auto IsNearlyEqual = [](float a, float b, float relativeTolerance) { return std::abs(a - b) <= relativeTolerance * std::abs(b); };
+
+    std::vector<RawVertexFormat> vertices;
+    std::vector<uint32_t> indices;
+
+    // plane of 'kPlaneSize' world units, its UVs repeating 'kUVScale' times: (kUVScale / kPlaneSize)^2 everywhere
+    const float kPlaneSize = 8.0f;
+    const float kUVScale = 4.0f;
+    MakePlaneMesh(16, 16, kPlaneSize, kUVScale, vertices, indices);
+
+    const float kPlaneUVDensity = (kUVScale * kUVScale) / (kPlaneSize * kPlaneSize);
+    test_verify(IsNearlyEqual(ComputeMeshUVDensity(vertices, indices), kPlaneUVDensity, 1e-3f));
+    test_verify(IsNearlyEqual(ComputeMeshUVDensity(vertices, indices, 0.0f), kPlaneUVDensity, 1e-3f));
+    test_verify(IsNearlyEqual(ComputeMeshUVDensity(vertices, indices, 1.0f), kPlaneUVDensity, 1e-3f));
+
+    // a thin triangle mapping a whole UV square skews the ratio of the totals, not the median
+    {
+        const uint32_t firstVertexIdx = (uint32_t)vertices.size();
+        RawVertexFormat sliver[3];
+        sliver[0].m_Position = Vector3{ 0.0f, 0.0f, 1.0f };
+        sliver[1].m_Position = Vector3{ kPlaneSize, 0.0f, 1.0f };
+        sliver[2].m_Position = Vector3{ 0.0f, 0.01f, 1.0f };
+        sliver[0].m_TexCoord = Half2{ 0.0f, 0.0f };
+        sliver[1].m_TexCoord = Half2{ 64.0f, 0.0f };
+        sliver[2].m_TexCoord = Half2{ 0.0f, 64.0f };
+        vertices.insert(vertices.end(), std::begin(sliver), std::end(sliver));
+        indices.insert(indices.end(), { firstVertexIdx, firstVertexIdx + 1, firstVertexIdx + 2 });
+
+        test_verify(IsNearlyEqual(ComputeMeshUVDensity(vertices, indices), kPlaneUVDensity, 1e-3f));
+        test_verify(ComputeMeshUVDensity(vertices, indices, 1.0f) > kPlaneUVDensity * 1000.0f);
+    }
+
+    // no UVs
+    MakePlaneMesh(4, 4, kPlaneSize, 0.0f, vertices, indices);
+    test_verify(ComputeMeshUVDensity(vertices, indices) == 0.0f);
+
+    // on a lat/long sphere, UV density is 1 / (2 * pi^2 * r^2 * sin(theta)) at latitude theta. Area is uniform in cos(theta),
+    // so area weighted, sin(theta) is above sqrt(3) / 2 half the time: the median density is 1 / (pi^2 * r^2 * sqrt(3))
+    const float kSphereRadius = 2.0f;
+    MakeSphereMesh(64, 32, kSphereRadius, vertices, indices);
+
+    const float kPi = std::numbers::pi_v<float>;
+    const float kSphereMedianUVDensity = 1.0f / (kPi * kPi * kSphereRadius * kSphereRadius * std::sqrt(3.0f));
+    test_verify(IsNearlyEqual(ComputeMeshUVDensity(vertices, indices), kSphereMedianUVDensity, 0.02f));
+
+    // denser towards the poles, the least dense along the equator
+    test_verify(IsNearlyEqual(ComputeMeshUVDensity(vertices, indices, 0.0f), 1.0f / (2.0f * kPi * kPi * kSphereRadius * kSphereRadius), 0.02f));
+    test_verify(ComputeMeshUVDensity(vertices, indices, 0.9f) > kSphereMedianUVDensity);
+
+    // expected mip of a texture on the plane facing the camera: 1 texel per pixel at mip 0 where 'sqrt(density) * 1024' texels per world unit
+    // match the '1080 / (2 * depth)' pixels per world unit of a 90 degrees fov, then 1 mip coarser every time the depth doubles
+    TexturePrefetchCamera camera;
+    camera.m_Eye = Vector3::Zero;
+    camera.m_Orientation = Quaternion::Identity;
+    camera.m_FOV = ConvertToRadians(90.0f);
+    camera.m_AspectRatio = 1.0f;
+    camera.m_ZNear = 0.1f;
+    camera.m_ViewportHeight = 1080.0f;
+
+    const float kMip0Depth = 1080.0f / (2.0f * std::sqrt(kPlaneUVDensity) * 1024.0f);
+    for (float expectedMip : { 1.5f, 3.5f })
+    {
+        const float depth = kMip0Depth * std::exp2(expectedMip);
+
+        // a tiny sphere, so its closest point is at 'depth'
+        float closestViewDepth;
+        test_verify(GetClosestViewDepth(camera, Sphere{ Vector3{ 0.0f, 0.0f, -depth }, 1e-3f }, closestViewDepth));
+        test_verify(std::abs(EstimateTextureMip(kPlaneUVDensity, 1024, 1024, closestViewDepth, camera.m_FOV, camera.m_ViewportHeight) - expectedMip) < 1e-2f);
+    }
+
+    float closestViewDepth;
+    test_verify(!GetClosestViewDepth(camera, Sphere{ Vector3{ 0.0f, 0.0f, 5.0f }, 1.0f }, closestViewDepth));
+    test_verify(GetClosestViewDepth(camera, Sphere{ Vector3{ 0.0f, 0.0f, -1.0f }, 2.0f }, closestViewDepth) && closestViewDepth == camera.m_ZNear);
+}
+
+static void RunTexturePrefetchSelfTest()
+{
+    PROFILE_FUNCTION();
+
+    auto IsNearlyEqual = [](float a, float b, float tolerance) { return std::abs(a - b) <= tolerance; };
+
+    const float kDeltaTimeSeconds = 0.1f;
+    const Vector3 kVelocity{ 1.0f, 0.0f, -2.0f }; // per second
+    const float kYawRate = ConvertToRadians(-100.0f); // per second, turning right
+
+    // constant linear & angular velocity are extrapolated exactly
+    CameraMotionPredictor predictor;
+    const uint32_t kNumSamples = 4;
+    for (uint32_t i = 0; i < kNumSamples; ++i)
+    {
+        const float time = i * kDeltaTimeSeconds;
+        predictor.AddSample(kVelocity * time, Quaternion::CreateFromAxisAngle(Vector3::UnitY, kYawRate * time), kDeltaTimeSeconds);
+    }
+
+    const float kLookAheadSeconds = 0.5f;
+    const float predictedTime = (kNumSamples - 1) * kDeltaTimeSeconds + kLookAheadSeconds;
+
+    Vector3 predictedEye;
+    Quaternion predictedOrientation;
+    predictor.Predict(kLookAheadSeconds, predictedEye, predictedOrientation);
+    test_verify(Vector3::Distance(predictedEye, kVelocity * predictedTime) < 1e-4f);
+    test_verify(std::abs(predictedOrientation.Dot(Quaternion::CreateFromAxisAngle(Vector3::UnitY, kYawRate * predictedTime))) > 1.0f - 1e-5f);
+
+    // w/o history, the camera stays
+    {
+        CameraMotionPredictor singleSamplePredictor;
+        singleSamplePredictor.AddSample(Vector3::UnitX, Quaternion::Identity, kDeltaTimeSeconds);
+
+        Vector3 eye;
+        Quaternion orientation;
+        singleSamplePredictor.Predict(kLookAheadSeconds, eye, orientation);
+        test_verify(eye == Vector3::UnitX && orientation == Quaternion::Identity);
+    }
+
+    // 1 UV unit per world unit on a 1024 texture is 1024 texels per world unit. w/ a 90 degrees fov over 1080 pixels, a world unit covers 1080 / (2 * depth) pixels
+    const float kFOV = ConvertToRadians(90.0f);
+    const float kViewportHeight = 1080.0f;
+    test_verify(IsNearlyEqual(EstimateTextureMip(1.0f, 1024, 1024, 1080.0f / 2048.0f, kFOV, kViewportHeight), 0.0f, 1e-4f));
+    test_verify(IsNearlyEqual(EstimateTextureMip(1.0f, 1024, 1024, 4.0f * 1080.0f / 2048.0f, kFOV, kViewportHeight), 2.0f, 1e-4f));
+    test_verify(IsNearlyEqual(EstimateTextureMip(0.25f, 1024, 1024, 1080.0f / 2048.0f, kFOV, kViewportHeight), -1.0f, 1e-4f)); // UVs cover a quarter: half the texels per unit
+    test_verify(IsNearlyEqual(EstimateTextureMip(1.0f, 2048, 2048, 1080.0f / 2048.0f, kFOV, kViewportHeight), 1.0f, 1e-4f));
+
+    // synthetic scene, camera at the origin looking down -Z
+    std::vector<MinMipFeedbackLayout> textureLayouts(6);
+    for (MinMipFeedbackLayout& layout : textureLayouts)
+    {
+        layout = { 1024, 1024, 256, 256, 11 };
+    }
+    textureLayouts[5].m_NumMips = 0; // not streamed
+
+    auto MakeInstance = [](const Vector3& center, float radius, float uvDensity, uint32_t textureIdx)
+        {
+            TexturePrefetchInstance instance;
+            instance.m_WorldBoundingSphere = Sphere{ center, radius };
+            instance.m_UVDensity = uvDensity;
+            instance.m_TextureIndices[0] = textureIdx;
+            return instance;
+        };
+
+    const float kClosestDepth = 5.0f * 1080.0f / 2048.0f; // mip log2(5), see above
+    std::vector<TexturePrefetchInstance> instances =
+    {
+        MakeInstance(Vector3{ 0.0f, 0.0f, -(kClosestDepth + 1.0f) }, 1.0f, 1.0f, 0),
+        MakeInstance(Vector3{ 0.0f, 0.0f, -100.0f }, 1.0f, 1.0f, 0),              // same texture further away: the closest instance wins
+        MakeInstance(Vector3{ 0.0f, 0.0f, 10.0f }, 1.0f, 1.0f, 1),                // behind the camera
+        MakeInstance(Vector3{ 20.0f, 0.0f, 5.0f }, 1.0f, 1.0f, 2),                // right of the frustum, until the camera turns
+        MakeInstance(Vector3{ 0.0f, 0.0f, -10.0f }, 1.0f, 0.0f, 3),               // no UVs
+        MakeInstance(Vector3{ 0.0f, 0.0f, -1e6f }, 1.0f, 1.0f, 4),                // far away: clamped to the last mip
+        MakeInstance(Vector3{ 0.0f, 0.0f, -10.0f }, 1.0f, 1.0f, 5),
+        MakeInstance(Vector3{ -4.0f, 0.0f, 0.5f }, 5.0f, 1.0f, 1),                // straddles the left plane & the near plane
+    };
+    instances[7].m_TextureIndices[0] = UINT_MAX;
+    instances[7].m_TextureIndices[3] = 1;
+
+    TexturePrefetchCamera camera;
+    camera.m_Eye = Vector3::Zero;
+    camera.m_Orientation = Quaternion::Identity;
+    camera.m_FOV = kFOV;
+    camera.m_AspectRatio = 16.0f / 9.0f;
+    camera.m_ZNear = 0.1f;
+    camera.m_ViewportHeight = kViewportHeight;
+
+    // the instance reaching the near plane is estimated at its radius: mip floor(log2(5 * 2048 / 1080)) = 3
+    std::vector<uint8_t> mips;
+    ComputeTextureMipEstimates(camera, instances, textureLayouts, 0.0f, mips);
+    test_verify((mips == std::vector<uint8_t>{ 2, 3, kNoPrefetchMip, kNoPrefetchMip, 10, kNoPrefetchMip }));
+
+    // a mip bias requests coarser mips
+    ComputeTextureMipEstimates(camera, instances, textureLayouts, 1.0f, mips);
+    test_verify(mips[0] == 3);
+
+    // turning right, the predicted camera sees the instance on the right, & only that is prefetched
+    instances.pop_back();
+    TexturePrefetchCamera predictedCamera = camera;
+    std::vector<uint8_t> currentMips;
+
+    predictedCamera.m_Orientation = Quaternion::CreateFromAxisAngle(Vector3::UnitY, ConvertToRadians(-30.0f));
+    ComputeTexturePrefetchMips(camera, predictedCamera, instances, textureLayouts, 0.0f, currentMips, mips);
+    test_verify(std::count(mips.begin(), mips.end(), kNoPrefetchMip) == (ptrdiff_t)mips.size());
+
+    predictedCamera.m_Orientation = Quaternion::CreateFromAxisAngle(Vector3::UnitY, ConvertToRadians(-80.0f));
+    ComputeTexturePrefetchMips(camera, predictedCamera, instances, textureLayouts, 0.0f, currentMips, mips);
+    test_verify(currentMips[2] == kNoPrefetchMip && mips[2] != kNoPrefetchMip);
+    test_verify(mips[0] == kNoPrefetchMip);
+
+    // w/o motion, nothing is prefetched
+    ComputeTexturePrefetchMips(camera, camera, instances, textureLayouts, 0.0f, currentMips, mips);
+    test_verify(currentMips[0] == 2);
+    test_verify(std::count(mips.begin(), mips.end(), kNoPrefetchMip) == (ptrdiff_t)mips.size());
+
+    // camera inside a large instance, i.e. a room: its sphere reaches the near plane wherever the camera looks. Only coarse mips are estimated, & none prefetched
+    // while the camera moves inside it. Approaching a small instance in the room prefetches that one's texture only
+    {
+        const float kRoomRadius = 50.0f;
+        std::vector<TexturePrefetchInstance> roomInstances =
+        {
+            MakeInstance(Vector3{ 0.0f, 0.0f, -5.0f }, kRoomRadius, 1.0f, 0),
+            MakeInstance(Vector3{ 0.0f, 0.0f, -20.0f }, 0.5f, 1.0f, 1),
+        };
+
+        const uint8_t kRoomMip = (uint8_t)std::floor(std::log2(1024.0f / (kViewportHeight / (2.0f * kRoomRadius)))); // 6
+        const float kCameraSteps[] = { 0.0f, -1.0f, -2.0f, -8.0f };
+        for (float cameraZ : kCameraSteps)
+        {
+            TexturePrefetchCamera roomCamera = camera;
+            roomCamera.m_Eye = Vector3{ 0.0f, 0.0f, cameraZ };
+            predictedCamera = roomCamera;
+            predictedCamera.m_Eye.z -= 4.0f;
+
+            ComputeTexturePrefetchMips(roomCamera, predictedCamera, roomInstances, textureLayouts, 0.0f, currentMips, mips);
+            test_verify(currentMips[0] == kRoomMip);
+            test_verify(mips[0] == kNoPrefetchMip);
+            test_verify(mips[1] < currentMips[1]);
+        }
+    }
+
+    // 4x4 regions of 256 texels, only region (3, 1) samples mip 1
+    const MinMipFeedbackLayout& layout = textureLayouts[0];
+    std::vector<uint8_t> feedback(16, 0xFF);
+    feedback[1 * 4 + 3] = 1;
+
+    test_verify(IsTileRequestedByFeedback(layout, feedback, 1, 0, 1, 256, 256));  // covers regions [2, 3] x [0, 1]
+    test_verify(!IsTileRequestedByFeedback(layout, feedback, 0, 0, 1, 256, 256));
+    test_verify(!IsTileRequestedByFeedback(layout, feedback, 3, 1, 0, 256, 256)); // mip 0 isn't sampled
+    test_verify(IsTileRequestedByFeedback(layout, feedback, 0, 0, 2, 256, 256));  // covers all regions
+
+    MergePrefetchMip(feedback, 2);
+    test_verify(feedback[1 * 4 + 3] == 1);
+    test_verify(std::count(feedback.begin(), feedback.end(), 2) == 15);
+
+    MergePrefetchMip(feedback, kNoPrefetchMip);
+    test_verify(feedback[1 * 4 + 3] == 1);
+
+    TestMeshUVDensity();
+}
+REGISTER_HEADLESS_RUN("textureprefetchselftest", HeadlessRunType::SelfTest, RunTexturePrefetchSelfTest);
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "MathUtilities.h"
+#include "TextureFeedbackSets.h"
+
+// Predictive texture streaming: sampler feedback lags the camera by the readback & the feedback resolve round-robin, so detail pops in on fast moves
+// The camera is extrapolated from its recent motion, instances visible from the predicted camera estimate the mip of their textures from their UV density & distance,
+// & where that mip is finer than the one estimated from the current camera, it's merged into the texture's feedback as a low priority request. Device agnostic, see 'RunTexturePrefetchSelfTest'
+
+static const uint8_t kNoPrefetchMip = 0xFF;
+
+// Linear & angular camera velocity averaged over the last frames, extrapolated ahead
+class CameraMotionPredictor
+{
+public:
+    void AddSample(const Vector3& eye, const Quaternion& orientation, float deltaTimeSeconds);
+    void Reset() { m_NumSamples = 0; }
+
+    // the last sample, until there are at least 2
+    void Predict(float lookAheadSeconds, Vector3& eyeOut, Quaternion& orientationOut) const;
+
+private:
+    struct Sample
+    {
+        Vector3 m_Eye;
+        Quaternion m_Orientation;
+        float m_DeltaTimeSeconds; // since the previous sample
+    };
+
+    static constexpr uint32_t kMaxSamples = 8;
+
+    const Sample& GetSample(uint32_t age) const { return m_Samples[(m_NextSampleIdx + kMaxSamples - 1 - age) % kMaxSamples]; }
+
+    Sample m_Samples[kMaxSamples];
+    uint32_t m_NextSampleIdx = 0;
+    uint32_t m_NumSamples = 0;
+};
+
+struct TexturePrefetchCamera
+{
+    Vector3 m_Eye;
+    Quaternion m_Orientation; // looks down -Z, as 'View'
+    float m_FOV;              // vertical, in radians
+    float m_AspectRatio;
+    float m_ZNear;
+    float m_ViewportHeight;   // in pixels
+};
+
+struct TexturePrefetchInstance
+{
+    Sphere m_WorldBoundingSphere;
+    float m_UVDensity = 0.0f;     // UV area per world area, see 'ComputeMeshUVDensity'. 0 if the mesh has no UVs
+    uint32_t m_TextureIndices[4] = { UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX };
+};
+
+// UV area per world area of a mesh: the world area weighted 'percentile' of its triangles' ratios. Unlike the ratio of the totals, the median isn't skewed by
+// the few stretched or degenerate triangles most meshes have. 0 if the mesh has no UVs
+float ComputeMeshUVDensity(std::span<const struct RawVertexFormat> vertices, std::span<const uint32_t> indices, float percentile = 0.5f);
+
+// Mip sampled at ~1 texel per pixel for a texture on a surface w/ 'uvDensity' facing the camera, 'viewDepth' away. Not clamped to the texture's mips
+float EstimateTextureMip(float uvDensity, uint32_t textureWidth, uint32_t textureHeight, float viewDepth, float fovY, float viewportHeight);
+
+// View depth of the closest point of a world space sphere, clamped to the near plane. False if the sphere is out of the camera's frustum
+bool GetClosestViewDepth(const TexturePrefetchCamera& camera, const Sphere& worldSphere, float& outViewDepth);
+
+// View depth to estimate the mips of an instance bounded by 'worldSphere' at: its closest point, unless the sphere reaches the near plane
+// The camera is then in or right by the sphere, where its closest point tells nothing about its surfaces: its radius is used instead, so large instances only get coarse mips
+bool GetEstimateViewDepth(const TexturePrefetchCamera& camera, const Sphere& worldSphere, float& outViewDepth);
+
+// Per texture, the finest mip estimated by the instances in the camera's frustum, offset by 'mipBias' & clamped to its mips. 'kNoPrefetchMip' if no instance sees it
+// Textures are described by their feedback layout, textures w/o mips are skipped. Instances are bounded by their sphere, so the estimate errs towards finer mips
+void ComputeTextureMipEstimates(const TexturePrefetchCamera& camera, std::span<const TexturePrefetchInstance> instances, std::span<const MinMipFeedbackLayout> textureLayouts, float mipBias, std::vector<uint8_t>& outMips);
+
+// Per texture, the mip estimated from 'predictedCamera' if it's finer than the one estimated from 'currentCamera', else 'kNoPrefetchMip'
+// Only what the camera motion brings is prefetched: the bounding sphere estimate of what's already in view is left to the feedback, which knows better
+void ComputeTexturePrefetchMips(const TexturePrefetchCamera& currentCamera, const TexturePrefetchCamera& predictedCamera, std::span<const TexturePrefetchInstance> instances,
+    std::span<const MinMipFeedbackLayout> textureLayouts, float mipBias, std::vector<uint8_t>& outCurrentMips, std::vector<uint8_t>& outPrefetchMips);
+
+// Requests 'prefetchMip' in every region of a texture's MinMip feedback that doesn't sample a finer mip already
+void MergePrefetchMip(std::span<uint8_t> minMipFeedback, uint8_t prefetchMip);
+
+// Whether the MinMip feedback requests a standard tile, i.e. samples its mip or a finer one in any region the tile covers. Tiles are in tiles of 'mip'
+bool IsTileRequestedByFeedback(const MinMipFeedbackLayout& layout, std::span<const uint8_t> minMipFeedback, uint32_t tileX, uint32_t tileY, uint32_t mip, uint32_t tileWidth, uint32_t tileHeight);
+
+// Scene facing helpers: the camera of a view, & a scene primitive bounded by its world sphere, w/ the UV density of one of its mesh LODs
+TexturePrefetchCamera MakeTexturePrefetchCamera(const class View& view);
+TexturePrefetchInstance MakeTexturePrefetchInstance(const class Primitive& primitive, uint32_t meshLODIdx);
+
+// Mip sampled from each material texture of a scene primitive seen from 'view', in 'TexturePrefetchInstance::m_TextureIndices' order: albedo, normal, metallic roughness & emissive
+// Not clamped to the textures' mips. FLT_MAX if the texture is missing, or the primitive is out of view or has no UVs
+void GetExpectedTextureMips(const View& view, const Primitive& primitive, uint32_t meshLODIdx, float outMips[4]);
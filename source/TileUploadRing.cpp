@@ -0,0 +1,340 @@
+#include "TileUploadRing.h"
+
+#include "Engine.h"
+#include "Graphic.h"
+#include "HeadlessRuns.h"
+#include "TiledTextureFile.h"
+
+void TileShelfPacker::Reset(uint32_t width, uint32_t height)
+{
+    m_Width = width;
+    m_Height = height;
+    m_ShelfX = 0;
+    m_ShelfY = 0;
+    m_ShelfHeight = 0;
+}
+
+bool TileShelfPacker::Allocate(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY)
+{
+    check(width > 0 && height > 0);
+
+    if (width > m_Width)
+    {
+        return false;
+    }
+
+    // close the current shelf
+    if (m_ShelfX + width > m_Width)
+    {
+        m_ShelfY += m_ShelfHeight;
+        m_ShelfX = 0;
+        m_ShelfHeight = 0;
+    }
+
+    if (m_ShelfY + height > m_Height)
+    {
+        return false;
+    }
+
+    outX = m_ShelfX;
+    outY = m_ShelfY;
+
+    m_ShelfX += width;
+    m_ShelfHeight = std::max(m_ShelfHeight, height);
+
+    return true;
+}
+
+void TileStagingPlacer::Reset(uint32_t tileWidthInBlocks, uint32_t tileHeightInBlocks)
+{
+    m_TileWidthInBlocks = tileWidthInBlocks;
+    m_TileHeightInBlocks = tileHeightInBlocks;
+    m_bHasSharedStagingTile = false;
+}
+
+TileStagingPlacement TileStagingPlacer::Place(uint32_t widthInBlocks, uint32_t heightInBlocks)
+{
+    check(widthInBlocks <= m_TileWidthInBlocks && heightInBlocks <= m_TileHeightInBlocks);
+
+    TileStagingPlacement placement;
+    if (widthInBlocks == m_TileWidthInBlocks && heightInBlocks == m_TileHeightInBlocks)
+    {
+        placement.m_bNewStagingTile = true;
+        return placement;
+    }
+
+    placement.m_bShared = true;
+    if (!m_bHasSharedStagingTile || !m_SharedStagingTilePacker.Allocate(widthInBlocks, heightInBlocks, placement.m_XInBlocks, placement.m_YInBlocks))
+    {
+        m_SharedStagingTilePacker.Reset(m_TileWidthInBlocks, m_TileHeightInBlocks);
+        verify(m_SharedStagingTilePacker.Allocate(widthInBlocks, heightInBlocks, placement.m_XInBlocks, placement.m_YInBlocks));
+
+        m_bHasSharedStagingTile = true;
+        placement.m_bNewStagingTile = true;
+    }
+
+    return placement;
+}
+
+void TileUploadRing::Shutdown()
+{
+    nvrhi::DeviceHandle device = g_Graphic.m_NVRHIDevice;
+    for (StagingTile& stagingTile : m_StagingTiles)
+    {
+        device->unmapStagingTexture(stagingTile.m_Texture);
+    }
+
+    m_StagingTiles.clear();
+    m_Pools.clear();
+}
+
+void TileUploadRing::BeginFrame(uint32_t frameSlot)
+{
+    check(frameSlot < GraphicConstants::kMaxFramesInFlight);
+    m_FrameSlot = frameSlot;
+
+    for (Pool& pool : m_Pools)
+    {
+        std::vector<uint32_t>& filledStagingTileIndices = pool.m_FilledStagingTileIndices[frameSlot];
+        pool.m_FreeStagingTileIndices.insert(pool.m_FreeStagingTileIndices.end(), filledStagingTileIndices.begin(), filledStagingTileIndices.end());
+        filledStagingTileIndices.clear();
+
+        pool.m_SharedStagingTileIdx = UINT_MAX;
+        pool.m_Placer.Reset(pool.m_TileWidthInBlocks, pool.m_TileHeightInBlocks);
+    }
+
+    m_NumStagingTilesFilledThisFrame = 0;
+    m_NumSharedTileUploadsThisFrame = 0;
+}
+
+TileUploadRing::Allocation TileUploadRing::Allocate(nvrhi::Format format, const nvrhi::TileShape& tileShape, uint32_t widthInTexels, uint32_t heightInTexels)
+{
+    check(widthInTexels <= tileShape.widthInTexels && heightInTexels <= tileShape.heightInTexels);
+
+    Pool& pool = GetPool(format, tileShape);
+    const nvrhi::FormatInfo& formatInfo = nvrhi::getFormatInfo(format);
+
+    const TileStagingPlacement placement = pool.m_Placer.Place(DivideAndRoundUp(widthInTexels, formatInfo.blockSize), DivideAndRoundUp(heightInTexels, formatInfo.blockSize));
+
+    uint32_t stagingTileIdx;
+    if (placement.m_bShared)
+    {
+        if (placement.m_bNewStagingTile)
+        {
+            pool.m_SharedStagingTileIdx = AcquireStagingTile(pool);
+        }
+
+        stagingTileIdx = pool.m_SharedStagingTileIdx;
+        ++m_NumSharedTileUploadsThisFrame;
+    }
+    else
+    {
+        stagingTileIdx = AcquireStagingTile(pool);
+    }
+
+    const StagingTile& stagingTile = m_StagingTiles[stagingTileIdx];
+
+    Allocation allocation;
+    allocation.m_StagingTexture = stagingTile.m_Texture;
+    allocation.m_Data = GetTileStagingData(stagingTile.m_Data, stagingTile.m_RowPitch, formatInfo.bytesPerBlock, placement);
+    allocation.m_RowPitch = stagingTile.m_RowPitch;
+    allocation.m_XInTexels = placement.m_XInBlocks * formatInfo.blockSize;
+    allocation.m_YInTexels = placement.m_YInBlocks * formatInfo.blockSize;
+    allocation.m_WidthInTexels = AlignUp(widthInTexels, (uint32_t)formatInfo.blockSize);
+    allocation.m_HeightInTexels = AlignUp(heightInTexels, (uint32_t)formatInfo.blockSize);
+
+    return allocation;
+}
+
+TileUploadRing::Pool& TileUploadRing::GetPool(nvrhi::Format format, const nvrhi::TileShape& tileShape)
+{
+    for (Pool& pool : m_Pools)
+    {
+        if (pool.m_Format == format && pool.m_TileWidthInTexels == tileShape.widthInTexels && pool.m_TileHeightInTexels == tileShape.heightInTexels)
+        {
+            return pool;
+        }
+    }
+
+    const nvrhi::FormatInfo& formatInfo = nvrhi::getFormatInfo(format);
+
+    Pool& newPool = m_Pools.emplace_back();
+    newPool.m_Format = format;
+    newPool.m_TileWidthInTexels = tileShape.widthInTexels;
+    newPool.m_TileHeightInTexels = tileShape.heightInTexels;
+    newPool.m_TileWidthInBlocks = tileShape.widthInTexels / formatInfo.blockSize;
+    newPool.m_TileHeightInBlocks = tileShape.heightInTexels / formatInfo.blockSize;
+    newPool.m_Placer.Reset(newPool.m_TileWidthInBlocks, newPool.m_TileHeightInBlocks);
+    return newPool;
+}
+
+uint32_t TileUploadRing::AcquireStagingTile(Pool& pool)
+{
+    uint32_t stagingTileIdx;
+    if (!pool.m_FreeStagingTileIndices.empty())
+    {
+        stagingTileIdx = pool.m_FreeStagingTileIndices.back();
+        pool.m_FreeStagingTileIndices.pop_back();
+    }
+    else
+    {
+        PROFILE_SCOPED("Create Staging Tile");
+
+        nvrhi::DeviceHandle device = g_Graphic.m_NVRHIDevice;
+
+        nvrhi::TextureDesc desc;
+        desc.width = pool.m_TileWidthInTexels;
+        desc.height = pool.m_TileHeightInTexels;
+        desc.format = pool.m_Format;
+        desc.debugName = "Tile Upload Staging Tile";
+
+        StagingTile& stagingTile = m_StagingTiles.emplace_back();
+        stagingTile.m_Texture = device->createStagingTexture(desc, nvrhi::CpuAccessMode::Write);
+
+        // mapped once, for its whole lifetime: upload heaps can stay mapped while the GPU reads them
+        size_t rowPitch = 0;
+        stagingTile.m_Data = (std::byte*)device->mapStagingTexture(stagingTile.m_Texture, nvrhi::TextureSlice{}, nvrhi::CpuAccessMode::Write, &rowPitch);
+        stagingTile.m_RowPitch = (uint32_t)rowPitch;
+        check(stagingTile.m_Data);
+
+        stagingTileIdx = (uint32_t)m_StagingTiles.size() - 1;
+    }
+
+    pool.m_FilledStagingTileIndices[m_FrameSlot].push_back(stagingTileIdx);
+    ++m_NumStagingTilesFilledThisFrame;
+
+    return stagingTileIdx;
+}
+
+// CPU side of tile uploads: tiles of a mip reordered as whole mips read from a DDS are, packed into staging tiles w/ a row pitch of their own, land where the
+// linear mip has them once copied. Staging tiles are plain memory here
+static void RunTileUploadRingSelfTest()
+{
+    PROFILE_FUNCTION();
+
+    // shelves
+    {
+        TileShelfPacker packer;
+        packer.Reset(256, 256);
+        test_verify(packer.IsEmpty());
+
+        uint32_t x, y;
+        test_verify(packer.Allocate(128, 64, x, y) && x == 0 && y == 0);
+        test_verify(packer.Allocate(100, 32, x, y) && x == 128 && y == 0);
+        test_verify(packer.Allocate(64, 16, x, y) && x == 0 && y == 64);  // doesn't fit the first shelf, starts a new one below its tallest rect
+        test_verify(packer.Allocate(192, 192, x, y) && x == 64 && y == 64);
+        test_verify(!packer.Allocate(64, 1, x, y));                         // a new shelf would start at 256
+        test_verify(!packer.Allocate(512, 1, x, y));
+
+        packer.Reset(256, 256);
+        test_verify(packer.Allocate(256, 256, x, y) && x == 0 && y == 0);  // a whole tile
+        test_verify(!packer.Allocate(4, 4, x, y));
+    }
+
+    struct TestCase
+    {
+        uint32_t m_WidthInBlocks;
+        uint32_t m_HeightInBlocks;
+        uint32_t m_BytesPerBlock;
+    };
+
+    static const TestCase kTestCases[] =
+    {
+        { 512, 342, 16 }, // BC7 2048 x 1365: small tiles along the bottom edge
+        { 128, 86, 16 },  // BC7 512 x 341: 85 texel tall bottom edge tiles, padded to 22 blocks
+        { 250, 150, 8 },  // BC1 1000 x 600: small tiles on both edges
+        { 300, 257, 4 },  // RGBA8
+        { 129, 3, 1 },    // R8, thinner than a tile
+    };
+
+    const uint32_t kStagingRowPitchAlignment = 256; // as D3D12 texture copies require
+
+    std::mt19937 rng{ 5678 };
+
+    for (const TestCase& testCase : kTestCases)
+    {
+        MipTileLayout layout;
+        layout.m_WidthInBlocks = testCase.m_WidthInBlocks;
+        layout.m_HeightInBlocks = testCase.m_HeightInBlocks;
+        layout.m_BytesPerBlock = testCase.m_BytesPerBlock;
+        TiledTextureFile::GetStandardTileShapeInBlocks(testCase.m_BytesPerBlock, layout.m_TileWidthInBlocks, layout.m_TileHeightInBlocks);
+
+        const uint32_t linearRowPitch = layout.m_WidthInBlocks * layout.m_BytesPerBlock;
+        std::vector<std::byte> linearMip(linearRowPitch * layout.m_HeightInBlocks);
+        for (std::byte& b : linearMip)
+        {
+            b = (std::byte)rng();
+        }
+
+        std::vector<std::byte> tiledMip(linearMip.size());
+        ConvertLinearMipToTiles(layout, linearMip, tiledMip);
+
+        const uint32_t stagingRowPitch = AlignUp(layout.m_TileWidthInBlocks * layout.m_BytesPerBlock, kStagingRowPitchAlignment);
+        std::vector<std::vector<std::byte>> stagingTiles;
+        TileStagingPlacer placer;
+        placer.Reset(layout.m_TileWidthInBlocks, layout.m_TileHeightInBlocks);
+        uint32_t sharedStagingTileIdx = UINT_MAX;
+
+        struct Placement
+        {
+            uint32_t m_StagingTileIdx;
+            TileStagingPlacement m_Placement;
+        };
+        std::vector<Placement> placements;
+
+        for (uint32_t mipTileIndex = 0; mipTileIndex < layout.GetWidthInTiles() * layout.GetHeightInTiles(); ++mipTileIndex)
+        {
+            uint32_t tileWidthInBlocks, tileHeightInBlocks;
+            layout.GetTileSizeInBlocks(mipTileIndex, tileWidthInBlocks, tileHeightInBlocks);
+
+            // the placement of 'TileUploadRing::Allocate', w/ plain memory staging tiles
+            const TileStagingPlacement placement = placer.Place(tileWidthInBlocks, tileHeightInBlocks);
+            test_verify(placement.m_XInBlocks + tileWidthInBlocks <= layout.m_TileWidthInBlocks && placement.m_YInBlocks + tileHeightInBlocks <= layout.m_TileHeightInBlocks);
+
+            uint32_t stagingTileIdx = sharedStagingTileIdx;
+            if (placement.m_bNewStagingTile)
+            {
+                stagingTileIdx = (uint32_t)stagingTiles.size();
+                stagingTiles.emplace_back(stagingRowPitch * layout.m_TileHeightInBlocks);
+            }
+            if (placement.m_bShared)
+            {
+                sharedStagingTileIdx = stagingTileIdx;
+            }
+
+            // as 'TextureFeedbackManager::UploadTile'
+            const uint32_t tileRowPitch = tileWidthInBlocks * layout.m_BytesPerBlock;
+            std::byte* stagingData = GetTileStagingData(stagingTiles[stagingTileIdx].data(), stagingRowPitch, layout.m_BytesPerBlock, placement);
+            CopyRows(stagingData, stagingRowPitch, tiledMip.data() + layout.GetTileOffset(mipTileIndex), tileRowPitch, tileRowPitch, tileHeightInBlocks);
+
+            placements.push_back({ stagingTileIdx, placement });
+        }
+
+        // once all tiles are written, so that tiles sharing a staging tile can't have overwritten each other
+        for (uint32_t mipTileIndex = 0; mipTileIndex < layout.GetWidthInTiles() * layout.GetHeightInTiles(); ++mipTileIndex)
+        {
+            uint32_t tileWidthInBlocks, tileHeightInBlocks;
+            layout.GetTileSizeInBlocks(mipTileIndex, tileWidthInBlocks, tileHeightInBlocks);
+
+            const Placement& placement = placements[mipTileIndex];
+            const uint32_t tileRowPitch = tileWidthInBlocks * layout.m_BytesPerBlock;
+            const std::byte* stagingData = GetTileStagingData(stagingTiles[placement.m_StagingTileIdx].data(), stagingRowPitch, layout.m_BytesPerBlock, placement.m_Placement);
+
+            // as the 'copyTexture' of the staging rect to the tile's rect in the mip
+            const uint32_t mipBlockX = (mipTileIndex % layout.GetWidthInTiles()) * layout.m_TileWidthInBlocks;
+            const uint32_t mipBlockY = (mipTileIndex / layout.GetWidthInTiles()) * layout.m_TileHeightInBlocks;
+            for (uint32_t blockRow = 0; blockRow < tileHeightInBlocks; ++blockRow)
+            {
+                const std::byte* expected = linearMip.data() + (mipBlockY + blockRow) * linearRowPitch + mipBlockX * layout.m_BytesPerBlock;
+                test_verify(memcmp(stagingData + blockRow * stagingRowPitch, expected, tileRowPitch) == 0);
+            }
+        }
+
+        const uint32_t numTiles = layout.GetWidthInTiles() * layout.GetHeightInTiles();
+        test_verify(stagingTiles.size() <= numTiles);
+
+        SDL_Log("Tile Upload Ring Self Test [%u x %u blocks, %u bytes per block]: %u tiles in %u staging tiles",
+            testCase.m_WidthInBlocks, testCase.m_HeightInBlocks, testCase.m_BytesPerBlock, numTiles, (uint32_t)stagingTiles.size());
+    }
+}
+REGISTER_HEADLESS_RUN("tileuploadringselftest", HeadlessRunType::SelfTest, RunTileUploadRingSelfTest);
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "extern/nvrhi/include/nvrhi/nvrhi.h"
+
+#include "GraphicConstants.h"
+
+// Packs rects in rows ('shelves') into a fixed size area: left to right on the current shelf, then on a new shelf below it. Rects are never freed, the area is reset as a whole
+class TileShelfPacker
+{
+public:
+    void Reset(uint32_t width, uint32_t height);
+
+    // false if the rect fits neither the current shelf nor a new one
+    bool Allocate(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY);
+
+    bool IsEmpty() const { return m_ShelfX == 0 && m_ShelfY == 0; }
+
+private:
+    uint32_t m_Width = 0;
+    uint32_t m_Height = 0;
+    uint32_t m_ShelfX = 0;
+    uint32_t m_ShelfY = 0;
+    uint32_t m_ShelfHeight = 0;
+};
+
+// Where a tile lands in staging tiles, in blocks
+struct TileStagingPlacement
+{
+    bool m_bShared = false;         // packed with other small tiles in the shared staging tile
+    bool m_bNewStagingTile = false; // needs a staging tile: one of its own, or a new shared one
+    uint32_t m_XInBlocks = 0;
+    uint32_t m_YInBlocks = 0;
+};
+
+// Placement of the tiles of 1 format & tile shape in staging tiles, in blocks so that every rect starts on a block boundary
+// Full tiles get a staging tile of their own, smaller ones are packed into the shared staging tile, or a new one once it's full. Device agnostic
+class TileStagingPlacer
+{
+public:
+    // forgets the shared staging tile, i.e.: at the start of a frame
+    void Reset(uint32_t tileWidthInBlocks, uint32_t tileHeightInBlocks);
+
+    TileStagingPlacement Place(uint32_t widthInBlocks, uint32_t heightInBlocks);
+
+private:
+    uint32_t m_TileWidthInBlocks = 0;
+    uint32_t m_TileHeightInBlocks = 0;
+    bool m_bHasSharedStagingTile = false;
+    TileShelfPacker m_SharedStagingTilePacker;
+};
+
+// top left of a placement in the mapped data of its staging tile
+inline std::byte* GetTileStagingData(std::byte* stagingTileData, uint32_t rowPitch, uint32_t bytesPerBlock, const TileStagingPlacement& placement)
+{
+    return stagingTileData + placement.m_YInBlocks * rowPitch + placement.m_XInBlocks * bytesPerBlock;
+}
+
+// Persistently mapped staging memory of tile uploads: tile data is written once to a staging tile, then copied to its texture with 1 'copyTexture'
+// Staging tiles are standard tile sized staging textures, pooled per format & tile shape, & reused 'kMaxFramesInFlight' frames after the frame that filled them
+// Tiles smaller than the tile shape, on the right & bottom edges of non-pow2 mips, are packed together into shared staging tiles, across textures of the same format. See 'TileStagingPlacer'
+// NOTE: not thread safe
+class TileUploadRing
+{
+public:
+    struct Allocation
+    {
+        nvrhi::IStagingTexture* m_StagingTexture = nullptr;
+        std::byte* m_Data = nullptr; // mapped, at the top left of the allocated rect
+        uint32_t m_RowPitch = 0;
+
+        // of the allocated rect in the staging texture, for the 'copyTexture' source slice. Whole blocks: the size of clipped edge tiles of block compressed mips is rounded up
+        uint32_t m_XInTexels = 0;
+        uint32_t m_YInTexels = 0;
+        uint32_t m_WidthInTexels = 0;
+        uint32_t m_HeightInTexels = 0;
+    };
+
+    void Shutdown();
+
+    // staging tiles filled the last time this frame slot was used are free again
+    void BeginFrame(uint32_t frameSlot);
+
+    Allocation Allocate(nvrhi::Format format, const nvrhi::TileShape& tileShape, uint32_t widthInTexels, uint32_t heightInTexels);
+
+    uint32_t GetNumStagingTiles() const { return (uint32_t)m_StagingTiles.size(); }
+
+    uint32_t m_NumStagingTilesFilledThisFrame = 0;
+    uint32_t m_NumSharedTileUploadsThisFrame = 0;
+
+private:
+    struct StagingTile
+    {
+        nvrhi::StagingTextureHandle m_Texture;
+        std::byte* m_Data = nullptr;
+        uint32_t m_RowPitch = 0;
+    };
+
+    // staging tiles of 1 format & tile shape
+    struct Pool
+    {
+        nvrhi::Format m_Format;
+        uint32_t m_TileWidthInTexels;
+        uint32_t m_TileHeightInTexels;
+        uint32_t m_TileWidthInBlocks;
+        uint32_t m_TileHeightInBlocks;
+
+        std::vector<uint32_t> m_FreeStagingTileIndices; // into 'm_StagingTiles'
+        std::vector<uint32_t> m_FilledStagingTileIndices[GraphicConstants::kMaxFramesInFlight];
+
+        // shared by the small tiles of this frame
+        uint32_t m_SharedStagingTileIdx = UINT_MAX;
+        TileStagingPlacer m_Placer;
+    };
+
+    Pool& GetPool(nvrhi::Format format, const nvrhi::TileShape& tileShape);
+    uint32_t AcquireStagingTile(Pool& pool);
+
+    std::vector<StagingTile> m_StagingTiles;
+    std::vector<Pool> m_Pools; // a handful of formats, searched linearly
+    uint32_t m_FrameSlot = 0;
+};
@@ -0,0 +1,152 @@
+#include "TileUploadScheduler.h"
+
+#include "EngineCore.h"
+#include "HeadlessRuns.h"
+#include "IntegerMath.h"
+
+// per frame upload budget of 'TextureFeedbackManager', also replayed by 'RunStreamingSimulator'
+CommandLineOption<int> g_TileUploadBudgetMB{ "tileuploadbudgetmb", 16 };
+
+static void RunTileUploadSchedulerSelfTest()
+{
+    PROFILE_FUNCTION();
+
+    using Scheduler = TileUploadScheduler<uint32_t>;
+    using UploadState = Scheduler::UploadState;
+
+    const uint32_t kTileSize = KB_TO_BYTES(64);
+
+    auto AlwaysReady = [](uint32_t) { return UploadState::Ready; };
+
+    // priority order
+    {
+        Scheduler scheduler;
+        scheduler.SetConfig({ UINT_MAX, 30 });
+
+        scheduler.Enqueue({ 0, 1.0f, kTileSize, 0 });
+        scheduler.Enqueue({ 2, 1.0f, kTileSize, 1 });
+        scheduler.Enqueue({ 1, 5.0f, kTileSize, 2 });
+        scheduler.Enqueue({ 2, 3.0f, kTileSize, 3 });
+        scheduler.Enqueue({ 1, 5.0f, kTileSize, 4 }); // same key as 2: enqueue order
+        scheduler.Enqueue({ 0, 2.0f, kTileSize, 5 });
+
+        std::vector<uint32_t> scheduled;
+        scheduler.ScheduleFrame(AlwaysReady, scheduled);
+
+        const std::vector<uint32_t> kExpected = { 3, 1, 2, 4, 5, 0 };
+        test_verify(scheduled == kExpected);
+        test_verify(scheduler.GetNumPendingUploads() == 0);
+    }
+
+    // prefetch uploads go after all others, whatever their mip
+    {
+        Scheduler scheduler;
+        scheduler.SetConfig({ UINT_MAX, 30 });
+
+        scheduler.Enqueue({ 4, 1.0f, kTileSize, 0, true });
+        scheduler.Enqueue({ 0, 1.0f, kTileSize, 1 });
+        scheduler.Enqueue({ 2, 1.0f, kTileSize, 2, true });
+        scheduler.Enqueue({ 1, 1.0f, kTileSize, 3 });
+
+        std::vector<uint32_t> scheduled;
+        scheduler.ScheduleFrame(AlwaysReady, scheduled);
+        test_verify((scheduled == std::vector<uint32_t>{ 3, 1, 0, 2 }));
+    }
+
+    // byte budget
+    {
+        Scheduler scheduler;
+        scheduler.SetConfig({ MB_TO_BYTES(1), 30 });
+
+        const uint32_t kNumUploads = 100;
+        for (uint32_t i = 0; i < kNumUploads; ++i)
+        {
+            scheduler.Enqueue({ i % 4, 1.0f, kTileSize, i });
+        }
+
+        std::vector<uint32_t> scheduled;
+        uint32_t numFrames = 0;
+        while (scheduler.GetNumPendingUploads() > 0)
+        {
+            const size_t numScheduledBefore = scheduled.size();
+            scheduler.ScheduleFrame(AlwaysReady, scheduled);
+            ++numFrames;
+
+            test_verify(scheduler.GetLastFrameNumBytesScheduled() <= MB_TO_BYTES(1));
+            test_verify((scheduled.size() - numScheduledBefore) * kTileSize == scheduler.GetLastFrameNumBytesScheduled());
+        }
+        test_verify(numFrames == DivideAndRoundUp(kNumUploads, MB_TO_BYTES(1) / kTileSize));
+        test_verify(scheduled.size() == kNumUploads);
+
+        // coarsest mips first, across frames
+        for (uint32_t i = 1; i < scheduled.size(); ++i)
+        {
+            test_verify(scheduled[i - 1] % 4 >= scheduled[i] % 4);
+        }
+
+        // an upload over the budget goes through alone, so it can't stall
+        scheduler.Enqueue({ 0, 1.0f, MB_TO_BYTES(2), 1000 });
+        scheduler.Enqueue({ 0, 1.0f, kTileSize, 1001 });
+
+        scheduled.clear();
+        scheduler.ScheduleFrame(AlwaysReady, scheduled);
+        test_verify(scheduled.size() == 1 && scheduled[0] == 1000);
+        scheduler.ScheduleFrame(AlwaysReady, scheduled);
+        test_verify(scheduled.size() == 2 && scheduled[1] == 1001);
+    }
+
+    // uploads not ready keep their place, dropped ones are removed
+    {
+        Scheduler scheduler;
+        scheduler.SetConfig({ kTileSize * 2, 30 });
+
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            scheduler.Enqueue({ 0, 1.0f, kTileSize, i });
+        }
+
+        std::vector<uint32_t> scheduled;
+        scheduler.ScheduleFrame([](uint32_t payload) { return (payload == 0) ? UploadState::NotReady : (payload == 1) ? UploadState::Dropped : UploadState::Ready; }, scheduled);
+        test_verify((scheduled == std::vector<uint32_t>{ 2, 3 }));
+        test_verify(scheduler.GetNumPendingUploads() == 1);
+
+        scheduled.clear();
+        scheduler.ScheduleFrame(AlwaysReady, scheduled);
+        test_verify((scheduled == std::vector<uint32_t>{ 0 }));
+    }
+
+    // starvation guard: a fine mip upload behind a steady flood of coarse ones that fills every frame
+    {
+        const uint32_t kStarvationAgeInFrames = 30;
+
+        Scheduler scheduler;
+        scheduler.SetConfig({ kTileSize * 4, kStarvationAgeInFrames });
+
+        const uint32_t kStarvedPayload = UINT_MAX;
+        scheduler.Enqueue({ 0, 0.0f, kTileSize, kStarvedPayload });
+
+        uint32_t payload = 0;
+        uint32_t scheduledFrameIdx = 0;
+        std::vector<uint32_t> scheduled;
+        for (uint32_t frameIdx = 1; frameIdx <= kStarvationAgeInFrames * 2 && scheduledFrameIdx == 0; ++frameIdx)
+        {
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                scheduler.Enqueue({ 8, 10.0f, kTileSize, payload++ });
+            }
+
+            scheduled.clear();
+            scheduler.ScheduleFrame(AlwaysReady, scheduled);
+            test_verify(scheduled.size() == 4);
+
+            if (std::find(scheduled.begin(), scheduled.end(), kStarvedPayload) != scheduled.end())
+            {
+                test_verify(scheduled[0] == kStarvedPayload); // goes first once starved
+                scheduledFrameIdx = frameIdx;
+            }
+        }
+        test_verify(scheduledFrameIdx == kStarvationAgeInFrames + 1);
+        test_verify(scheduler.m_NumStarvedUploads == 1);
+    }
+}
+REGISTER_HEADLESS_RUN("tileuploadschedulerselftest", HeadlessRunType::SelfTest, RunTileUploadSchedulerSelfTest);
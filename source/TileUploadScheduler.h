@@ -0,0 +1,147 @@
+#pragma once
+
+struct TileUploadSchedulerConfig
+{
+    uint32_t m_MaxBytesPerFrame = MB_TO_BYTES(16); // at least 1 upload per frame goes through regardless, so that bigger uploads can't stall
+    uint32_t m_StarvationAgeInFrames = 30;         // uploads waiting this long go before all others, oldest first
+};
+
+// Orders pending tile uploads & hands out at most 'm_MaxBytesPerFrame' worth of them per frame, so that fast camera moves are spread over several frames instead of hitching 1
+// Priority, most urgent first: starved uploads, non prefetch uploads, coarser mips, higher importance, then enqueue order. Coarser mips go first as finer mips fall back to them
+// Uploads whose data isn't ready are skipped & keep their place. Device agnostic, see 'RunTileUploadSchedulerSelfTest'
+// NOTE: not thread safe
+template <typename Payload>
+class TileUploadScheduler
+{
+public:
+    using Config = TileUploadSchedulerConfig;
+
+    enum class UploadState
+    {
+        Ready,
+        NotReady, // stays queued
+        Dropped,  // removed without being scheduled
+    };
+
+    struct Request
+    {
+        uint32_t m_Mip;
+        float m_Importance; // higher is more urgent
+        uint32_t m_NumBytes;
+        Payload m_Payload;
+        bool m_bPrefetch = false; // speculative, see 'TexturePrefetch'
+    };
+
+    void SetConfig(const Config& config) { m_Config = config; }
+    const Config& GetConfig() const { return m_Config; }
+
+    void Enqueue(const Request& request)
+    {
+        m_Pending.push_back({ request, m_FrameIdx, m_NextSequence++ });
+    }
+
+    // Moves this frame's uploads to 'outPayloads', most urgent first. 'getUploadState(const Payload&)' is called on candidates in priority order until the budget is spent
+    template <typename GetUploadStateFunc>
+    void ScheduleFrame(GetUploadStateFunc&& getUploadState, std::vector<Payload>& outPayloads)
+    {
+        ++m_FrameIdx;
+
+        std::sort(m_Pending.begin(), m_Pending.end(), [this](const PendingUpload& lhs, const PendingUpload& rhs) { return IsMoreUrgent(lhs, rhs); });
+
+        uint32_t numBytesScheduled = 0;
+        uint32_t numScheduled = 0;
+        bool bBudgetSpent = false;
+
+        std::erase_if(m_Pending, [&](const PendingUpload& pendingUpload)
+            {
+                if (bBudgetSpent)
+                {
+                    return false;
+                }
+
+                switch (getUploadState(pendingUpload.m_Request.m_Payload))
+                {
+                case UploadState::NotReady:
+                    return false;
+                case UploadState::Dropped:
+                    return true;
+                case UploadState::Ready:
+                    break;
+                }
+
+                // strict priority order: once an upload doesn't fit, smaller ones behind it wait too
+                if (numScheduled > 0 && numBytesScheduled + pendingUpload.m_Request.m_NumBytes > m_Config.m_MaxBytesPerFrame)
+                {
+                    bBudgetSpent = true;
+                    return false;
+                }
+
+                numBytesScheduled += pendingUpload.m_Request.m_NumBytes;
+                ++numScheduled;
+
+                if (IsStarved(pendingUpload))
+                {
+                    ++m_NumStarvedUploads;
+                }
+
+                outPayloads.push_back(pendingUpload.m_Request.m_Payload);
+                return true;
+            });
+
+        m_LastFrameNumBytesScheduled = numBytesScheduled;
+    }
+
+    uint32_t GetNumPendingUploads() const { return (uint32_t)m_Pending.size(); }
+    uint32_t GetLastFrameNumBytesScheduled() const { return m_LastFrameNumBytesScheduled; }
+
+    // stats
+    uint64_t m_NumStarvedUploads = 0; // scheduled through the starvation guard
+
+private:
+    struct PendingUpload
+    {
+        Request m_Request;
+        uint64_t m_EnqueueFrameIdx;
+        uint64_t m_Sequence;
+    };
+
+    bool IsStarved(const PendingUpload& pendingUpload) const
+    {
+        return m_FrameIdx - pendingUpload.m_EnqueueFrameIdx > m_Config.m_StarvationAgeInFrames;
+    }
+
+    bool IsMoreUrgent(const PendingUpload& lhs, const PendingUpload& rhs) const
+    {
+        const bool bLHSStarved = IsStarved(lhs);
+        const bool bRHSStarved = IsStarved(rhs);
+        if (bLHSStarved != bRHSStarved)
+        {
+            return bLHSStarved;
+        }
+        if (bLHSStarved)
+        {
+            return lhs.m_Sequence < rhs.m_Sequence;
+        }
+
+        if (lhs.m_Request.m_bPrefetch != rhs.m_Request.m_bPrefetch)
+        {
+            return rhs.m_Request.m_bPrefetch;
+        }
+        if (lhs.m_Request.m_Mip != rhs.m_Request.m_Mip)
+        {
+            return lhs.m_Request.m_Mip > rhs.m_Request.m_Mip;
+        }
+        if (lhs.m_Request.m_Importance != rhs.m_Request.m_Importance)
+        {
+            return lhs.m_Request.m_Importance > rhs.m_Request.m_Importance;
+        }
+        return lhs.m_Sequence < rhs.m_Sequence;
+    }
+
+    Config m_Config;
+
+    std::vector<PendingUpload> m_Pending;
+    uint64_t m_FrameIdx = 0;
+    uint64_t m_NextSequence = 0;
+    uint32_t m_LastFrameNumBytesScheduled = 0;
+};
@@ -0,0 +1,553 @@
+#include "TiledTextureFile.h"
+
+#include "Engine.h"
+#include "GraphicConstants.h"
+#include "HeadlessRuns.h"
+#include "TextureLoading.h"
+#include "Utilities.h"
+#include "Visual.h"
+
+std::string TiledTextureFile::GetFilePath(std::string_view ddsFilePath)
+{
+    const std::filesystem::path path{ ddsFilePath };
+    return (path.parent_path() / (path.stem().string() + "_Tiles.bin")).string();
+}
+
+uint64_t TiledTextureFile::GetSourceFileWriteTime(std::string_view ddsFilePath)
+{
+    std::error_code errorCode;
+    const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(ddsFilePath, errorCode);
+    return errorCode ? 0 : (uint64_t)writeTime.time_since_epoch().count();
+}
+
+bool TiledTextureFile::IsUpToDate(std::string_view ddsFilePath) const
+{
+    std::error_code errorCode;
+    const uint64_t sourceFileSize = std::filesystem::file_size(ddsFilePath, errorCode);
+
+    return IsValid() && !errorCode &&
+        (m_Header.m_SourceFileSize == sourceFileSize) &&
+        (m_Header.m_SourceFileWriteTime == GetSourceFileWriteTime(ddsFilePath));
+}
+
+void TiledTextureFile::GetStandardTileShapeInBlocks(uint32_t bytesPerBlock, uint32_t& outWidthInBlocks, uint32_t& outHeightInBlocks)
+{
+    check(bytesPerBlock > 0 && std::has_single_bit(bytesPerBlock));
+
+    // 64KB of blocks, in a square or a 2:1 rectangle: 256x256 for 1 byte blocks ... 128x64 for 8 bytes (BC1, BC4), 64x64 for 16 bytes (BC7)
+    const uint32_t numBlocksLog2 = std::countr_zero((uint32_t)GraphicConstants::kTiledResourceSizeInBytes) - std::countr_zero(bytesPerBlock);
+    outWidthInBlocks = 1u << ((numBlocksLog2 + 1) / 2);
+    outHeightInBlocks = 1u << (numBlocksLog2 / 2);
+}
+
+void TiledTextureFile::InitializeLayout(uint64_t sourceFileSize, uint64_t sourceFileWriteTime, uint32_t width, uint32_t height, uint32_t mipCount, uint32_t blockSizeInTexels, uint32_t bytesPerBlock)
+{
+    check(width > 0 && height > 0 && mipCount > 0 && mipCount <= GraphicConstants::kMaxTextureMips);
+
+    m_Header = Header{};
+    m_Header.m_SourceFileSize = sourceFileSize;
+    m_Header.m_SourceFileWriteTime = sourceFileWriteTime;
+    m_Header.m_Width = width;
+    m_Header.m_Height = height;
+    m_Header.m_MipCount = mipCount;
+    m_Header.m_BlockSizeInTexels = blockSizeInTexels;
+    m_Header.m_BytesPerBlock = bytesPerBlock;
+    GetStandardTileShapeInBlocks(bytesPerBlock, m_Header.m_TileWidthInBlocks, m_Header.m_TileHeightInBlocks);
+
+    m_Mips.resize(mipCount);
+    for (uint32_t i = 0; i < mipCount; ++i)
+    {
+        const uint32_t mipWidth = std::max<uint32_t>(1, width >> i);
+        const uint32_t mipHeight = std::max<uint32_t>(1, height >> i);
+
+        Mip& mip = m_Mips[i];
+        mip.m_WidthInBlocks = DivideAndRoundUp(mipWidth, blockSizeInTexels);
+        mip.m_HeightInBlocks = DivideAndRoundUp(mipHeight, blockSizeInTexels);
+        mip.m_WidthInTiles = DivideAndRoundUp(mip.m_WidthInBlocks, m_Header.m_TileWidthInBlocks);
+        mip.m_HeightInTiles = DivideAndRoundUp(mip.m_HeightInBlocks, m_Header.m_TileHeightInBlocks);
+        mip.m_FirstTileIndex = m_Header.m_NumTiles;
+
+        m_Header.m_NumTiles += mip.m_WidthInTiles * mip.m_HeightInTiles;
+    }
+
+    m_TileOffsets.resize(m_Header.m_NumTiles);
+
+    uint64_t fileOffset = AlignUp((uint64_t)(sizeof(Header) + m_TileOffsets.size() * sizeof(uint64_t)), (uint64_t)kTileAlignment);
+    for (uint32_t i = 0; i < mipCount; ++i)
+    {
+        const Mip& mip = m_Mips[i];
+        for (uint32_t mipTileIndex = 0; mipTileIndex < mip.m_WidthInTiles * mip.m_HeightInTiles; ++mipTileIndex)
+        {
+            m_TileOffsets[mip.m_FirstTileIndex + mipTileIndex] = fileOffset;
+            fileOffset += AlignUp((uint64_t)GetTileNumBytes(i, mipTileIndex), (uint64_t)kTileAlignment);
+        }
+    }
+}
+
+void TiledTextureFile::GetTileSizeInBlocks(uint32_t mip, uint32_t mipTileIndex, uint32_t& outWidthInBlocks, uint32_t& outHeightInBlocks) const
+{
+    const Mip& mipInfo = m_Mips.at(mip);
+    check(mipTileIndex < mipInfo.m_WidthInTiles * mipInfo.m_HeightInTiles);
+
+    const uint32_t tileX = mipTileIndex % mipInfo.m_WidthInTiles;
+    const uint32_t tileY = mipTileIndex / mipInfo.m_WidthInTiles;
+
+    outWidthInBlocks = std::min(m_Header.m_TileWidthInBlocks, mipInfo.m_WidthInBlocks - tileX * m_Header.m_TileWidthInBlocks);
+    outHeightInBlocks = std::min(m_Header.m_TileHeightInBlocks, mipInfo.m_HeightInBlocks - tileY * m_Header.m_TileHeightInBlocks);
+}
+
+uint32_t TiledTextureFile::GetTileNumBytes(uint32_t mip, uint32_t mipTileIndex) const
+{
+    uint32_t widthInBlocks, heightInBlocks;
+    GetTileSizeInBlocks(mip, mipTileIndex, widthInBlocks, heightInBlocks);
+    return widthInBlocks * heightInBlocks * m_Header.m_BytesPerBlock;
+}
+
+void MipTileLayout::GetTileSizeInBlocks(uint32_t mipTileIndex, uint32_t& outWidthInBlocks, uint32_t& outHeightInBlocks) const
+{
+    check(mipTileIndex < GetWidthInTiles() * GetHeightInTiles());
+
+    const uint32_t tileX = mipTileIndex % GetWidthInTiles();
+    const uint32_t tileY = mipTileIndex / GetWidthInTiles();
+
+    outWidthInBlocks = std::min(m_TileWidthInBlocks, m_WidthInBlocks - tileX * m_TileWidthInBlocks);
+    outHeightInBlocks = std::min(m_TileHeightInBlocks, m_HeightInBlocks - tileY * m_TileHeightInBlocks);
+}
+
+uint32_t MipTileLayout::GetTileOffset(uint32_t mipTileIndex) const
+{
+    check(mipTileIndex < GetWidthInTiles() * GetHeightInTiles());
+
+    const uint32_t tileX = mipTileIndex % GetWidthInTiles();
+    const uint32_t tileY = mipTileIndex / GetWidthInTiles();
+
+    // the tile rows above hold all of their block rows, & the tiles on the left of this tile row are all as tall as this one
+    const uint32_t tileRowHeightInBlocks = std::min(m_TileHeightInBlocks, m_HeightInBlocks - tileY * m_TileHeightInBlocks);
+    return (tileY * m_TileHeightInBlocks * m_WidthInBlocks + tileX * m_TileWidthInBlocks * tileRowHeightInBlocks) * m_BytesPerBlock;
+}
+
+void CopyRows(std::byte* dest, uint32_t destRowPitch, const std::byte* src, uint32_t srcRowPitch, uint32_t rowNumBytes, uint32_t numRows)
+{
+    check(destRowPitch >= rowNumBytes && srcRowPitch >= rowNumBytes);
+
+    if (destRowPitch == rowNumBytes && srcRowPitch == rowNumBytes)
+    {
+        memcpy(dest, src, (size_t)rowNumBytes * numRows);
+        return;
+    }
+
+    for (uint32_t row = 0; row < numRows; ++row)
+    {
+        memcpy(dest + (size_t)row * destRowPitch, src + (size_t)row * srcRowPitch, rowNumBytes);
+    }
+}
+
+void CopyTileFromLinearMip(const MipTileLayout& layout, std::span<const std::byte> linearMip, uint32_t mipTileIndex, std::byte* dest)
+{
+    const uint32_t linearRowPitch = layout.m_WidthInBlocks * layout.m_BytesPerBlock;
+    check(linearMip.size() == (size_t)linearRowPitch * layout.m_HeightInBlocks);
+
+    uint32_t tileWidthInBlocks, tileHeightInBlocks;
+    layout.GetTileSizeInBlocks(mipTileIndex, tileWidthInBlocks, tileHeightInBlocks);
+
+    const uint32_t sourceBlockX = (mipTileIndex % layout.GetWidthInTiles()) * layout.m_TileWidthInBlocks;
+    const uint32_t sourceBlockY = (mipTileIndex / layout.GetWidthInTiles()) * layout.m_TileHeightInBlocks;
+    const uint32_t tileRowPitch = tileWidthInBlocks * layout.m_BytesPerBlock;
+
+    const size_t readOffset = (size_t)sourceBlockY * linearRowPitch + sourceBlockX * layout.m_BytesPerBlock;
+    CopyRows(dest, tileRowPitch, linearMip.data() + readOffset, linearRowPitch, tileRowPitch, tileHeightInBlocks);
+}
+
+void ConvertLinearMipToTiles(const MipTileLayout& layout, std::span<const std::byte> linearMip, std::span<std::byte> outTiledMip)
+{
+    PROFILE_FUNCTION();
+
+    check(outTiledMip.size() == linearMip.size());
+
+    for (uint32_t mipTileIndex = 0; mipTileIndex < layout.GetWidthInTiles() * layout.GetHeightInTiles(); ++mipTileIndex)
+    {
+        CopyTileFromLinearMip(layout, linearMip, mipTileIndex, outTiledMip.data() + layout.GetTileOffset(mipTileIndex));
+    }
+}
+
+void TiledTextureFile::Write(FILE* f, std::span<const std::span<const std::byte>> linearMipDatas) const
+{
+    PROFILE_FUNCTION();
+
+    check(f);
+    check(IsValid());
+    check(linearMipDatas.size() == m_Mips.size());
+
+    verify(fwrite(&m_Header, sizeof(m_Header), 1, f) == 1);
+    verify(fwrite(m_TileOffsets.data(), sizeof(uint64_t), m_TileOffsets.size(), f) == m_TileOffsets.size());
+
+    uint64_t fileOffset = sizeof(Header) + m_TileOffsets.size() * sizeof(uint64_t);
+
+    std::vector<std::byte> tileData(GraphicConstants::kTiledResourceSizeInBytes);
+    const std::byte padding[kTileAlignment]{};
+
+    for (uint32_t i = 0; i < m_Mips.size(); ++i)
+    {
+        const Mip& mip = m_Mips[i];
+        const MipTileLayout mipTileLayout{ mip.m_WidthInBlocks, mip.m_HeightInBlocks, m_Header.m_TileWidthInBlocks, m_Header.m_TileHeightInBlocks, m_Header.m_BytesPerBlock };
+
+        for (uint32_t mipTileIndex = 0; mipTileIndex < mip.m_WidthInTiles * mip.m_HeightInTiles; ++mipTileIndex)
+        {
+            CopyTileFromLinearMip(mipTileLayout, linearMipDatas[i], mipTileIndex, tileData.data());
+
+            const uint64_t tileFileOffset = GetTileFileOffset(i, mipTileIndex);
+            check(tileFileOffset >= fileOffset && tileFileOffset - fileOffset < kTileAlignment);
+            if (tileFileOffset > fileOffset)
+            {
+                verify(fwrite(padding, 1, tileFileOffset - fileOffset, f) == tileFileOffset - fileOffset);
+            }
+
+            const uint32_t tileNumBytes = GetTileNumBytes(i, mipTileIndex);
+            verify(fwrite(tileData.data(), 1, tileNumBytes, f) == tileNumBytes);
+
+            fileOffset = tileFileOffset + tileNumBytes;
+        }
+    }
+}
+
+bool TiledTextureFile::Load(std::string_view filePath)
+{
+    PROFILE_FUNCTION();
+
+    *this = TiledTextureFile{};
+
+    if (!std::filesystem::exists(filePath))
+    {
+        return false;
+    }
+
+    const uint64_t fileSize = std::filesystem::file_size(filePath);
+
+    ScopedFile f{ filePath, "rb" };
+
+    Header header;
+    if (fread(&header, sizeof(header), 1, f) != 1 || header.m_Magic != kMagic || header.m_Version != kCurrentVersion)
+    {
+        return false;
+    }
+
+    if (header.m_MipCount == 0 || header.m_MipCount > GraphicConstants::kMaxTextureMips || header.m_Width == 0 || header.m_Height == 0 ||
+        header.m_BlockSizeInTexels == 0 || header.m_BytesPerBlock == 0 || !std::has_single_bit(header.m_BytesPerBlock))
+    {
+        return false;
+    }
+
+    // the layout is fully derived from the description. Anything else in the header means a corrupt file
+    InitializeLayout(header.m_SourceFileSize, header.m_SourceFileWriteTime, header.m_Width, header.m_Height, header.m_MipCount, header.m_BlockSizeInTexels, header.m_BytesPerBlock);
+    if (memcmp(&header, &m_Header, sizeof(Header)) != 0)
+    {
+        *this = TiledTextureFile{};
+        return false;
+    }
+
+    if (fread(m_TileOffsets.data(), sizeof(uint64_t), m_TileOffsets.size(), f) != m_TileOffsets.size())
+    {
+        *this = TiledTextureFile{};
+        return false;
+    }
+
+    for (uint32_t i = 0; i < m_Mips.size(); ++i)
+    {
+        const Mip& mip = m_Mips[i];
+        for (uint32_t mipTileIndex = 0; mipTileIndex < mip.m_WidthInTiles * mip.m_HeightInTiles; ++mipTileIndex)
+        {
+            if (GetTileFileOffset(i, mipTileIndex) + GetTileNumBytes(i, mipTileIndex) > fileSize)
+            {
+                *this = TiledTextureFile{};
+                return false;
+            }
+        }
+    }
+
+    m_FilePath = filePath;
+
+    return true;
+}
+
+void TiledTextureFile::ReadTile(FILE* f, uint32_t mip, uint32_t mipTileIndex, std::byte* dest) const
+{
+    PROFILE_FUNCTION();
+
+    check(f);
+    check(dest);
+
+    const uint32_t numBytes = GetTileNumBytes(mip, mipTileIndex);
+
+    _fseeki64(f, GetTileFileOffset(mip, mipTileIndex), SEEK_SET);
+    verify(fread(dest, 1, numBytes, f) == numBytes);
+}
+
+void ConvertDDSToTiledTextureFile(std::string_view ddsFilePath)
+{
+    PROFILE_FUNCTION();
+
+    Texture texture;
+    texture.m_ImageFilePath = ddsFilePath;
+
+    ScopedFile ddsFile{ ddsFilePath, "rb" };
+
+    ReadDDSTextureFileHeader(ddsFile, texture);
+
+    const TextureFileHeader& fileHeader = texture.m_TextureFileHeader;
+    texture.m_TextureMipDatas.resize(fileHeader.m_MipCount);
+
+    ReadDDSMipInfos(texture);
+
+    const nvrhi::FormatInfo& formatInfo = nvrhi::getFormatInfo(fileHeader.m_Format);
+
+    TiledTextureFile tiledTextureFile;
+    tiledTextureFile.InitializeLayout(fileHeader.m_FileSize, TiledTextureFile::GetSourceFileWriteTime(ddsFilePath), fileHeader.m_Width, fileHeader.m_Height, fileHeader.m_MipCount, formatInfo.blockSize, formatInfo.bytesPerBlock);
+
+    std::vector<std::span<const std::byte>> linearMipDatas;
+    for (uint32_t mip = 0; mip < fileHeader.m_MipCount; ++mip)
+    {
+        ReadDDSMipData(texture, ddsFile, mip);
+
+        const TextureMipData& mipData = texture.m_TextureMipDatas[mip];
+        check(mipData.m_RowPitch == tiledTextureFile.GetMip(mip).m_WidthInBlocks * formatInfo.bytesPerBlock);
+
+        linearMipDatas.push_back(mipData.m_Data);
+    }
+
+    const std::string tiledFilePath = TiledTextureFile::GetFilePath(ddsFilePath);
+    {
+        ScopedFile tiledFile{ tiledFilePath, "wb" };
+        tiledTextureFile.Write(tiledFile, linearMipDatas);
+    }
+
+    SDL_Log("Tiled Texture File: %s, %u x %u, %u mips, %u tiles", tiledFilePath.c_str(), fileHeader.m_Width, fileHeader.m_Height, fileHeader.m_MipCount, tiledTextureFile.GetHeader().m_NumTiles);
+}
+
+CommandLineOption<std::string> g_ConvertTiledTexturesPath{ "converttiledtexturespath", "" };
+
+void RunTiledTextureFileConverter(std::string_view path)
+{
+    PROFILE_FUNCTION();
+
+    if (path.empty())
+    {
+        SDL_Log("Tiled Texture File Converter: no DDS file or directory given. Use \"-converttiledtexturespath=<path>\"");
+        return;
+    }
+
+    std::vector<std::string> ddsFilePaths;
+    if (std::filesystem::is_directory(path))
+    {
+        for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator{ path })
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".dds")
+            {
+                ddsFilePaths.push_back(entry.path().string());
+            }
+        }
+    }
+    else
+    {
+        ddsFilePaths.push_back(std::string{ path });
+    }
+
+    uint32_t numConverted = 0;
+    for (const std::string& ddsFilePath : ddsFilePaths)
+    {
+        TiledTextureFile tiledTextureFile;
+        if (tiledTextureFile.Load(TiledTextureFile::GetFilePath(ddsFilePath)) && tiledTextureFile.IsUpToDate(ddsFilePath))
+        {
+            continue;
+        }
+
+        ConvertDDSToTiledTextureFile(ddsFilePath);
+        ++numConverted;
+    }
+
+    SDL_Log("Tiled Texture File Converter: %u of %u DDS files converted", numConverted, (uint32_t)ddsFilePaths.size());
+}
+REGISTER_HEADLESS_RUN("converttiledtextures", HeadlessRunType::Tool, [] { RunTiledTextureFileConverter(g_ConvertTiledTexturesPath.Get()); });
+
+// Round trip: linear mips -> tiled file -> tiles read 1 by 1, against the tiles copied block row by block row out of the linear mips
+static void RunTiledTextureFileSelfTest()
+{
+    PROFILE_FUNCTION();
+
+    struct TestCase
+    {
+        uint32_t m_Width;
+        uint32_t m_Height;
+        uint32_t m_BlockSizeInTexels;
+        uint32_t m_BytesPerBlock;
+    };
+
+    static const TestCase kTestCases[] =
+    {
+        { 256, 256, 4, 16 },  // BC7, exactly 1 tile
+        { 2048, 1365, 4, 16 },// BC7, non-pow2 height
+        { 1000, 600, 4, 8 },  // BC1, non-pow2 both ways & 2:1 tiles
+        { 300, 257, 1, 4 },   // RGBA8
+        { 513, 3, 1, 1 },     // R8, thinner than a tile
+        { 4096, 64, 4, 16 },  // BC7, wide strip
+    };
+
+    std::mt19937 rng{ 1234 };
+
+    const std::string filePath = (std::filesystem::temp_directory_path() / "TiledTextureFileSelfTest_Tiles.bin").string();
+
+    for (const TestCase& testCase : kTestCases)
+    {
+        const uint32_t mipCount = std::bit_width(std::max(testCase.m_Width, testCase.m_Height));
+
+        TiledTextureFile writtenFile;
+        writtenFile.InitializeLayout(12345, 67890, testCase.m_Width, testCase.m_Height, mipCount, testCase.m_BlockSizeInTexels, testCase.m_BytesPerBlock);
+
+        std::vector<std::vector<std::byte>> linearMips(mipCount);
+        std::vector<std::span<const std::byte>> linearMipSpans;
+        for (uint32_t mip = 0; mip < mipCount; ++mip)
+        {
+            const TiledTextureFile::Mip& mipInfo = writtenFile.GetMip(mip);
+            linearMips[mip].resize(mipInfo.m_WidthInBlocks * mipInfo.m_HeightInBlocks * testCase.m_BytesPerBlock);
+            for (std::byte& b : linearMips[mip])
+            {
+                b = (std::byte)rng();
+            }
+            linearMipSpans.push_back(linearMips[mip]);
+        }
+
+        {
+            ScopedFile f{ filePath, "wb" };
+            writtenFile.Write(f, linearMipSpans);
+        }
+
+        TiledTextureFile tiledTextureFile;
+        test_verify(tiledTextureFile.Load(filePath));
+        test_verify(memcmp(&tiledTextureFile.GetHeader(), &writtenFile.GetHeader(), sizeof(TiledTextureFile::Header)) == 0);
+
+        const uint32_t tileWidthInTexels = tiledTextureFile.GetHeader().m_TileWidthInBlocks * testCase.m_BlockSizeInTexels;
+        const uint32_t tileHeightInTexels = tiledTextureFile.GetHeader().m_TileHeightInBlocks * testCase.m_BlockSizeInTexels;
+        test_verify(tiledTextureFile.GetHeader().m_TileWidthInBlocks * tiledTextureFile.GetHeader().m_TileHeightInBlocks * testCase.m_BytesPerBlock == GraphicConstants::kTiledResourceSizeInBytes);
+
+        ScopedFile f{ filePath, "rb" };
+
+        std::vector<std::byte> tileData(GraphicConstants::kTiledResourceSizeInBytes);
+        std::vector<std::byte> expectedTileData(GraphicConstants::kTiledResourceSizeInBytes);
+        uint64_t lastTileEndOffset = 0;
+
+        for (uint32_t mip = 0; mip < mipCount; ++mip)
+        {
+            // tile rect in texels as 'Texture::GetTileInfo' computes it, mip size rounded up to whole blocks
+            const uint32_t mipWidth = AlignUp(std::max(testCase.m_Width >> mip, 1u), testCase.m_BlockSizeInTexels);
+            const uint32_t mipHeight = AlignUp(std::max(testCase.m_Height >> mip, 1u), testCase.m_BlockSizeInTexels);
+            const uint32_t widthInTiles = DivideAndRoundUp(mipWidth, tileWidthInTexels);
+            const uint32_t heightInTiles = DivideAndRoundUp(mipHeight, tileHeightInTexels);
+
+            const TiledTextureFile::Mip& mipInfo = tiledTextureFile.GetMip(mip);
+            test_verify(mipInfo.m_WidthInTiles == widthInTiles && mipInfo.m_HeightInTiles == heightInTiles);
+
+            // the same tiles, reordered in memory as whole mips read from the DDS are
+            const MipTileLayout mipTileLayout{ mipInfo.m_WidthInBlocks, mipInfo.m_HeightInBlocks, tiledTextureFile.GetHeader().m_TileWidthInBlocks, tiledTextureFile.GetHeader().m_TileHeightInBlocks, testCase.m_BytesPerBlock };
+            test_verify(mipTileLayout.GetWidthInTiles() == widthInTiles && mipTileLayout.GetHeightInTiles() == heightInTiles);
+
+            std::vector<std::byte> tiledMip(linearMips[mip].size());
+            ConvertLinearMipToTiles(mipTileLayout, linearMips[mip], tiledMip);
+
+            for (uint32_t tileY = 0; tileY < heightInTiles; ++tileY)
+            {
+                for (uint32_t tileX = 0; tileX < widthInTiles; ++tileX)
+                {
+                    const uint32_t x = tileX * tileWidthInTexels;
+                    const uint32_t y = tileY * tileHeightInTexels;
+                    const uint32_t width = std::min(tileWidthInTexels, mipWidth - x);
+                    const uint32_t height = std::min(tileHeightInTexels, mipHeight - y);
+
+                    // block rows, out of the linear mip
+                    const uint32_t tileBlocksWidth = width / testCase.m_BlockSizeInTexels;
+                    const uint32_t tileBlocksHeight = height / testCase.m_BlockSizeInTexels;
+                    const uint32_t sourceBlockX = x / testCase.m_BlockSizeInTexels;
+                    const uint32_t sourceBlockY = y / testCase.m_BlockSizeInTexels;
+                    const uint32_t rowPitchTile = tileBlocksWidth * testCase.m_BytesPerBlock;
+                    const uint32_t linearRowPitch = (mipWidth / testCase.m_BlockSizeInTexels) * testCase.m_BytesPerBlock;
+                    for (uint32_t blockRow = 0; blockRow < tileBlocksHeight; ++blockRow)
+                    {
+                        const uint32_t readOffset = (sourceBlockY + blockRow) * linearRowPitch + sourceBlockX * testCase.m_BytesPerBlock;
+                        memcpy(expectedTileData.data() + blockRow * rowPitchTile, linearMips[mip].data() + readOffset, rowPitchTile);
+                    }
+
+                    const uint32_t mipTileIndex = tileY * widthInTiles + tileX;
+                    const uint32_t numBytes = tiledTextureFile.GetTileNumBytes(mip, mipTileIndex);
+                    test_verify(numBytes == rowPitchTile * tileBlocksHeight);
+
+                    const uint64_t tileFileOffset = tiledTextureFile.GetTileFileOffset(mip, mipTileIndex);
+                    test_verify(tileFileOffset % TiledTextureFile::kTileAlignment == 0);
+                    test_verify(tileFileOffset >= lastTileEndOffset);
+                    lastTileEndOffset = tileFileOffset + numBytes;
+
+                    std::ranges::fill(tileData, std::byte{ 0xCD });
+                    tiledTextureFile.ReadTile(f, mip, mipTileIndex, tileData.data());
+                    test_verify(memcmp(tileData.data(), expectedTileData.data(), numBytes) == 0);
+
+                    const uint32_t tiledMipOffset = mipTileLayout.GetTileOffset(mipTileIndex);
+                    test_verify(tiledMipOffset + numBytes <= tiledMip.size());
+                    test_verify(memcmp(tiledMip.data() + tiledMipOffset, expectedTileData.data(), numBytes) == 0);
+                    if (mipTileIndex + 1 < widthInTiles * heightInTiles)
+                    {
+                        test_verify(mipTileLayout.GetTileOffset(mipTileIndex + 1) == tiledMipOffset + numBytes); // tightly packed
+                    }
+                    else
+                    {
+                        test_verify(tiledMipOffset + numBytes == tiledMip.size());
+                    }
+                    if (numBytes < tileData.size())
+                    {
+                        test_verify(tileData[numBytes] == std::byte{ 0xCD }); // nothing read past the tile
+                    }
+                }
+            }
+        }
+
+        test_verify(lastTileEndOffset == std::filesystem::file_size(filePath));
+
+        SDL_Log("Tiled Texture File Self Test [%u x %u, %u bytes per block]: %u mips, %u tiles, %.2f MB",
+            testCase.m_Width, testCase.m_Height, testCase.m_BytesPerBlock, mipCount, tiledTextureFile.GetHeader().m_NumTiles, BYTES_TO_MB(lastTileEndOffset));
+    }
+
+    // truncated files are rejected rather than read past their end
+    {
+        const uint64_t fileSize = std::filesystem::file_size(filePath);
+        std::filesystem::resize_file(filePath, fileSize - 1);
+
+        TiledTextureFile tiledTextureFile;
+        test_verify(!tiledTextureFile.Load(filePath));
+        test_verify(!tiledTextureFile.IsValid());
+    }
+
+    // a source modified in place, w/o changing its size, makes the tiled file stale
+    {
+        const std::string sourceFilePath = (std::filesystem::temp_directory_path() / "TiledTextureFileSelfTest.dds").string();
+        {
+            ScopedFile sourceFile{ sourceFilePath, "wb" };
+            test_verify(fwrite("abcd", 1, 4, sourceFile) == 4);
+        }
+
+        TiledTextureFile tiledTextureFile;
+        tiledTextureFile.InitializeLayout(4, TiledTextureFile::GetSourceFileWriteTime(sourceFilePath), 256, 256, 1, 1, 4);
+        test_verify(tiledTextureFile.IsUpToDate(sourceFilePath));
+
+        {
+            ScopedFile sourceFile{ sourceFilePath, "wb" };
+            test_verify(fwrite("efgh", 1, 4, sourceFile) == 4);
+        }
+        // file clocks can be coarser than the time it took to rewrite it
+        std::filesystem::last_write_time(sourceFilePath, std::filesystem::last_write_time(sourceFilePath) + std::chrono::seconds{ 2 });
+
+        test_verify(std::filesystem::file_size(sourceFilePath) == tiledTextureFile.GetHeader().m_SourceFileSize);
+        test_verify(!tiledTextureFile.IsUpToDate(sourceFilePath));
+
+        std::filesystem::remove(sourceFilePath);
+        test_verify(!tiledTextureFile.IsUpToDate(sourceFilePath));
+    }
+
+    std::filesystem::remove(filePath);
+}
+REGISTER_HEADLESS_RUN("tiledtexturefileselftest", HeadlessRunType::SelfTest, RunTiledTextureFileSelfTest);
@@ -0,0 +1,110 @@
+#pragma once
+
+// Streaming layout of a DDS texture, stored next to it as "<name>_Tiles.bin" & produced offline by 'ConvertDDSToTiledTextureFile'
+// Each mip is split in standard tiles of 'GraphicConstants::kTiledResourceSizeInBytes', stored row-major per mip with a tile offset table up front
+// A tile is contiguous, with its block rows tightly packed: exactly what 'TextureFeedbackManager::UploadTile' writes to the texture, so a tile is read & uploaded as is
+// Tiles on the right & bottom edges of non-pow2 mips are clipped to the mip, not padded. Device agnostic, see 'RunTiledTextureFileSelfTest'
+class TiledTextureFile
+{
+public:
+    static const uint32_t kMagic = 'T' | ('I' << 8) | ('L' << 16) | ('E' << 24);
+    static const uint32_t kCurrentVersion = 2; // increment this if the file format changes
+    static const uint32_t kTileAlignment = KB_TO_BYTES(4); // file offset alignment of every tile
+
+    struct Header
+    {
+        uint32_t m_Magic = kMagic;
+        uint32_t m_Version = kCurrentVersion;
+        // size & last write time of the source DDS. A mismatch of either means that the tiled file is stale, see 'IsUpToDate'
+        uint64_t m_SourceFileSize = 0;
+        uint64_t m_SourceFileWriteTime = 0;
+        uint32_t m_Width = 0;
+        uint32_t m_Height = 0;
+        uint32_t m_MipCount = 0;
+        uint32_t m_BlockSizeInTexels = 0; // 4 for BC formats, 1 otherwise
+        uint32_t m_BytesPerBlock = 0;
+        uint32_t m_TileWidthInBlocks = 0;
+        uint32_t m_TileHeightInBlocks = 0;
+        uint32_t m_NumTiles = 0;
+    };
+
+    struct Mip
+    {
+        uint32_t m_WidthInBlocks;
+        uint32_t m_HeightInBlocks;
+        uint32_t m_WidthInTiles;
+        uint32_t m_HeightInTiles;
+        uint32_t m_FirstTileIndex; // into 'm_TileOffsets'
+    };
+
+    static std::string GetFilePath(std::string_view ddsFilePath);
+
+    // file clock ticks. 0 if the file doesn't exist
+    static uint64_t GetSourceFileWriteTime(std::string_view ddsFilePath);
+
+    // Shape of a standard 64KB tile of a 2D texture, in blocks (texels for non-BC formats)
+    static void GetStandardTileShapeInBlocks(uint32_t bytesPerBlock, uint32_t& outWidthInBlocks, uint32_t& outHeightInBlocks);
+
+    // Derives the tile shape, the mip & tile tables & the tile offsets from the texture description
+    void InitializeLayout(uint64_t sourceFileSize, uint64_t sourceFileWriteTime, uint32_t width, uint32_t height, uint32_t mipCount, uint32_t blockSizeInTexels, uint32_t bytesPerBlock);
+
+    // Offline. 'linearMipDatas[mip]' is the mip as stored in the DDS: rows of 'Mip::m_WidthInBlocks' blocks
+    void Write(FILE* f, std::span<const std::span<const std::byte>> linearMipDatas) const;
+
+    // Reads the header & tile offset table. False if the file is missing, from another version or truncated
+    bool Load(std::string_view filePath);
+
+    // Reads exactly 1 tile into 'dest', which holds at least 'GetTileNumBytes' bytes
+    void ReadTile(FILE* f, uint32_t mip, uint32_t mipTileIndex, std::byte* dest) const;
+
+    // false if the DDS was modified or replaced since it was converted, even if its size didn't change
+    bool IsUpToDate(std::string_view ddsFilePath) const;
+
+    bool IsValid() const { return m_Header.m_NumTiles > 0; }
+    const Header& GetHeader() const { return m_Header; }
+    const Mip& GetMip(uint32_t mip) const { return m_Mips.at(mip); }
+    const std::string& GetFilePath() const { return m_FilePath; }
+
+    // 'mipTileIndex' is row-major in the mip, as rtxts tile indices & 'TextureMipData::m_ResidencyBits'
+    void GetTileSizeInBlocks(uint32_t mip, uint32_t mipTileIndex, uint32_t& outWidthInBlocks, uint32_t& outHeightInBlocks) const;
+    uint32_t GetTileNumBytes(uint32_t mip, uint32_t mipTileIndex) const;
+    uint64_t GetTileFileOffset(uint32_t mip, uint32_t mipTileIndex) const { return m_TileOffsets.at(m_Mips.at(mip).m_FirstTileIndex + mipTileIndex); }
+
+private:
+    Header m_Header;
+    std::vector<Mip> m_Mips;
+    std::vector<uint64_t> m_TileOffsets;
+    std::string m_FilePath;
+};
+
+// Tiles of 1 mip held in memory, in the 'TiledTextureFile' layout. Whole mips read from a DDS are reordered into it once read, so that every tile is contiguous & upload-ready
+struct MipTileLayout
+{
+    uint32_t m_WidthInBlocks;
+    uint32_t m_HeightInBlocks;
+    uint32_t m_TileWidthInBlocks;
+    uint32_t m_TileHeightInBlocks;
+    uint32_t m_BytesPerBlock;
+
+    uint32_t GetWidthInTiles() const { return DivideAndRoundUp(m_WidthInBlocks, m_TileWidthInBlocks); }
+    uint32_t GetHeightInTiles() const { return DivideAndRoundUp(m_HeightInBlocks, m_TileHeightInBlocks); }
+    void GetTileSizeInBlocks(uint32_t mipTileIndex, uint32_t& outWidthInBlocks, uint32_t& outHeightInBlocks) const;
+
+    // tiles are row-major & tightly packed: the tiled mip is as large as the linear one
+    uint32_t GetTileOffset(uint32_t mipTileIndex) const;
+};
+
+// 'numRows' rows of 'rowNumBytes', each at its own pitch in 'dest' & 'src'. A single copy if both are tightly packed
+void CopyRows(std::byte* dest, uint32_t destRowPitch, const std::byte* src, uint32_t srcRowPitch, uint32_t rowNumBytes, uint32_t numRows);
+
+// Copies 1 tile out of a linear mip, in rows of 'm_WidthInBlocks' blocks, into 'dest' w/ its block rows tightly packed
+void CopyTileFromLinearMip(const MipTileLayout& layout, std::span<const std::byte> linearMip, uint32_t mipTileIndex, std::byte* dest);
+
+// Reorders a linear mip into its tiles, each at 'MipTileLayout::GetTileOffset'
+void ConvertLinearMipToTiles(const MipTileLayout& layout, std::span<const std::byte> linearMip, std::span<std::byte> outTiledMip);
+
+// Writes "<name>_Tiles.bin" next to a DDS, with the tiles of all of its mips. CPU only
+void ConvertDDSToTiledTextureFile(std::string_view ddsFilePath);
+
+// Converts a DDS, or all DDS files under a folder, whose tiled files are missing or stale
+void RunTiledTextureFileConverter(std::string_view path);
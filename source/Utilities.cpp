@@ -1,5 +1,5 @@
 #include "Utilities.h"
-#include "Engine.h"
+#include "EngineCore.h"
 
 static_assert(magic_enum::is_magic_enum_supported);
 
@@ -10,13 +10,18 @@ const char* StringFormat(const char* format, ...)
     va_list args_list;
     va_start(args_list, format);
 
+    // the 1st vsnprintf consumes the list on non-MSVC compilers
+    va_list args_list_copy;
+    va_copy(args_list_copy, args_list);
+
     if (int len = std::vsnprintf(nullptr, 0, format, args_list);
         len > 0)
     {
         buffer.resize(len);
-        std::vsnprintf(&buffer[0], len + 1, format, args_list);
+        std::vsnprintf(&buffer[0], len + 1, format, args_list_copy);
     }
 
+    va_end(args_list_copy);
     va_end(args_list);
 
     // Return a pointer to the underlying char array of the string
@@ -168,3 +173,72 @@ ScopedFile::~ScopedFile()
     fclose(m_File);
     m_File = nullptr;
 }
+
+LinearAllocator::LinearAllocator(std::size_t initialSize)
+{
+    AddBlock(initialSize);
+}
+
+void LinearAllocator::Reset()
+{
+    // merge all blocks, so that the next frame fits in a single block
+    if (m_Blocks.size() > 1)
+    {
+        const std::size_t totalSize = GetCapacity();
+        m_Blocks.clear();
+        AddBlock(totalSize);
+    }
+
+    m_Offset = 0;
+    m_UsedBytes = 0;
+}
+
+std::size_t LinearAllocator::GetCapacity() const
+{
+    std::size_t capacity = 0;
+    for (const Block& block : m_Blocks)
+    {
+        capacity += block.m_Size;
+    }
+    return capacity;
+}
+
+void* LinearAllocator::do_allocate(std::size_t nbBytes, std::size_t alignment)
+{
+    check((alignment & (alignment - 1)) == 0);
+
+    auto TryAllocate = [&]() -> void*
+        {
+            const Block& block = m_Blocks.back();
+
+            const uintptr_t blockStart = (uintptr_t)block.m_Data.get();
+            const uintptr_t allocStart = (blockStart + m_Offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+            if (allocStart + nbBytes > blockStart + block.m_Size)
+            {
+                return nullptr;
+            }
+
+            m_Offset = allocStart + nbBytes - blockStart;
+            return (void*)allocStart;
+        };
+
+    void* p = TryAllocate();
+    if (!p)
+    {
+        AddBlock(std::max(m_Blocks.back().m_Size * 2, nbBytes + alignment));
+        p = TryAllocate();
+    }
+    check(p);
+
+    m_UsedBytes += nbBytes;
+    m_PeakBytes = std::max(m_PeakBytes, m_UsedBytes);
+
+    return p;
+}
+
+void LinearAllocator::AddBlock(std::size_t size)
+{
+    m_Blocks.push_back(Block{ std::make_unique_for_overwrite<std::byte[]>(size), size });
+    m_Offset = 0;
+}
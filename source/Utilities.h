@@ -2,6 +2,8 @@
 
 #include "magic_enum/magic_enum.hpp"
 
+#include "Hash.h"
+
 const char* StringFormat(const char* format, ...);
 
 const char* GetExecutableDirectory();
@@ -52,12 +54,7 @@ inline void HashCombine(std::size_t& seed, const T& v)
 
 inline std::size_t HashRange(std::byte* startByte, std::size_t nbBytes)
 {
-    std::size_t hash = 0;
-    for (std::size_t i = 0; i < nbBytes; ++i)
-    {
-        HashCombine(hash, *(startByte + i));
-    }
-    return hash;
+    return (std::size_t)HashBytes(startByte, nbBytes);
 }
 
 template <typename T>
@@ -67,6 +64,39 @@ inline std::size_t HashRawMem(const T& s)
     return HashRange((std::byte*)& s, sizeof(T));
 }
 
+// Bump allocator for data that lives for at most 1 frame. 'Reset' rewinds it instead of freeing memory
+// If a frame overflows the current block, a new block is appended & all blocks are merged into 1 bigger block on the next 'Reset'
+// NOTE: not thread safe
+class LinearAllocator : public std::pmr::memory_resource
+{
+public:
+    explicit LinearAllocator(std::size_t initialSize = KB_TO_BYTES(64));
+
+    void Reset();
+
+    std::size_t GetUsedBytes() const { return m_UsedBytes; }
+    std::size_t GetPeakBytes() const { return m_PeakBytes; }
+    std::size_t GetCapacity() const;
+
+private:
+    void* do_allocate(std::size_t nbBytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t nbBytes, std::size_t alignment) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void AddBlock(std::size_t size);
+
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> m_Data;
+        std::size_t m_Size;
+    };
+    std::vector<Block> m_Blocks;
+
+    std::size_t m_Offset = 0; // into the last block
+    std::size_t m_UsedBytes = 0;
+    std::size_t m_PeakBytes = 0;
+};
+
 struct ScopedFile
 {
     ScopedFile(std::string_view filePath, const char* mode);
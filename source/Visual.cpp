@@ -8,6 +8,7 @@
 #include "Scene.h"
 #include "TextureFeedbackManager.h"
 #include "TextureLoading.h"
+#include "TexturePrefetch.h"
 #include "Utilities.h"
 
 #include "shaders/ShaderInterop.h"
@@ -124,6 +125,41 @@ void Texture::LoadFromFile(std::string_view filePath)
         tileCounter += numTiles;
     }
 
+    // stream standard mips tile by tile, if the texture has been converted offline. See 'RunTiledTextureFileConverter'
+    if (m_TiledTextureFile.Load(TiledTextureFile::GetFilePath(filePath)))
+    {
+        const TiledTextureFile::Header& tiledFileHeader = m_TiledTextureFile.GetHeader();
+        const nvrhi::FormatInfo& formatInfo = nvrhi::getFormatInfo(reservedTexDesc.format);
+
+        bool bMatchesTexture = m_TiledTextureFile.IsUpToDate(filePath) &&
+            (tiledFileHeader.m_Width == m_TextureFileHeader.m_Width) &&
+            (tiledFileHeader.m_Height == m_TextureFileHeader.m_Height) &&
+            (tiledFileHeader.m_MipCount == m_TextureFileHeader.m_MipCount) &&
+            (tiledFileHeader.m_BlockSizeInTexels == formatInfo.blockSize) &&
+            (tiledFileHeader.m_BytesPerBlock == formatInfo.bytesPerBlock) &&
+            (tiledFileHeader.m_TileWidthInBlocks * formatInfo.blockSize == m_TileShape.widthInTexels) &&
+            (tiledFileHeader.m_TileHeightInBlocks * formatInfo.blockSize == m_TileShape.heightInTexels);
+
+        for (uint32_t i = 0; bMatchesTexture && i < m_PackedMipDesc.numStandardMips; ++i)
+        {
+            const TiledTextureFile::Mip& tiledFileMip = m_TiledTextureFile.GetMip(i);
+            bMatchesTexture = (tiledFileMip.m_WidthInTiles == m_TilingsInfo[i].widthInTiles) && (tiledFileMip.m_HeightInTiles == m_TilingsInfo[i].heightInTiles);
+        }
+
+        if (bMatchesTexture)
+        {
+            for (uint32_t i = 0; i < m_PackedMipDesc.numStandardMips; ++i)
+            {
+                m_TextureMipDatas[i].m_TileDatas.resize(m_TilingsInfo[i].widthInTiles * m_TilingsInfo[i].heightInTiles);
+            }
+        }
+        else
+        {
+            SDL_Log("Stale tiled texture file for '%s', streaming whole mips", debugName.c_str());
+            m_TiledTextureFile = TiledTextureFile{};
+        }
+    }
+
     // read packed mip bytes
     for (uint32_t i = 0; i < m_PackedMipDesc.numPackedMips; ++i)
     {
@@ -152,6 +188,12 @@ void Texture::LoadFromFile(std::string_view filePath)
     rtxts::TextureDesc minMipDesc;
     g_TextureFeedbackManager->AddTexture(*this, tiledTextureDesc, feedbackDesc, minMipDesc);
 
+    m_FeedbackLayout.m_Width = reservedTexDesc.width;
+    m_FeedbackLayout.m_Height = reservedTexDesc.height;
+    m_FeedbackLayout.m_RegionWidth = feedbackDesc.textureOrMipRegionWidth;
+    m_FeedbackLayout.m_RegionHeight = feedbackDesc.textureOrMipRegionHeight;
+    m_FeedbackLayout.m_NumMips = reservedTexDesc.mipLevels;
+
     // Sampler feedback texture
     nvrhi::SamplerFeedbackTextureDesc samplerFeedbackTextureDesc;
     samplerFeedbackTextureDesc.samplerFeedbackFormat = nvrhi::SamplerFeedbackFormat::MinMipOpaque;
@@ -162,8 +204,8 @@ void Texture::LoadFromFile(std::string_view filePath)
     m_SamplerFeedbackTextureHandle = device->createSamplerFeedbackTexture(m_NVRHITextureHandle, samplerFeedbackTextureDesc);
 
     // Resolve / Readback buffer
-    const uint32_t feedbackTilesX = (reservedTexDesc.width - 1) / feedbackDesc.textureOrMipRegionWidth + 1;
-    const uint32_t feedbackTilesY = (reservedTexDesc.height - 1) / feedbackDesc.textureOrMipRegionHeight + 1;
+    const uint32_t feedbackTilesX = m_FeedbackLayout.GetNumRegionsX();
+    const uint32_t feedbackTilesY = m_FeedbackLayout.GetNumRegionsY();
     for (nvrhi::BufferHandle& resolveBuffer : m_FeedbackResolveBuffers)
     {
         nvrhi::BufferDesc resolveBufferDesc;
@@ -343,6 +385,7 @@ void Mesh::Initialize(
         newLOD.m_NumIndices = LODIndices.size();
         newLOD.m_MeshletDataBufferIdx = meshletsOut.size(); // NOTE: this will be properly offset at the global level after all mesh data are loaded
         newLOD.m_Error = LODError * LODErrorScalingFactor;
+        newLOD.m_UVDensity = ComputeMeshUVDensity(vertices, LODIndices);
 
         std::vector<meshopt_Meshlet> meshlets;
         std::vector<uint32_t> meshletVertices;
@@ -6,6 +6,8 @@
 #include "GraphicConstants.h"
 #include "MathUtilities.h"
 #include "DescriptorTableManager.h"
+#include "TextureFeedbackSets.h"
+#include "TiledTextureFile.h"
 
 // NOTE: keep the values in sync with cgltf_alpha_mode
 enum class AlphaMode
@@ -26,6 +28,14 @@ struct TextureFileHeader
     uint32_t m_ImageDataByteOffset;
 };
 
+// 1 standard tile of a streamed mip, read from the texture's 'TiledTextureFile'
+struct TextureTileData
+{
+    bool m_bDataReady = false;
+    uint64_t m_ReadRequestID = 0; // 'StreamingIO::RequestID' of the read in flight, if any
+    uint64_t m_CacheEntryID = 0;  // 'StreamingMemoryCache::EntryID' of the upload-ready data, see 'TiledTextureFile'. Stale once evicted
+};
+
 struct TextureMipData
 {
     Vector2U m_Resolution = { 0, 0 };
@@ -34,11 +44,15 @@ struct TextureMipData
     uint32_t m_RowPitch = 0;
 
     bool m_bDataReady = false;
-    std::vector<std::byte> m_Data;
+    std::vector<std::byte> m_Data;  // packed mips & textures that aren't streamed
+    uint64_t m_CacheEntryID = 0;    // 'StreamingMemoryCache::EntryID' of streamed standard mips without 'm_TileDatas'. Stale once evicted
 
     uint32_t m_FirstTileIndex;
     rtxts::BitArray m_ResidencyBits;
 
+    // only for standard mips of textures with a 'TiledTextureFile'. Indexed like 'm_ResidencyBits'. 'm_CacheEntryID' stays unused then
+    std::vector<TextureTileData> m_TileDatas;
+
     bool IsValid() const { return m_Resolution.x > 0 && m_Resolution.y > 0 && m_NumBytes > 0; }
 };
 
@@ -62,13 +76,22 @@ public:
     nvrhi::TileShape m_TileShape;
     std::vector<nvrhi::SubresourceTiling> m_TilingsInfo;
 
+    // tile-granular streaming of standard mips. Invalid if the file is missing or doesn't match the texture: whole mips are read from the DDS then
+    TiledTextureFile m_TiledTextureFile;
+    uint32_t m_StreamingFileID = UINT_MAX; // 'StreamingIO::FileID' of the tiled file or the DDS, once opened for streaming
+
     nvrhi::TextureHandle m_NVRHITextureHandle;
     uint32_t m_SRVIndexInTable = UINT_MAX;
 
     uint32_t m_TiledTextureID = UINT_MAX;
     nvrhi::SamplerFeedbackTextureHandle m_SamplerFeedbackTextureHandle;
-    nvrhi::BufferHandle m_FeedbackResolveBuffers[2];
+    nvrhi::BufferHandle m_FeedbackResolveBuffers[GraphicConstants::kMaxFramesInFlight];
     nvrhi::TextureHandle m_MinMipTextureHandle;
+    MinMipFeedbackLayout m_FeedbackLayout;
+
+    // material texture sets share the sampler feedback of their primary texture. See 'TextureFeedbackManager::InitializeFeedbackSets'
+    uint32_t m_FeedbackPrimaryTextureIdx = UINT_MAX; // if this texture follows another's feedback
+    std::vector<uint32_t> m_FeedbackFollowerTextureIndices;
 
     uint32_t m_SamplerFeedbackIndexInTable = UINT_MAX;
     uint32_t m_MinMipIndexInTable = UINT_MAX;
@@ -80,6 +103,7 @@ struct MeshLOD
     uint32_t m_MeshletDataBufferIdx = UINT_MAX;
     uint32_t m_NumMeshlets = 0;
     float m_Error = 0.0f;
+    float m_UVDensity = 0.0f; // UV area per world area, see 'ComputeMeshUVDensity'
 };
 
 class Mesh
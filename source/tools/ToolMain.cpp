@@ -0,0 +1,16 @@
+#include "EngineCore.h"
+#include "HeadlessRuns.h"
+
+extern CommandLineOption<std::string> g_HeadlessRuns;
+
+// Entry point of the standalone tools: headless runs of the device agnostic sources a tool is built with, w/o the app. See 'AddTool' in CMakeLists.txt
+// Same options as the app, i.e.: "-run=rendergraphreplay -rendergraphreplayfile=RenderGraphDeclarations.txt". W/o '-run', runs the tool's 'TOOL_DEFAULT_RUNS'
+int main(int argc, char** argv)
+{
+    InitializeExecutableDirectory(argv[0]);
+    ParseCommandLineOptions(argc, argv);
+
+    const std::string_view runs = g_HeadlessRuns.Get().empty() ? std::string_view{ TOOL_DEFAULT_RUNS } : std::string_view{ g_HeadlessRuns.Get() };
+
+    return HeadlessRuns::Run(runs) ? 0 : 1;
+}